@@ -65,11 +65,14 @@
 #include "omnetpp/simtimemath.h"
 #include "omnetpp/simtime_t.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/cmessageprinter.h"
 #include "omnetpp/cmsgpar.h"
 #include "omnetpp/cmodelchange.h"
 #include "omnetpp/cmodule.h"
+#include "omnetpp/cmodulepath.h"
 #include "omnetpp/ceventheap.h"
+#include "omnetpp/ccalendarqueue.h"
 #include "omnetpp/cmatchexpression.h"
 #include "omnetpp/cpatternmatcher.h"
 #include "omnetpp/cnedfunction.h"
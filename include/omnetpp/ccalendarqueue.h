@@ -0,0 +1,225 @@
+//==========================================================================
+//  CCALENDARQUEUE.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CCALENDARQUEUE_H
+#define __OMNETPP_CCALENDARQUEUE_H
+
+#include <vector>
+#include "cfutureeventset.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Calendar queue based implementation of the future event set.
+ *
+ * The calendar queue (R. Brown, 1988) hashes events into an array of
+ * buckets ("days") by arrival time, and dequeues by sweeping through the
+ * buckets like through the days of a calendar year. Insertion and removal
+ * take O(1) amortized time if the bucket width is well matched to the
+ * spacing of event timestamps, which is why the bucket array is resized
+ * (and the bucket width re-estimated from the events near the front of the
+ * queue) whenever the number of events doubles or halves. This makes the
+ * calendar queue a good choice for models with millions of pending events,
+ * where the O(log n) cost and poor cache locality of cEventHeap dominate.
+ *
+ * Bucket selection uses integer arithmetic on the raw simtime values, and
+ * events within a bucket are kept sorted by cEvent::compareBySchedulingOrder(),
+ * so the order of events (and thus fingerprints) is exactly the same as with
+ * cEventHeap.
+ *
+ * To use it, add the following line to omnetpp.ini:
+ *
+ * <pre>
+ * futureeventset-class = "omnetpp::cCalendarQueue"
+ * </pre>
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cCalendarQueue : public cFutureEventSet
+{
+  private:
+    // events in a bucket are sorted in scheduling order; already removed
+    // ones at the front are skipped via 'head', so that both removing the
+    // first event and appending a new last one are O(1)
+    struct Bucket {
+        std::vector<cEvent*> events;
+        int head = 0;
+        bool isEmpty() const {return head == (int)events.size();}
+        cEvent *front() const {return events[head];}
+    };
+
+    // calendar data structure
+    Bucket *buckets;           // bucket array
+    int numBuckets;            // always power of 2
+    int64_t bucketWidth;       // in raw simtime units
+    int length;                // total number of events
+    eventnumber_t insertCount; // counts insertions; needed for stable ordering of events with equal time and priority
+
+    // dequeue position; mutable because peekFirst() also advances it
+    mutable int currentBucket;     // bucket where the next event is looked for
+    mutable int64_t currentTop;    // exclusive upper time limit (raw) of currentBucket in the current "year"
+
+    // resize thresholds
+    int shrinkThreshold, growThreshold;
+
+    // for get(k) and sort(): snapshot of the contents
+    std::vector<cEvent*> snapshot;
+    bool snapshotValid;
+
+  private:
+    void copy(const cCalendarQueue& other);
+    int getBucketIndex(int64_t t) const {return (int)((t / bucketWidth) & (numBuckets-1));}
+    void bucketInsert(cEvent *event);
+    void setPositionTo(int64_t t) const;
+    Bucket *findFirst() const;
+    Bucket *findMinimum() const;
+    void resize(int newNumBuckets);
+    int64_t estimateBucketWidth(std::vector<cEvent*>& events) const;
+    void invalidateSnapshot() {snapshotValid = false;}
+    void buildSnapshot();
+
+  public:
+    /** @name Constructors, destructor, assignment */
+    //@{
+
+    /**
+     * Copy constructor.
+     */
+    cCalendarQueue(const cCalendarQueue& other);
+
+    /**
+     * Constructor.
+     */
+    cCalendarQueue(const char *name=nullptr);
+
+    /**
+     * Destructor.
+     */
+    virtual ~cCalendarQueue();
+
+    /**
+     * Assignment operator. The name member is not copied;
+     * see cOwnedObject's operator=() for more details.
+     */
+    cCalendarQueue& operator=(const cCalendarQueue& other);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cCalendarQueue *dup() const override  {return new cCalendarQueue(*this);}
+
+    /**
+     * Produces a one-line description of the object's contents.
+     * See cObject for more details.
+     */
+    virtual std::string str() const override;
+
+    /**
+     * Calls v->visit(this) for each contained object.
+     * See cObject for more details.
+     */
+    virtual void forEachChild(cVisitor *v) override;
+
+    // no parsimPack() and parsimUnpack()
+    //@}
+
+    /** @name Simulation-related operations. */
+    //@{
+    /**
+     * Insert an event into the FES.
+     */
+    virtual void insert(cEvent *event) override;
+
+    /**
+     * Peek the first event in the FES (the one with the smallest timestamp.)
+     * If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *peekFirst() const override;
+
+    /**
+     * Removes and return the first event in the FES (the one with the
+     * smallest timestamp.) If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *removeFirst() override;
+
+    /**
+     * Undo for removeFirst(): it puts back an event to the front of the FES.
+     */
+    virtual void putBackFirst(cEvent *event) override;
+
+    /**
+     * Removes and returns the given event in the FES. If the event is
+     * not in the FES, returns nullptr.
+     */
+    virtual cEvent *remove(cEvent *event) override;
+
+    /**
+     * Returns true if the FES is empty.
+     */
+    virtual bool isEmpty() const override {return length == 0;}
+
+    /**
+     * Deletes all events in the FES.
+     */
+    virtual void clear() override;
+    //@}
+
+    /** @name Random access. */
+    //@{
+
+    /**
+     * Returns the number of events in the FES.
+     */
+    virtual int getLength() const override {return length;}
+
+    /**
+     * Returns the kth event in the FES if 0 <= k < getLength(), and nullptr
+     * otherwise. Note that iteration does not necessarily return events
+     * in increasing timestamp (getArrivalTime()) order unless you called
+     * sort() before.
+     */
+    virtual cEvent *get(int k) override;
+
+    /**
+     * Sorts the contents of the FES. This is only necessary if one wants
+     * to iterate through in the FES in strict timestamp order.
+     */
+    virtual void sort() override;
+    //@}
+
+    /** @name Calendar queue parameters. */
+    //@{
+    /**
+     * Returns the current number of buckets.
+     */
+    int getNumBuckets() const {return numBuckets;}
+
+    /**
+     * Returns the current bucket width.
+     */
+    simtime_t getBucketWidth() const {return SimTime().setRaw(bucketWidth);}
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -315,7 +315,6 @@ class SIM_API cFigure : public cOwnedObject
         };
 
     private:
-        static int lastId;
         static cStringPool stringPool;
         int id;
         double zIndex;
@@ -33,6 +33,12 @@ class opp_string;
  * For example, the MPI implementation, cMPICommBuffer encapsulates
  * MPI_Pack() and MPI_Unpack().
  *
+ * Implementations may record a reference to packed arrays and memory blocks
+ * (see packBytes()) instead of copying them (see cScatterGatherCommBuffer),
+ * so their data must stay alive and unchanged until the buffer has been
+ * sent with cParsimCommunications::send() or broadcast(). Basic types and
+ * strings are always copied, so they may be passed as temporaries.
+ *
  * @see cObject::parsimPack(), cObject::parsimUnpack()
  *
  * @ingroup ParsimBrief
@@ -363,6 +369,21 @@ class SIM_API cCommBuffer : public cObject
     virtual void unpack(SimTime *d, int size) = 0;
     //@}
 
+    /** @name Pack/unpack raw memory blocks */
+    //@{
+    /**
+     * Packs a block of memory as it is, e.g. a struct that only contains
+     * fields of basic types (opp_msgc generates such code for structs).
+     * This is only valid if all partitions use the same data representation.
+     * The default implementation packs the block as a char array.
+     */
+    virtual void packBytes(const void *d, int size)  {pack((const char *)d, size);}
+    /**
+     * Unpacks a block of memory packed with packBytes().
+     */
+    virtual void unpackBytes(void *d, int size)  {unpack((char *)d, size);}
+    //@}
+
     /** @name Utility functions */
     //@{
     /**
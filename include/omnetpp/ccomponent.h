@@ -51,8 +51,8 @@ class SIM_API cComponent : public cDefaultList //implies noncopyable
     friend class cComponent__SignalListenerListDescriptor;  // sim_std.msg
     friend class cPar; // needs to call handleParameterChange()
     friend class cChannel; // allow it to access FL_INITIALIZED and releaseLocalListeners()
-    friend class cModule; // allow it to access FL_INITIALIZED, releaseLocalListeners() and repairSignalFlags()
-    friend class cGate;   // because of repairSignalFlags()
+    friend class cModule; // allow it to access FL_INITIALIZED, releaseLocalListeners() and invalidateListenerFlags()
+    friend class cGate;   // because of invalidateListenerFlags()
     friend class cSimulation; // sets componentId
     friend class cResultListener; // invalidateCachedResultRecorderLists()
   public:
@@ -100,38 +100,49 @@ class SIM_API cComponent : public cDefaultList //implies noncopyable
     typedef std::vector<SignalListenerList> SignalTable;
     SignalTable *signalTable; // ordered by signalID so we can do binary search
 
-    // string-to-simsignal_t mapping
-    static struct SignalNameMapping {
-        std::map<std::string,simsignal_t> signalNameToID;
-        std::map<simsignal_t,std::string> signalIDToName;
-    } *signalNameMapping;  // must be dynamically allocated on first access so that registerSignal() can be invoked from static initialization code
-    static int lastSignalID;
-
-    // for hasListeners()/mayHaveListeners()
-    static std::vector<int> signalListenerCounts;  // index: signalID, value: number of listeners anywhere
-
-    // stack of listener lists being notified, to detect concurrent modification
-    static cIListener **notificationStack[];
-    static int notificationSP;
-
-    // whether only signals declared in NED via @signal are allowed to be emitted
-    static bool checkSignals;
-
-    // for caching the result of getResultRecorders()
-    struct ResultRecorderList {
-        const cComponent *component;
-        std::vector<cResultRecorder*> recorders;
-    };
-
-    // for getResultRecorders(); static because we don't want to increase cComponent's size
-    static std::vector<ResultRecorderList*> cachedResultRecorderLists;
+    // Note: the signal name registry is process-wide, while the signal listener
+    // counts, the notification stack and the other signal-related state that
+    // belongs to a running simulation are per-thread (see ccomponent.cc), so
+    // that simulations may run concurrently in separate threads.
+
+    // for the emit() fast path: bit k of the first numListenerFlagWords words
+    // is set if signal k has listeners in this component or in any of its
+    // ancestors; the second numListenerFlagWords words are the same for the
+    // listeners of this component only, so that fire() can skip ancestors
+    // without looking up their listener lists. Computed on demand, and recomputed
+    // when listenerFlagsGeneration falls behind the current generation, which
+    // is incremented on subscribe/unsubscribe and on module hierarchy changes.
+    mutable uint64_t *listenerFlags;
+    mutable int numListenerFlagWords;
+    mutable uint64_t listenerFlagsGeneration;
+
+#ifdef OPP_INLINE_TLS
+    // data pointer and size of the per-thread signal listener counts array,
+    // for the inline mayHaveListeners()
+    static OPP_THREAD_LOCAL const int *signalListenerCountsData;
+    static OPP_THREAD_LOCAL int numSignalListenerCounts;
+#endif
 
   private:
     SignalListenerList *findListenerList(simsignal_t signalID) const;
     SignalListenerList *findOrCreateListenerList(simsignal_t signalID);
     void throwInvalidSignalID(simsignal_t signalID) const;
+    bool computeMayHaveListeners(simsignal_t signalID) const;
+    static void signalListenerCountsResized();
     void removeListenerList(simsignal_t signalID);
     void checkNotFiring(simsignal_t, cIListener **listenerList);
+    const uint64_t *getListenerFlags() const;
+    bool hasListenerFlag(simsignal_t signalID) const {
+        const uint64_t *flags = getListenerFlags();
+        int word = signalID >> 6;
+        return word < numListenerFlagWords && ((flags[word] >> (signalID & 63)) & 1) != 0;
+    }
+    bool hasLocalListenerFlag(simsignal_t signalID) const {
+        const uint64_t *flags = getListenerFlags();
+        int word = signalID >> 6;
+        return word < numListenerFlagWords && ((flags[numListenerFlagWords + word] >> (signalID & 63)) & 1) != 0;
+    }
+    static void invalidateListenerFlags();
     template<typename T> void fire(cComponent *src, simsignal_t signalID, T x, cObject *details);
     void fireFinish();
     void releaseLocalListeners();
@@ -188,8 +199,8 @@ class SIM_API cComponent : public cDefaultList //implies noncopyable
     static uint64_t getSignalMask(simsignal_t signalID);
 
     // internal: controls whether signals should be validated against @signal declarations in NED files
-    static void setCheckSignals(bool b) {checkSignals = b;}
-    static bool getCheckSignals() {return checkSignals;}
+    static void setCheckSignals(bool b);
+    static bool getCheckSignals();
 
     // internal: for inspectors
     const std::vector<cResultRecorder*>& getResultRecorders() const;
@@ -919,9 +930,11 @@ class SIM_API cComponent : public cDefaultList //implies noncopyable
      * This method has a constant cost but may return false positive.
      */
     bool mayHaveListeners(simsignal_t signalID) const {
-        if (signalID < 0 || signalID > lastSignalID)
-            throwInvalidSignalID(signalID);
-        return signalListenerCounts[signalID] > 0;
+#ifdef OPP_INLINE_TLS
+        if ((unsigned int)signalID < (unsigned int)numSignalListenerCounts)
+            return signalListenerCountsData[signalID] > 0;
+#endif
+        return computeMayHaveListeners(signalID);
     }
 
     /**
@@ -19,6 +19,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <mutex>
 #include "cpar.h"
 #include "cgate.h"
 #include "cownedobject.h"
@@ -53,6 +54,10 @@ class SIM_API cComponentType : public cNoncopyableOwnedObject
     bool availabilityTested;
     bool available;
 
+    // protects sharedParMap, sharedParSet and signalsSeen, because component
+    // types are shared by simulations running concurrently (Cmdenv -j)
+    mutable std::mutex cacheMutex;
+
     typedef std::map<std::string, cParImpl *> StringToParMap;
     StringToParMap sharedParMap;
 
@@ -95,13 +100,14 @@ class SIM_API cComponentType : public cNoncopyableOwnedObject
     // internal: apply pattern-based ("deep") parameter settings in NED
     virtual void applyPatternAssignments(cComponent *component) = 0;
 
-    // internal: sharedParMap access
+    // internal: sharedParMap access. putSharedParImpl() returns the cached
+    // object, which is not the argument if another thread stored one first
     cParImpl *getSharedParImpl(const char *key) const;
-    void putSharedParImpl(const char *key, cParImpl *value);
+    cParImpl *putSharedParImpl(const char *key, cParImpl *value);
 
-    // internal: sharedParSet access
+    // internal: sharedParSet access; putSharedParImpl() works as above
     cParImpl *getSharedParImpl(cParImpl *p) const;
-    void putSharedParImpl(cParImpl *p);
+    cParImpl *putSharedParImpl(cParImpl *p);
 
     // internal: helper for checkSignal()
     cObjectFactory *lookupClass(const char *className) const;
@@ -19,7 +19,7 @@
 #include "platdep/platmisc.h"  // for <windows.h>
 #include "simkerneldefs.h"
 
-#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES)
+#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES) && !defined(USE_ASM_COROUTINES)
 #error "Coroutine library choice not specified"
 #endif
 
@@ -50,9 +50,19 @@ typedef void (*CoroutineFnp)( void * );
  *
  * On Windows, it uses the Win32 Fiber API.
  *
- * On Unix-like systems, it uses POSIX coroutines (setcontext()/switchcontext())
+ * On x86-64 and aarch64 Unix-like systems (with ELF binaries), it uses
+ * a hand-written context switch routine that only saves and restores the
+ * callee-saved registers, unless disabled at build time (PREFER_ASM_COROUTINES=no
+ * in configure.user). Unlike swapcontext(), it does not save the signal mask,
+ * so switching does not involve a system call.
+ *
+ * On other Unix-like systems, it uses POSIX coroutines (setcontext()/switchcontext())
  * if they are available.
  *
+ * In the latter two cases, stacks are allocated with mmap(), with a guard area below them
+ * that turns stack overflows into immediate segmentation faults, and are
+ * kept for reuse when the coroutine is deleted.
+ *
  * Otherwise, it uses a portable coroutine library first described
  * by Stig Kofoed ("Portable coroutines", see the Manual for a better
  * reference). It creates all coroutine stacks within the main stack,
@@ -69,18 +79,20 @@ class SIM_API cCoroutine
   protected:
 #ifdef USE_WIN32_FIBERS
     LPVOID lpFiber;
-    static LPVOID lpMainFiber;
     unsigned stackSize;
 #endif
 #ifdef USE_POSIX_COROUTINES
-    static ucontext_t mainContext;
-    static ucontext_t *curContextPtr;
-    static unsigned totalStackLimit;
-    static unsigned totalStackUsage;
     unsigned stackSize;
     char *stackPtr;
+    bool stackMapped;
     ucontext_t context;
 #endif
+#ifdef USE_ASM_COROUTINES
+    unsigned stackSize;
+    char *stackPtr;
+    bool stackMapped;
+    void *savedSp;  // stack pointer of the suspended coroutine
+#endif
 #ifdef USE_PORTABLE_COROUTINES
     _Task *task;
 #endif
@@ -91,7 +103,11 @@ class SIM_API cCoroutine
 
     /**
      * Initializes the coroutine library. This function has to be called
-     * exactly once in a program, possibly at the top of main().
+     * once in a program, possibly at the top of main(). The main context and
+     * the stack accounting are per-thread, so threads that run simulations
+     * of their own (with activity() modules) must also call it at their start.
+     * (With the portable coroutine library, only the main thread may run
+     * coroutines.)
      */
     static void init(unsigned totalStack, unsigned mainStack);
 
@@ -136,7 +152,11 @@ class SIM_API cCoroutine
      * Returns true if there was a stack overflow during execution of the
      * coroutine.
      *
-     * Windows/Fiber API, POSIX coroutines: Not implemented: always returns false.
+     * Windows/Fiber API: Not implemented, always returns false.
+     *
+     * POSIX and assembly coroutines: Always returns false. Stacks are protected
+     * by a guard area, so a stack overflow immediately causes a segmentation
+     * fault, and a diagnostic message is printed.
      *
      * Portable coroutines: it checks the intactness of a predefined byte pattern
      * (0xdeadbeef) at the stack boundary, and report stack overflow
@@ -156,7 +176,11 @@ class SIM_API cCoroutine
     /**
      * Returns the amount of stack actually used by the coroutine.
      *
-     * Windows/Fiber API, POSIX coroutines: Not implemented, always returns 0.
+     * Windows/Fiber API: Not implemented, always returns 0.
+     *
+     * POSIX and assembly coroutines: Returns the size of the stack pages that
+     * have been committed by the operating system, i.e. the maximum stack depth
+     * reached (rounded up to the page size).
      *
      * Portable coroutines: It works by checking the intactness of
      * predefined byte patterns (0xdeadbeef) placed in the stack.
@@ -85,6 +85,11 @@ class SIM_API cEnvir
     // connectionDeleted(), displayStringChanged().
     bool suppressNotifications;
 
+    // Internal flag. When set to true, the simulation kernel MAY omit calling
+    // messageSendHop() for hops where the message is not affected, i.e. for
+    // connections without a channel object or with a cIdealChannel.
+    bool suppressPassThroughHops;
+
     // Debugging. When set, cRuntimeError constructor executes a debug trap/launches debugger
     bool debugOnErrors = false;
 
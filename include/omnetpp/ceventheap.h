@@ -21,50 +21,88 @@
 namespace omnetpp {
 
 /**
- * @brief The default, binary heap based implementation of the future event set.
+ * @brief The default, heap based implementation of the future event set.
  *
- * Using binary heap as the underlying data structure provides reliable
- * performance for most workloads. A worst case for heap is insertion at the
- * front (i.e. for the current simulation time), which is actually quite common,
- * due to the abundance of zero-delay links in models. This case is optimized
- * by employing an additional circular buffer specifically for storing events
- * inserted scheduled for the current simulation time.
+ * Using heap as the underlying data structure provides reliable
+ * performance for most workloads. The heap is 4-ary, and stores the sort key
+ * (arrival time, priority, insertion order) of each event inline next to the
+ * event pointer. The children of each node occupy a contiguous, cache line
+ * aligned block, so sifting up or down the heap does not need to dereference
+ * the event objects.
+ *
+ * A worst case for heap is insertion at the front (i.e. for the current
+ * simulation time), which is actually quite common, due to the abundance
+ * of zero-delay links in models. This case is optimized by employing
+ * additional circular buffers specifically for storing events scheduled
+ * for the current simulation time, one for each scheduling priority
+ * in a small range around zero.
  *
  * @ingroup SimSupport
  */
 class SIM_API cEventHeap : public cFutureEventSet
 {
   private:
+    // heap entry: the event with its sort key
+    struct HeapEntry {
+        int64_t arrivalTime;       // raw simtime
+        eventnumber_t insertOrder;
+        short priority;
+        cEvent *event;
+
+        // same as cEvent::compareBySchedulingOrder(event, other.event) < 0
+        bool operator<(const HeapEntry& other) const {
+            return arrivalTime != other.arrivalTime ? arrivalTime < other.arrivalTime :
+                   priority != other.priority ? priority < other.priority :
+                   insertOrder < other.insertOrder;
+        }
+    };
+
     // heap data structure
-    cEvent **heap;            // heap array  (heap[0] always empty)
+    HeapEntry *heap;          // heap array (aligned; the root is at heap[HEAP_ROOT], see .cc file)
+    char *heapMemory;         // the allocated memory block that contains heap[]
     int heapLength;           // number of elements on the heap
-    int heapCapacity;         // allocated size of the heap[] array
+    int heapCapacity;         // allocated size of the heap[] array (not counting the unused elements at the front)
     eventnumber_t insertCount; // counts insertions; needed because heap's insert is not stable (does not keep order)
 
-    // circular buffer for events scheduled for the current simtime (quite frequent); acts as FIFO
-    cEvent **cb;              // size of the circular buffer
-    int cbsize;               // always power of 2
-    int cbhead, cbtail;       // cbhead is inclusive, cbtail is exclusive
-    bool useCb;               // for disabling cb
+    // circular buffers ("lanes") for events scheduled for the current simtime
+    // (quite frequent), one for each priority in the range LANE_MINPRIORITY..
+    // LANE_MINPRIORITY+NUM_LANES-1; each acts as FIFO
+    enum { NUM_LANES = 16, LANE_MINPRIORITY = -8 };
+    struct Lane {
+        cEvent **cb;          // the circular buffer
+        int cbsize;           // always power of 2
+        int cbhead, cbtail;   // cbhead is inclusive, cbtail is exclusive
+        int length() const {return (cbtail-cbhead) & (cbsize-1);}
+        cEvent *get(int k) const {return cb[(cbhead+k) & (cbsize-1)];}
+    };
+    Lane lanes[NUM_LANES];
+    int laneCount;            // total number of events in the lanes
+    int firstLane;            // the first non-empty lane, or NUM_LANES if all are empty
+    simtime_t laneTime;       // arrival time of all events in the lanes
+    bool useCb;               // for disabling the lanes
 
   private:
     void copy(const cEventHeap& other);
 
-    // internal: restore heap
-    void shiftup(int from=1);
+    // internal: heap memory management and restoring the heap
+    HeapEntry *allocateHeap(int capacity, char *&memory);
+    void siftUp(int pos, const HeapEntry& entry);
+    void siftDown(int pos);
 
-    int cblength() const  {return (cbtail-cbhead) & (cbsize-1);}
-    cEvent *cbget(int k)  {return cb[(cbhead+k) & (cbsize-1)];}
-    void cbgrow();
+    void initLanes();
+    void laneGrow(int lane);
+    int getLaneFor(cEvent *event) const;
+    bool heapTopPrecedes(cEvent *event) const;
+    cEvent *laneRemoveFirst();
 
     void heapInsert(cEvent *event);
-    void cbInsert(cEvent *event);
+    void cbInsert(cEvent *event, int lane);
     void flushCb();
 
   public:
     // internal:
     bool getUseCb() const {return useCb;}
-    void setUseCb(bool b) {ASSERT(cbhead==cbtail); useCb = b;}
+    void setUseCb(bool b) {ASSERT(laneCount==0); useCb = b;}
 
   public:
     /** @name Constructors, destructor, assignment */
@@ -149,7 +187,7 @@ class SIM_API cEventHeap : public cFutureEventSet
     /**
      * Returns true if the FES is empty.
      */
-    virtual bool isEmpty() const override {return cbhead==cbtail && heapLength==0;}
+    virtual bool isEmpty() const override {return laneCount==0 && heapLength==0;}
 
     /**
      * Deletes all events in the FES.
@@ -163,7 +201,7 @@ class SIM_API cEventHeap : public cFutureEventSet
     /**
      * Returns the number of events in the FES.
      */
-    virtual int getLength() const override {return cblength() + heapLength;}
+    virtual int getLength() const override {return laneCount + heapLength;}
 
     /**
      * Returns the kth event in the FES if 0 <= k < getLength(), and nullptr
@@ -99,7 +99,7 @@ class SIM_API cGate : public cObject, noncopyable
     struct Desc
     {
         cModule *owner;
-        Name *name;  // pooled (points into cModule::namePool)
+        Name *name;  // pooled (points into cModule's name pool)
         int vectorSize; // gate vector size, or -1 if scalar gate; actually allocated size is capacityFor(size)
         union Gates { cGate *gate; cGate **gatev; };
         Gates input;
@@ -132,8 +132,7 @@ class SIM_API cGate : public cObject, noncopyable
     cChannel *channel;  // channel object (if exists)
     cGate *prevGate;    // previous and next gate in the path
     cGate *nextGate;
-
-    static int lastConnectionId;
+    cGate *nextHopGate; // cache: first gate from here along the path which has a channel that needs processing, or the path end gate; nullptr if not yet computed
 
   protected:
     // internal: constructor is protected because only cModule is allowed to create instances
@@ -151,6 +150,10 @@ class SIM_API cGate : public cObject, noncopyable
     // internal
     void checkChannels() const;
 
+    // internal: path cache used by deliver()
+    cGate *getNextHopGate();
+    void invalidatePathCache();
+
 #ifdef SIMFRONTEND_SUPPORT
     // internal
     virtual bool hasChangedSince(int64_t lastRefreshSerial);
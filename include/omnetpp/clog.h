@@ -417,13 +417,11 @@ class SIM_API cLogProxy
     static nullstream dummyStream; // EV evaluates to this when in express mode (getEnvir()->disabled())
 
   private:
-    static LogBuffer buffer;  // underlying buffer that contains the text that has been written so far
-    static std::ostream stream;  // this singleton is used to avoid allocating a new stream each time a log statement executes
-    static cLogEntry currentEntry; // context of the current (last) log statement that has been executed.
-    static LogLevel previousLogLevel; // log level of the previous log statement
-    static const char *previousCategory; // category of the previous log statement
+    struct State; // buffer, stream, current log entry, etc; one instance per thread
+    State *state; // the calling thread's State
 
   private:
+    static State& getState();
     void fillEntry(LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction);
 
   public:
@@ -432,7 +430,7 @@ class SIM_API cLogProxy
     cLogProxy(const cComponent *sourceComponent, LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction);
     ~cLogProxy();
 
-    std::ostream& getStream() { return stream; }
+    std::ostream& getStream();
     static void flushLastLine();
 };
 
@@ -0,0 +1,129 @@
+//==========================================================================
+//  CMEMORYPOOL.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CMEMORYPOOL_H
+#define __OMNETPP_CMEMORYPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "simkerneldefs.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Recycling allocator for frequently created and deleted objects,
+ * typically messages and packets.
+ *
+ * Memory blocks are grouped into size classes (multiples of 16 bytes up to
+ * getMaxPooledSize()). Freed blocks are not returned to the global heap but
+ * are kept on a per-thread, per-size-class free list, and are handed out
+ * again on the next allocation of the same size class. Blocks larger than
+ * getMaxPooledSize() are passed through to the global operator new/delete.
+ * Free lists are thread-local, so allocation and deallocation need no
+ * locking; a block may be freed by a different thread than the one that
+ * allocated it, it then migrates into that thread's free list. To keep
+ * memory bounded when one thread mostly allocates and another mostly frees,
+ * each free list is capped at getMaxCachedBytesPerSizeClass(); beyond that,
+ * blocks are released to the global heap. Objects deleted while or after
+ * the thread exits (e.g. by destructors of static objects) bypass the pool.
+ *
+ * Classes opt in by redirecting their class-level operator new/delete to
+ * allocate() and deallocate(). The message compiler does that for message,
+ * packet and class types annotated with the <tt>@pooled</tt> property,
+ * and hand-written classes may use the OMNETPP_USE_MEMORY_POOL macro.
+ * Since operator new is inherited, subclasses are pooled as well, and
+ * objects created via cObjectFactory (Register_Class()) are also served
+ * from the pool.
+ *
+ * @ingroup SimSupport
+ */
+class SIM_API cMemoryPool
+{
+  public:
+    /**
+     * Allocation statistics of the calling thread.
+     */
+    struct Statistics {
+        int64_t numAllocations = 0;   ///< number of allocate() calls for pooled sizes
+        int64_t numReused = 0;        ///< number of allocations served from a free list
+        int64_t numDeallocations = 0; ///< number of deallocate() calls for pooled sizes
+        int64_t numReleased = 0;      ///< number of freed blocks released to the global heap because a free list was full
+        int64_t numCachedBlocks = 0;  ///< number of blocks currently on the free lists
+        int64_t cachedBytes = 0;      ///< total size of the blocks currently on the free lists
+    };
+
+  private:
+    // static class
+    cMemoryPool() {}
+
+  public:
+    /**
+     * Allocates a memory block of at least the given size. Never returns
+     * nullptr; throws std::bad_alloc if memory is exhausted.
+     */
+    static void *allocate(size_t size);
+
+    /**
+     * Returns a memory block obtained from allocate(). The size must be
+     * the same as the one passed to allocate().
+     */
+    static void deallocate(void *p, size_t size);
+
+    /**
+     * Releases all blocks on the calling thread's free lists to the global
+     * heap. This is done automatically when the thread exits.
+     */
+    static void purge();
+
+    /**
+     * Returns the allocation statistics of the calling thread.
+     */
+    static Statistics getStatistics();
+
+    /**
+     * Resets the counters in the calling thread's statistics. Cached
+     * blocks are not affected.
+     */
+    static void resetStatistics();
+
+    /**
+     * Returns the largest block size handled by the pool; larger requests
+     * are passed through to the global operator new and delete.
+     */
+    static size_t getMaxPooledSize();
+
+    /**
+     * Returns the limit on the total size of cached blocks in one free list.
+     * When a free list exceeds it, half of its blocks are released to the
+     * global heap.
+     */
+    static size_t getMaxCachedBytesPerSizeClass();
+};
+
+/**
+ * @brief Redirects the class-level operator new and delete to cMemoryPool.
+ * To be placed into the public section of a class declaration.
+ *
+ * @ingroup SimSupport
+ */
+#define OMNETPP_USE_MEMORY_POOL \
+    static void *operator new(size_t size) {return omnetpp::cMemoryPool::allocate(size);} \
+    static void operator delete(void *p, size_t size) {omnetpp::cMemoryPool::deallocate(p, size);}
+
+}  // namespace omnetpp
+
+
+#endif
+
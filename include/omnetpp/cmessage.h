@@ -115,11 +115,6 @@ class SIM_API cMessage : public cEvent
 
     long messageId;            // a unique message identifier assigned upon message creation
     long messageTreeId;        // a message identifier that is inherited by dup, if non dupped it is msgid
-    static long nextMessageId; // the next unique message identifier to be assigned upon message creation
-
-    // global variables for statistics
-    static long totalMsgCount;
-    static long liveMsgCount;
 
   private:
     // internal: create parlist
@@ -622,8 +617,9 @@ class SIM_API cMessage : public cEvent
      * Counter is <tt>signed</tt> to make it easier to detect if it overflows
      * during very long simulation runs.
      * May be useful for profiling or debugging memory leaks.
+     * Message counters are maintained per thread.
      */
-    static long getTotalMessageCount() {return totalMsgCount;}
+    static long getTotalMessageCount();
 
     /**
      * Returns the number of message objects that currently exist in the
@@ -632,12 +628,12 @@ class SIM_API cMessage : public cEvent
      * May be useful for profiling or debugging memory leaks caused by forgetting
      * to delete messages.
      */
-    static long getLiveMessageCount() {return liveMsgCount;}
+    static long getLiveMessageCount();
 
     /**
      * Reset counters used by getTotalMessageCount() and getLiveMessageCount().
      */
-    static void resetMessageCounters()  {totalMsgCount=liveMsgCount=0;}
+    static void resetMessageCounters();
     //@}
 };
 
@@ -257,10 +257,6 @@ class SIM_API cModule : public cComponent //implies noncopyable
         ChannelIterator& operator--() {if (!end()) k--; return *this;}
     };
 
-  private:
-    static std::string lastModuleFullPath; // cached result of last getFullPath() call
-    static const cModule *lastModuleFullPathModule; // module of lastModuleFullPath
-
   private:
     enum {
         FL_BUILDINSIDE_CALLED = 1 << 9, // whether buildInside() has been called
@@ -279,11 +275,15 @@ class SIM_API cModule : public cComponent //implies noncopyable
     cModule *prevSibling, *nextSibling; // pointers to sibling submodules
     cModule *firstSubmodule;  // pointer to first submodule
     cModule *lastSubmodule;   // pointer to last submodule (needed for efficient append operation)
+    struct SubmoduleIndex;
+    mutable SubmoduleIndex *submoduleIndex; // hash index of submodules by name and index; only built for modules with many submodules
 
     typedef std::set<cGate::Name> NamePool;
-    static NamePool namePool;
+    static NamePool& getNamePool(); // per-thread
     int gateDescArraySize;    // size of the descv array
     cGate::Desc *gateDescArray; // array with one element per gate or gate vector
+    struct GateDescIndex;
+    mutable GateDescIndex *gateDescIndex; // hash index of gateDescArray by gate name; only built for modules with many gates
 
     int vectorIndex;      // index if module vector, 0 otherwise
     int vectorSize;       // vector size, -1 if not a vector
@@ -327,12 +327,20 @@ class SIM_API cModule : public cComponent //implies noncopyable
     // internal: used by changeParentTo()
     void reassignModuleIdRec();
 
+    // internal: called when the full path of this module and its submodules changes
+    void invalidatePooledFullPathRec();
+
     // internal: inserts a submodule. Called as part of the module creation process.
     void insertSubmodule(cModule *mod);
 
     // internal: removes a submodule
     void removeSubmodule(cModule *mod);
 
+    // internal: maintenance of the submodule hash index
+    void buildSubmoduleIndex() const;
+    void addToSubmoduleIndex(cModule *mod);
+    void removeFromSubmoduleIndex(cModule *mod);
+
     // internal: "virtual ctor" for cGate, because in cPlaceholderModule we need
     // different gate objects; type should be INPUT or OUTPUT, but not INOUT
     virtual cGate *createGateObject(cGate::Type type);
@@ -353,6 +361,11 @@ class SIM_API cModule : public cComponent //implies noncopyable
     // internal: like findGateDesc(), but throws an error if the gate does not exist
     cGate::Desc *gateDesc(const char *gatename, char& suffix) const;
 
+    // internal: maintenance of the gatedesc hash index
+    void buildGateDescIndex() const;
+    void addToGateDescIndex(int descIndex);
+    void removeFromGateDescIndex(int descIndex);
+
     // internal: helper for setGateSize()
     void adjustGateDesc(cGate *g, cGate::Desc *newvec);
 
@@ -432,6 +445,18 @@ class SIM_API cModule : public cComponent //implies noncopyable
      */
     virtual std::string getFullPath() const override;
 
+    /**
+     * Returns the full path of the module like getFullPath(), but as a pooled
+     * string that does not need to be copied or freed. The string is computed
+     * on the first call and served from a table indexed by module ID afterwards,
+     * so this method is the preferred choice in code that frequently needs
+     * module paths (logging, result recording, etc.) The returned pointer
+     * remains valid until the network is deleted; note, however, that if the
+     * module is renamed or moved, it will keep pointing to the old path, and
+     * subsequent calls will return a new pointer.
+     */
+    const char *getFullPathPooled() const;
+
     /**
      * Overridden to add the module ID.
      */
@@ -614,7 +639,7 @@ class SIM_API cModule : public cComponent //implies noncopyable
      *   "Net.src" also means the src submodule of the toplevel module, provided
      *   it is called Net.
      *
-     *  @see cSimulation::getModuleByPath()
+     *  @see cSimulation::getModuleByPath(), cModulePath
      */
     virtual cModule *getModuleByPath(const char *path) const;
     //@}
@@ -0,0 +1,85 @@
+//==========================================================================
+//  CMODULEPATH.H - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CMODULEPATH_H
+#define __OMNETPP_CMODULEPATH_H
+
+#include <string>
+#include <vector>
+#include "simkerneldefs.h"
+
+namespace omnetpp {
+
+class cModule;
+
+/**
+ * @brief A module path in parsed form, for resolving the same path
+ * repeatedly.
+ *
+ * cModule::getModuleByPath() parses the path string on every call.
+ * cModulePath parses it once, in the constructor, and resolve() only needs
+ * to walk the module tree. The path syntax and the semantics of resolve()
+ * are the same as those of getModuleByPath(); syntax errors are reported
+ * by the constructor.
+ *
+ * Example:
+ * <pre>
+ *   cModulePath path("^.host[3].app");  // e.g. in a class member
+ *   ...
+ *   cModule *app = path.resolve(this);
+ * </pre>
+ *
+ * @see cModule::getModuleByPath()
+ * @ingroup SimSupport
+ */
+class SIM_API cModulePath
+{
+  protected:
+    struct Element {
+        std::string name;
+        int index;             // -1 if no index was given
+        bool isParent;         // "^"
+        bool mayBeNetworkName; // true for the first element of an absolute path
+    };
+    std::string path;
+    bool isRelative;
+    std::vector<Element> elements;
+
+  public:
+    /**
+     * Constructor. Parses the given path, and throws an error if it is
+     * syntactically invalid.
+     */
+    explicit cModulePath(const char *path);
+
+    /**
+     * Returns the path string this object was created with.
+     */
+    const char *str() const {return path.c_str();}
+
+    /**
+     * Resolves the path. Relative paths are resolved relative to the given
+     * module; absolute paths are resolved from the toplevel module of the
+     * active simulation. Returns nullptr if the module was not found or the
+     * path is empty.
+     */
+    cModule *resolve(const cModule *contextModule) const;
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
+
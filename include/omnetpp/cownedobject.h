@@ -113,15 +113,6 @@ class SIM_API cOwnedObject : public cNamedObject
     cObject *owner;    // owner pointer
     unsigned int pos;  // used only when owner is a cDefaultList
 
-  private:
-    // list in which objects are accumulated if there is no simple module in context
-    // (see also setDefaultOwner() and cSimulation::setContextModule())
-    static cDefaultList *defaultOwner;
-
-    // global variables for statistics
-    static long totalObjectCount;
-    static long liveObjectCount;
-
   private:
     void copy(const cOwnedObject& obj);
 
@@ -129,9 +120,22 @@ class SIM_API cOwnedObject : public cNamedObject
     // internal
     virtual void removeFromOwnershipTree();
 
+    // internal: inserts an object that has no owner (see removeFromOwnershipTree())
+    // into the default owner of the calling thread
+    void addToDefaultOwner();
+
     // internal
     static void setDefaultOwner(cDefaultList *list);
 
+    // internal: sets the list in which objects created in the global context
+    // (see cSimulation::setGlobalContext()) are accumulated in the calling thread,
+    // and also makes it the default owner. It is the global defaultList unless
+    // set otherwise; threads that run a simulation of their own need their own list.
+    static void setGlobalDefaultOwner(cDefaultList *list);
+
+    // internal
+    static cDefaultList *getGlobalDefaultOwner();
+
   public:
     /** @name Constructors, destructor, assignment. */
     //@{
@@ -219,8 +223,9 @@ class SIM_API cOwnedObject : public cNamedObject
      * Counter is <tt>signed</tt> to make it easier to detect if it overflows
      * during very long simulation runs.
      * May be useful for profiling or debugging memory leaks.
+     * Object counters are maintained per thread.
      */
-    static long getTotalObjectCount() {return totalObjectCount;}
+    static long getTotalObjectCount();
 
     /**
      * Returns the number of objects that currently exist in the program.
@@ -228,13 +233,13 @@ class SIM_API cOwnedObject : public cNamedObject
      * the destructor.
      * May be useful for profiling or debugging memory leaks.
      */
-    static long getLiveObjectCount() {return liveObjectCount;}
+    static long getLiveObjectCount();
 
     /**
      * Reset counters used by getTotalObjectCount() and getLiveObjectCount().
      * (Note that getLiveObjectCount() may go negative after a reset call.)
      */
-    static void resetObjectCounters()  {totalObjectCount=liveObjectCount=0L;}
+    static void resetObjectCounters();
     //@}
 };
 
@@ -57,9 +57,6 @@ class SIM_API cParImpl : public cNamedObject
     // unit (s, mW, GHz, baud, etc); optional
     const char *unitp; // stringpooled
 
-    // global variables for statistics
-    static long totalParimplObjs;
-    static long liveParimplObjs;
     static cStringPool unitStringPool;
 
   private:
@@ -332,7 +329,7 @@ class SIM_API cParImpl : public cNamedObject
      * during very long simulation runs.
      * May be useful for profiling or debugging memory leaks.
      */
-    static long getTotalParImplObjectCount() {return totalParimplObjs;}
+    static long getTotalParImplObjectCount();
 
     /**
      * Returns the number of objects that currently exist in the program.
@@ -340,13 +337,13 @@ class SIM_API cParImpl : public cNamedObject
      * the destructor.
      * May be useful for profiling or debugging memory leaks.
      */
-    static long getLiveParImplObjectCount() {return liveParimplObjs;}
+    static long getLiveParImplObjectCount();
 
     /**
      * Reset counters used by getTotalObjectCount() and getLiveObjectCount().
      * (Note that getLiveObjectCount() may go negative after a reset call.)
      */
-    static void resetParImplObjectCounters()  {totalParimplObjs=liveParimplObjs=0L;}
+    static void resetParImplObjectCounters();
     //@}
 };
 
@@ -97,6 +97,15 @@ class SIM_API cParsimCommunications : public cObject
      */
     virtual void broadcast(cCommBuffer *buffer, int tag);
 
+    /**
+     * Returns true if the given object, packed with cCommBuffer::packObject()
+     * into a buffer that has been sent, was passed over to the destination
+     * partition as it is instead of being serialized. The sender must not
+     * delete or access such objects afterwards. This default implementation
+     * returns false.
+     */
+    virtual bool hasTakenOwnership(cObject *obj) {return false;}
+
     /**
      * Receives packed data with given tag from given destination.
      * Normally returns true; false is returned if blocking was interrupted by the user.
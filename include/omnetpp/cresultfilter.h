@@ -67,7 +67,11 @@ class SIM_API cResultFilter : public cResultListener
         void fire(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details);
         void fire(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details);
         void fire(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details);
+        void fireBatch(cResultFilter *prev, const simtime_t *times, const double *values, int count);
         virtual void callFinish(cResultFilter *prev) override;
+        // filters receive timestamps explicitly, so by default it is the delegates that decide;
+        // filters that use the current simulation time or event number should return false
+        virtual bool acceptsDelayedDelivery() const override;
         virtual void forEachChild(cVisitor *v) override;
     public:
         cResultFilter();
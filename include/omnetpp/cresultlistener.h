@@ -48,6 +48,15 @@ class SIM_API cResultListener : public cObject, public cIListener
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details) = 0;
         virtual void subscribedTo(cResultFilter *prev);
         virtual void unsubscribedFrom(cResultFilter *prev);
+
+        // batched delivery of numeric values (see DeferredDeliveryFilter); the
+        // default implementation delivers them one by one via receiveSignal(double)
+        virtual void receiveBatch(cResultFilter *prev, const simtime_t *times, const double *values, int count);
+        // whether values may be delivered after the end of the event in which they
+        // were emitted; false for listeners that depend on the simulation state
+        // at the time of delivery (e.g. on the current event number)
+        virtual bool acceptsDelayedDelivery() const {return false;}
+
         virtual void callFinish(cResultFilter *prev) {finish(prev);}
         virtual void finish(cResultFilter *prev) {}
 
@@ -97,6 +97,9 @@ class SIM_API cNumericResultRecorder : public cResultRecorder
     protected:
         // all receiveSignal() methods either throw error or delegate here.
         virtual void collect(simtime_t_cref t, double value, cObject *details) = 0;
+        // batched variant of collect(), invoked from receiveBatch(); the default
+        // implementation calls collect() for each value
+        virtual void collectBatch(const simtime_t *times, const double *values, int count);
     protected:
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, bool b, cObject *details) override;
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, long l, cObject *details) override;
@@ -105,6 +108,7 @@ class SIM_API cNumericResultRecorder : public cResultRecorder
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details) override;
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details) override;
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details) override;
+        virtual void receiveBatch(cResultFilter *prev, const simtime_t *times, const double *values, int count) override {collectBatch(times, values, count);}
 };
 
 /**
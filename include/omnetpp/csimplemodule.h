@@ -74,9 +74,6 @@ class SIM_API cSimpleModule : public cModule //implies noncopyable
     cMessage *timeoutMessage;   // msg used in wait() and receive() with timeout
     cCoroutine *coroutine;
 
-    static bool stackCleanupRequested; // 'true' value asks activity() to throw a cStackCleanupException
-    static cSimpleModule *afterCleanupTransferTo; // transfer back to this module (or to main)
-
   private:
     // internal use
     static void activate(void *p);
@@ -38,6 +38,7 @@ class cParsimPartition;
 class cNedFileLoader;
 class cFingerprintCalculator;
 class cModuleType;
+class DeferredDeliveryFilter;
 class cEnvir;
 class cDefaultList;
 
@@ -63,10 +64,12 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
 {
     friend class cSimpleModule;
   private:
-    // global variables
-    static cSimulation *activeSimulation;
-    static cEnvir *activeEnvir;
+#ifdef OPP_INLINE_TLS
+    // the active simulation and its environment, per-thread (see csimulation.cc)
+    static OPP_THREAD_LOCAL cSimulation *activeSimulation;
+    static OPP_THREAD_LOCAL cEnvir *activeEnvir;
     static cEnvir *staticEnvir; // the environment to activate when activeSimulation becomes nullptr
+#endif
 
     // variables of the module vector
     int size;                 // size of componentv[]
@@ -87,6 +90,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     cFutureEventSet *fes;     // stores future events
     cScheduler *scheduler;    // event scheduler
     simtime_t warmupPeriod;   // warm-up period
+    simtime_t simTimeLimit;   // simulation time limit, or SIMTIME_MAX
 
     int simulationStage;      // simulation stage (one of CTX_NONE, CTX_BUILD, CTX_EVENT, CTX_INITIALIZE, CTX_FINISH or CTX_CLEANUP)
     simtime_t currentSimtime; // simulation time (time of current event)
@@ -98,6 +102,8 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
 
     cFingerprintCalculator *fingerprint; // used for fingerprint calculation
 
+    std::vector<DeferredDeliveryFilter *> deferredResultFilters; // result filters to be flushed at the end of the current event
+
   private:
     // internal
     void checkActive()  {if (getActiveSimulation()!=this) throw cRuntimeError(this, E_WRONGSIM);}
@@ -137,20 +143,34 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     /** @name Accessing and switching the active simulation object */
     //@{
     /**
-     * Returns the active simulation object. May be nullptr.
+     * Returns the active simulation object of the calling thread. May be nullptr.
      */
+#ifdef OPP_INLINE_TLS
     static cSimulation *getActiveSimulation()  {return activeSimulation;}
+#else
+    static cSimulation *getActiveSimulation();
+#endif
 
     /**
-     * Returns the environment object for the active simulation. Never returns nullptr;
-     * setActiveSimulation(nullptr) will cause a static "do-nothing" instance to step in.
+     * Returns the environment object for the active simulation of the calling
+     * thread. Never returns nullptr; setActiveSimulation(nullptr) will cause
+     * a static "do-nothing" instance to step in.
      */
-    static cEnvir *getActiveEnvir()  {return activeEnvir;}
+#ifdef OPP_INLINE_TLS
+    static cEnvir *getActiveEnvir()  {cEnvir *env = activeEnvir; return env ? env : staticEnvir;}
+#else
+    static cEnvir *getActiveEnvir();
+#endif
 
     /**
      * Activate the given simulation object, and its associated environment
      * object. nullptr is also accepted; it will cause the static environment
      * object to step in (see getStaticEnvir()).
+     *
+     * The active simulation is a per-thread setting, so several simulations
+     * may run concurrently, each in a thread of its own. Such threads must
+     * also be given a global context object list of their own, see
+     * cOwnedObject::setGlobalDefaultOwner().
      */
     static void setActiveSimulation(cSimulation *sim);
 
@@ -163,7 +183,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     /**
      * Returns the environment object to use when there is no active simulation object.
      */
-    static cEnvir *getStaticEnvir()  {return staticEnvir;}
+    static cEnvir *getStaticEnvir();
 
     /**
      * Returns the environment object associated with this simulation object.
@@ -321,6 +341,12 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     void setSimulationTimeLimit(simtime_t simTimeLimit);
 
+    /**
+     * Returns the simulation time limit set with setSimulationTimeLimit(),
+     * or SIMTIME_MAX if there is none.
+     */
+    simtime_t_cref getSimulationTimeLimit() const  {return simTimeLimit;}
+
     /**
      * Builds a new network.
      */
@@ -444,6 +470,25 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
      */
     void executeEvent(cEvent *event);
 
+    /**
+     * Registers a result filter whose buffered values must be delivered at
+     * the end of the current event. Used internally by DeferredDeliveryFilter.
+     */
+    void addDeferredResultFilter(DeferredDeliveryFilter *filter) {deferredResultFilters.push_back(filter);}
+
+    /**
+     * Removes a result filter registered with addDeferredResultFilter().
+     * Used internally by DeferredDeliveryFilter.
+     */
+    void removeDeferredResultFilter(DeferredDeliveryFilter *filter);
+
+    /**
+     * Delivers the values buffered in the result filters registered with
+     * addDeferredResultFilter(). Called after network initialization, at the
+     * end of each event, and before finish.
+     */
+    void flushDeferredResults();
+
     /**
      * Switches to the given simple module's coroutine. This method is invoked
      * from executeEvent() for activity()-based modules.
@@ -475,7 +520,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     /**
      * Sets global context. Used internally.
      */
-    void setGlobalContext()  {contextComponent=nullptr; cOwnedObject::setDefaultOwner(&defaultList);}
+    void setGlobalContext()  {contextComponent=nullptr; cOwnedObject::setDefaultOwner(cOwnedObject::getGlobalDefaultOwner());}
 
     /**
      * Returns the module whose activity() method is currently active.
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <map>
+#include <mutex>
 #include "simkerneldefs.h"
 #include "simutil.h"
 
@@ -30,6 +31,9 @@ namespace omnetpp {
  * (largely) constant strings that occur in many instances during runtime:
  * module names, gate names, property names, keys and values, etc.
  *
+ * The pool may be accessed concurrently from multiple threads. It only takes
+ * its lock while simulations run in several threads (Cmdenv -j).
+ *
  * @see cNamedObject::cNamedObject, cNamedObject::setNamePooling()
  * @ingroup internals
  */
@@ -46,6 +50,7 @@ class cStringPool
     std::string name;
     typedef std::map<char *,int,strless> StringIntMap;
     StringIntMap pool; // map<string,refcount>
+    mutable std::mutex mutex; // protects pool
     bool alive; // useful when stringpool is a global variable
 
   public:
@@ -114,17 +114,14 @@ class SiblingModuleParameterRef : public cDynamicExpression::Functor
  */
 class LoopVar : public cDynamicExpression::Functor
 {
-  private:
-    // the loopvar stack (vars of nested loops are pushed on the stack by cNedNetworkBuilder)
-    static const char *varNames[32];
-    static long vars[32];
-    static int varCount;
   public:
+    // the loopvar stack (vars of nested loops are pushed on the stack by cNedNetworkBuilder);
+    // the stack is per-thread
     static long& pushVar(const char *varName);
     static void popVar();
     static void reset();
-    static const char **getVarNames() {return varNames;}
-    static int getNumVars() {return varCount;}
+    static const char **getVarNames();
+    static int getNumVars();
 
   protected:
     std::string varName;
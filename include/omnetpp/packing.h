@@ -21,13 +21,16 @@
 namespace omnetpp {
 
 //
-// pack/unpack functions for primitive types
+// pack/unpack functions for primitive types; arrays of them are packed
+// in one call, instead of element by element
 //
 #define DOPACKING(T,R) \
           inline void doParsimPacking(omnetpp::cCommBuffer *b, const T R a) {b->pack(a);}  \
           inline void doParsimPacking(omnetpp::cCommBuffer *b, const T *a, int n) {b->pack(a,n);}  \
           inline void doParsimUnpacking(omnetpp::cCommBuffer *b, T& a) {b->unpack(a);}  \
-          inline void doParsimUnpacking(omnetpp::cCommBuffer *b, T *a, int n) {b->unpack(a,n);}
+          inline void doParsimUnpacking(omnetpp::cCommBuffer *b, T *a, int n) {b->unpack(a,n);}  \
+          inline void doParsimArrayPacking(omnetpp::cCommBuffer *b, const T *a, int n) {b->pack(a,n);}  \
+          inline void doParsimArrayUnpacking(omnetpp::cCommBuffer *b, T *a, int n) {b->unpack(a,n);}
 #define _
 DOPACKING(char,_)
 DOPACKING(unsigned char,_)
@@ -38,6 +41,8 @@ DOPACKING(int,_)
 DOPACKING(unsigned int,_)
 DOPACKING(long,_)
 DOPACKING(unsigned long,_)
+DOPACKING(long long,_)
+DOPACKING(unsigned long long,_)
 DOPACKING(float,_)
 DOPACKING(double,_)
 DOPACKING(long double,_)
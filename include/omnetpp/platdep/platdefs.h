@@ -76,10 +76,25 @@
 #  define _OPP_GNU_ATTRIBUTE(x)
 #endif
 
+// Per-thread state of the simulation kernel that is accessed on hot paths
+// (the active simulation, signal listener counts, etc.) On ELF platforms it is
+// declared with the initial-exec TLS model, which makes access as cheap as a
+// global variable's, and can be accessed from inline functions. Elsewhere
+// (e.g. Windows DLLs cannot export thread-local variables), it is only
+// accessed via out-of-line functions.
+#if defined __GNUC__ && defined __ELF__
+#  define OPP_INLINE_TLS
+#  define OPP_THREAD_LOCAL  __thread __attribute__((tls_model("initial-exec")))
+#else
+#  define OPP_THREAD_LOCAL  thread_local
+#endif
+
 // choose coroutine library if unspecified
-#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES)
+#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES) && !defined(USE_ASM_COROUTINES)
 #  if defined _WIN32
 #    define USE_WIN32_FIBERS
+#  elif defined PREFER_ASM_COROUTINES && defined __GNUC__ && defined __ELF__ && (defined __x86_64__ || defined __aarch64__)
+#    define USE_ASM_COROUTINES
 #  elif HAVE_SWAPCONTEXT
 #    define USE_POSIX_COROUTINES
 #  else
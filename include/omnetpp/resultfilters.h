@@ -282,6 +282,57 @@ class SIM_API SumPerDurationFilter : public cNumericResultFilter
         virtual std::string str() const override;
 };
 
+/**
+ * @brief Filter that buffers numeric signal values, and delivers them to its
+ * delegates in batches via receiveBatch().
+ *
+ * Buffered values are delivered when the buffer fills up, before a value
+ * that cannot be buffered (a string, an object, or any value with a details
+ * object) is passed through, and at finish. If some delegate does not accept
+ * values after the end of the event they were emitted in (see
+ * acceptsDelayedDelivery(); e.g. vector recorders, which also record the
+ * event number), values are also delivered at the end of the current event.
+ * Numeric values of all types are delivered as double.
+ *
+ * This filter is inserted by cStatisticBuilder in front of the result
+ * recorders of statistics for which the <tt>statistic-deferred-delivery</tt>
+ * configuration option is enabled.
+ */
+class SIM_API DeferredDeliveryFilter : public cResultFilter
+{
+    protected:
+        simtime_t *times;
+        double *values;
+        int capacity;
+        int numBuffered = 0;
+        int needsEventEndFlush = -1;  // -1: not yet known; computed on first use, when the delegates are already in place
+        bool registered = false;      // whether we are on the simulation's end-of-event flush list
+    protected:
+        void append(simtime_t_cref t, double value) {
+            if (numBuffered == 0 && !registered)
+                bufferingStarted();
+            times[numBuffered] = t;
+            values[numBuffered] = value;
+            if (++numBuffered == capacity)
+                flush();
+        }
+        void bufferingStarted();
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, bool b, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, long l, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, unsigned long l, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, double d, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details) override;
+        virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details) override;
+        virtual void callFinish(cResultFilter *prev) override;
+    public:
+        explicit DeferredDeliveryFilter(int capacity=256);
+        virtual ~DeferredDeliveryFilter();
+        int getNumBuffered() const {return numBuffered;}
+        virtual void flush();
+        virtual std::string str() const override;
+};
+
 }  // namespace omnetpp
 
 #endif
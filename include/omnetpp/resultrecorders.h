@@ -61,6 +61,8 @@ class SIM_API CountRecorder : public cResultRecorder
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details) override {count++;}
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details) override {if (s) count++;}
         virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details) override {if (obj) count++;}
+        virtual void receiveBatch(cResultFilter *prev, const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         CountRecorder() {count = 0;}
@@ -77,6 +79,8 @@ class SIM_API LastValueRecorder : public cNumericResultRecorder
         double lastValue;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         LastValueRecorder() {lastValue = NAN;}
@@ -94,6 +98,8 @@ class SIM_API SumRecorder : public cNumericResultRecorder
         double sum;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         SumRecorder() {sum = 0;}
@@ -118,6 +124,8 @@ class SIM_API MeanRecorder : public cNumericResultRecorder
     protected:
         virtual void init(cComponent *component, const char *statsName, const char *recordingMode, cProperty *attrsProperty, opp_string_map *manualAttrs) override;
         virtual void finish(cResultFilter *prev) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
     public:
         MeanRecorder() {}
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
@@ -135,6 +143,8 @@ class SIM_API MinRecorder : public cNumericResultRecorder
         double min;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         MinRecorder() {min = INFINITY;}
@@ -152,6 +162,8 @@ class SIM_API MaxRecorder : public cNumericResultRecorder
         double max;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         MaxRecorder() {max = -INFINITY;}
@@ -170,6 +182,8 @@ class SIM_API AverageRecorder : public cNumericResultRecorder
         double sum;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         AverageRecorder() {count = 0; sum = 0;}
@@ -190,6 +204,8 @@ class SIM_API TimeAverageRecorder : public cNumericResultRecorder
         simtime_t totalTime = SIMTIME_ZERO;
     protected:
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void collectBatch(const simtime_t *times, const double *values, int n) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
         virtual void finish(cResultFilter *prev) override;
     public:
         TimeAverageRecorder() {}
@@ -212,6 +228,7 @@ class SIM_API StatisticsRecorder : public cNumericResultRecorder
         virtual void collect(simtime_t_cref t, double value, cObject *details) override;
         virtual void finish(cResultFilter *prev) override;
         virtual void forEachChild(cVisitor *v) override;
+        virtual bool acceptsDelayedDelivery() const override {return true;}
     public:
         StatisticsRecorder();
         ~StatisticsRecorder();
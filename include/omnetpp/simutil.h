@@ -222,9 +222,6 @@ class SIM_API cContextSwitcher
  */
 class SIM_API cMethodCallContextSwitcher : public cContextSwitcher
 {
-  private:
-    static int depth;
-
   public:
     /**
      * Switches context to the given module
@@ -248,7 +245,7 @@ class SIM_API cMethodCallContextSwitcher : public cContextSwitcher
     /**
      * Returns the depth of Enter_Method[_Silent] calls
      */
-    static int getDepth() {return depth;}
+    static int getDepth();
 };
 
 /**
@@ -1,4 +1,5 @@
 import shlex
+import struct
 import pandas as pd
 import numpy as np
 
@@ -40,6 +41,9 @@ class Context:
 
 # TODO: rename to something sensible, like read_results
 def read_omnetpp(filename):
+    if is_binary_vector_file(filename):
+        return read_binary_vector_file(filename)
+
     # Performance notes:
     #  (1) most CPU cycles are burnt in splitting the line to tokens (you can verify this by strategically placing 'continue' statements below)
     #  (2) creating an empty DataFrame (such as at the end of this method, with records=[]) takes surprisingly long time
@@ -203,3 +207,217 @@ def flush_context(ctx, records):
     ctx.binedges = []
     ctx.binvalues = []
 
+
+
+# Binary output vector files, as written by BinaryOutputVectorManager. See
+# src/common/binaryvectorfileformat.h for the description of the format.
+
+BINARY_VECTOR_FILE_MAGIC = b'OPPBVEC\n'
+BINARY_VECTOR_FILE_VERSION = 1
+
+# record types
+REC_RUN = 1
+REC_RUNATTR = 2
+REC_ITERVAR = 3
+REC_PARAM = 4
+REC_VECTOR = 5
+REC_BLOCK = 6
+REC_BLOCKINDEX = 7
+REC_INDEX = 8
+
+# block flags
+FLAG_EVENTNUMBERS = 1
+FLAG_COMPRESSED = 2
+
+def is_binary_vector_file(filename):
+    with open(filename, 'rb') as f:
+        return f.read(len(BINARY_VECTOR_FILE_MAGIC)) == BINARY_VECTOR_FILE_MAGIC
+
+class BinaryReader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def at_end(self):
+        return self.pos == len(self.data)
+
+    def read_bytes(self, n):
+        if n > len(self.data) - self.pos:
+            raise RuntimeError("binary vector file: unexpected end of record")
+        self.pos += n
+        return self.data[self.pos-n:self.pos]
+
+    def read_byte(self):
+        return self.read_bytes(1)[0]
+
+    def read_uint32(self):
+        return struct.unpack('<I', self.read_bytes(4))[0]
+
+    def read_double(self):
+        return struct.unpack('<d', self.read_bytes(8))[0]
+
+    def read_varint(self):
+        x = 0
+        shift = 0
+        while True:
+            b = self.read_byte()
+            x |= (b & 0x7f) << shift
+            shift += 7
+            if not (b & 0x80) or shift >= 64:
+                return x
+
+    def read_signed_varint(self):
+        x = self.read_varint()
+        return (x >> 1) ^ -(x & 1)
+
+    def read_string(self):
+        return self.read_bytes(self.read_varint()).decode('utf-8')
+
+def lz_decompress(src, dest_len):
+    # the reverse of opp_lzcompress() (LZ4 block format)
+    dest = bytearray()
+    ip = 0
+    try:
+        while True:
+            token = src[ip]
+            ip += 1
+            num_literals = token >> 4
+            if num_literals == 15:
+                while True:
+                    b = src[ip]
+                    ip += 1
+                    num_literals += b
+                    if b != 255:
+                        break
+            if num_literals > len(src) - ip:
+                raise IndexError()
+            dest += src[ip:ip+num_literals]
+            ip += num_literals
+            if ip == len(src):
+                break  # last sequence
+
+            offset = src[ip] | (src[ip+1] << 8)
+            ip += 2
+            match_len = token & 15
+            if match_len == 15:
+                while True:
+                    b = src[ip]
+                    ip += 1
+                    match_len += b
+                    if b != 255:
+                        break
+            match_len += 4
+            start = len(dest) - offset
+            if offset == 0 or start < 0 or len(dest) + match_len > dest_len:
+                raise IndexError()
+            if offset >= match_len:
+                dest += dest[start:start+match_len]
+            else:
+                for i in range(match_len):  # overlapping copy
+                    dest.append(dest[start+i])
+    except IndexError:
+        raise RuntimeError("binary vector file: corrupt compressed data")
+    if len(dest) != dest_len:
+        raise RuntimeError("binary vector file: corrupt compressed data")
+    return bytes(dest)
+
+def decode_block(payload):
+    # returns (vector_id, times, values) for a BLOCK record
+    reader = BinaryReader(payload)
+    vector_id = reader.read_varint()
+    flags = reader.read_byte()
+    simtime_exp = reader.read_signed_varint()
+    count = reader.read_varint()
+    reader.read_signed_varint()  # startEventNum
+    reader.read_signed_varint()  # endEventNum
+    start_time = reader.read_signed_varint()
+    reader.read_signed_varint()  # endTime
+    for i in range(4):
+        reader.read_double()  # min, max, sum, sumSqr
+    raw_size = reader.read_varint()
+    stored_size = reader.read_varint()
+    data = reader.read_bytes(stored_size)
+    if flags & FLAG_COMPRESSED:
+        data = lz_decompress(data, raw_size)
+    elif raw_size != stored_size:
+        raise RuntimeError("binary vector file: uncompressed size in block record does not match stored size")
+
+    # every sample takes at least 1 byte per varint column plus 8 bytes for the value
+    min_sample_size = 10 if flags & FLAG_EVENTNUMBERS else 9
+    if count > len(data) // min_sample_size:
+        raise RuntimeError("binary vector file: sample count in block header does not match block length")
+
+    # the event number and time columns are delta-encoded varints
+    columns = BinaryReader(data)
+    if flags & FLAG_EVENTNUMBERS:
+        for i in range(count):
+            columns.read_varint()
+    deltas = [columns.read_signed_varint() for i in range(count)]
+    rawtimes = np.cumsum(np.array(deltas, dtype=np.int64)) + start_time
+    times = rawtimes / 10.0**-simtime_exp if simtime_exp < 0 else rawtimes * 10.0**simtime_exp
+
+    # each value is XOR'ed with the previous one
+    valuebytes = columns.read_bytes(8 * count)
+    if not columns.at_end():
+        raise RuntimeError("binary vector file: garbage at the end of block data")
+    values = np.bitwise_xor.accumulate(np.frombuffer(valuebytes, dtype='<u8')).view('<f8')
+    return vector_id, times, values
+
+def read_binary_vector_file(filename):
+    # The records are scanned sequentially, so the index section at the end
+    # of the file is not needed, and files of crashed simulations can also
+    # be read (an incomplete record at the end is ignored). Vector data are
+    # returned as numpy arrays.
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if len(data) < 12 or data[:8] != BINARY_VECTOR_FILE_MAGIC:
+        raise RuntimeError("not a binary vector file: " + filename)
+    if struct.unpack('<I', data[8:12])[0] > BINARY_VECTOR_FILE_VERSION:
+        raise RuntimeError("unsupported binary vector file version: " + filename)
+
+    run = None
+    records = []
+    vectors = {}  # vector id -> (module, name, attrs, list of time arrays, list of value arrays)
+    pos = 12
+    while pos + 5 <= len(data):
+        type = data[pos]
+        length = struct.unpack('<I', data[pos+1:pos+5])[0]
+        if pos + 5 + length > len(data) or type == REC_INDEX:
+            break  # incomplete record, or the index section
+        reader = BinaryReader(data[pos+5:pos+5+length])
+        pos += 5 + length
+
+        if type == REC_RUN:
+            run = reader.read_string()
+        elif type in (REC_RUNATTR, REC_ITERVAR, REC_PARAM):
+            name = reader.read_string()
+            value = reader.read_string()
+            rectype = {REC_RUNATTR: 'runattr', REC_ITERVAR: 'itervar', REC_PARAM: 'param'}[type]
+            records.append({'run': run, 'type': rectype, 'attrname': name, 'value': value})
+        elif type == REC_VECTOR:
+            vector_id = reader.read_varint()
+            module_name = reader.read_string()
+            vector_name = reader.read_string()
+            reader.read_string()  # columns
+            attrs = {}
+            for i in range(reader.read_varint()):
+                key = reader.read_string()
+                attrs[key] = reader.read_string()
+            vectors[vector_id] = (module_name, vector_name, attrs, [], [])
+        elif type == REC_BLOCK:
+            vector_id, times, values = decode_block(reader.data)
+            if vector_id not in vectors:
+                raise RuntimeError("binary vector file: block of undeclared vector %d" % vector_id)
+            vectors[vector_id][3].append(times)
+            vectors[vector_id][4].append(values)
+        # other records are skipped, for forward compatibility
+
+    for module_name, vector_name, attrs, timeblocks, valueblocks in vectors.values():
+        vectime = np.concatenate(timeblocks) if timeblocks else np.array([])
+        vecvalue = np.concatenate(valueblocks) if valueblocks else np.array([])
+        records.append({'run': run, 'type': 'vector', 'module': module_name, 'name': vector_name, 'vectime': vectime, 'vecvalue': vecvalue})
+        for key, value in attrs.items():
+            records.append({'run': run, 'type': 'attr', 'module': module_name, 'name': vector_name, 'attrname': key, 'value': value})
+
+    dataframe = pd.DataFrame(data=records, columns=['run', 'type', 'module', 'name', 'attrname', 'value', 'vectime', 'vecvalue'])
+    return dataframe
@@ -21,6 +21,9 @@
 #include <cstring>
 #include <csignal>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "common/opp_ctype.h"
 #include "common/commonutil.h"
@@ -30,11 +33,13 @@
 #include "common/stringtokenizer.h"
 #include "envir/appreg.h"
 #include "envir/args.h"
+#include "envir/sectionbasedconfig.h"
 #include "envir/speedometer.h"
 #include "envir/visitor.h"
 #include "omnetpp/csimplemodule.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cmessage.h"
+#include "omnetpp/cmemorypool.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/cproperties.h"
@@ -122,6 +127,7 @@ CmdenvOptions::CmdenvOptions()
     detailedEventBanners = false;
     statusFrequencyMs = 2000;
     printPerformanceData = false;
+    numThreads = 1;
 }
 
 Cmdenv::Cmdenv() : opt((CmdenvOptions *&)EnvirBase::opt)
@@ -130,14 +136,28 @@ Cmdenv::Cmdenv() : opt((CmdenvOptions *&)EnvirBase::opt)
     // the class may be instantiated only for the purpose of calling
     // printUISpecificHelp() on it
 
+    runsTried = numRuns = numErrors = 0;
+    runQueue = nullptr;
+
+    workerIndex = -1;
+
     logging = true;
-    logStream = fopen(".cmdenv-log", "w");
-    if (!logStream)
-        logStream = stdout;
+    logStream = nullptr;  // opened in doRun() or, with -j, separately for each run
 }
 
 Cmdenv::~Cmdenv()
 {
+    if (logStream && logStream != stdout)
+        fclose(logStream);
+}
+
+void Cmdenv::openLogStream(const char *fileName)
+{
+    if (logStream && logStream != stdout)
+        fclose(logStream);
+    logStream = fopen(fileName, "w");
+    if (!logStream)
+        logStream = stdout;
 }
 
 void Cmdenv::readOptions()
@@ -151,6 +171,25 @@ void Cmdenv::readOptions()
     opt->configName = cfg->getAsString(CFGID_CONFIG_NAME);
     opt->runFilter = cfg->getAsString(CFGID_RUNS_TO_EXECUTE);
     opt->extraStack = (size_t)cfg->getAsDouble(CFGID_CMDENV_EXTRA_STACK);
+
+    // '-j' option: number of runs to execute concurrently, or with parallel
+    // simulation, the number of partitions to run on threads of this process
+    // (it has to be known before EnvirBase::setup() creates the parsim components)
+    if (args->optionGiven('j')) {
+        const char *numThreadsStr = args->optionValue('j');
+        char *endp;
+        long numThreads = strtol(numThreadsStr, &endp, 10);
+        if (*endp || numThreads < 1)
+            throw cRuntimeError("Invalid argument for -j: '%s', positive integer expected", numThreadsStr);
+        opt->numThreads = (int)numThreads;
+    }
+    if (hasPartitionThreads()) {
+        if (args->optionGiven('p'))
+            throw cRuntimeError("The -p option cannot be used together with -j, partitions are assigned to the threads automatically");
+#ifdef WITH_PARSIM
+        opt->parsimcommClass = "omnetpp::cThreadCommunications";
+#endif
+    }
 }
 
 void Cmdenv::readPerRunOptions()
@@ -198,123 +237,30 @@ void Cmdenv::doRun()
 
         numRuns = (int)runNumbers.size();
         runsTried = 0;
-        int numErrors = 0;
-        for (int runNumber : runNumbers) {
-            runsTried++;
-            bool finishedOK = false;
-            bool networkSetupDone = false;
-            bool startrunDone = false;
+        numErrors = 0;
+        openLogStream(".cmdenv-log");
+        if (hasPartitionThreads() || (opt->numThreads > 1 && numRuns > 1)) {
             try {
-                if (opt->verbose)
-                    out << "\nPreparing for running configuration " << opt->configName << ", run #" << runNumber << "..." << endl;
-
-                cfg->activateConfig(opt->configName.c_str(), runNumber);
-                readPerRunOptions();
-
-                const char *iterVars = cfg->getVariable(CFGVAR_ITERATIONVARS);
-                const char *runId = cfg->getVariable(CFGVAR_RUNID);
-                const char *repetition = cfg->getVariable(CFGVAR_REPETITION);
-                if (!opt->verbose)
-                    out << opt->configName << " run " << runNumber << ": " << iterVars << ", $repetition=" << repetition << endl; // print before redirection; useful as progress indication from opp_runall
-
-                if (opt->redirectOutput) {
-                    processFileName(opt->outputFile);
-                    if (opt->verbose)
-                        out << "Redirecting output to file \"" << opt->outputFile << "\"..." << endl;
-                    startOutputRedirection(opt->outputFile.c_str());
-                    if (opt->verbose)
-                        out << "\nRunning configuration " << opt->configName << ", run #" << runNumber << "..." << endl;
-                }
-
-                if (opt->verbose) {
-                    if (iterVars && strlen(iterVars) > 0)
-                        out << "Scenario: " << iterVars << ", $repetition=" << repetition << endl;
-                    out << "Assigned runID=" << runId << endl;
-                }
-
-                // find network
-                cModuleType *network = resolveNetwork(opt->networkName.c_str());
-                ASSERT(network);
-
-                // set up network
-                if (opt->verbose)
-                    out << "Setting up network \"" << opt->networkName.c_str() << "\"..." << endl;
-
-                setupNetwork(network);
-                networkSetupDone = true;
-
-                // prepare for simulation run
-                if (opt->verbose)
-                    out << "Initializing..." << endl;
-
-                loggingEnabled = !opt->expressMode;
-                startRun();
-                startrunDone = true;
-
-                // run the simulation
-                if (opt->verbose)
-                    out << "\nRunning simulation..." << endl;
-
-                // simulate() should only throw exception if error occurred and
-                // finish() should not be called.
-                notifyLifecycleListeners(LF_ON_SIMULATION_START);
-                simulate();
-                loggingEnabled = true;
-
-                if (opt->verbose)
-                    out << "\nCalling finish() at end of Run #" << runNumber << "..." << endl;
-                getSimulation()->callFinish();
-                cLogProxy::flushLastLine();
-
-                checkFingerprint();
-
-                notifyLifecycleListeners(LF_ON_SIMULATION_SUCCESS);
-
-                finishedOK = true;
+                runParallel(runNumbers);
             }
             catch (std::exception& e) {
-                loggingEnabled = true;
-                stoppedWithException(e);
-                notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
                 displayException(e);
+                exitCode = 1;
+                return;
             }
+        }
+        else {
+            for (int runNumber : runNumbers) {
+                runsTried++;
+                bool finishedOK = runSimulation(runNumber);
 
-            // call endRun()
-            if (startrunDone) {
-                try {
-                    endRun();
-                }
-                catch (std::exception& e) {
-                    finishedOK = false;
-                    notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
-                    displayException(e);
-                }
-            }
+                // skip further runs if signal was caught
+                if (sigintReceived)
+                    break;
 
-            // delete network
-            if (networkSetupDone) {
-                try {
-                    getSimulation()->deleteNetwork();
-                }
-                catch (std::exception& e) {
-                    numErrors++;
-                    notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
-                    displayException(e);
-                }
+                if (!finishedOK && opt->stopBatchOnError)
+                    break;
             }
-
-            // stop redirecting into file
-            stopOutputRedirection();
-
-            if (!finishedOK)
-                numErrors++;
-
-            // skip further runs if signal was caught
-            if (sigintReceived)
-                break;
-
-            if (!finishedOK && opt->stopBatchOnError)
-                break;
         }
 
         if (numRuns > 1 && opt->verbose) {
@@ -334,6 +280,279 @@ void Cmdenv::doRun()
     }
 }
 
+bool Cmdenv::runSimulation(int runNumber)
+{
+    bool finishedOK = false;
+    bool networkSetupDone = false;
+    bool startrunDone = false;
+    try {
+        if (opt->verbose)
+            out << "\nPreparing for running configuration " << opt->configName << ", run #" << runNumber << "..." << endl;
+
+        cfg->activateConfig(opt->configName.c_str(), runNumber);
+        readPerRunOptions();
+
+        // with -j, runs executing concurrently must not share the log file
+        if (runQueue) {
+            std::string logFileName = opp_stringf(".cmdenv-log-%d", runNumber);
+            if (opt->parsim)
+                logFileName += opp_stringf("-p%d", workerIndex);
+            openLogStream(logFileName.c_str());
+        }
+
+        const char *iterVars = cfg->getVariable(CFGVAR_ITERATIONVARS);
+        const char *runId = cfg->getVariable(CFGVAR_RUNID);
+        const char *repetition = cfg->getVariable(CFGVAR_REPETITION);
+        if (!opt->verbose)
+            out << opt->configName << " run " << runNumber << ": " << iterVars << ", $repetition=" << repetition << endl; // print before redirection; useful as progress indication from opp_runall
+
+        if (opt->redirectOutput) {
+            processFileName(opt->outputFile);
+            if (opt->verbose)
+                out << "Redirecting output to file \"" << opt->outputFile << "\"..." << endl;
+            startOutputRedirection(opt->outputFile.c_str());
+            if (opt->verbose)
+                out << "\nRunning configuration " << opt->configName << ", run #" << runNumber << "..." << endl;
+        }
+
+        if (opt->verbose) {
+            if (iterVars && strlen(iterVars) > 0)
+                out << "Scenario: " << iterVars << ", $repetition=" << repetition << endl;
+            out << "Assigned runID=" << runId << endl;
+        }
+
+        // find network
+        cModuleType *network = resolveNetwork(opt->networkName.c_str());
+        ASSERT(network);
+
+        // set up network
+        if (opt->verbose)
+            out << "Setting up network \"" << opt->networkName.c_str() << "\"..." << endl;
+
+        setupNetwork(network);
+        networkSetupDone = true;
+
+        // prepare for simulation run
+        if (opt->verbose)
+            out << "Initializing..." << endl;
+
+        loggingEnabled = !opt->expressMode;
+        startRun();
+        startrunDone = true;
+
+        // run the simulation
+        if (opt->verbose)
+            out << "\nRunning simulation..." << endl;
+
+        // simulate() should only throw exception if error occurred and
+        // finish() should not be called.
+        notifyLifecycleListeners(LF_ON_SIMULATION_START);
+        simulate();
+        loggingEnabled = true;
+
+        if (opt->verbose)
+            out << "\nCalling finish() at end of Run #" << runNumber << "..." << endl;
+        getSimulation()->callFinish();
+        cLogProxy::flushLastLine();
+
+        checkFingerprint();
+
+        notifyLifecycleListeners(LF_ON_SIMULATION_SUCCESS);
+
+        finishedOK = true;
+    }
+    catch (std::exception& e) {
+        loggingEnabled = true;
+        stoppedWithException(e);
+        notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
+        displayException(e);
+    }
+
+    // call endRun()
+    if (startrunDone) {
+        try {
+            endRun();
+        }
+        catch (std::exception& e) {
+            finishedOK = false;
+            notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
+            displayException(e);
+        }
+    }
+
+    // delete network
+    if (networkSetupDone) {
+        try {
+            getSimulation()->deleteNetwork();
+        }
+        catch (std::exception& e) {
+            numErrors++;
+            notifyLifecycleListeners(LF_ON_SIMULATION_ERROR);
+            displayException(e);
+        }
+    }
+
+    // stop redirecting into file
+    stopOutputRedirection();
+
+    if (!finishedOK)
+        numErrors++;
+    return finishedOK;
+}
+
+/**
+ * Shared state of the worker threads in parallel (-j) mode.
+ */
+class ParallelRunQueue
+{
+  public:
+    const std::vector<int>& runNumbers;
+    std::atomic<int> nextIndex;
+    std::atomic<bool> stopRequested;
+    std::mutex networkSetupMutex;
+
+    ParallelRunQueue(const std::vector<int>& runNumbers) : runNumbers(runNumbers), nextIndex(0), stopRequested(false) {}
+};
+
+void Cmdenv::runParallel(const std::vector<int>& runNumbers)
+{
+#ifdef USE_PORTABLE_COROUTINES
+    throw cRuntimeError("The -j option is not supported with the portable coroutine library (USE_PORTABLE_COROUTINES)");
+#endif
+    if (!dynamic_cast<SectionBasedConfiguration *>(cfg))
+        throw cRuntimeError("The -j option requires the configuration to be a SectionBasedConfiguration");
+
+    // with parallel simulation, every thread is a partition, and takes part in every run
+    int numThreads = opt->parsim ? opt->numThreads : std::min(opt->numThreads, (int)runNumbers.size());
+    if (opt->verbose && opt->parsim)
+        out << "\nExecuting " << runNumbers.size() << " runs as parallel simulations, with " << numThreads << " partitions on separate threads..." << endl;
+    else if (opt->verbose)
+        out << "\nExecuting " << runNumbers.size() << " runs on " << numThreads << " threads..." << endl;
+
+    // Every worker has its own Cmdenv and cSimulation instance, and a list
+    // for the objects created in its global context. They are created and
+    // destroyed here in the main thread, so that their registration in the
+    // ownership tree does not race; the NED type tree and the contents of
+    // the ini files are shared.
+    ParallelRunQueue queue(runNumbers);
+    std::vector<Cmdenv *> workers;
+    std::vector<cSimulation *> simulations;
+    std::vector<cDefaultList *> objectLists;
+    for (int i = 0; i < numThreads; i++) {
+        Cmdenv *worker = createWorker();
+        worker->setupWorker(this, &queue, i);
+        workers.push_back(worker);
+        simulations.push_back(new cSimulation("simulation", worker));
+        objectLists.push_back(new cDefaultList(opp_stringf("worker-%d", i).c_str()));
+    }
+
+    installSignalHandler();
+    sigintReceived = false;
+
+    // from now on, the shared caches (NED types, parameters, string pools, etc.) need locking
+    setMultiThreaded(true);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        cSimulation *simulation = simulations[i];
+        cDefaultList *objectList = objectLists[i];
+        threads.push_back(std::thread([simulation, objectList]() {
+            cOwnedObject::setGlobalDefaultOwner(objectList);
+            cSimulation::setActiveSimulation(simulation);
+            static_cast<Cmdenv *>(simulation->getEnvir())->runWorker();
+            cSimulation::setActiveSimulation(nullptr);
+            cOwnedObject::setGlobalDefaultOwner(&defaultList);
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    setMultiThreaded(false);
+    deinstallSignalHandler();
+
+    for (int i = 0; i < numThreads; i++) {
+        if (opt->parsim) {
+            // the partitions of a run count as one run
+            runsTried = std::max(runsTried, workers[i]->runsTried);
+            numErrors = std::max(numErrors, workers[i]->numErrors);
+        }
+        else {
+            runsTried += workers[i]->runsTried;
+            numErrors += workers[i]->numErrors;
+        }
+        delete simulations[i];  // also deletes the worker
+        delete objectLists[i];
+    }
+}
+
+void Cmdenv::setupWorker(Cmdenv *master, ParallelRunQueue *queue, int index)
+{
+    opt = new CmdenvOptions(*master->opt);
+    if (!master->hasPartitionThreads())
+        args = new ArgList(*master->args);
+    else {
+        // the worker is partition 'index'; the communications layer learns it from the -p option
+        partitionArg = opp_stringf("-p%d,%d", index, opt->numThreads);
+        char **argv = master->args->getArgVector();
+        partitionArgv.assign(argv, argv + master->args->getArgCount());
+        partitionArgv.insert(partitionArgv.begin() + 1, const_cast<char *>(partitionArg.c_str()));
+        args = new ArgList();
+        args->parse((int)partitionArgv.size(), partitionArgv.data(), master->args->getSpec());
+    }
+    cfg = static_cast<SectionBasedConfiguration *>(master->cfg)->createSharingReader();
+    debugOnErrors = master->debugOnErrors;
+    attachDebuggerOnErrors = master->attachDebuggerOnErrors;
+    numRuns = master->numRuns;
+    runsTried = 0;
+    numErrors = 0;
+    runQueue = queue;
+    workerIndex = index;
+}
+
+void Cmdenv::runWorker()
+{
+    try {
+        setupWorkerThread();
+        notifyLifecycleListeners(LF_ON_STARTUP);
+    }
+    catch (std::exception& e) {
+        displayException(e);
+        numErrors++;
+        runQueue->stopRequested = true;  // with parallel simulation, this also releases the other partitions (see idle())
+        return;
+    }
+
+    int localIndex = 0;
+    while (!runQueue->stopRequested) {
+        // with parallel simulation, every partition takes part in every run
+        int index = opt->parsim ? localIndex++ : runQueue->nextIndex++;
+        if (index >= (int)runQueue->runNumbers.size())
+            break;
+        runsTried++;
+        bool finishedOK = runSimulation(runQueue->runNumbers[index]);
+        if (sigintReceived || (!finishedOK && opt->stopBatchOnError)) {
+            if (opt->parsim)
+                break;  // errors are propagated to all partitions, so they all stop here
+            runQueue->stopRequested = true;
+        }
+    }
+
+    shutdown();
+}
+
+void Cmdenv::setupNetwork(cModuleType *network)
+{
+    // with -j, building the network is serialized among the worker threads,
+    // because it populates caches in the shared NED type tree
+    if (runQueue) {
+        std::lock_guard<std::mutex> lock(runQueue->networkSetupMutex);
+        EnvirBase::setupNetwork(network);
+    }
+    else {
+        EnvirBase::setupNetwork(network);
+    }
+}
+
 // note: also updates "since" (sets it to the current time) if answer is "true"
 inline bool elapsed(long millis, int64_t& since)
 {
@@ -352,7 +571,8 @@ void Cmdenv::simulate()  // XXX probably not needed anymore -- take over interes
     installSignalHandler();
 
     startClock();
-    sigintReceived = false;
+    if (!runQueue)
+        sigintReceived = false;
 
     Speedometer speedometer;  // only used by Express mode, but we need it in catch blocks too
 
@@ -473,6 +693,12 @@ void Cmdenv::doStatusUpdate(Speedometer& speedometer)
         out << "     Messages:  created: " << cMessage::getTotalMessageCount()
             << "   present: " << cMessage::getLiveMessageCount()
             << "   in FES: " << getSimulation()->getFES()->getLength() << endl;
+
+        cMemoryPool::Statistics poolStats = cMemoryPool::getStatistics();
+        if (poolStats.numAllocations > 0)
+            out << "     Pool:      allocs: " << poolStats.numAllocations
+                << "   reused: " << (int)(100.0 * poolStats.numReused / poolStats.numAllocations) << "%"
+                << "   cached: " << poolStats.numCachedBlocks << " blocks, " << poolStats.cachedBytes / 1024 << " KiB" << endl;
     }
     else {
         out << "** Event #" << getSimulation()->getEventNumber() << "   t=" << getSimulation()->getSimTime()
@@ -505,7 +731,7 @@ const char *Cmdenv::progressPercentage()
         return "";
     else {
         double totalRatio = (ratio + runsTried - 1) / numRuns;
-        static char buf[32];
+        static thread_local char buf[32];
         // DO NOT change the "% completed" string. The IDE launcher plugin matches
         // against this string for detecting user input
         snprintf(buf, 32, "  %d%% completed  (%d%% total)", (int)(100*ratio), (int)(100*totalRatio));
@@ -543,12 +769,16 @@ void Cmdenv::signalHandler(int signum)
 
 void Cmdenv::installSignalHandler()
 {
+    if (runQueue)
+        return;  // worker thread in parallel mode: done by the main instance
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
 }
 
 void Cmdenv::deinstallSignalHandler()
 {
+    if (runQueue)
+        return;  // worker thread in parallel mode: done by the main instance
     signal(SIGINT, SIG_DFL);
     signal(SIGTERM, SIG_DFL);
 }
@@ -651,7 +881,8 @@ bool Cmdenv::askYesNo(const char *question)
 
 bool Cmdenv::idle()
 {
-    return sigintReceived;
+    // with -j and parallel simulation, a partition that failed to start stops the others as well
+    return sigintReceived || (runQueue && opt->parsim && runQueue->stopRequested);
 }
 
 void Cmdenv::getImageSize(const char *imageName, double& outWidth, double& outHeight)
@@ -695,6 +926,14 @@ void Cmdenv::printUISpecificHelp()
     out << "    Cmdenv executes all runs denoted by the -c and -r options. The number\n";
     out << "    of runs executed and the number of runs that ended with an error are\n";
     out << "    reported at the end.\n";
+    out << "  -j <numthreads>\n";
+    out << "                Execute up to <numthreads> runs concurrently, each on a separate\n";
+    out << "                thread of this process. Loaded NED types and ini file contents\n";
+    out << "                are shared among the threads. Use of cmdenv-redirect-output=true\n";
+    out << "                is recommended, otherwise the output of concurrent runs is mixed.\n";
+    out << "                With parallel-simulation=true, the simulation is run with\n";
+    out << "                <numthreads> partitions, each on a separate thread, using\n";
+    out << "                cThreadCommunications; -p must not be specified then.\n";
     out << endl;
 }
 
@@ -45,8 +45,11 @@ struct CMDENV_API CmdenvOptions : public EnvirOptions
     bool detailedEventBanners; // if normal mode
     long statusFrequencyMs; // if express mode
     bool printPerformanceData; // if express mode
+    int numThreads; // number of runs to execute concurrently (-j option)
 };
 
+class ParallelRunQueue;
+
 /**
  * Command line user interface.
  */
@@ -61,12 +64,22 @@ class CMDENV_API Cmdenv : public EnvirBase
      // the number of runs already started (>1 if multiple runs are running in the same process)
      int runsTried;
      int numRuns;
+     int numErrors;
+
+     // with -j: the run queue shared by the worker instances (nullptr in sequential mode)
+     ParallelRunQueue *runQueue;
+     int workerIndex;
+
+     // with -j and parallel simulation: the command line of the worker, extended with its -p option
+     std::string partitionArg;
+     std::vector<char *> partitionArgv;
 
      // logging
      bool logging;
      FILE *logStream;
 
    protected:
+     void openLogStream(const char *fileName);
      virtual void log(cLogEntry *entry) override;
      virtual void alert(const char *msg) override;
      virtual bool askYesNo(const char *question) override;
@@ -104,14 +117,24 @@ class CMDENV_API Cmdenv : public EnvirBase
 
      virtual EnvirOptions *createOptions() override {return new CmdenvOptions();}
      virtual void readOptions() override;
+     virtual bool hasPartitionThreads() const override {return opt->parsim && opt->numThreads > 1;}
      virtual void readPerRunOptions() override;
      virtual void configure(cComponent *component) override;
      virtual void askParameter(cPar *par, bool unassigned) override;
 
+     virtual void setupNetwork(cModuleType *network) override;
+
      void help();
+     bool runSimulation(int runNumber);
      void simulate();
      const char *progressPercentage();
 
+     // parallel runs (-j option)
+     virtual Cmdenv *createWorker() {return new Cmdenv();}
+     void runParallel(const std::vector<int>& runNumbers);
+     void setupWorker(Cmdenv *master, ParallelRunQueue *queue, int index);
+     void runWorker();
+
      void installSignalHandler();
      void deinstallSignalHandler();
      static void signalHandler(int signum);
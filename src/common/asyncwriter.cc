@@ -0,0 +1,136 @@
+//=========================================================================
+//  ASYNCWRITER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "exception.h"
+#include "asyncwriter.h"
+
+namespace omnetpp {
+namespace common {
+
+AsyncWriter::AsyncWriter(size_t memoryLimit) : memoryLimit(memoryLimit)
+{
+    pendingSize = 0;
+    numSubmitted = 0;
+    numCompleted = 0;
+    stopping = false;
+    failed = false;
+    errorReported = false;
+    writerSleeping = false;
+    ownerSleeping = false;
+    thread = std::thread([this]() { run(); });
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    stopping = true;
+    wakeWriter();
+    thread.join();
+}
+
+void AsyncWriter::wakeWriter()
+{
+    // the sleeping flag is set while holding the mutex, so if we see it,
+    // locking the mutex here ensures that the writer is already waiting
+    if (writerSleeping) {
+        std::lock_guard<std::mutex> lock(mutex);
+        writerWakeup.notify_one();
+    }
+}
+
+void AsyncWriter::wakeOwner()
+{
+    if (ownerSleeping) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ownerWakeup.notify_one();
+    }
+}
+
+template<typename Predicate>
+void AsyncWriter::waitUntil(Predicate pred)
+{
+    if (pred())
+        return;
+    std::unique_lock<std::mutex> lock(mutex);
+    ownerSleeping = true;
+    while (!pred())
+        ownerWakeup.wait(lock);
+    ownerSleeping = false;
+}
+
+void AsyncWriter::run()
+{
+    int64_t numProcessed = 0;
+    while (true) {
+        Item item;
+        if (queue.pop(item)) {
+            try {
+                (*item.job)();
+            }
+            catch (std::exception& e) {
+                if (!failed) {
+                    errorMessage = e.what();
+                    failed = true;
+                }
+            }
+            delete item.job;
+            pendingSize -= item.size;
+            numCompleted = ++numProcessed;
+            wakeOwner();
+        }
+        else {
+            std::unique_lock<std::mutex> lock(mutex);
+            writerSleeping = true;
+            while (numSubmitted == numProcessed && !stopping)
+                writerWakeup.wait(lock);
+            writerSleeping = false;
+            if (numSubmitted == numProcessed && stopping)
+                break;
+        }
+    }
+}
+
+void AsyncWriter::submit(Job&& job, size_t size)
+{
+    checkError();
+
+    // back-pressure: wait until there is room for the job (a job larger
+    // than the limit is accepted when the queue is empty)
+    if (pendingSize + size > memoryLimit)
+        waitUntil([this, size]() { return pendingSize == 0 || pendingSize + size <= memoryLimit; });
+
+    pendingSize += size;
+    queue.push(Item { new Job(std::move(job)), size });
+    numSubmitted++;  // after push(), so the writer finds the item when it sees the new count
+    wakeWriter();
+}
+
+void AsyncWriter::waitUntilIdle()
+{
+    int64_t target = numSubmitted;
+    waitUntil([this, target]() { return numCompleted == target; });
+}
+
+bool AsyncWriter::checkError()
+{
+    if (!failed)
+        return false;
+    if (!errorReported) {
+        errorReported = true;
+        throw opp_runtime_error("%s", errorMessage.c_str());
+    }
+    return true;
+}
+
+}  // namespace common
+}  // namespace omnetpp
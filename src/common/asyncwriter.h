@@ -0,0 +1,126 @@
+//=========================================================================
+//  ASYNCWRITER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_ASYNCWRITER_H
+#define __OMNETPP_COMMON_ASYNCWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "commondefs.h"
+#include "spscqueue.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Executes jobs (typically result file writing operations) on a background
+ * thread, in the order they were submitted. Jobs may only be submitted from
+ * a single thread, the owner of the object.
+ *
+ * Jobs are passed to the writer thread via a lock-free queue. Every job is
+ * submitted with the amount of memory it holds; when the total of the pending
+ * jobs would exceed the memory limit, submit() blocks until the writer thread
+ * catches up (back-pressure).
+ *
+ * If a job throws an exception, the error is reported to the owner thread
+ * by the next submit(), drain() or checkError() call. Subsequent jobs are
+ * still executed (so that they can release the resources they hold), but
+ * their errors are ignored.
+ */
+class COMMON_API AsyncWriter
+{
+  public:
+    typedef std::function<void()> Job;
+
+  private:
+    struct Item {
+        Job *job;
+        size_t size;
+    };
+
+    SpscQueue<Item> queue;
+    size_t memoryLimit;
+
+    std::atomic<size_t> pendingSize;   // total size of the submitted but not yet completed jobs
+    std::atomic<int64_t> numSubmitted;
+    std::atomic<int64_t> numCompleted;
+    std::atomic<bool> stopping;
+
+    std::atomic<bool> failed;
+    std::string errorMessage;          // written by the writer thread before setting 'failed'
+    bool errorReported;                // owner thread only
+
+    std::mutex mutex;                  // only used for sleeping/waking up the threads
+    std::condition_variable writerWakeup;
+    std::condition_variable ownerWakeup;
+    std::atomic<bool> writerSleeping;
+    std::atomic<bool> ownerSleeping;
+
+    std::thread thread;
+
+  private:
+    void run();
+    void wakeWriter();
+    void wakeOwner();
+    template<typename Predicate> void waitUntil(Predicate pred);
+
+  public:
+    /**
+     * Starts the writer thread. The memory limit is in bytes.
+     */
+    explicit AsyncWriter(size_t memoryLimit);
+
+    /**
+     * Executes the pending jobs, then stops the writer thread.
+     */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    size_t getMemoryLimit() const {return memoryLimit;}
+
+    /**
+     * Queues the job for execution. 'size' is the amount of memory held by
+     * the job (approximate), which counts against the memory limit until the
+     * job completes. Blocks while the limit would be exceeded.
+     */
+    void submit(Job&& job, size_t size);
+
+    /**
+     * Blocks until all submitted jobs have been executed. Does not throw.
+     */
+    void waitUntilIdle();
+
+    /**
+     * Blocks until all submitted jobs have been executed, then reports
+     * the error of the writer thread, if any.
+     */
+    void drain() {waitUntilIdle(); checkError();}
+
+    /**
+     * Throws the error that occurred in the writer thread, unless it has
+     * already been reported. Returns true if a job has failed.
+     */
+    bool checkError();
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
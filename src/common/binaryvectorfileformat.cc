@@ -0,0 +1,121 @@
+//==========================================================================
+//  BINARYVECTORFILEFORMAT.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "binaryvectorfileformat.h"
+
+namespace omnetpp {
+namespace common {
+
+const char BinaryVectorFileFormat::FILE_MAGIC[8] = {'O', 'P', 'P', 'B', 'V', 'E', 'C', '\n'};
+const char BinaryVectorFileFormat::TRAILER_MAGIC[8] = {'O', 'P', 'P', 'B', 'V', 'I', 'D', 'X'};
+
+void BinaryVectorFileFormat::Writer::writeBlockHeader(const BlockHeader& header)
+{
+    writeVarint(header.vectorId);
+    writeByte(header.flags);
+    writeSignedVarint(header.simtimeExp);
+    writeVarint(header.count);
+    writeSignedVarint(header.startEventNum);
+    writeSignedVarint(header.endEventNum);
+    writeSignedVarint(header.startTime);
+    writeSignedVarint(header.endTime);
+    writeDouble(header.min);
+    writeDouble(header.max);
+    writeDouble(header.sum);
+    writeDouble(header.sumSqr);
+}
+
+void BinaryVectorFileFormat::Reader::readBlockHeader(BlockHeader& header)
+{
+    header.vectorId = (int)readVarint();
+    header.flags = readByte();
+    header.simtimeExp = (int)readSignedVarint();
+    header.count = (int64_t)readVarint();
+    header.startEventNum = readSignedVarint();
+    header.endEventNum = readSignedVarint();
+    header.startTime = readSignedVarint();
+    header.endTime = readSignedVarint();
+    header.min = readDouble();
+    header.max = readDouble();
+    header.sum = readDouble();
+    header.sumSqr = readDouble();
+}
+
+void BinaryVectorFileFormat::encodeColumns(const BlockHeader& header, const int64_t *eventNumbers, const int64_t *times, const double *values, std::string& dest)
+{
+    Writer writer(dest);
+    int64_t count = header.count;
+
+    if (header.flags & FLAG_EVENTNUMBERS) {
+        int64_t prev = header.startEventNum;
+        for (int64_t i = 0; i < count; i++) {
+            writer.writeSignedVarint(eventNumbers[i] - prev);
+            prev = eventNumbers[i];
+        }
+    }
+
+    int64_t prevTime = header.startTime;
+    for (int64_t i = 0; i < count; i++) {
+        writer.writeSignedVarint(times[i] - prevTime);
+        prevTime = times[i];
+    }
+
+    uint64_t prevBits = 0;
+    for (int64_t i = 0; i < count; i++) {
+        uint64_t bits;
+        memcpy(&bits, &values[i], 8);
+        writer.writeUInt64(bits ^ prevBits);
+        prevBits = bits;
+    }
+}
+
+void BinaryVectorFileFormat::decodeColumns(const BlockHeader& header, const char *data, size_t len, std::vector<int64_t>& eventNumbers, std::vector<int64_t>& times, std::vector<double>& values)
+{
+    Reader reader(data, len);
+    size_t count = header.count;
+
+    // every sample takes at least 1 byte per varint column plus 8 bytes for the value;
+    // check before allocating memory for the columns based on a possibly corrupt count
+    size_t minSampleSize = (header.flags & FLAG_EVENTNUMBERS) ? 10 : 9;
+    if (header.count < 0 || count > len / minSampleSize)
+        throw opp_runtime_error("Binary vector file: Sample count in block header does not match block length");
+
+    eventNumbers.clear();
+    if (header.flags & FLAG_EVENTNUMBERS) {
+        eventNumbers.resize(count);
+        int64_t prev = header.startEventNum;
+        for (size_t i = 0; i < count; i++)
+            eventNumbers[i] = prev = prev + reader.readSignedVarint();
+    }
+
+    times.resize(count);
+    int64_t prevTime = header.startTime;
+    for (size_t i = 0; i < count; i++)
+        times[i] = prevTime = prevTime + reader.readSignedVarint();
+
+    values.resize(count);
+    uint64_t prevBits = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits = reader.readUInt64() ^ prevBits;
+        memcpy(&values[i], &bits, 8);
+        prevBits = bits;
+    }
+
+    if (!reader.atEnd())
+        throw opp_runtime_error("Binary vector file: Garbage at the end of block data");
+}
+
+} // namespace common
+}  // namespace omnetpp
+
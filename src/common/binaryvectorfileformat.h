@@ -0,0 +1,148 @@
+//==========================================================================
+//  BINARYVECTORFILEFORMAT.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYVECTORFILEFORMAT_H
+#define __OMNETPP_COMMON_BINARYVECTORFILEFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "commondefs.h"
+#include "exception.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Definitions shared by the writer and the reader of binary output vector
+ * files.
+ *
+ * The file starts with an 8-byte magic and a 4-byte version number, followed
+ * by records. Every record consists of a 1-byte record type, a 4-byte payload
+ * length and the payload. All numbers are little endian; integers in the
+ * payload are mostly varints (signed ones zigzag-encoded), doubles are
+ * stored as 8-byte IEEE values, and strings as a varint length plus the
+ * characters.
+ *
+ * Output vector data are stored in BLOCK records. A block holds consecutive
+ * samples of one vector in columnar form: the event number column (only if
+ * the vector records event numbers) and the simulation time column are
+ * delta-encoded varints, and the value column holds each value XOR'ed with
+ * the previous one, so that slowly changing values produce zero bytes.
+ * The column data may be compressed with opp_lzcompress(). The block header
+ * also contains the statistics of the block, like the index (.vci) file does
+ * for text-based vector files.
+ *
+ * When the file is closed properly, an index section is appended to it.
+ * It starts with an INDEX record, repeats the run and vector declaration
+ * records, contains a BLOCKINDEX record (a block header plus the file offset
+ * of the block) for every block, and is terminated by a trailer: the 8-byte
+ * offset of the index section and an 8-byte magic. If the trailer is missing
+ * (e.g. because the simulation crashed), readers can still recover the same
+ * information by scanning the records of the file.
+ */
+class COMMON_API BinaryVectorFileFormat
+{
+  public:
+    static const char FILE_MAGIC[8];
+    static const char TRAILER_MAGIC[8];
+    enum { FILE_VERSION = 1 };
+    enum { FILE_HEADER_SIZE = 12, RECORD_HEADER_SIZE = 5, TRAILER_SIZE = 16 };
+    enum { MAX_BLOCK_HEADER_SIZE = 128 };  // upper bound for the encoded size of BlockHeader
+
+    enum RecordType {
+        REC_RUN = 1,      // runName
+        REC_RUNATTR,      // name, value
+        REC_ITERVAR,      // name, value
+        REC_PARAM,        // key, value
+        REC_VECTOR,       // id, moduleName, name, columns, numAttrs, (name, value)*
+        REC_BLOCK,        // header, rawSize, storedSize, data
+        REC_BLOCKINDEX,   // offset of the BLOCK record, size of the BLOCK record, header
+        REC_INDEX         // empty; marks the start of the index section
+    };
+
+    enum { FLAG_EVENTNUMBERS = 1, FLAG_COMPRESSED = 2 };
+
+    struct BlockHeader {
+        int vectorId;
+        int flags;
+        int simtimeExp;
+        int64_t count;
+        int64_t startEventNum, endEventNum;
+        int64_t startTime, endTime;  // raw simtime values
+        double min, max, sum, sumSqr;
+    };
+
+    /**
+     * Serializes data into a byte buffer.
+     */
+    class Writer {
+      private:
+        std::string& buf;
+      public:
+        explicit Writer(std::string& buf) : buf(buf) {}
+        void writeByte(uint8_t b) {buf.push_back((char)b);}
+        void writeUInt32(uint32_t x) {for (int i = 0; i < 4; i++) writeByte((uint8_t)(x >> (8*i)));}
+        void writeUInt64(uint64_t x) {for (int i = 0; i < 8; i++) writeByte((uint8_t)(x >> (8*i)));}
+        void writeVarint(uint64_t x) {while (x >= 0x80) {writeByte((uint8_t)(x | 0x80)); x >>= 7;} writeByte((uint8_t)x);}
+        void writeSignedVarint(int64_t x) {writeVarint(((uint64_t)x << 1) ^ (uint64_t)(x >> 63));}
+        void writeDouble(double d) {uint64_t x; memcpy(&x, &d, 8); writeUInt64(x);}
+        void writeString(const std::string& s) {writeVarint(s.size()); buf.append(s);}
+        void writeBytes(const char *data, size_t len) {buf.append(data, len);}
+        void writeBlockHeader(const BlockHeader& header);
+    };
+
+    /**
+     * Deserializes data from a byte buffer. Throws an error on reading past
+     * the end of the buffer.
+     */
+    class Reader {
+      private:
+        const uint8_t *p;
+        const uint8_t *end;
+        void underflow() const {throw opp_runtime_error("Binary vector file: Unexpected end of record");}
+      public:
+        Reader(const char *data, size_t len) : p((const uint8_t *)data), end((const uint8_t *)data + len) {}
+        bool atEnd() const {return p == end;}
+        const char *getPointer() const {return (const char *)p;}
+        uint8_t readByte() {if (p == end) underflow(); return *p++;}
+        uint32_t readUInt32() {uint32_t x = 0; for (int i = 0; i < 4; i++) x |= (uint32_t)readByte() << (8*i); return x;}
+        uint64_t readUInt64() {uint64_t x = 0; for (int i = 0; i < 8; i++) x |= (uint64_t)readByte() << (8*i); return x;}
+        uint64_t readVarint() {uint64_t x = 0; uint8_t b; int shift = 0; do {b = readByte(); x |= (uint64_t)(b & 0x7f) << shift; shift += 7;} while ((b & 0x80) && shift < 64); return x;}
+        int64_t readSignedVarint() {uint64_t x = readVarint(); return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);}
+        double readDouble() {uint64_t x = readUInt64(); double d; memcpy(&d, &x, 8); return d;}
+        std::string readString() {uint64_t len = readVarint(); if (len > (uint64_t)(end - p)) underflow(); std::string s((const char *)p, len); p += len; return s;}
+        const char *readBytes(size_t len) {if (len > (size_t)(end - p)) underflow(); const char *data = (const char *)p; p += len; return data;}
+        void readBlockHeader(BlockHeader& header);
+    };
+
+    /**
+     * Encodes the columns of a block into the given buffer. The eventNumbers
+     * array is only used if header.flags contains FLAG_EVENTNUMBERS.
+     */
+    static void encodeColumns(const BlockHeader& header, const int64_t *eventNumbers, const int64_t *times, const double *values, std::string& dest);
+
+    /**
+     * Decodes the columns of a block; the reverse of encodeColumns(). The
+     * eventNumbers vector is left empty if the block contains no event numbers.
+     */
+    static void decodeColumns(const BlockHeader& header, const char *data, size_t len, std::vector<int64_t>& eventNumbers, std::vector<int64_t>& times, std::vector<double>& values);
+};
+
+} // namespace common
+}  // namespace omnetpp
+
+
+#endif
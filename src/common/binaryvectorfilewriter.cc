@@ -0,0 +1,323 @@
+//==========================================================================
+//  BINARYVECTORFILEWRITER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include "commonutil.h"
+#include "lzcompress.h"
+#include "binaryvectorfilewriter.h"
+
+
+namespace omnetpp {
+namespace common {
+
+typedef BinaryVectorFileFormat Format;
+
+BinaryVectorFileWriter::BinaryVectorFileWriter()
+{
+    f = nullptr;
+    fileOffset = 0;
+    compress = true;
+    nextVectorId = 0;
+    bufferedSamplesLimit = 0;
+    bufferedSamples = 0;
+}
+
+BinaryVectorFileWriter::~BinaryVectorFileWriter()
+{
+    cleanup(); // not close() because it throws; also, close() must have been called already if there was no error
+    for (VectorData *vp : vectors)
+        delete vp;
+}
+
+void BinaryVectorFileWriter::check(size_t fwriteResult, size_t expected)
+{
+    if (fwriteResult != expected) {
+        cleanup();
+        throw opp_runtime_error("Cannot write output vector file '%s'", fname.c_str());
+    }
+}
+
+void BinaryVectorFileWriter::open(const char *filename)
+{
+    fname = filename;
+    f = fopen(fname.c_str(), "wb");  // we only support overwrite but not append
+    if (f == nullptr)
+        throw opp_runtime_error("Cannot open output vector file '%s'", fname.c_str());
+    fileOffset = 0;
+    declarations.clear();
+    blockIndex.clear();
+
+    std::string header(Format::FILE_MAGIC, sizeof(Format::FILE_MAGIC));
+    Format::Writer(header).writeUInt32(Format::FILE_VERSION);
+    check(fwrite(header.data(), 1, header.size(), f), header.size());
+    fileOffset += header.size();
+}
+
+void BinaryVectorFileWriter::close()
+{
+    if (f) {
+        writeIndex();
+        fclose(f);
+        f = nullptr;
+    }
+}
+
+void BinaryVectorFileWriter::cleanup()  // MUST NOT THROW
+{
+    if (f) {
+        fclose(f);
+        f = nullptr;
+    }
+}
+
+void BinaryVectorFileWriter::writeRecord(int type, const std::string& payload, bool isDeclaration)
+{
+    std::string header;
+    Format::Writer writer(header);
+    writer.writeByte(type);
+    writer.writeUInt32(payload.size());
+    check(fwrite(header.data(), 1, header.size(), f), header.size());
+    check(fwrite(payload.data(), 1, payload.size(), f), payload.size());
+    fileOffset += header.size() + payload.size();
+
+    if (isDeclaration) {
+        declarations += header;
+        declarations += payload;
+    }
+}
+
+void BinaryVectorFileWriter::writeIndex()
+{
+    // the index repeats the declarations, so that readers don't need to scan the whole file
+    int64_t indexOffset = fileOffset;
+    writeRecord(Format::REC_INDEX, std::string(), false);
+    check(fwrite(declarations.data(), 1, declarations.size(), f), declarations.size());
+    check(fwrite(blockIndex.data(), 1, blockIndex.size(), f), blockIndex.size());
+
+    std::string trailer;
+    Format::Writer(trailer).writeUInt64(indexOffset);
+    trailer.append(Format::TRAILER_MAGIC, sizeof(Format::TRAILER_MAGIC));
+    check(fwrite(trailer.data(), 1, trailer.size(), f), trailer.size());
+    fileOffset += declarations.size() + blockIndex.size() + trailer.size();
+}
+
+void BinaryVectorFileWriter::beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments)
+{
+    Assert(vectors.size() == 0);
+    bufferedSamples = 0;
+    Assert(isOpen());
+
+    std::string payload;
+    Format::Writer writer(payload);
+
+    // save run
+    writer.writeString(runName);
+    writeRecord(Format::REC_RUN, payload, true);
+
+    // save run attributes
+    for (auto& pair : attributes) {
+        payload.clear();
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+        writeRecord(Format::REC_RUNATTR, payload, true);
+    }
+
+    // save itervars
+    for (auto& pair : itervars) {
+        payload.clear();
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+        writeRecord(Format::REC_ITERVAR, payload, true);
+    }
+
+    // save run params
+    for (auto& pair : paramAssignments) {
+        payload.clear();
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+        writeRecord(Format::REC_PARAM, payload, true);
+    }
+}
+
+void BinaryVectorFileWriter::finalizeVector(VectorData *vp)
+{
+    Assert(isOpen());
+    if (!vp->values.empty())
+        writeBlock(vp);
+}
+
+void BinaryVectorFileWriter::endRecordingForRun()
+{
+    Assert(isOpen());
+    for (VectorData *vp : vectors) {
+        finalizeVector(vp);
+        delete vp;
+    }
+    vectors.clear();
+
+    bufferedSamples = 0;
+    nextVectorId = 0;
+}
+
+void *BinaryVectorFileWriter::registerVector(const std::string& componentFullPath, const std::string& name, const StringMap& attributes, size_t bufferSize, bool recordEventNumbers)
+{
+    VectorData *vp = new VectorData();
+    vp->id = nextVectorId++;
+    vp->recordEventNumbers = recordEventNumbers;
+    vp->simtimeExp = 0;
+    vp->bufferedSamplesLimit = bufferSize / getSampleSize();
+    if (vp->bufferedSamplesLimit > 0) {
+        if (recordEventNumbers)
+            vp->eventNumbers.reserve(vp->bufferedSamplesLimit);
+        vp->times.reserve(vp->bufferedSamplesLimit);
+        vp->values.reserve(vp->bufferedSamplesLimit);
+    }
+    vectors.push_back(vp);
+
+    std::string payload;
+    Format::Writer writer(payload);
+    writer.writeVarint(vp->id);
+    writer.writeString(componentFullPath);
+    writer.writeString(name);
+    writer.writeString(recordEventNumbers ? "ETV" : "TV");
+    writer.writeVarint(attributes.size());
+    for (auto& pair : attributes) {
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+    }
+    writeRecord(Format::REC_VECTOR, payload, true);
+
+    return vp;
+}
+
+void BinaryVectorFileWriter::deregisterVector(void *vectorhandle)
+{
+    Assert(f != nullptr && vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
+    vectors.erase(newEnd, vectors.end());
+    finalizeVector(vp);
+    delete vp;
+}
+
+void BinaryVectorFileWriter::recordInVector(void *vectorhandle, eventnumber_t eventNumber, rawsimtime_t t, int simtimeScaleExp, double value)
+{
+    Assert(f != nullptr && vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+
+    // a block may only contain samples of the same scale exponent
+    if (!vp->values.empty() && simtimeScaleExp != vp->simtimeExp)
+        writeBlock(vp);
+
+    // store value
+    if (vp->recordEventNumbers)
+        vp->eventNumbers.push_back(eventNumber);
+    vp->times.push_back(t);
+    vp->values.push_back(value);
+    vp->simtimeExp = simtimeScaleExp;
+    vp->statistics.collect(value);
+    this->bufferedSamples++;
+
+    // write out block if necessary
+    if (vp->bufferedSamplesLimit > 0 && (long)vp->values.size() >= vp->bufferedSamplesLimit)
+        writeBlock(vp);
+    else if (bufferedSamplesLimit > 0 && bufferedSamples >= bufferedSamplesLimit)
+        writeRecords();
+}
+
+void BinaryVectorFileWriter::writeRecords()
+{
+    for (auto vp : vectors)
+        if (!vp->values.empty())
+            writeBlock(vp);
+}
+
+void BinaryVectorFileWriter::writeBlock(VectorData *vp)
+{
+    Assert(f != nullptr);
+    Assert(vp != nullptr);
+    Assert(!vp->values.empty());
+
+    size_t count = vp->values.size();
+    Statistics& stats = vp->statistics;
+
+    BlockHeader header;
+    header.vectorId = vp->id;
+    header.flags = vp->recordEventNumbers ? Format::FLAG_EVENTNUMBERS : 0;
+    header.simtimeExp = vp->simtimeExp;
+    header.count = count;
+    header.startEventNum = vp->recordEventNumbers ? vp->eventNumbers.front() : -1;
+    header.endEventNum = vp->recordEventNumbers ? vp->eventNumbers.back() : -1;
+    header.startTime = vp->times.front();
+    header.endTime = vp->times.back();
+    header.min = stats.getMin();
+    header.max = stats.getMax();
+    header.sum = stats.getSum();
+    header.sumSqr = stats.getSumSqr();
+
+    // encode columns, and compress them if that pays off
+    columnBuffer.clear();
+    Format::encodeColumns(header, vp->eventNumbers.data(), vp->times.data(), vp->values.data(), columnBuffer);
+    size_t rawSize = columnBuffer.size();
+    recordBuffer.clear();
+    if (compress) {
+        opp_lzcompress(columnBuffer.data(), rawSize, recordBuffer);
+        if (recordBuffer.size() < rawSize)
+            header.flags |= Format::FLAG_COMPRESSED;
+        else
+            recordBuffer.clear();
+    }
+    const std::string& data = (header.flags & Format::FLAG_COMPRESSED) ? recordBuffer : columnBuffer;
+
+    std::string payload;
+    payload.reserve(Format::MAX_BLOCK_HEADER_SIZE + 20 + data.size());
+    Format::Writer writer(payload);
+    writer.writeBlockHeader(header);
+    writer.writeVarint(rawSize);
+    writer.writeVarint(data.size());
+    writer.writeBytes(data.data(), data.size());
+
+    int64_t offset = fileOffset;
+    writeRecord(Format::REC_BLOCK, payload, false);
+
+    // add entry to the block index
+    std::string indexPayload;
+    Format::Writer indexWriter(indexPayload);
+    indexWriter.writeUInt64(offset);
+    indexWriter.writeUInt64(fileOffset - offset);
+    indexWriter.writeBlockHeader(header);
+    Format::Writer blockIndexWriter(blockIndex);
+    blockIndexWriter.writeByte(Format::REC_BLOCKINDEX);
+    blockIndexWriter.writeUInt32(indexPayload.size());
+    blockIndexWriter.writeBytes(indexPayload.data(), indexPayload.size());
+
+    bufferedSamples -= count;
+    vp->eventNumbers.clear();
+    vp->times.clear();
+    vp->values.clear();
+    stats.clear();
+}
+
+void BinaryVectorFileWriter::flush()
+{
+    Assert(isOpen());
+    writeRecords();
+    fflush(f);
+}
+
+
+}  // namespace common
+}  // namespace omnetpp
+
@@ -0,0 +1,109 @@
+//==========================================================================
+//  BINARYVECTORFILEWRITER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYVECTORFILEWRITER_H
+#define __OMNETPP_COMMON_BINARYVECTORFILEWRITER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "commondefs.h"
+#include "statistics.h"
+#include "binaryvectorfileformat.h"
+
+namespace omnetpp {
+namespace common {
+
+
+/**
+ * Class for writing binary, columnar output vector files. See
+ * BinaryVectorFileFormat for the description of the file format.
+ * The interface is the same as that of OmnetppVectorFileWriter.
+ */
+class COMMON_API BinaryVectorFileWriter
+{
+  public:
+    typedef std::map<std::string, std::string> StringMap;
+    typedef std::vector<std::pair<std::string, std::string>> OrderedKeyValueList;
+    typedef int64_t eventnumber_t;
+    typedef int64_t rawsimtime_t;
+    typedef BinaryVectorFileFormat::BlockHeader BlockHeader;
+
+  protected:
+    struct VectorData {
+       int id;                    // vector ID
+       std::vector<eventnumber_t> eventNumbers; // buffered samples, one column per field
+       std::vector<rawsimtime_t> times;
+       std::vector<double> values;
+       long bufferedSamplesLimit; // maximum number of samples gathered in the buffer before writing out (0=no limit)
+       bool recordEventNumbers;   // record the current event number for each sample
+       int simtimeExp;            // simtime scale exponent of the buffered samples
+       Statistics statistics;     // statistics of the buffered samples
+    };
+
+    typedef std::vector<VectorData*> Vectors;
+
+    std::string fname;   // output file name
+    FILE *f;             // file ptr of output file
+    int64_t fileOffset;  // current write position in the output file
+    bool compress;       // whether to compress block data
+    int nextVectorId;    // holds next free ID for output vectors
+
+    std::string declarations; // run and vector declaration records, to be repeated in the index
+    std::string blockIndex;   // BLOCKINDEX records, to be written into the index
+
+    Vectors vectors;           // registered output vectors
+    int bufferedSamples;       // currently total buffered samples
+    int bufferedSamplesLimit;  // limit of total buffered samples (0=no limit)
+
+    std::string recordBuffer;  // work buffers, kept to spare allocations
+    std::string columnBuffer;
+
+  protected:
+    void cleanup();  // MUST NOT THROW
+    void check(size_t fwriteResult, size_t expected);
+    void writeRecord(int type, const std::string& payload, bool isDeclaration);
+    void writeIndex();
+    virtual void writeRecords();
+    virtual void writeBlock(VectorData *vp);
+    virtual void finalizeVector(VectorData *vp);
+
+  public:
+    BinaryVectorFileWriter();
+    virtual ~BinaryVectorFileWriter();
+
+    void open(const char *filename); // overwrite if file exists (append not supported)
+    void close();
+    bool isOpen() const {return f != nullptr;} // IMPORTANT: file will be closed when an error occurs
+
+    void setCompression(bool enabled) {compress = enabled;}
+    bool getCompression() const {return compress;}
+    void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / getSampleSize();}
+    size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * getSampleSize();}
+    static size_t getSampleSize() {return sizeof(eventnumber_t) + sizeof(rawsimtime_t) + sizeof(double);}
+
+    void beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
+    void endRecordingForRun();
+    void *registerVector(const std::string& componentFullPath, const std::string& name, const StringMap& attributes, size_t bufferSize, bool recordEventNumbers);
+    void deregisterVector(void *vechandle);
+    void recordInVector(void *vectorhandle, eventnumber_t eventNumber, rawsimtime_t t, int simtimeScaleExp, double value);
+
+    void flush();
+};
+
+
+} // namespace common
+}  // namespace omnetpp
+
+#endif
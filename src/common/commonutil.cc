@@ -60,6 +60,15 @@ const char *opp_gethostname()
 
 //----
 
+bool multiThreaded = false;
+
+void setMultiThreaded(bool enabled)
+{
+    multiThreaded = enabled;
+}
+
+//----
+
 int CallTracer::depth;
 
 CallTracer::CallTracer(const char *fmt, ...)
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <mutex>
 #include "commondefs.h"
 #include "exception.h"
 
@@ -115,15 +116,45 @@ template <class T> struct ToString<T*>
 
 #define RETURN(x) { __x.setResult(x); return x; }
 
+/**
+ * Set when simulations may run concurrently in several threads of the process
+ * (Cmdenv -j). Process-wide caches and pools only take their locks when it is
+ * set, so single-threaded runs do not pay for locking. Use setMultiThreaded()
+ * to change it, and only while no other simulation thread is running.
+ */
+COMMON_API extern bool multiThreaded;
+
+COMMON_API void setMultiThreaded(bool enabled);
+inline bool isMultiThreaded() {return multiThreaded;}
+
+/**
+ * Scoped lock like std::lock_guard, except that it only locks the mutex
+ * if isMultiThreaded() is true.
+ */
+template <class Mutex>
+class OptionalLockGuard
+{
+  private:
+    Mutex *mutex;
+  public:
+    explicit OptionalLockGuard(Mutex& m) : mutex(multiThreaded ? &m : nullptr) {if (mutex) mutex->lock();}
+    ~OptionalLockGuard() {if (mutex) mutex->unlock();}
+    OptionalLockGuard(const OptionalLockGuard&) = delete;
+    OptionalLockGuard& operator=(const OptionalLockGuard&) = delete;
+};
+
 /**
  * Not all our bison/flex based parsers are reentrant. This macro is meant
- * to catch and report concurrent invocations, e.g. from background threads
- * in the GUI code.
+ * to catch and report recursive invocations, and to serialize concurrent
+ * invocations from multiple threads (e.g. background threads in the GUI
+ * code, or simulations running concurrently in the same process).
  */
 #define NONREENTRANT_PARSER() \
-    static bool active = false; \
+    static std::mutex parserMutex; \
+    static thread_local bool active = false; \
     struct Guard { \
-      Guard() {if (active) throw opp_runtime_error("non-reentrant parser invoked again while parsing"); active=true;} \
+      std::unique_lock<std::mutex> lock; \
+      Guard() {if (active) throw opp_runtime_error("non-reentrant parser invoked again while parsing"); lock = std::unique_lock<std::mutex>(parserMutex); active=true;} \
       ~Guard() {active=false;} \
     } __guard;
 
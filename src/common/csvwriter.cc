@@ -17,6 +17,7 @@
 #include <cmath>
 #include "commonutil.h"
 #include "bigdecimal.h"
+#include "numberformat.h"
 #include "opp_ctype.h"
 #include "csvwriter.h"
 
@@ -142,8 +143,11 @@ void CsvWriter::writeSep()
 
 void CsvWriter::doWriteDouble(double value)
 {
-    if (std::isfinite(value))
-        out() << std::setprecision(prec) << value;
+    if (std::isfinite(value)) {
+        char buf[OPP_NUMBUF_SIZE];
+        opp_formatdouble_prec(buf, value, prec);
+        out() << buf;
+    }
     else if (isPositiveInfinity(value))
         out() << "Inf";
     else if (isNegativeInfinity(value))
@@ -16,6 +16,7 @@
 
 #include "commonutil.h"
 #include "bigdecimal.h"
+#include "numberformat.h"
 #include "stringutil.h"
 #include "jsonwriter.h"
 
@@ -69,8 +70,11 @@ void JsonWriter::doWriteInt(int64_t value)
 
 void JsonWriter::doWriteDouble(double value)
 {
-    if (std::isfinite(value))
-        out() << std::setprecision(prec) << value;
+    if (std::isfinite(value)) {
+        char buf[OPP_NUMBUF_SIZE];
+        opp_formatdouble_prec(buf, value, prec);
+        out() << buf;
+    }
     else if (isPositiveInfinity(value))
         out() << infStr;
     else if (isNegativeInfinity(value))
@@ -0,0 +1,169 @@
+//==========================================================================
+//  LZCOMPRESS.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <cstdint>
+#include "exception.h"
+#include "lzcompress.h"
+
+namespace omnetpp {
+namespace common {
+
+#define MINMATCH      4
+#define LASTLITERALS  5    // the last 5 bytes are always literals (LZ4 rule)
+#define MFLIMIT       12   // no match may start in the last 12 bytes (LZ4 rule)
+#define MAXOFFSET     65535
+#define HASHLOG       12
+#define SKIPSTRENGTH  6    // speeds up the scanning of incompressible data
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+static inline uint32_t hash32(uint32_t x)
+{
+    return (x * 2654435761U) >> (32 - HASHLOG);
+}
+
+static inline void writeLength(std::string& dest, size_t len)
+{
+    while (len >= 255) {
+        dest.push_back((char)255);
+        len -= 255;
+    }
+    dest.push_back((char)len);
+}
+
+static void writeSequence(std::string& dest, const uint8_t *literals, size_t numLiterals, size_t offset, size_t matchLen)
+{
+    // matchLen==0 denotes the last sequence, which only contains literals
+    size_t matchCode = matchLen ? matchLen - MINMATCH : 0;
+    uint8_t token = (uint8_t)(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    dest.push_back((char)token);
+    if (numLiterals >= 15)
+        writeLength(dest, numLiterals - 15);
+    dest.append((const char *)literals, numLiterals);
+    if (matchLen) {
+        dest.push_back((char)(offset & 0xff));
+        dest.push_back((char)(offset >> 8));
+        if (matchCode >= 15)
+            writeLength(dest, matchCode - 15);
+    }
+}
+
+size_t opp_lzcompress(const char *src, size_t srcLen, std::string& dest)
+{
+    size_t origDestSize = dest.size();
+    const uint8_t *in = (const uint8_t *)src;
+
+    int64_t table[1 << HASHLOG];  // last position for each hash value
+    for (int64_t& entry : table)
+        entry = -1;
+
+    size_t anchor = 0;  // start of pending literals
+    size_t pos = 0;
+    if (srcLen >= MFLIMIT + 1) {
+        size_t matchLimit = srcLen - LASTLITERALS;
+        while (pos + MFLIMIT <= srcLen) {
+            uint32_t sequence = read32(in + pos);
+            uint32_t h = hash32(sequence);
+            int64_t candidate = table[h];
+            table[h] = pos;
+            if (candidate < 0 || (int64_t)pos - candidate > MAXOFFSET || read32(in + candidate) != sequence) {
+                pos += 1 + ((pos - anchor) >> SKIPSTRENGTH);
+                continue;
+            }
+
+            // extend match forward
+            size_t matchLen = MINMATCH;
+            while (pos + matchLen < matchLimit && in[candidate + matchLen] == in[pos + matchLen])
+                matchLen++;
+
+            writeSequence(dest, in + anchor, pos - anchor, pos - candidate, matchLen);
+            pos += matchLen;
+            anchor = pos;
+            if (pos >= 2 && pos + MINMATCH <= srcLen)
+                table[hash32(read32(in + pos - 2))] = pos - 2;
+        }
+    }
+    writeSequence(dest, in + anchor, srcLen - anchor, 0, 0);
+    return dest.size() - origDestSize;
+}
+
+void opp_lzdecompress(const char *src, size_t srcLen, char *dest, size_t destLen)
+{
+    const uint8_t *ip = (const uint8_t *)src;
+    const uint8_t *ipEnd = ip + srcLen;
+    uint8_t *op = (uint8_t *)dest;
+    uint8_t *opEnd = op + destLen;
+
+#define CHECK(cond)  if (!(cond)) throw opp_runtime_error("opp_lzdecompress(): Corrupt compressed data")
+
+    while (true) {
+        CHECK(ip < ipEnd);
+        uint8_t token = *ip++;
+
+        // literals
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15) {
+            uint8_t b;
+            do {
+                CHECK(ip < ipEnd);
+                b = *ip++;
+                numLiterals += b;
+            } while (b == 255);
+        }
+        CHECK((size_t)(ipEnd - ip) >= numLiterals && (size_t)(opEnd - op) >= numLiterals);
+        memcpy(op, ip, numLiterals);
+        ip += numLiterals;
+        op += numLiterals;
+        if (ip == ipEnd)
+            break;  // last sequence
+
+        // match
+        CHECK(ipEnd - ip >= 2);
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        size_t matchLen = token & 15;
+        if (matchLen == 15) {
+            uint8_t b;
+            do {
+                CHECK(ip < ipEnd);
+                b = *ip++;
+                matchLen += b;
+            } while (b == 255);
+        }
+        matchLen += MINMATCH;
+        CHECK(offset != 0 && offset <= (size_t)(op - (uint8_t *)dest) && (size_t)(opEnd - op) >= matchLen);
+        const uint8_t *match = op - offset;
+        if (offset >= matchLen) {
+            memcpy(op, match, matchLen);
+            op += matchLen;
+        }
+        else {
+            for (size_t i = 0; i < matchLen; i++)  // overlapping copy
+                *op++ = *match++;
+        }
+    }
+    CHECK(op == opEnd);
+
+#undef CHECK
+}
+
+} // namespace common
+}  // namespace omnetpp
+
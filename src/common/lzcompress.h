@@ -0,0 +1,45 @@
+//==========================================================================
+//  LZCOMPRESS.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_LZCOMPRESS_H
+#define __OMNETPP_COMMON_LZCOMPRESS_H
+
+#include <string>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Compresses a memory block with a simple, fast LZ77-type algorithm, and
+ * appends the result to the given string. The encoding follows the LZ4
+ * block format (sequences of a token byte, literals, a 2-byte offset and
+ * an optional match length extension), but the compressor favors speed over
+ * compression ratio. The size of the original data is not stored, the caller
+ * needs to remember it. Returns the number of bytes appended.
+ */
+COMMON_API size_t opp_lzcompress(const char *src, size_t srcLen, std::string& dest);
+
+/**
+ * Decompresses data produced by opp_lzcompress() into the given buffer,
+ * which must be exactly as large as the original data. Throws an error if
+ * the input is corrupt.
+ */
+COMMON_API void opp_lzdecompress(const char *src, size_t srcLen, char *dest, size_t destLen);
+
+} // namespace common
+}  // namespace omnetpp
+
+
+#endif
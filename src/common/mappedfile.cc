@@ -0,0 +1,121 @@
+//=========================================================================
+//  MAPPEDFILE.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <cerrno>
+#include <cstring>
+#include "exception.h"
+#include "mappedfile.h"
+
+namespace omnetpp {
+namespace common {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char *fileName) : fileName(fileName)
+{
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw opp_runtime_error("Cannot open file '%s'", fileName);
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        unmap();
+        throw opp_runtime_error("Cannot determine size of file '%s'", fileName);
+    }
+    size = fileSize.QuadPart;
+    if (size == 0)
+        return;  // empty files cannot be mapped
+    if ((uint64_t)size > (SIZE_MAX >> 1)) {
+        unmap();
+        throw opp_runtime_error("File '%s' is too large to be mapped into memory", fileName);
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle != nullptr)
+        data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        unmap();
+        throw opp_runtime_error("Cannot map file '%s' into memory", fileName);
+    }
+}
+
+void MappedFile::unmap()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    data = nullptr;
+    mappingHandle = fileHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const char *fileName) : fileName(fileName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd == -1)
+        throw opp_runtime_error("Cannot open file '%s': %s", fileName, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        throw opp_runtime_error("Cannot determine size of file '%s': %s", fileName, strerror(err));
+    }
+    size = st.st_size;
+
+    if (size > 0) {
+        if ((uint64_t)size > (SIZE_MAX >> 1)) {
+            close(fd);
+            throw opp_runtime_error("File '%s' is too large to be mapped into memory", fileName);
+        }
+        void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            throw opp_runtime_error("Cannot map file '%s' into memory: %s", fileName, strerror(err));
+        }
+        data = (const char *)p;
+    }
+    close(fd);  // the mapping remains valid
+}
+
+void MappedFile::unmap()
+{
+    if (data)
+        munmap((void *)data, size);
+    data = nullptr;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+}  // namespace common
+}  // namespace omnetpp
@@ -0,0 +1,62 @@
+//=========================================================================
+//  MAPPEDFILE.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_MAPPEDFILE_H
+#define __OMNETPP_COMMON_MAPPEDFILE_H
+
+#include <string>
+#include <cstdint>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Maps a file into memory for reading. The contents are accessible via
+ * getData() until the object is destroyed; the data is not NUL-terminated.
+ * The file must not be modified while it is mapped.
+ *
+ * Throws opp_runtime_error if the file cannot be opened or mapped (e.g.
+ * a large file on a 32-bit platform).
+ */
+class COMMON_API MappedFile
+{
+  private:
+    std::string fileName;
+    const char *data = nullptr;
+    int64_t size = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+  private:
+    void unmap();
+
+  public:
+    MappedFile(const char *fileName);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char *getFileName() const {return fileName.c_str();}
+    const char *getData() const {return data;}
+    int64_t getSize() const {return size;}
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+
+#endif
@@ -0,0 +1,439 @@
+//==========================================================================
+//  NUMBERFORMAT.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "exception.h"
+#include "numberformat.h"
+
+namespace omnetpp {
+namespace common {
+
+#define MAX_PRECISION  50
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t POW10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// Writes the decimal digits of x backwards, ending at 'end'; returns the start
+static inline char *writeDigitsBackwards(char *end, uint64_t x)
+{
+    char *p = end;
+    while (x >= 100) {
+        unsigned i = (unsigned)(x % 100) * 2;
+        x /= 100;
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + i, 2);
+    }
+    if (x >= 10) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + x * 2, 2);
+    }
+    else {
+        *--p = (char)('0' + x);
+    }
+    return p;
+}
+
+char *opp_formatint64(char *buf, int64_t d)
+{
+    char *s = buf;
+    uint64_t x = d;
+    if (d < 0) {
+        *s++ = '-';
+        x = 0 - x;
+    }
+    char tmp[24];
+    char *end = tmp + sizeof(tmp);
+    char *p = writeDigitsBackwards(end, x);
+    memcpy(s, p, end - p);
+    s += end - p;
+    *s = '\0';
+    return s;
+}
+
+char *opp_formatsimtime(char *buf, int64_t t, int scaleexp)
+{
+    if (scaleexp < -18 || scaleexp > 18)
+        throw opp_runtime_error("opp_formatsimtime(): scaleexp=%d out of accepted range [-18,18]", scaleexp);
+
+    char *s = buf;
+    if (t == 0) {
+        *s++ = '0';
+        *s = '\0';
+        return s;
+    }
+
+    uint64_t x = t;
+    if (t < 0) {
+        *s++ = '-';
+        x = 0 - x;  // also works for INT64_MIN
+    }
+    char tmp[24];
+    char *end = tmp + sizeof(tmp);
+    char *p = writeDigitsBackwards(end, x);
+    int n = end - p;
+
+    if (scaleexp >= 0) {
+        memcpy(s, p, n);
+        s += n;
+        for (int i = 0; i < scaleexp; i++)
+            *s++ = '0';
+    }
+    else {
+        // omit trailing zeros of the fractional part
+        int numFractionalDigits = -scaleexp;
+        int len = n;
+        while (n - len < numFractionalDigits && p[len-1] == '0')
+            len--;
+        if (n > numFractionalDigits) {
+            int numIntegerDigits = n - numFractionalDigits;
+            memcpy(s, p, numIntegerDigits);
+            s += numIntegerDigits;
+            if (len > numIntegerDigits) {
+                *s++ = '.';
+                memcpy(s, p + numIntegerDigits, len - numIntegerDigits);
+                s += len - numIntegerDigits;
+            }
+        }
+        else {
+            *s++ = '0';
+            *s++ = '.';
+            for (int i = n; i < numFractionalDigits; i++)
+                *s++ = '0';
+            memcpy(s, p, len);
+            s += len;
+        }
+    }
+    *s = '\0';
+    return s;
+}
+
+// Prints 'digits' (a number of exactly 'numDigits' digits) with the decimal
+// exponent 'exp' of its first digit, following the rules of printf's %g for
+// the given precision
+static char *formatG(char *s, uint64_t digits, int numDigits, int exp, int prec)
+{
+    char tmp[24];
+    char *p = writeDigitsBackwards(tmp + sizeof(tmp), digits);
+
+    int nd = numDigits;  // number of significant digits without trailing zeros
+    while (nd > 1 && p[nd-1] == '0')
+        nd--;
+
+    if (exp < prec && exp >= -4) {
+        // fixed notation
+        if (exp >= 0) {
+            int numIntegerDigits = exp + 1;
+            if (nd <= numIntegerDigits) {
+                memcpy(s, p, nd);
+                s += nd;
+                for (int i = nd; i < numIntegerDigits; i++)
+                    *s++ = '0';
+            }
+            else {
+                memcpy(s, p, numIntegerDigits);
+                s += numIntegerDigits;
+                *s++ = '.';
+                memcpy(s, p + numIntegerDigits, nd - numIntegerDigits);
+                s += nd - numIntegerDigits;
+            }
+        }
+        else {
+            *s++ = '0';
+            *s++ = '.';
+            for (int i = -1; i > exp; i--)
+                *s++ = '0';
+            memcpy(s, p, nd);
+            s += nd;
+        }
+    }
+    else {
+        // exponential notation, with at least two exponent digits
+        *s++ = p[0];
+        if (nd > 1) {
+            *s++ = '.';
+            memcpy(s, p + 1, nd - 1);
+            s += nd - 1;
+        }
+        *s++ = 'e';
+        if (exp < 0) {
+            *s++ = '-';
+            exp = -exp;
+        }
+        else {
+            *s++ = '+';
+        }
+        if (exp >= 100) {
+            *s++ = (char)('0' + exp / 100);
+            exp %= 100;
+        }
+        memcpy(s, DIGIT_PAIRS + exp * 2, 2);
+        s += 2;
+    }
+    *s = '\0';
+    return s;
+}
+
+#ifdef __SIZEOF_INT128__
+
+typedef unsigned __int128 uint128;
+
+namespace {
+
+struct Pow5Table {
+    enum { SIZE = 56 };  // 5^55 < 2^128
+    uint128 v[SIZE];
+    Pow5Table() {
+        v[0] = 1;
+        for (int i = 1; i < SIZE; i++)
+            v[i] = v[i-1] * 5;
+    }
+};
+
+}  // namespace
+
+static const Pow5Table POW5;  // filled at startup
+
+static inline int bitLength(uint64_t x)
+{
+    return x == 0 ? 0 : 64 - __builtin_clzll(x);
+}
+
+static inline int bitLength(uint128 x)
+{
+    uint64_t hi = (uint64_t)(x >> 64);
+    return hi != 0 ? 64 + bitLength(hi) : bitLength((uint64_t)x);
+}
+
+static inline bool decompose(double d, uint64_t& mantissa, int& exp)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    int biasedExp = (int)((bits >> 52) & 0x7ff);
+    mantissa = bits & ((1ULL << 52) - 1);
+    if (biasedExp == 0)
+        exp = -1074;  // subnormal
+    else {
+        mantissa |= 1ULL << 52;
+        exp = biasedExp - 1075;
+    }
+    return mantissa != 0;
+}
+
+/*
+ * Computes the first n significant decimal digits of v = m*2^e, correctly
+ * rounded (ties to even), as an n-digit integer, and the decimal exponent
+ * of the first digit. Works with exact 128-bit integer arithmetic: with
+ * s = n-1-k, v*10^s = (m * 5^s * 2^(e+s)) is computed as a fraction num/den
+ * whose quotient is the digits and whose remainder decides the rounding.
+ * Returns false if the numbers do not fit into 128 bits.
+ *
+ * If checkRoundtrip is true, it also determines whether the result reads
+ * back as v, i.e. whether it lies within half a unit in the last place of v.
+ */
+static bool computeDigits(uint64_t m, int e, int n, bool checkRoundtrip, uint64_t& digits, int& k, bool& roundtrips)
+{
+    int log2v = bitLength(m) - 1 + e;
+    k = (int)std::floor(log2v * 0.30102999566398120);  // may be off by one, corrected below
+
+    for (int iter = 0; iter < 4; iter++) {
+        int s = n - 1 - k;
+        int shift = e + s;
+        uint128 num = m, den = 1;
+        if (s >= 0) {
+            if (s >= Pow5Table::SIZE || bitLength(m) + bitLength(POW5.v[s]) > 128)
+                return false;
+            num *= POW5.v[s];
+        }
+        else {
+            if (-s >= Pow5Table::SIZE)
+                return false;
+            den = POW5.v[-s];
+        }
+        if (shift >= 0) {
+            if (bitLength(num) + shift > 128)
+                return false;
+            num <<= shift;
+        }
+        else {
+            if (bitLength(den) - shift > 128)
+                return false;
+            den <<= -shift;
+        }
+
+        uint128 q, r;
+        if ((den & (den - 1)) == 0) {
+            q = num >> (bitLength(den) - 1);
+            r = num & (den - 1);
+        }
+        else {
+            q = num / den;
+            r = num % den;
+        }
+
+        // fix up the decimal exponent estimate
+        if (q >= POW10[n]) {
+            k++;
+            continue;
+        }
+        if (q < POW10[n-1]) {
+            k--;
+            continue;
+        }
+
+        bool roundUp = r > den - r || (r == den - r && (q & 1) != 0);
+        digits = (uint64_t)q + (roundUp ? 1 : 0);
+
+        if (checkRoundtrip) {
+            // distance of the result from v is diff/den (in units of the last
+            // digit), half-ulp is v/2m = num/(den*2m); the lower half-ulp is
+            // half that if v is a power of two (the predecessor is closer)
+            uint128 diff = roundUp ? den - r : r;
+            bool closerPredecessor = m == (1ULL << 52) && e > -1074;
+            uint64_t mult = (!roundUp && closerPredecessor) ? 4*m : 2*m;
+            uint128 t = num / mult;
+            if ((m & 1) == 0)
+                roundtrips = diff <= t;  // ties are read back as the even mantissa
+            else
+                roundtrips = diff < t || (diff == t && num % mult != 0);
+        }
+
+        if (digits == POW10[n]) {
+            digits = POW10[n-1];
+            k++;
+        }
+        return true;
+    }
+    return false;
+}
+
+#endif
+
+char *opp_formatdouble(char *buf, double d, int prec)
+{
+#ifdef __SIZEOF_INT128__
+    if (std::isfinite(d) && prec >= 0 && prec <= 17) {
+        if (prec == 0)
+            prec = 1;
+        char *s = buf;
+        if (std::signbit(d))
+            *s++ = '-';  // decompose() ignores the sign bit
+        uint64_t m;
+        int e;
+        if (!decompose(d, m, e)) {
+            *s++ = '0';
+            *s = '\0';
+            return s;
+        }
+        uint64_t digits;
+        int k;
+        bool dummy;
+        if (computeDigits(m, e, prec, false, digits, k, dummy))
+            return formatG(s, digits, prec, k, prec);
+    }
+#endif
+    if (prec > MAX_PRECISION)
+        prec = MAX_PRECISION;  // so that the result fits into the buffer
+    int len = snprintf(buf, OPP_NUMBUF_SIZE, "%.*g", prec, d);
+    return buf + len;
+}
+
+char *opp_formatdouble_shortest(char *buf, double d)
+{
+#ifdef __SIZEOF_INT128__
+    if (std::isfinite(d)) {
+        char *s = buf;
+        if (std::signbit(d))
+            *s++ = '-';  // decompose() ignores the sign bit
+        uint64_t m;
+        int e;
+        if (!decompose(d, m, e)) {
+            *s++ = '0';
+            *s = '\0';
+            return s;
+        }
+
+        // binary search for the smallest precision that round-trips (if n
+        // digits round-trip, then n+1 digits do as well); 17 always does
+        int lo = 1, hi = 17;
+        uint64_t digits, bestDigits = 0;
+        int k, bestK = 0;
+        bool roundtrips, found = false, ok = true;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (!computeDigits(m, e, mid, true, digits, k, roundtrips)) {
+                ok = false;
+                break;
+            }
+            if (roundtrips) {
+                hi = mid;
+                bestDigits = digits;
+                bestK = k;
+                found = true;
+            }
+            else {
+                lo = mid + 1;
+            }
+        }
+        if (ok && !found)
+            ok = computeDigits(m, e, hi, false, bestDigits, bestK, roundtrips);
+        if (ok)
+            return formatG(s, bestDigits, hi, bestK, 17);
+    }
+#endif
+    int prec = 1;
+    char tmp[OPP_NUMBUF_SIZE];
+    while (prec < 17 && std::isfinite(d)) {
+        snprintf(tmp, sizeof(tmp), "%.*e", prec - 1, d);
+        if (strtod(tmp, nullptr) == d)
+            break;
+        prec++;
+    }
+    if (prec == 17 || !std::isfinite(d))
+        return buf + snprintf(buf, OPP_NUMBUF_SIZE, "%.17g", d);
+
+    // reformat the digits in tmp[] (d.ddde+XX) the way %.17g would
+    const char *e = strchr(tmp, 'e');
+    int exp = atoi(e + 1);
+    char *s = buf;
+    const char *p = tmp;
+    if (*p == '-')
+        *s++ = *p++;
+    uint64_t digits = 0;
+    for ( ; p < e; p++)
+        if (*p != '.')
+            digits = 10 * digits + (*p - '0');
+    return formatG(s, digits, prec, exp, 17);
+}
+
+}  // namespace common
+}  // namespace omnetpp
@@ -0,0 +1,77 @@
+//==========================================================================
+//  NUMBERFORMAT.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_NUMBERFORMAT_H
+#define __OMNETPP_COMMON_NUMBERFORMAT_H
+
+#include <cstdint>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Fast number formatting routines for writing result files. Unlike the
+ * similar functions in stringutil.h, these functions print at the beginning
+ * of the buffer, and return a pointer to the terminating '\\0', so that
+ * several numbers can be appended to each other.
+ *
+ * The buffers must be at least OPP_NUMBUF_SIZE bytes long.
+ */
+#define OPP_NUMBUF_SIZE  64
+
+/**
+ * Prints d into the buffer exactly as printf("%.*g", prec, d) would (with
+ * the C locale and round-to-nearest mode, and assuming a C library that
+ * rounds correctly, like glibc). Numbers are converted with exact integer
+ * arithmetic; cases not covered by it (e.g. precisions above 17, very large
+ * or very small exponents, platforms without 128-bit integers) are passed
+ * to snprintf(). Precisions above 50 are treated as 50.
+ */
+COMMON_API char *opp_formatdouble(char *buf, double d, int prec);
+
+/**
+ * Prints d into the buffer using the fewest significant digits that
+ * convert back to the same double. The digits are those printed by
+ * printf("%.*g", n, d) with the smallest such precision n, and the choice
+ * between fixed and exponential notation is the same as with "%.17g",
+ * so e.g. 407540 is not printed as 4.0754e+05.
+ */
+COMMON_API char *opp_formatdouble_shortest(char *buf, double d);
+
+/**
+ * Convenience function for result file writers: a precision of -1 selects
+ * opp_formatdouble_shortest(), otherwise opp_formatdouble() is used.
+ */
+inline char *opp_formatdouble_prec(char *buf, double d, int prec) {
+    return prec == -1 ? opp_formatdouble_shortest(buf, d) : opp_formatdouble(buf, d, prec);
+}
+
+/**
+ * Prints the 64-bit fixed point number t*10^scaleexp into the buffer.
+ * The output is identical to that of opp_ttoa(); scaleexp must be in
+ * the -18..18 range.
+ */
+COMMON_API char *opp_formatsimtime(char *buf, int64_t t, int scaleexp);
+
+/**
+ * Prints the integer into the buffer.
+ */
+COMMON_API char *opp_formatint64(char *buf, int64_t d);
+
+}  // namespace common
+}  // namespace omnetpp
+
+
+#endif
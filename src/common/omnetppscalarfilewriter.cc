@@ -14,8 +14,10 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <cstring>
 #include "commonutil.h"
 #include "stringutil.h"
+#include "numberformat.h"
 #include "omnetpp/platdep/platmisc.h"
 #include "omnetppscalarfilewriter.h"
 
@@ -78,7 +80,9 @@ void OmnetppScalarFileWriter::writeStatisticField(const char *name, int64_t valu
 
 void OmnetppScalarFileWriter::writeStatisticField(const char *name, double value)
 {
-    check(fprintf(f, "field %s %.*g\n", QUOTE(name), prec, value));
+    char buf[OPP_NUMBUF_SIZE];
+    opp_formatdouble_prec(buf, value, prec);
+    check(fprintf(f, "field %s %s\n", QUOTE(name), buf));
 }
 
 void OmnetppScalarFileWriter::writeStatisticFields(const Statistics& statistic)
@@ -132,7 +136,9 @@ void OmnetppScalarFileWriter::endRecordingForRun()
 void OmnetppScalarFileWriter::recordScalar(const std::string& componentFullPath, const std::string& name, double value, const StringMap& attributes)
 {
     Assert(isOpen());
-    check(fprintf(f, "scalar %s %s %.*g\n", QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), prec, value));
+    char buf[OPP_NUMBUF_SIZE];
+    opp_formatdouble_prec(buf, value, prec);
+    check(fprintf(f, "scalar %s %s %s\n", QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), buf));
     writeAttributes(attributes);
 }
 
@@ -150,8 +156,18 @@ void OmnetppScalarFileWriter::recordHistogram(const std::string& componentFullPa
     check(fprintf(f, "statistic %s %s\n", QUOTE(componentFullPath.c_str()), QUOTE(name.c_str())));
     writeStatisticFields(statistic);
     writeAttributes(attributes);
-    for (auto bin : bins.getBins())
-        check(fprintf(f, "bin\t%.*g\t%.*g\n", prec, bin.lowerBound, prec, bin.count));
+    char line[2*OPP_NUMBUF_SIZE+8];
+    for (auto bin : bins.getBins()) {
+        char *p = line;
+        memcpy(p, "bin\t", 4);
+        p += 4;
+        p = opp_formatdouble_prec(p, bin.lowerBound, prec);
+        *p++ = '\t';
+        p = opp_formatdouble_prec(p, bin.count, prec);
+        *p++ = '\n';
+        *p = '\0';
+        check(fputs(line, f));
+    }
 }
 
 void OmnetppScalarFileWriter::flush()
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include "commonutil.h"
 #include "stringutil.h"
+#include "numberformat.h"
 #include "omnetppvectorfilewriter.h"
 
 
@@ -61,6 +62,14 @@ void OmnetppVectorFileWriter::checki(int fprintfResult)
     }
 }
 
+void OmnetppVectorFileWriter::writeChunk(const char *data, size_t size)
+{
+    if (fwrite(data, 1, size, f) != size) {
+        close();
+        throw opp_runtime_error("Cannot write output vector file '%s'", fname.c_str());
+    }
+}
+
 void OmnetppVectorFileWriter::open(const char *filename)
 {
     // open file
@@ -242,19 +251,31 @@ void OmnetppVectorFileWriter::writeBlock(VectorData *vp)
     Assert(vp != nullptr);
     Assert(!vp->buffer.empty());
 
-    char buf[64], buf2[64];
-
     Block& currentBlock = vp->currentBlock;
     currentBlock.offset = opp_ftell(f);
 
-    if (vp->recordEventNumbers) {
-        for (auto sample : vp->buffer)
-            check(fprintf(f, "%d\t%" PRId64 "\t%s\t%.*g\n", vp->id, sample.eventNumber, sample.time.ttoa(buf), prec, sample.value));
-    }
-    else {
-        for (auto sample : vp->buffer)
-            check(fprintf(f, "%d\t%s\t%.*g\n", vp->id, sample.time.ttoa(buf), prec, sample.value));
+    // format the lines into a local buffer, and write it out in large chunks
+    char lines[16384];
+    char *linesEnd = lines + sizeof(lines) - 4*OPP_NUMBUF_SIZE;  // leave room for a full line
+    char *p = lines;
+    for (const Sample& sample : vp->buffer) {
+        p = opp_formatint64(p, vp->id);
+        *p++ = '\t';
+        if (vp->recordEventNumbers) {
+            p = opp_formatint64(p, sample.eventNumber);
+            *p++ = '\t';
+        }
+        p = opp_formatsimtime(p, sample.time.t, sample.time.scaleExp);
+        *p++ = '\t';
+        p = opp_formatdouble_prec(p, sample.value, prec);
+        *p++ = '\n';
+        if (p >= linesEnd) {
+            writeChunk(lines, p - lines);
+            p = lines;
+        }
     }
+    if (p != lines)
+        writeChunk(lines, p - lines);
 
     currentBlock.size = opp_ftell(f) - currentBlock.offset;
 
@@ -265,18 +286,24 @@ void OmnetppVectorFileWriter::writeBlock(VectorData *vp)
     // so the index can be used to access the vector file while it is being written
     fflush(f);
 
+    char buf[64], buf2[64], min[OPP_NUMBUF_SIZE], max[OPP_NUMBUF_SIZE], sum[OPP_NUMBUF_SIZE], sqrsum[OPP_NUMBUF_SIZE];
+    opp_formatdouble_prec(min, stats.getMin(), prec);
+    opp_formatdouble_prec(max, stats.getMax(), prec);
+    opp_formatdouble_prec(sum, stats.getSum(), prec);
+    opp_formatdouble_prec(sqrsum, stats.getSumSqr(), prec);
+
     if (vp->recordEventNumbers) {
-        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
+        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %s %s %" PRId64 " %s %s %s %s\n",
                 vp->id, block.offset, block.size,
                 block.startEventNum, block.endEventNum,
                 block.startTime.ttoa(buf), block.endTime.ttoa(buf2),
-                stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
+                stats.getCount(), min, max, sum, sqrsum));
     }
     else {
-        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
+        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %s %s %" PRId64 " %s %s %s %s\n",
                 vp->id, block.offset, block.size,
                 block.startTime.ttoa(buf), block.endTime.ttoa(buf2),
-                stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
+                stats.getCount(), min, max, sum, sqrsum));
     }
 
     fflush(fi);
@@ -98,6 +98,7 @@ class COMMON_API OmnetppVectorFileWriter
     void cleanup();  // MUST NOT THROW
     void check(int fprintfResult);
     void checki(int fprintfResult);
+    void writeChunk(const char *data, size_t size);
     virtual void writeRecords();
     virtual void writeBlock(VectorData *vp);
     virtual void finalizeVector(VectorData *vp);
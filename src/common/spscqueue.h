@@ -0,0 +1,132 @@
+//=========================================================================
+//  SPSCQUEUE.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//  Author: Andras Varga
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_SPSCQUEUE_H
+#define __OMNETPP_COMMON_SPSCQUEUE_H
+
+#include <atomic>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Unbounded lock-free FIFO queue for exactly one producer thread and
+ * exactly one consumer thread. push() may only be called from the producer
+ * thread, and pop()/isEmpty() only from the consumer thread.
+ *
+ * The queue is a singly linked list with a dummy head node. Nodes consumed
+ * by the consumer are not freed, but are recycled by the producer, so that
+ * in steady state neither push() nor pop() allocates memory. Producer-side
+ * and consumer-side fields are kept on separate cache lines to avoid false
+ * sharing.
+ */
+template<typename T>
+class SpscQueue
+{
+  private:
+    struct Node {
+        std::atomic<Node*> next;
+        T value;
+        Node() : next(nullptr), value() {}
+    };
+
+    enum { CACHELINE_SIZE = 64 };
+
+    // consumer side
+    std::atomic<Node*> tail;   // the last consumed node (dummy); its successor is the next to pop
+    char pad1[CACHELINE_SIZE];
+
+    // producer side
+    Node *head;                // the most recently pushed node
+    Node *first;               // oldest node in the free list; nodes up to 'tailCopy' are free
+    Node *tailCopy;            // cached value of 'tail'
+    char pad2[CACHELINE_SIZE];
+
+  private:
+    Node *allocNode() {
+        // reuse a node already consumed by the consumer, if there is one
+        if (first != tailCopy) {
+            Node *node = first;
+            first = first->next.load(std::memory_order_relaxed);
+            return node;
+        }
+        tailCopy = tail.load(std::memory_order_acquire);
+        if (first != tailCopy) {
+            Node *node = first;
+            first = first->next.load(std::memory_order_relaxed);
+            return node;
+        }
+        return new Node();
+    }
+
+  public:
+    SpscQueue() {
+        Node *node = new Node();
+        tail.store(node, std::memory_order_relaxed);
+        head = first = tailCopy = node;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() {
+        Node *node = first;
+        while (node) {
+            Node *next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    /**
+     * Appends an element to the queue. Producer thread only.
+     */
+    void push(const T& value) {
+        Node *node = allocNode();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->value = value;
+        head->next.store(node, std::memory_order_release);
+        head = node;
+    }
+
+    /**
+     * Removes the oldest element from the queue and stores it into 'value'.
+     * Returns false if the queue was empty. Consumer thread only.
+     */
+    bool pop(T& value) {
+        Node *t = tail.load(std::memory_order_relaxed);
+        Node *next = t->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+        value = next->value;
+        next->value = T();
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Returns true if the queue is (momentarily) empty. Consumer thread only.
+     */
+    bool isEmpty() const {
+        return tail.load(std::memory_order_relaxed)->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
@@ -74,9 +74,14 @@ class COMMON_API SqliteVectorFileWriter
     sqlite3_stmt *add_vector_stmt;
     sqlite3_stmt *add_vector_attr_stmt;
     sqlite3_stmt *add_vector_data_stmt;
+    sqlite3_stmt *add_vector_data_multi_stmt;  // inserts ROWS_PER_INSERT rows at once
     sqlite3_stmt *update_vector_stmt;
 
     int bufferedSamplesLimit;  // limit of total buffered samples; 0=no limit
+    int commitFreq;            // number of samples to insert before committing; 0=commit after every block
+    bool writeAheadLogging;    // whether to use WAL journal mode while the file is open
+    bool inTransaction;        // whether a transaction is open
+    int uncommittedSamples;    // number of samples inserted in the open transaction
 
     Vectors vectors;           // registered output vectors
     int bufferedSamples;       // currently total buffered samples
@@ -89,6 +94,9 @@ class COMMON_API SqliteVectorFileWriter
     virtual void writeBlock(VectorData *vp);
     virtual void finalizeVector(VectorData *vp);
     void executeSql(const char *sql);
+    void beginTransaction();
+    void commitTransaction();
+    void commitIfDue();
 
     void prepareStatement(sqlite3_stmt *&stmt, const char *sql);
     void finalizeStatement(sqlite3_stmt *&stmt);
@@ -106,6 +114,10 @@ class COMMON_API SqliteVectorFileWriter
 
     void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / sizeof(Sample);}
     size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * sizeof(Sample);}
+    void setCommitFreq(int n) {commitFreq = n;}  // number of samples per transaction; 0=commit after every block
+    int getCommitFreq() const {return commitFreq;}
+    void setWriteAheadLogging(bool enabled) {writeAheadLogging = enabled;}  // takes effect in open()
+    bool getWriteAheadLogging() const {return writeAheadLogging;}
 
     void beginRecordingForRun(const std::string& runName, int simtimeScaleExp, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
     void endRecordingForRun();
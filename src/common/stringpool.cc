@@ -14,6 +14,7 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include "commonutil.h"
 #include "stringpool.h"
 
 namespace omnetpp {
@@ -31,6 +32,7 @@ StringPool::~StringPool()
 
 void StringPool::clear()
 {
+    OptionalLockGuard<std::mutex> lock(mutex);
     for (char *str : pool)
         delete[] str;
     pool.clear();
@@ -40,6 +42,7 @@ const char *StringPool::get(const char *s)
 {
     if (s == nullptr)
         return "";  // must not be nullptr because SWIG-generated code will crash!
+    OptionalLockGuard<std::mutex> lock(mutex);
     StringSet::iterator it = pool.find(const_cast<char *>(s));
     if (it != pool.end())
         return *it;
@@ -19,6 +19,7 @@
 
 #include <set>
 #include <cstring>
+#include <mutex>
 #include "commondefs.h"
 
 namespace omnetpp {
@@ -31,6 +32,9 @@ namespace common {
  * Note: this variant does not do reference counting, so strings do not need
  * to be released. The downside is that they will only be deallocated in the
  * stringpool object's destructor.
+ *
+ * get() may be called concurrently from multiple threads; the lock is only
+ * taken while the process runs simulations in several threads (Cmdenv -j).
  */
 class COMMON_API StringPool
 {
@@ -48,6 +52,7 @@ class COMMON_API StringPool
     };
     typedef std::set<char *,strless> StringSet;
     StringSet pool;
+    std::mutex mutex;
 
   public:
     StringPool();
@@ -512,7 +512,7 @@ char *opp_concat(const char *s1,
 {
     // concatenate strings into a static buffer
     // FIXME throw error if string overflows!!!
-    static char buf[256];
+    static thread_local char buf[256];
     char *bufEnd = buf+255;
     char *dest=buf;
     if (s1) while (*s1 && dest!=bufEnd) *dest++ = *s1++;
@@ -112,6 +112,11 @@ class ENVIR_API ArgList
      * Returns the original argv. It should not be modified.
      */
     char **getArgVector() const  {return argv;}
+
+    /**
+     * Returns the option specification passed to parse().
+     */
+    const char *getSpec() const  {return spec.c_str();}
 };
 
 } // namespace envir
@@ -0,0 +1,106 @@
+//==========================================================================
+//  ASYNCVECTORRECORDER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <memory>
+#include "asyncvectorrecorder.h"
+
+namespace omnetpp {
+namespace envir {
+
+#define MAX_BUFFER_SIZE    (256*1024)  // bytes
+
+AsyncVectorRecorder::AsyncVectorRecorder(size_t memoryLimit, RecordFunction recordFunction) :
+    recordFunction(recordFunction), asyncWriter(memoryLimit)
+{
+    // use several buffers within the memory limit, so that the simulation
+    // can fill one while the writer thread processes the others
+    size_t bufferSize = std::min(memoryLimit / 4, (size_t)MAX_BUFFER_SIZE);
+    samplesPerBuffer = std::max(bufferSize / sizeof(Sample), (size_t)1);
+    samples = new Samples();
+    samples->reserve(samplesPerBuffer);
+}
+
+AsyncVectorRecorder::~AsyncVectorRecorder()
+{
+    asyncWriter.waitUntilIdle();
+    delete samples;
+    Samples *buffer;
+    while (returnedBuffers.pop(buffer))
+        delete buffer;
+}
+
+void AsyncVectorRecorder::submitSamples()
+{
+    if (samples->empty())
+        return;
+
+    Samples *buffer = samples;
+    size_t size = buffer->capacity() * sizeof(Sample);
+    if (!returnedBuffers.pop(samples)) {
+        samples = new Samples();
+        samples->reserve(samplesPerBuffer);
+    }
+
+    asyncWriter.submit([this, buffer]() {
+        try {
+            for (const Sample& sample : *buffer)
+                recordFunction(*sample.handleInWriter, sample.eventNumber, sample.t, sample.scaleExp, sample.value);
+        }
+        catch (std::exception&) {
+            returnBuffer(buffer);
+            throw;
+        }
+        returnBuffer(buffer);
+    }, size);
+}
+
+void AsyncVectorRecorder::returnBuffer(Samples *buffer)
+{
+    buffer->clear();
+    returnedBuffers.push(buffer);
+}
+
+void AsyncVectorRecorder::execute(Job&& job)
+{
+    submitSamples();
+    asyncWriter.submit(std::move(job), 0);
+}
+
+void *AsyncVectorRecorder::registerVector(RegisterFunction&& registerFunction)
+{
+    void **handleInWriter = new void*(nullptr);
+    execute([handleInWriter, registerFunction]() {
+        *handleInWriter = registerFunction();
+    });
+    return handleInWriter;
+}
+
+void AsyncVectorRecorder::deregisterVector(void *handle, DeregisterFunction&& deregisterFunction)
+{
+    void **handleInWriter = (void **)handle;
+    execute([handleInWriter, deregisterFunction]() {
+        std::unique_ptr<void*> deleter(handleInWriter);
+        deregisterFunction(*handleInWriter);
+    });
+}
+
+void AsyncVectorRecorder::drain()
+{
+    submitSamples();
+    asyncWriter.drain();
+}
+
+}  // namespace envir
+}  // namespace omnetpp
@@ -0,0 +1,124 @@
+//==========================================================================
+//  ASYNCVECTORRECORDER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_ASYNCVECTORRECORDER_H
+#define __OMNETPP_ENVIR_ASYNCVECTORRECORDER_H
+
+#include <functional>
+#include <vector>
+#include "common/asyncwriter.h"
+#include "common/spscqueue.h"
+#include "omnetpp/simkerneldefs.h"
+#include "envirdefs.h"
+
+namespace omnetpp {
+namespace envir {
+
+using omnetpp::common::AsyncWriter;
+
+/**
+ * Helper for output vector managers that let the vector file writer run
+ * on a background thread. All writer operations are submitted as jobs
+ * to an AsyncWriter; recorded samples are collected into buffers on the
+ * simulation thread, and a filled buffer is submitted as a single job that
+ * feeds the samples into the writer. The writer is only accessed from the
+ * background thread, so it produces the same file as in synchronous mode.
+ *
+ * Vector handles returned by the writer are only known in the background
+ * thread, so registerVector() returns a handle of its own that stands for
+ * the writer's handle.
+ */
+class ENVIR_API AsyncVectorRecorder
+{
+  public:
+    typedef AsyncWriter::Job Job;
+    typedef std::function<void*()> RegisterFunction;
+    typedef std::function<void(void *handleInWriter)> DeregisterFunction;
+    typedef std::function<void(void *handleInWriter, eventnumber_t eventNumber, int64_t t, int scaleExp, double value)> RecordFunction;
+
+  protected:
+    struct Sample {
+        void **handleInWriter;
+        eventnumber_t eventNumber;
+        int64_t t;
+        int scaleExp;
+        double value;
+    };
+
+    typedef std::vector<Sample> Samples;
+
+    RecordFunction recordFunction;
+    size_t samplesPerBuffer;
+    Samples *samples;  // the buffer being filled
+    omnetpp::common::SpscQueue<Samples*> returnedBuffers;  // emptied buffers, on their way back from the writer thread
+    AsyncWriter asyncWriter;
+
+  protected:
+    void submitSamples();
+    void returnBuffer(Samples *buffer);  // called in the writer thread
+
+  public:
+    /**
+     * The memory limit is in bytes; it applies to the samples and jobs
+     * queued for the writer thread. recordFunction is called in the writer
+     * thread for each sample.
+     */
+    AsyncVectorRecorder(size_t memoryLimit, RecordFunction recordFunction);
+
+    /**
+     * Waits until the queued jobs have been executed.
+     */
+    ~AsyncVectorRecorder();
+
+    /**
+     * Submits a job; it will be executed after the samples recorded so far.
+     */
+    void execute(Job&& job);
+
+    /**
+     * Submits the registration of a vector. The returned handle can be used
+     * with record() and deregisterVector().
+     */
+    void *registerVector(RegisterFunction&& registerFunction);
+
+    /**
+     * Submits the deregistration of a vector; the handle becomes invalid.
+     */
+    void deregisterVector(void *handle, DeregisterFunction&& deregisterFunction);
+
+    /**
+     * Adds a sample to the current buffer, and submits the buffer if it is full.
+     */
+    void record(void *handle, eventnumber_t eventNumber, int64_t t, int scaleExp, double value) {
+        samples->push_back(Sample { (void **)handle, eventNumber, t, scaleExp, value });
+        if (samples->size() >= samplesPerBuffer)
+            submitSamples();
+    }
+
+    /**
+     * Submits the buffered samples, and waits until all jobs have been
+     * executed. Reports errors that occurred in the writer thread.
+     */
+    void drain();
+
+    /**
+     * See AsyncWriter::checkError().
+     */
+    bool checkError() {return asyncWriter.checkError();}
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+#endif
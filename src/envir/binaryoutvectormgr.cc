@@ -0,0 +1,251 @@
+//==========================================================================
+//  OMNETPPOUTVECTORMGR.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include "common/stringutil.h"
+#include "common/fileutil.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/ccomponenttype.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "envirbase.h"
+#include "binaryoutvectormgr.h"
+#include "resultfileutils.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace envir {
+
+typedef std::map<std::string, std::string> StringMap;
+
+Register_Class(BinaryOutputVectorManager);
+
+// global options
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE_APPEND;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE;
+extern omnetpp::cConfigOption *CFGID_OUTPUTVECTOR_MEMORY_LIMIT;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_ASYNC_WRITING;
+
+// per-vector options
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING;
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING_INTERVALS;
+extern omnetpp::cConfigOption *CFGID_VECTOR_BUFFER;
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORD_EVENTNUMBERS;
+
+Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_FILE_COMPRESSION, "output-vector-file-compression", CFG_BOOL, "true", "Whether to compress the data blocks of binary output vector files (see BinaryOutputVectorManager). Compression is skipped for blocks where it does not reduce the size.");
+
+BinaryOutputVectorManager::BinaryOutputVectorManager()
+{
+    initialized = false;
+
+    size_t memoryLimit = (size_t) getEnvir()->getConfig()->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
+    bool asyncWriting = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_ASYNC_WRITING);
+    if (!asyncWriting) {
+        asyncRecorder = nullptr;
+        writer.setOverallMemoryLimit(memoryLimit);
+    }
+    else {
+        // the memory limit is shared between the writer's buffers and the queue of the writer thread
+        writer.setOverallMemoryLimit(memoryLimit / 2);
+        asyncRecorder = new AsyncVectorRecorder(memoryLimit / 2, [this](void *handle, eventnumber_t eventNumber, int64_t t, int scaleExp, double value) {
+            if (writer.isOpen())
+                writer.recordInVector(handle, eventNumber, t, scaleExp, value);
+        });
+    }
+}
+
+BinaryOutputVectorManager::~BinaryOutputVectorManager()
+{
+    delete asyncRecorder;
+}
+
+void BinaryOutputVectorManager::open()
+{
+    mkPath(directoryOf(fname.c_str()).c_str());
+    writer.open(fname.c_str());
+}
+
+void BinaryOutputVectorManager::close()
+{
+    writer.close();
+}
+
+void BinaryOutputVectorManager::initialize()
+{
+    open();
+    writeRunData();
+}
+
+inline StringMap convertMap(const opp_string_map *m)
+{
+    StringMap result;
+    if (m)
+        for (auto pair : *m)
+            result[pair.first.c_str()] = pair.second.c_str();
+    return result;
+}
+
+void BinaryOutputVectorManager::writeRunData()
+{
+    writer.beginRecordingForRun(ResultFileUtils::getRunId().c_str(), ResultFileUtils::getRunAttributes(), ResultFileUtils::getIterationVariables(), ResultFileUtils::getParamAssignments());
+}
+
+void BinaryOutputVectorManager::startRun()
+{
+    bool shouldAppend = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_FILE_APPEND);
+    if (shouldAppend)
+        throw cRuntimeError("%s does not support append mode", getClassName());
+
+    fname = getEnvir()->getConfig()->getAsFilename(CFGID_OUTPUT_VECTOR_FILE).c_str();
+    dynamic_cast<EnvirBase *>(getEnvir())->processFileName(fname);
+    removeFile(fname.c_str(), "old output vector file");
+
+    bool compress = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_FILE_COMPRESSION);
+    writer.setCompression(compress);
+}
+
+void BinaryOutputVectorManager::endRun()
+{
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            if (writer.isOpen())
+                writer.endRecordingForRun();
+            close();
+        });
+        initialized = false;
+        vectors.clear();
+        asyncRecorder->drain();  // so that the file is complete when the run is over
+        return;
+    }
+
+    if (writer.isOpen())
+        writer.endRecordingForRun();
+
+    initialized = false;
+    vectors.clear();
+    close();
+}
+
+void *BinaryOutputVectorManager::registerVector(const char *modulename, const char *vectorname)
+{
+    VectorData *vp = new VectorData();
+    vp->handleInWriter = nullptr;
+    vp->moduleName = modulename;
+    vp->vectorName = vectorname;
+
+    std::string vectorfullpath = std::string(modulename) + "." + vectorname;
+    vp->enabled = getEnvir()->getConfig()->getAsBool(vectorfullpath.c_str(), CFGID_VECTOR_RECORDING);
+
+    // get interval string
+    const char *text = getEnvir()->getConfig()->getAsCustom(vectorfullpath.c_str(), CFGID_VECTOR_RECORDING_INTERVALS);
+    if (text)
+        vp->intervals.parse(text);
+
+    vectors.push_back(vp);
+    return vp;
+}
+
+void BinaryOutputVectorManager::deregisterVector(void *vectorhandle)
+{
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    if (vp->handleInWriter != nullptr) {
+        if (asyncRecorder)
+            asyncRecorder->deregisterVector(vp->handleInWriter, [this](void *handle) {
+                if (writer.isOpen() && handle != nullptr)
+                    writer.deregisterVector(handle);
+            });
+        else if (writer.isOpen())
+            writer.deregisterVector(vp->handleInWriter);
+    }
+
+    Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
+    vectors.erase(newEnd, vectors.end());
+    delete vp;
+}
+
+void BinaryOutputVectorManager::setVectorAttribute(void *vectorhandle, const char *name, const char *value)
+{
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    ASSERT(vp->handleInWriter == nullptr); // otherwise it's too late
+    vp->attributes[name] = value;
+}
+
+bool BinaryOutputVectorManager::record(void *vectorhandle, simtime_t t, double value)
+{
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+
+    if (!vp->enabled || !vp->intervals.contains(t))
+        return false;
+
+    if (!initialized) {
+        initialized = true;
+        initialize();
+    }
+
+    if (isBad())
+        return false;
+
+    if (vp->handleInWriter == nullptr) {
+        std::string vectorFullPath = vp->moduleName.str() + "." + vp->vectorName.c_str();
+        size_t bufferSize = (size_t) getEnvir()->getConfig()->getAsDouble(vectorFullPath.c_str(), CFGID_VECTOR_BUFFER);
+        bool recordEventNumbers = getEnvir()->getConfig()->getAsBool(vectorFullPath.c_str(), CFGID_VECTOR_RECORD_EVENTNUMBERS);
+        if (asyncRecorder) {
+            std::string moduleName = vp->moduleName.c_str();
+            std::string vectorName = vp->vectorName.c_str();
+            StringMap attributes = convertMap(&vp->attributes);
+            vp->handleInWriter = asyncRecorder->registerVector([=]() {
+                return writer.registerVector(moduleName, vectorName, attributes, bufferSize, recordEventNumbers);
+            });
+        }
+        else
+            vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize, recordEventNumbers);
+    }
+
+    eventnumber_t eventNumber = getSimulation()->getEventNumber();
+    if (asyncRecorder)
+        asyncRecorder->record(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    else
+        writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    return true;
+}
+
+const char *BinaryOutputVectorManager::getFileName() const
+{
+    return fname.c_str();
+}
+
+void BinaryOutputVectorManager::flush()
+{
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            if (writer.isOpen())
+                writer.flush();
+        });
+        asyncRecorder->drain();
+    }
+    else if (writer.isOpen())
+        writer.flush();
+}
+
+}  // namespace envir
+}  // namespace omnetpp
+
@@ -62,6 +62,7 @@
 #include "envirutils.h"
 #include "appreg.h"
 #include "valueiterator.h"
+#include "modelpartitioner.h"
 #include "xmldoccache.h"
 
 #ifdef __APPLE__
@@ -168,6 +169,7 @@ Register_PerRunConfigOption(CFGID_RNG_CLASS, "rng-class", CFG_STRING, "omnetpp::
 Register_PerRunConfigOption(CFGID_SEED_SET, "seed-set", CFG_INT, "${runnumber}", "Selects the kth set of automatic random number seeds for the simulation. Meaningful values include `${repetition}` which is the repeat loop counter (see `repeat` option), and `${runnumber}`.");
 Register_PerRunConfigOption(CFGID_RESULT_DIR, "result-dir", CFG_STRING, "results", "Value for the `${resultdir}` variable, which is used as the default directory for result files (output vector file, output scalar file, eventlog file, etc.)");
 Register_PerRunConfigOption(CFGID_RECORD_EVENTLOG, "record-eventlog", CFG_BOOL, "false", "Enables recording an eventlog file, which can be later visualized on a sequence chart. See `eventlog-file` option too.");
+Register_PerRunConfigOption(CFGID_AUTOPARTITION_NUM_PARTITIONS, "autopartition-num-partitions", CFG_INT, "0", "When set to a positive number, the run serves as a profiling run for parallel simulation: the number of events per network submodule and the connection delays are used to compute a partitioning into the given number of partitions, which is written as `partition-id` settings into the file given with `autopartition-file`. The partitioning minimizes the links cut (preferring links with large delays, as they allow a larger lookahead) while keeping the partitions balanced. Connections with zero delay are never cut. Cannot be used with parallel simulation.");
 Register_PerRunConfigOption(CFGID_DEBUG_STATISTICS_RECORDING, "debug-statistics-recording", CFG_BOOL, "false", "Turns on the printing of debugging information related to statistics recording (`@statistic` properties)");
 Register_PerRunConfigOption(CFGID_CHECK_SIGNALS, "check-signals", CFG_BOOL, CHECKSIGNALS_DEFAULT, "Controls whether the simulation kernel will validate signals emitted by modules and channels against signal declarations (`@signal` properties) in NED files. The default setting depends on the build type: `true` in DEBUG, and `false` in RELEASE mode.");
 
@@ -176,14 +178,16 @@ Register_PerObjectConfigOption(CFGID_RNG_K, "rng-%", KIND_COMPONENT, CFG_INT, ""
 
 Register_PerRunConfigOption(CFGID_OUTPUT_SCALAR_FILE, "output-scalar-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.sca", "Name for the output scalar file.");
 Register_PerRunConfigOption(CFGID_OUTPUT_SCALAR_FILE_APPEND, "output-scalar-file-append", CFG_BOOL, "false", "What to do when the output scalar file already exists: append to it (OMNeT++ 3.x behavior), or delete it and begin a new file (default).");
-Register_PerRunConfigOption(CFGID_OUTPUT_SCALAR_PRECISION, "output-scalar-precision", CFG_INT, DEFAULT_OUTPUT_SCALAR_PRECISION, "The number of significant digits for recording data into the output scalar file. The maximum value is ~15 (IEEE double precision). This has no effect on SQLite recording, as it stores values as 8-byte IEEE floating point numbers.");
+Register_PerRunConfigOption(CFGID_OUTPUT_SCALAR_PRECISION, "output-scalar-precision", CFG_INT, DEFAULT_OUTPUT_SCALAR_PRECISION, "The number of significant digits for recording data into the output scalar file. The maximum value is ~15 (IEEE double precision); -1 selects the shortest representation that converts back to exactly the same value. This has no effect on SQLite recording, as it stores values as 8-byte IEEE floating point numbers.");
+Register_PerRunConfigOption(CFGID_OUTPUT_SCALAR_ASYNC_WRITING, "output-scalar-async-writing", CFG_BOOL, "false", "Whether to write the output scalar file in a background thread. When enabled, scalar results are queued for the writer thread, so that file I/O (and SQLite database operations) do not slow down the simulation. The file is complete by the end of the run.");
 
 Register_PerObjectConfigOption(CFGID_SCALAR_RECORDING, "scalar-recording", KIND_SCALAR, CFG_BOOL, "true", "Whether the matching output scalars and statistic objects should be recorded.\nUsage: `<module-full-path>.<scalar-name>.scalar-recording=true/false`. To enable/disable individual recording modes for a @statistic (those added via the `record=...` key of `@statistic` or the `**.result-recording-modes=...` config option), use `<statistic-name>:<mode>` for `<scalar-name>`, and make sure the `@statistic` as a whole is not disabled with `**.<statistic-name>.statistic-recording=false`.\nExample: `**.ping.roundTripTime:stddev.scalar-recording=false`");
 Register_PerObjectConfigOption(CFGID_BIN_RECORDING, "bin-recording", KIND_SCALAR, CFG_BOOL, "true", "Whether the bins of the matching histogram object should be recorded, provided that recording of the histogram object itself is enabled (`**.<scalar-name>.scalar-recording=true`).\nUsage: `<module-full-path>.<scalar-name>.bin-recording=true/false`. To control histogram recording from a `@statistic`, use `<statistic-name>:histogram` for `<scalar-name>`.\nExample: `**.ping.roundTripTime:histogram.bin-recording=false`");
 
 Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_FILE, "output-vector-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.vec", "Name for the output vector file.");
 Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_FILE_APPEND, "output-vector-file-append", CFG_BOOL, "false", "What to do when the output vector file already exists: append to it, or delete it and begin a new file (default). Note: `cIndexedFileOutputVectorManager` currently does not support appending.");
-Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_PRECISION, "output-vector-precision", CFG_INT, DEFAULT_OUTPUT_VECTOR_PRECISION, "The number of significant digits for recording data into the output vector file. The maximum value is ~15 (IEEE double precision). This setting has no effect on SQLite recording (it stores values as 8-byte IEEE floating point numbers), and for the \"time\" column which is represented as fixed-point numbers and always get recorded precisely.");
+Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_PRECISION, "output-vector-precision", CFG_INT, DEFAULT_OUTPUT_VECTOR_PRECISION, "The number of significant digits for recording data into the output vector file. The maximum value is ~15 (IEEE double precision); -1 selects the shortest representation that converts back to exactly the same value. This setting has no effect on SQLite recording (it stores values as 8-byte IEEE floating point numbers), and for the \"time\" column which is represented as fixed-point numbers and always get recorded precisely.");
+Register_PerRunConfigOption(CFGID_OUTPUT_VECTOR_ASYNC_WRITING, "output-vector-async-writing", CFG_BOOL, "false", "Whether to write the output vector file in a background thread. When enabled, recorded samples are handed over to the writer thread in batches, and formatting, compression and database inserts are done there. The memory limit set with `output-vectors-memory-limit` is shared between the writer's buffers and the queue of the writer thread; when the queue is full, the simulation waits for the writer thread. The file is complete by the end of the run, and its contents are the same as with synchronous writing.");
 
 Register_PerObjectConfigOption(CFGID_VECTOR_RECORDING, "vector-recording", KIND_VECTOR, CFG_BOOL, "true", "Whether data written into an output vector should be recorded.\nUsage: `<module-full-path>.<vector-name>.vector-recording=true/false`. To control vector recording from a `@statistic`, use `<statistic-name>:vector for <vector-name>`. Example: `**.ping.roundTripTime:vector.vector-recording=false`");
 Register_PerObjectConfigOption(CFGID_VECTOR_RECORD_EVENTNUMBERS, "vector-record-eventnumbers", KIND_VECTOR, CFG_BOOL, "true", "Whether to record event numbers for an output vector. (Values and timestamps are always recorded.) Event numbers are needed by the Sequence Chart Tool, for example.\nUsage: `<module-full-path>.<vector-name>.vector-record-eventnumbers=true/false`.\nExample: `**.ping.roundTripTime:vector.vector-record-eventnumbers=false`");
@@ -301,6 +305,7 @@ EnvirBase::EnvirBase() : out(std::cout.rdbuf())
     outvectorManager = nullptr;
     outScalarManager = nullptr;
     snapshotManager = nullptr;
+    partitioner = nullptr;
 
     numRNGs = 0;
     rngs = nullptr;
@@ -329,6 +334,7 @@ EnvirBase::~EnvirBase()
     delete outvectorManager;
     delete outScalarManager;
     delete snapshotManager;
+    delete partitioner;
 
     for (int i = 0; i < numRNGs; i++)
         delete rngs[i];
@@ -344,7 +350,7 @@ int EnvirBase::run(int argc, char *argv[], cConfiguration *configobject)
 {
     opt = createOptions();
     args = new ArgList();
-    args->parse(argc, argv, "h?f:u:l:c:r:n:p:x:X:q:agGvwsm");  // TODO share spec with startup.cc!
+    args->parse(argc, argv, "h?f:u:l:c:r:n:p:x:X:q:j:agGvwsm");  // TODO share spec with startup.cc!
     opt->useStderr = !args->optionGiven('m');
     opt->verbose = !args->optionGiven('s');
     cfg = dynamic_cast<cConfigurationEx *>(configobject);
@@ -557,31 +563,10 @@ bool EnvirBase::setup()
         // install XML document cache
         xmlCache = new XMLDocCache();
 
-        // set up for sequential or distributed execution
-        if (!opt->parsim) {
-            // sequential
-            cScheduler *scheduler = createByClassName<cScheduler>(opt->schedulerClass.c_str(), "event scheduler");
-            getSimulation()->setScheduler(scheduler);
-        }
-        else {
-#ifdef WITH_PARSIM
-            // parsim: create components
-            parsimComm = createByClassName<cParsimCommunications>(opt->parsimcommClass.c_str(), "parallel simulation communications layer");
-            parsimPartition = new cParsimPartition();
-            cParsimSynchronizer *parsimSynchronizer = createByClassName<cParsimSynchronizer>(opt->parsimsynchClass.c_str(), "parallel simulation synchronization layer");
-            addLifecycleListener(parsimPartition);
-
-            // wire them together (note: 'parsimSynchronizer' is also the scheduler for 'simulation')
-            parsimPartition->setContext(getSimulation(), parsimComm, parsimSynchronizer);
-            parsimSynchronizer->setContext(getSimulation(), parsimPartition, parsimComm);
-            getSimulation()->setScheduler(parsimSynchronizer);
-
-            // initialize them
-            parsimComm->init();
-#else
-            throw cRuntimeError("Parallel simulation is turned on in the ini file, but OMNeT++ was compiled without parallel simulation support (WITH_PARSIM=no)");
-#endif
-        }
+        // set up for sequential or distributed execution (partitions
+        // running on worker threads do that for themselves)
+        if (!hasPartitionThreads())
+            setupScheduler();
 
         // load NED files from folders on the NED path
         StringTokenizer tokenizer(opt->nedPath.c_str(), PATH_SEPARATOR);
@@ -610,6 +595,45 @@ bool EnvirBase::setup()
     return true;
 }
 
+void EnvirBase::setupWorkerThread()
+{
+    // coroutines, the XML document cache and the scheduler (or the partition
+    // of a parallel simulation) are per-thread;
+    // NED types and the options read by readOptions() are shared with the main thread
+    cCoroutine::init(opt->totalStack, MAIN_STACK_SIZE);
+    xmlCache = new XMLDocCache();
+    setupScheduler();
+}
+
+void EnvirBase::setupScheduler()
+{
+    // set up for sequential or distributed execution
+    if (!opt->parsim) {
+        // sequential
+        cScheduler *scheduler = createByClassName<cScheduler>(opt->schedulerClass.c_str(), "event scheduler");
+        getSimulation()->setScheduler(scheduler);
+    }
+    else {
+#ifdef WITH_PARSIM
+        // parsim: create components
+        parsimComm = createByClassName<cParsimCommunications>(opt->parsimcommClass.c_str(), "parallel simulation communications layer");
+        parsimPartition = new cParsimPartition();
+        cParsimSynchronizer *parsimSynchronizer = createByClassName<cParsimSynchronizer>(opt->parsimsynchClass.c_str(), "parallel simulation synchronization layer");
+        addLifecycleListener(parsimPartition);
+
+        // wire them together (note: 'parsimSynchronizer' is also the scheduler for 'simulation')
+        parsimPartition->setContext(getSimulation(), parsimComm, parsimSynchronizer);
+        parsimSynchronizer->setContext(getSimulation(), parsimPartition, parsimComm);
+        getSimulation()->setScheduler(parsimSynchronizer);
+
+        // initialize them
+        parsimComm->init();
+#else
+        throw cRuntimeError("Parallel simulation is turned on in the ini file, but OMNeT++ was compiled without parallel simulation support (WITH_PARSIM=no)");
+#endif
+    }
+}
+
 void EnvirBase::printHelp()
 {
     out << "Command line options:\n";
@@ -1078,6 +1102,8 @@ void EnvirBase::simulationEvent(cEvent *event)
     currentModuleId = event->isMessage() ? (static_cast<cMessage *>(event))->getArrivalModule()->getId() : -1;
     if (recordEventlog)
         eventlogManager->simulationEvent(event);
+    if (partitioner)
+        partitioner->simulationEvent(event);
 }
 
 void EnvirBase::beginSend(cMessage *msg)
@@ -1234,8 +1260,13 @@ void EnvirBase::processFileName(std::string& fname)
                                 "or COMPUTERNAME (Windows) environment variable", fname.c_str());
         int pid = getpid();
 
-        // append
-        fname += opp_stringf(".%s.%d%s", hostname, pid, extension.c_str());
+        // append; partitions running as threads of the same process are told apart by their procId
+        fname += opp_stringf(".%s.%d", hostname, pid);
+#ifdef WITH_PARSIM
+        if (parsimComm && hasPartitionThreads())
+            fname += opp_stringf("-%d", parsimComm->getProcId());
+#endif
+        fname += extension;
     }
 }
 
@@ -1410,6 +1441,16 @@ void EnvirBase::readPerRunOptions()
     snapshotManager = createByClassName<cISnapshotManager>(opt->snapshotmanagerClass.c_str(), "snapshot manager");
     addLifecycleListener(snapshotManager);
 
+    // install model partitioner if this is a profiling run
+    delete partitioner;
+    partitioner = nullptr;
+    if (cfg->getAsInt(CFGID_AUTOPARTITION_NUM_PARTITIONS) > 0) {
+        if (opt->parsim)
+            throw cRuntimeError("%s cannot be used with parallel simulation, it needs a sequential profiling run", CFGID_AUTOPARTITION_NUM_PARTITIONS->getName());
+        partitioner = new ModelPartitioner(out, opt->verbose);
+        addLifecycleListener(partitioner);
+    }
+
     // install FES
     cFutureEventSet *fes = createByClassName<cFutureEventSet>(opt->futureeventsetClass.c_str(), "FES");
     getSimulation()->setFES(fes);
@@ -1460,6 +1501,9 @@ void EnvirBase::readPerRunOptions()
 
     // open eventlog file.
     recordEventlog = cfg->getAsBool(CFGID_RECORD_EVENTLOG);
+
+    // hops which don't affect the message are only of interest for the eventlog and for animation
+    suppressPassThroughHops = !recordEventlog && !isGUI();
 }
 
 int EnvirBase::parseSimtimeResolution(const char *resolution)
@@ -1508,6 +1552,7 @@ void EnvirBase::setEventlogRecording(bool enabled)
         else
             eventlogManager->stopRecording();
         recordEventlog = enabled;
+        suppressPassThroughHops = !recordEventlog && !isGUI();
     }
 }
 
@@ -53,6 +53,7 @@ namespace envir {
 
 class XMLDocCache;
 class SignalSource;
+class ModelPartitioner;
 
 // assumed maximum length for getFullPath() string.
 // note: this maximum actually not enforced anywhere
@@ -157,6 +158,7 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     cIOutputVectorManager *outvectorManager;
     cIOutputScalarManager *outScalarManager;
     cISnapshotManager *snapshotManager;
+    ModelPartitioner *partitioner;  // nullptr unless a partitioning is computed from this run
 
     // Data for getUniqueNumber()
     unsigned long nextUniqueNumber;
@@ -295,6 +297,9 @@ class ENVIR_API EnvirBase : public cRunnableEnvir
     // functions added locally
     virtual bool simulationRequired();
     virtual bool setup();  // does not throw; returns true if OK to go on
+    virtual void setupWorkerThread();  // the parts of setup() needed for running simulations on another thread; may throw
+    virtual void setupScheduler();  // creates the scheduler, or the components of parallel simulation; may throw
+    virtual bool hasPartitionThreads() const {return false;}  // whether the partitions of parallel simulation run on worker threads
     virtual void run();  // does not throw; delegates to doRun()
     virtual void shutdown(); // does not throw
     virtual void doRun() = 0;
@@ -565,7 +565,7 @@ void EventlogFileManager::componentMethodBegin(cComponent *from, cComponent *to,
     if (isCombinedRecordingEnabled) {
         const char *methodText = "";  // for the Enter_Method_Silent case
         if (methodFmt) {
-            static char methodTextBuf[MAX_METHODCALL];
+            static thread_local char methodTextBuf[MAX_METHODCALL];
             vsnprintf(methodTextBuf, MAX_METHODCALL, methodFmt, va);
             methodTextBuf[MAX_METHODCALL-1] = '\0';
             methodText = methodTextBuf;
@@ -116,6 +116,15 @@ bool LogFormatter::usesEventName()
     return false;
 }
 
+// module paths are taken from the pooled path table, sparing a string allocation per log line
+static void printFullPath(std::ostream& stream, const cComponent *component)
+{
+    if (component->isModule())
+        stream << static_cast<const cModule *>(component)->getFullPathPooled();
+    else
+        stream << component->getFullPath();
+}
+
 std::string LogFormatter::formatPrefix(cLogEntry *entry)
 {
     bool lastPartEmpty = true;
@@ -209,7 +218,7 @@ std::string LogFormatter::formatPrefix(cLogEntry *entry)
 
             case EVENT_MODULE_FULLPATH:
                 if (ev->getCurrentEventModule())
-                    stream << ev->getCurrentEventModule()->getFullPath();
+                    stream << ev->getCurrentEventModule()->getFullPathPooled();
                 else
                     lastPartEmpty = true;
                 break;
@@ -244,7 +253,7 @@ std::string LogFormatter::formatPrefix(cLogEntry *entry)
 
             case CONTEXT_COMPONENT_FULLPATH:
                 if (contextComponent)
-                    stream << contextComponent->getFullPath();
+                    printFullPath(stream, contextComponent);
                 else
                     lastPartEmpty = true;
                 break;
@@ -377,7 +386,7 @@ std::string LogFormatter::formatPrefix(cLogEntry *entry)
             case EVENT_MODULE: {
                 cModule *mod = ev->getCurrentEventModule();
                 if (mod)
-                    stream << "(" << mod->getComponentType()->getName() << ")" << mod->getFullPath();
+                    stream << "(" << mod->getComponentType()->getName() << ")" << mod->getFullPathPooled();
                 else
                     lastPartEmpty = true;
                 break;
@@ -391,8 +400,10 @@ std::string LogFormatter::formatPrefix(cLogEntry *entry)
 
             // no break
             case CONTEXT_COMPONENT: {
-                if (contextComponent)
-                    stream << "(" << contextComponent->getComponentType()->getName() << ")" << contextComponent->getFullPath();
+                if (contextComponent) {
+                    stream << "(" << contextComponent->getComponentType()->getName() << ")";
+                    printFullPath(stream, contextComponent);
+                }
                 else
                     lastPartEmpty = true;
                 break;
@@ -406,8 +417,10 @@ std::string LogFormatter::formatPrefix(cLogEntry *entry)
 
             // no break
             case SOURCE_COMPONENT_OR_OBJECT: {
-                if (entry->sourceComponent)
-                    stream << "(" << entry->sourceComponent->getComponentType()->getName() << ")" << entry->sourceComponent->getFullPath();
+                if (entry->sourceComponent) {
+                    stream << "(" << entry->sourceComponent->getComponentType()->getName() << ")";
+                    printFullPath(stream, entry->sourceComponent);
+                }
                 else if (entry->sourceObject) {
                     stream << "(" << entry->sourceObject->getClassName() << ")"
                            << (entry->sourceObject->getOwner() == contextComponent ? entry->sourceObject->getFullName() : entry->sourceObject->getFullPath());
@@ -0,0 +1,424 @@
+//==========================================================================
+//  MODELPARTITIONER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include "common/fileutil.h"
+#include "common/stringutil.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cchannel.h"
+#include "omnetpp/cgate.h"
+#include "omnetpp/cpar.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+#include "envirbase.h"
+#include "modelpartitioner.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace envir {
+
+Register_PerRunConfigOption(CFGID_AUTOPARTITION_FILE, "autopartition-file", CFG_FILENAME, "${resultdir}/${configname}-partitioning.ini", "Name of the ini file fragment the partitioning computed by `autopartition-num-partitions` is written to.");
+Register_PerRunConfigOption(CFGID_AUTOPARTITION_MAX_IMBALANCE, "autopartition-max-imbalance", CFG_DOUBLE, "0.05", "When `autopartition-num-partitions` is set: the allowed relative overweight of a partition compared to the average, in terms of events processed.");
+
+extern cConfigOption *CFGID_AUTOPARTITION_NUM_PARTITIONS;  // registered in envirbase.cc
+
+static const int MAX_REFINEMENT_PASSES = 20;
+
+ModelPartitioner::ModelPartitioner(std::ostream& out, bool verbose) : out(out), verbose(verbose)
+{
+    numPartitions = 0;
+    numEvents = 0;
+}
+
+int ModelPartitioner::getTopLevelModuleId(int moduleId)
+{
+    auto it = topLevelIds.find(moduleId);
+    if (it != topLevelIds.end())
+        return it->second;
+
+    cModule *network = getSimulation()->getSystemModule();
+    cModule *mod = getSimulation()->getModule(moduleId);
+    while (mod && mod->getParentModule() != network)
+        mod = mod->getParentModule();
+    int topLevelId = mod ? mod->getId() : -1;  // -1 for the network module itself
+    topLevelIds[moduleId] = topLevelId;
+    return topLevelId;
+}
+
+void ModelPartitioner::simulationEvent(cEvent *event)
+{
+    if (!event->isMessage())
+        return;
+    cModule *mod = static_cast<cMessage *>(event)->getArrivalModule();
+    if (!mod)
+        return;
+    int topLevelId = getTopLevelModuleId(mod->getId());
+    if (topLevelId != -1)
+        eventCounts[topLevelId]++;
+    numEvents++;
+}
+
+void ModelPartitioner::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    switch (eventType) {
+        case LF_PRE_NETWORK_SETUP:
+            numPartitions = getEnvir()->getConfig()->getAsInt(CFGID_AUTOPARTITION_NUM_PARTITIONS);
+            eventCounts.clear();
+            topLevelIds.clear();
+            numEvents = 0;
+            break;
+
+        case LF_ON_RUN_END:
+            writePartitioning();
+            break;
+
+        default:
+            break;
+    }
+}
+
+// sum of the channel delays along the connection path that ends at the given gate
+static double getPathDelay(cGate *g)
+{
+    double sum = 0;
+    while (g->getPreviousGate()) {
+        cGate *prevg = g->getPreviousGate();
+        cChannel *chan = prevg->getChannel();
+        sum += (chan && chan->hasPar("delay")) ? chan->par("delay").doubleValue() : 0.0;
+        g = prevg;
+    }
+    return sum;
+}
+
+// ini pattern for the module, with consecutive vector indices merged into a range
+static std::string makeModulePattern(cModule *mod, int lastIndex)
+{
+    if (!mod->isVector())
+        return mod->getName();
+    if (lastIndex == mod->getIndex())
+        return opp_stringf("%s[%d]", mod->getName(), mod->getIndex());
+    return opp_stringf("%s[%d..%d]", mod->getName(), mod->getIndex(), lastIndex);
+}
+
+void ModelPartitioner::writePartitioning()
+{
+    cModule *network = getSimulation()->getSystemModule();
+    if (!network || numPartitions <= 0)
+        return;
+
+    // nodes of the graph: the submodules of the network
+    std::vector<cModule *> nodes;
+    std::unordered_map<int,int> nodeIndex;
+    std::vector<double> nodeWeights;
+    for (cModule::SubmoduleIterator it(network); !it.end(); ++it) {
+        cModule *mod = *it;
+        nodeIndex[mod->getId()] = nodes.size();
+        nodes.push_back(mod);
+        nodeWeights.push_back(eventCounts[mod->getId()] + 1);  // +1: idle modules also cost something
+    }
+
+    // edges: connections between them, along with their delays
+    std::vector<Edge> edges;
+    std::vector<double> delays;
+    double minDelay = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < (int)nodes.size(); i++) {
+        for (cModule::GateIterator it(nodes[i]); !it.end(); ++it) {
+            cGate *gate = *it;
+            if (gate->getType() != cGate::OUTPUT || !gate->getNextGate())
+                continue;
+            auto dest = nodeIndex.find(gate->getNextGate()->getOwnerModule()->getId());
+            if (dest == nodeIndex.end() || dest->second == i)
+                continue;
+            double delay = getPathDelay(gate->getPathEndGate());
+            edges.push_back(Edge { i, dest->second, 0 });
+            delays.push_back(delay);
+            if (delay > 0 && delay < minDelay)
+                minDelay = delay;
+        }
+    }
+
+    // cutting a link reduces the lookahead to its delay, so a smaller delay
+    // means a higher cost; zero-delay links cannot be cut at all
+    for (int i = 0; i < (int)edges.size(); i++)
+        edges[i].cost = delays[i] > 0 ? minDelay / delays[i] : std::numeric_limits<double>::infinity();
+
+    double maxImbalance = getEnvir()->getConfig()->getAsDouble(CFGID_AUTOPARTITION_MAX_IMBALANCE);
+    std::vector<int> partitionOf = computePartitioning(nodeWeights, edges, numPartitions, maxImbalance);
+
+    // statistics for the file header
+    std::vector<double> partitionWeights(numPartitions, 0);
+    std::vector<int> partitionSizes(numPartitions, 0);
+    double totalWeight = 0;
+    for (int i = 0; i < (int)nodes.size(); i++) {
+        partitionWeights[partitionOf[i]] += nodeWeights[i];
+        partitionSizes[partitionOf[i]]++;
+        totalWeight += nodeWeights[i];
+    }
+    int numCutEdges = 0;
+    double lookahead = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < (int)edges.size(); i++) {
+        if (partitionOf[edges[i].from] != partitionOf[edges[i].to]) {
+            numCutEdges++;
+            lookahead = std::min(lookahead, delays[i]);
+        }
+    }
+
+    // write the file
+    std::string fname = getEnvir()->getConfig()->getAsFilename(CFGID_AUTOPARTITION_FILE);
+    dynamic_cast<EnvirBase *>(getEnvir())->processFileName(fname);
+    mkPath(directoryOf(fname.c_str()).c_str());
+    std::ofstream f(fname.c_str());
+    if (!f.is_open())
+        throw cRuntimeError("Cannot open partitioning file '%s' for write", fname.c_str());
+
+    cConfigurationEx *cfg = getEnvir()->getConfigEx();
+    f << "# Partitioning of network " << network->getNedTypeName() << " into " << numPartitions << " partitions,\n";
+    f << "# computed from " << numEvents << " events of run " << cfg->getActiveConfigName() << " #" << cfg->getActiveRunNumber()
+      << " (until t=" << getSimulation()->getSimTime() << ")\n";
+    f << "#\n";
+    for (int p = 0; p < numPartitions; p++)
+        f << "# partition " << p << ": " << partitionSizes[p] << " modules, "
+          << opp_stringf("%.1f%%", 100.0 * partitionWeights[p] / totalWeight) << " of the events\n";
+    f << "# " << numCutEdges << " of " << edges.size() << " connections cut";
+    if (numCutEdges > 0)
+        f << ", smallest delay on a cut connection: " << lookahead << "s";
+    f << "\n#\n";
+
+    // modules in name and index order, so that vector elements can be merged into ranges
+    std::vector<int> order(nodes.size());
+    for (int i = 0; i < (int)order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&nodes](int a, int b) {
+        int cmp = strcmp(nodes[a]->getName(), nodes[b]->getName());
+        return cmp != 0 ? cmp < 0 : nodes[a]->getIndex() < nodes[b]->getIndex();
+    });
+    for (int k = 0; k < (int)order.size(); ) {
+        cModule *first = nodes[order[k]];
+        int partition = partitionOf[order[k]];
+        int lastIndex = first->getIndex();
+        k++;
+        while (first->isVector() && k < (int)order.size()) {
+            cModule *next = nodes[order[k]];
+            if (strcmp(next->getName(), first->getName()) != 0 || next->getIndex() != lastIndex+1 || partitionOf[order[k]] != partition)
+                break;
+            lastIndex = next->getIndex();
+            k++;
+        }
+        f << "*." << makeModulePattern(first, lastIndex) << ".partition-id = " << partition << "\n";
+    }
+    f.close();
+    if (f.fail())
+        throw cRuntimeError("Cannot write partitioning file '%s'", fname.c_str());
+
+    if (verbose)
+        out << "Partitioning into " << numPartitions << " partitions written to '" << fname << "', "
+            << numCutEdges << " connections cut" << std::endl;
+}
+
+std::vector<int> ModelPartitioner::computePartitioning(const std::vector<double>& nodeWeights, const std::vector<Edge>& edges, int numPartitions, double maxImbalance)
+{
+    int numNodes = nodeWeights.size();
+    if (numPartitions <= 1)
+        return std::vector<int>(numNodes, 0);
+
+    // contract edges that must not be cut, using union-find
+    std::vector<int> parent(numNodes);
+    for (int i = 0; i < numNodes; i++)
+        parent[i] = i;
+    auto find = [&parent](int i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (const Edge& e : edges)
+        if (std::isinf(e.cost))
+            parent[find(e.from)] = find(e.to);
+
+    std::vector<int> clusterOf(numNodes, -1);
+    std::vector<int> rootCluster(numNodes, -1);
+    std::vector<double> clusterWeights;
+    for (int i = 0; i < numNodes; i++) {
+        int root = find(i);
+        if (rootCluster[root] == -1) {
+            rootCluster[root] = clusterWeights.size();
+            clusterWeights.push_back(0);
+        }
+        clusterOf[i] = rootCluster[root];
+        clusterWeights[clusterOf[i]] += nodeWeights[i];
+    }
+    int numClusters = clusterWeights.size();
+    if (numClusters < numPartitions)
+        throw cRuntimeError("Cannot create %d partitions from %d modules (modules connected by zero-delay connections cannot be separated)", numPartitions, numClusters);
+
+    // adjacency lists of the clusters, with parallel edges merged
+    std::vector<std::map<int,double>> adjacencyMaps(numClusters);
+    for (const Edge& e : edges) {
+        int a = clusterOf[e.from], b = clusterOf[e.to];
+        if (a != b) {
+            adjacencyMaps[a][b] += e.cost;
+            adjacencyMaps[b][a] += e.cost;
+        }
+    }
+    std::vector<std::vector<std::pair<int,double>>> adjacency(numClusters);
+    for (int c = 0; c < numClusters; c++)
+        adjacency[c].assign(adjacencyMaps[c].begin(), adjacencyMaps[c].end());
+    adjacencyMaps.clear();
+
+    double totalWeight = 0;
+    for (double w : clusterWeights)
+        totalWeight += w;
+    double targetWeight = totalWeight / numPartitions;
+    double maxWeight = targetWeight * (1 + maxImbalance);
+
+    std::vector<int> partitionOf(numClusters, -1);
+    std::vector<double> partitionWeights(numPartitions, 0);
+    std::vector<int> partitionSizes(numPartitions, 0);
+    auto assign = [&](int c, int p) {
+        if (partitionOf[c] != -1) {
+            partitionWeights[partitionOf[c]] -= clusterWeights[c];
+            partitionSizes[partitionOf[c]]--;
+        }
+        partitionOf[c] = p;
+        partitionWeights[p] += clusterWeights[c];
+        partitionSizes[p]++;
+    };
+
+    // greedy graph growing: each partition (except the last one, which gets
+    // the rest) starts from a peripheral cluster, and grows by adding the
+    // cluster most strongly connected to it until it reaches the target weight
+    int numUnassigned = numClusters;
+    std::vector<double> connectivity(numClusters);
+    std::vector<int> queue;
+    for (int p = 0; p < numPartitions-1; p++) {
+        // find a pseudo-peripheral cluster: the one reached last by a BFS
+        int start = std::find(partitionOf.begin(), partitionOf.end(), -1) - partitionOf.begin();
+        std::vector<bool> visited(numClusters, false);
+        queue.assign(1, start);
+        visited[start] = true;
+        for (int head = 0; head < (int)queue.size(); head++)
+            for (auto& neighbour : adjacency[queue[head]])
+                if (partitionOf[neighbour.first] == -1 && !visited[neighbour.first]) {
+                    visited[neighbour.first] = true;
+                    queue.push_back(neighbour.first);
+                }
+        int c = queue.back();
+
+        std::fill(connectivity.begin(), connectivity.end(), 0.0);
+        std::set<std::pair<double,int>> frontier;  // (-connectivity, cluster)
+        while (true) {
+            assign(c, p);
+            numUnassigned--;
+            for (auto& neighbour : adjacency[c]) {
+                int n = neighbour.first;
+                if (partitionOf[n] != -1)
+                    continue;
+                frontier.erase(std::make_pair(-connectivity[n], n));
+                connectivity[n] += neighbour.second;
+                frontier.insert(std::make_pair(-connectivity[n], n));
+            }
+            if (partitionWeights[p] >= targetWeight || numUnassigned <= numPartitions-1-p)
+                break;
+            if (!frontier.empty()) {
+                c = frontier.begin()->second;
+                frontier.erase(frontier.begin());
+            }
+            else {
+                c = std::find(partitionOf.begin(), partitionOf.end(), -1) - partitionOf.begin();  // next connected component
+            }
+            // stop if adding the cluster would overshoot more than stopping here undershoots
+            if (partitionWeights[p] + clusterWeights[c] - targetWeight > targetWeight - partitionWeights[p])
+                break;
+        }
+    }
+    for (int c = 0; c < numClusters; c++)
+        if (partitionOf[c] == -1)
+            assign(c, numPartitions-1);
+
+    // refinement: move clusters to neighbouring partitions if that reduces
+    // the cut cost (or improves the balance at the same cost), without
+    // making the target partition overweight; clusters in an overweight
+    // partition are moved out even at the expense of the cut cost
+    std::vector<double> connectionToPartition(numPartitions);
+    for (int pass = 0; pass < MAX_REFINEMENT_PASSES; pass++) {
+        bool moved = false;
+        for (int c = 0; c < numClusters; c++) {
+            int a = partitionOf[c];
+            if (partitionSizes[a] == 1)
+                continue;  // don't leave a partition empty
+            bool overweight = partitionWeights[a] > maxWeight;
+            std::fill(connectionToPartition.begin(), connectionToPartition.end(), 0.0);
+            bool isBoundary = false;
+            for (auto& neighbour : adjacency[c]) {
+                connectionToPartition[partitionOf[neighbour.first]] += neighbour.second;
+                if (partitionOf[neighbour.first] != a)
+                    isBoundary = true;
+            }
+            if (!isBoundary && !overweight)
+                continue;
+
+            int best = -1;
+            double bestGain = 0;
+            for (int b = 0; b < numPartitions; b++) {
+                if (b == a)
+                    continue;
+                double newWeight = partitionWeights[b] + clusterWeights[c];
+                if (newWeight > maxWeight && !(overweight && newWeight < partitionWeights[a]))
+                    continue;
+                double gain = connectionToPartition[b] - connectionToPartition[a];
+                if (best == -1 || gain > bestGain || (gain == bestGain && partitionWeights[b] < partitionWeights[best])) {
+                    best = b;
+                    bestGain = gain;
+                }
+            }
+            if (best == -1)
+                continue;
+
+            double epsilon = 1e-9 * (connectionToPartition[a] + connectionToPartition[best]);
+            bool improvesCut = bestGain > epsilon;
+            bool improvesBalance = std::fabs(bestGain) <= epsilon && partitionWeights[best] + clusterWeights[c] < partitionWeights[a];
+            if (improvesCut || improvesBalance || overweight) {
+                assign(c, best);
+                moved = true;
+            }
+        }
+        if (!moved)
+            break;
+    }
+
+    // number partitions in the order of the nodes, for a stable output
+    std::vector<int> renumbering(numPartitions, -1);
+    int nextPartition = 0;
+    std::vector<int> result(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        int p = partitionOf[clusterOf[i]];
+        if (renumbering[p] == -1)
+            renumbering[p] = nextPartition++;
+        result[i] = renumbering[p];
+    }
+    return result;
+}
+
+}  // namespace envir
+}  // namespace omnetpp
+
@@ -0,0 +1,103 @@
+//==========================================================================
+//  MODELPARTITIONER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_MODELPARTITIONER_H
+#define __OMNETPP_ENVIR_MODELPARTITIONER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "omnetpp/clifecyclelistener.h"
+#include "envirdefs.h"
+
+namespace omnetpp {
+
+class cEvent;
+class cModule;
+
+namespace envir {
+
+/**
+ * Computes a partitioning for parallel simulation from a sequential
+ * profiling run, and writes it into an ini file fragment with
+ * `partition-id` settings.
+ *
+ * The graph being partitioned consists of the submodules of the network
+ * (i.e. the modules `partition-id` has to be specified for). Node weights
+ * are the number of events processed by the submodule and its descendants
+ * during the run. Edges are the connections between the submodules; the
+ * cost of cutting an edge is inversely proportional to the delay of the
+ * connection, because the smallest delay on a cut connection limits the
+ * lookahead. Connections with zero delay are never cut.
+ *
+ * The partitioning is computed with greedy graph growing, followed by
+ * Fiduccia-Mattheyses-style refinement passes that move modules between
+ * partitions as long as the cut cost decreases and the partition weights
+ * stay within the allowed imbalance.
+ *
+ * Note that only connections are considered; traffic exchanged via
+ * sendDirect() or method calls is invisible to the partitioner.
+ */
+class ENVIR_API ModelPartitioner : public cISimulationLifecycleListener
+{
+  public:
+    struct Edge
+    {
+        int from, to;  // node indices
+        double cost;   // cost of cutting the edge; infinity for edges that must not be cut
+    };
+
+  protected:
+    std::ostream& out;
+    bool verbose;
+    int numPartitions;
+    std::unordered_map<int,long> eventCounts;  // moduleId -> number of events, including those of descendants
+    std::unordered_map<int,int> topLevelIds;   // moduleId -> moduleId of the network's submodule containing it
+    long numEvents;
+
+  protected:
+    virtual int getTopLevelModuleId(int moduleId);
+    virtual void writePartitioning();
+
+  public:
+    /**
+     * Constructor. Progress messages are written to the given stream.
+     */
+    ModelPartitioner(std::ostream& out, bool verbose);
+
+    /**
+     * Records the event for the module it occurs in; to be called for
+     * every event.
+     */
+    virtual void simulationEvent(cEvent *event);
+
+    /**
+     * Writes the partitioning file at the end of the run.
+     */
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+
+    /**
+     * The partitioning algorithm. Returns the partition index for each node;
+     * maxImbalance is the allowed relative overweight of a partition
+     * compared to the average (e.g. 0.05).
+     */
+    static std::vector<int> computePartitioning(const std::vector<double>& nodeWeights, const std::vector<Edge>& edges, int numPartitions, double maxImbalance);
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+#endif
+
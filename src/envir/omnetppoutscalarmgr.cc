@@ -47,6 +47,7 @@ typedef std::map<std::string, std::string> StringMap;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_FILE;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_PRECISION;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_FILE_APPEND;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_ASYNC_WRITING;
 
 // per-scalar options
 extern omnetpp::cConfigOption *CFGID_SCALAR_RECORDING;
@@ -54,14 +55,20 @@ extern omnetpp::cConfigOption *CFGID_BIN_RECORDING;
 
 Register_Class(OmnetppOutputScalarManager);
 
+#define ASYNC_MEMORY_LIMIT    (16*1024*1024)  // bytes; for results queued for the writer thread
+#define ASYNC_JOB_SIZE        256             // approximate memory used by a queued scalar result
+
 
 OmnetppOutputScalarManager::OmnetppOutputScalarManager()
 {
     initialized = false;
+    bool asyncWriting = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_SCALAR_ASYNC_WRITING);
+    asyncWriter = asyncWriting ? new AsyncWriter(ASYNC_MEMORY_LIMIT) : nullptr;
 }
 
 OmnetppOutputScalarManager::~OmnetppOutputScalarManager()
 {
+    delete asyncWriter;
     closeFile();
 }
 
@@ -95,7 +102,16 @@ void OmnetppOutputScalarManager::startRun()
 void OmnetppOutputScalarManager::endRun()
 {
     initialized = false;
-    if (writer.isOpen()) {
+    if (asyncWriter) {
+        asyncWriter->submit([this]() {
+            if (writer.isOpen()) {
+                writer.endRecordingForRun();
+                closeFile();
+            }
+        }, 0);
+        asyncWriter->drain();  // so that the file is complete when the run is over
+    }
+    else if (writer.isOpen()) {
         writer.endRecordingForRun();
         closeFile();
     }
@@ -120,6 +136,18 @@ void OmnetppOutputScalarManager::writeRunData()
     writer.beginRecordingForRun(ResultFileUtils::getRunId().c_str(), ResultFileUtils::getRunAttributes(), ResultFileUtils::getIterationVariables(), ResultFileUtils::getParamAssignments());
 }
 
+void OmnetppOutputScalarManager::execute(AsyncWriter::Job&& job, size_t size)
+{
+    if (!asyncWriter)
+        job();
+    else {
+        asyncWriter->submit([this, job]() {
+            if (writer.isOpen())
+                job();
+        }, size);
+    }
+}
+
 void OmnetppOutputScalarManager::recordScalar(cComponent *component, const char *name, double value, opp_string_map *attributes)
 {
     if (!initialized) {
@@ -135,8 +163,13 @@ void OmnetppOutputScalarManager::recordScalar(cComponent *component, const char
 
     std::string componentFullPath = component->getFullPath();
     bool enabled = getEnvir()->getConfig()->getAsBool((componentFullPath+"."+name).c_str(), CFGID_SCALAR_RECORDING);
-    if (enabled)
-        writer.recordScalar(componentFullPath, name, value, convertMap(attributes));
+    if (enabled) {
+        std::string scalarName = name;
+        StringMap attrs = convertMap(attributes);
+        execute([=]() {
+            writer.recordScalar(componentFullPath, scalarName, value, attrs);
+        }, ASYNC_JOB_SIZE);
+    }
 }
 
 void OmnetppOutputScalarManager::recordStatistic(cComponent *component, const char *name, cStatistic *statistic, opp_string_map *attributes)
@@ -185,14 +218,23 @@ void OmnetppOutputScalarManager::recordStatistic(cComponent *component, const ch
                 for (int i = 0; i < n; i++)
                     bins.addBin(histogram->getBinEdge(i), histogram->getBinValue(i));
                 bins.addBin(histogram->getBinEdge(n), histogram->getOverflowSumWeights());
-                writer.recordHistogram(componentFullPath, name, stats, bins, convertMap(attributes));
+                std::string statisticName = name;
+                StringMap attrs = convertMap(attributes);
+                execute([=]() {
+                    writer.recordHistogram(componentFullPath, statisticName, stats, bins, attrs);
+                }, ASYNC_JOB_SIZE + (n+2) * 2 * sizeof(double));
                 savedAsHistogram = true;
             }
         }
     }
 
-    if (!savedAsHistogram)
-        writer.recordStatistic(componentFullPath, name, stats, convertMap(attributes));
+    if (!savedAsHistogram) {
+        std::string statisticName = name;
+        StringMap attrs = convertMap(attributes);
+        execute([=]() {
+            writer.recordStatistic(componentFullPath, statisticName, stats, attrs);
+        }, ASYNC_JOB_SIZE);
+    }
 }
 
 const char *OmnetppOutputScalarManager::getFileName() const
@@ -202,7 +244,14 @@ const char *OmnetppOutputScalarManager::getFileName() const
 
 void OmnetppOutputScalarManager::flush()
 {
-    if (writer.isOpen())
+    if (asyncWriter) {
+        asyncWriter->submit([this]() {
+            if (writer.isOpen())
+                writer.flush();
+        }, 0);
+        asyncWriter->drain();
+    }
+    else if (writer.isOpen())
         writer.flush();
 }
 
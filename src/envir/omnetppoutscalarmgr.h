@@ -22,12 +22,14 @@
 #include "omnetpp/envirext.h"
 #include "omnetpp/simutil.h"
 #include "envirdefs.h"
+#include "common/asyncwriter.h"
 #include "common/omnetppscalarfilewriter.h"
 #include "resultfileutils.h"
 
 namespace omnetpp {
 namespace envir {
 
+using omnetpp::common::AsyncWriter;
 using omnetpp::common::OmnetppScalarFileWriter;
 
 /**
@@ -41,13 +43,15 @@ class ENVIR_API OmnetppOutputScalarManager : public cIOutputScalarManager
     bool initialized;  // true after first call to initialize(), even if it failed
     std::string fname; // output file name
     OmnetppScalarFileWriter writer;
+    AsyncWriter *asyncWriter;  // non-nullptr if the writer runs in a background thread
 
   protected:
     void openFile();
     void closeFile();
     void writeRunData();
     void initialize();
-    bool isBad() {return initialized && !writer.isOpen();}
+    bool isBad() {return initialized && (asyncWriter ? asyncWriter->checkError() : !writer.isOpen());}
+    void execute(AsyncWriter::Job&& job, size_t size);
 
   public:
     /** @name Constructors, destructor */
@@ -43,6 +43,7 @@ Register_Class(OmnetppOutputVectorManager);
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE_APPEND;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE;
 extern omnetpp::cConfigOption *CFGID_OUTPUTVECTOR_MEMORY_LIMIT;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_ASYNC_WRITING;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_PRECISION;
 
 // per-vector options
@@ -57,11 +58,24 @@ OmnetppOutputVectorManager::OmnetppOutputVectorManager()
     initialized = false;
 
     size_t memoryLimit = (size_t) getEnvir()->getConfig()->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
-    writer.setOverallMemoryLimit(memoryLimit);
+    bool asyncWriting = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_ASYNC_WRITING);
+    if (!asyncWriting) {
+        asyncRecorder = nullptr;
+        writer.setOverallMemoryLimit(memoryLimit);
+    }
+    else {
+        // the memory limit is shared between the writer's buffers and the queue of the writer thread
+        writer.setOverallMemoryLimit(memoryLimit / 2);
+        asyncRecorder = new AsyncVectorRecorder(memoryLimit / 2, [this](void *handle, eventnumber_t eventNumber, int64_t t, int scaleExp, double value) {
+            if (writer.isOpen())
+                writer.recordInVector(handle, eventNumber, t, scaleExp, value);
+        });
+    }
 }
 
 OmnetppOutputVectorManager::~OmnetppOutputVectorManager()
 {
+    delete asyncRecorder;
 }
 
 void OmnetppOutputVectorManager::open()
@@ -117,6 +131,18 @@ void OmnetppOutputVectorManager::startRun()
 
 void OmnetppOutputVectorManager::endRun()
 {
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            if (writer.isOpen())
+                writer.endRecordingForRun();
+            close();
+        });
+        initialized = false;
+        vectors.clear();
+        asyncRecorder->drain();  // so that the file is complete when the run is over
+        return;
+    }
+
     if (writer.isOpen())
         writer.endRecordingForRun();
 
@@ -150,8 +176,15 @@ void OmnetppOutputVectorManager::deregisterVector(void *vectorhandle)
 {
     ASSERT(vectorhandle != nullptr);
     VectorData *vp = (VectorData *)vectorhandle;
-    if (writer.isOpen() && vp->handleInWriter != nullptr)
-        writer.deregisterVector(vp->handleInWriter);
+    if (vp->handleInWriter != nullptr) {
+        if (asyncRecorder)
+            asyncRecorder->deregisterVector(vp->handleInWriter, [this](void *handle) {
+                if (writer.isOpen() && handle != nullptr)
+                    writer.deregisterVector(handle);
+            });
+        else if (writer.isOpen())
+            writer.deregisterVector(vp->handleInWriter);
+    }
 
     Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
     vectors.erase(newEnd, vectors.end());
@@ -188,11 +221,23 @@ bool OmnetppOutputVectorManager::record(void *vectorhandle, simtime_t t, double
         std::string vectorFullPath = vp->moduleName.str() + "." + vp->vectorName.c_str();
         size_t bufferSize = (size_t) getEnvir()->getConfig()->getAsDouble(vectorFullPath.c_str(), CFGID_VECTOR_BUFFER);
         bool recordEventNumbers = getEnvir()->getConfig()->getAsBool(vectorFullPath.c_str(), CFGID_VECTOR_RECORD_EVENTNUMBERS);
-        vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize, recordEventNumbers);
+        if (asyncRecorder) {
+            std::string moduleName = vp->moduleName.c_str();
+            std::string vectorName = vp->vectorName.c_str();
+            StringMap attributes = convertMap(&vp->attributes);
+            vp->handleInWriter = asyncRecorder->registerVector([=]() {
+                return writer.registerVector(moduleName, vectorName, attributes, bufferSize, recordEventNumbers);
+            });
+        }
+        else
+            vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize, recordEventNumbers);
     }
 
     eventnumber_t eventNumber = getSimulation()->getEventNumber();
-    writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    if (asyncRecorder)
+        asyncRecorder->record(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    else
+        writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
     return true;
 }
 
@@ -203,7 +248,14 @@ const char *OmnetppOutputVectorManager::getFileName() const
 
 void OmnetppOutputVectorManager::flush()
 {
-    if (writer.isOpen())
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            if (writer.isOpen())
+                writer.flush();
+        });
+        asyncRecorder->drain();
+    }
+    else if (writer.isOpen())
         writer.flush();
 }
 
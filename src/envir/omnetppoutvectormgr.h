@@ -26,6 +26,7 @@
 #include "omnetpp/platdep/platdefs.h"
 #include "omnetpp/simtime_t.h"
 #include "intervals.h"
+#include "asyncvectorrecorder.h"
 #include "common/omnetppvectorfilewriter.h"
 
 namespace omnetpp {
@@ -56,6 +57,7 @@ class OmnetppOutputVectorManager : public cIOutputVectorManager
     std::string fname;
     OmnetppVectorFileWriter writer;
     Vectors vectors;         // registered output vectors
+    AsyncVectorRecorder *asyncRecorder;  // non-nullptr if the writer runs in a background thread
 
   protected:
     void open();
@@ -63,7 +65,7 @@ class OmnetppOutputVectorManager : public cIOutputVectorManager
     void writeRunData();
 
     virtual void initialize();
-    bool isBad() {return initialized && !writer.isOpen();}
+    bool isBad() {return initialized && (asyncRecorder ? asyncRecorder->checkError() : !writer.isOpen());}
 
   public:
     /** @name Constructors, destructor */
@@ -104,13 +104,15 @@ SectionBasedConfiguration::MatchableEntry::~MatchableEntry()
 SectionBasedConfiguration::SectionBasedConfiguration()
 {
     ini = nullptr;
+    ownsReader = true;
     activeRunNumber = 0;
 }
 
 SectionBasedConfiguration::~SectionBasedConfiguration()
 {
     clear();
-    delete ini;
+    if (ownsReader)
+        delete ini;
 }
 
 void SectionBasedConfiguration::setConfigurationReader(cConfigurationReader *ini)
@@ -149,6 +151,20 @@ void SectionBasedConfiguration::setCommandLineConfigOptions(const std::map<std::
     activateGlobalConfig();
 }
 
+SectionBasedConfiguration *SectionBasedConfiguration::createSharingReader() const
+{
+    ASSERT(ini != nullptr);
+    SectionBasedConfiguration *copy = new SectionBasedConfiguration();
+    copy->ini = ini;
+    copy->ownsReader = false;
+    copy->nullEntry.setBaseDirectory(ini->getDefaultBaseDirectory());
+    copy->cachedSectionChains.assign(ini->getNumSections(), std::vector<int>());
+    for (const auto & e : commandLineOptions)
+        copy->commandLineOptions.push_back(Entry(copy->getPooledBaseDir(e.getBaseDirectory()), e.getKey(), e.getValue()));
+    copy->activateGlobalConfig();
+    return copy;
+}
+
 void SectionBasedConfiguration::clear()
 {
     // note: this gets called between activateConfig() calls, so "ini" must NOT be nullptr'ed out here
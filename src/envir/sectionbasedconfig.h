@@ -126,6 +126,7 @@ class ENVIR_API SectionBasedConfiguration : public cConfigurationEx
   private:
     // input data
     cConfigurationReader *ini;
+    bool ownsReader;  // false if ini is shared with another object (see createSharingReader())
     std::vector<Entry> commandLineOptions;
 
     // section inheritance chains, computed from the input data
@@ -204,6 +205,16 @@ class ENVIR_API SectionBasedConfiguration : public cConfigurationEx
      */
     virtual void setCommandLineConfigOptions(const std::map<std::string,std::string>& options, const char *baseDir);
 
+    /**
+     * Creates a new configuration object that shares the configuration reader
+     * (i.e. the parsed ini file contents) with this one, and has the same
+     * command-line options. The new object can activate configurations and
+     * runs independently of this one, which allows runs to be executed
+     * concurrently in separate threads. The reader is not owned by the new
+     * object, so this object must outlive it.
+     */
+    virtual SectionBasedConfiguration *createSharingReader() const;
+
     /** @name Methods that implement the cConfiguration(Ex) interface. */
     //@{
     virtual void initializeFrom(cConfiguration *bootConfig) override;
@@ -43,6 +43,7 @@ typedef std::map<std::string, std::string> StringMap;
 // global options
 extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_FILE;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_FILE_APPEND;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_SCALAR_ASYNC_WRITING;
 
 Register_GlobalConfigOption(CFGID_OUTPUT_SCALAR_DB_COMMIT_FREQ, "output-scalar-db-commit-freq", CFG_INT, DEFAULT_COMMIT_FREQ, "Used with SqliteOutputScalarManager: COMMIT every n INSERTs.");
 
@@ -52,13 +53,19 @@ extern omnetpp::cConfigOption *CFGID_BIN_RECORDING;
 
 Register_Class(SqliteOutputScalarManager);
 
+#define ASYNC_MEMORY_LIMIT    (16*1024*1024)  // bytes; for results queued for the writer thread
+#define ASYNC_JOB_SIZE        256             // approximate memory used by a queued scalar result
+
 SqliteOutputScalarManager::SqliteOutputScalarManager()
 {
     initialized = false;
+    bool asyncWriting = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_SCALAR_ASYNC_WRITING);
+    asyncWriter = asyncWriting ? new AsyncWriter(ASYNC_MEMORY_LIMIT) : nullptr;
 }
 
 SqliteOutputScalarManager::~SqliteOutputScalarManager()
 {
+    delete asyncWriter;
 }
 
 void SqliteOutputScalarManager::openDb()
@@ -88,8 +95,13 @@ void SqliteOutputScalarManager::startRun()
 
 void SqliteOutputScalarManager::endRun()
 {
-    closeDb();
     initialized = false;
+    if (asyncWriter) {
+        asyncWriter->submit([this]() { closeDb(); }, 0);
+        asyncWriter->drain();  // so that the file is complete when the run is over
+    }
+    else
+        closeDb();
 }
 
 void SqliteOutputScalarManager::initialize()
@@ -145,6 +157,18 @@ void SqliteOutputScalarManager::recordNumericIterationVariableAsScalar(const cha
     }
 }
 
+void SqliteOutputScalarManager::execute(AsyncWriter::Job&& job, size_t size)
+{
+    if (!asyncWriter)
+        job();
+    else {
+        asyncWriter->submit([this, job]() {
+            if (writer.isOpen())
+                job();
+        }, size);
+    }
+}
+
 void SqliteOutputScalarManager::recordScalar(cComponent *component, const char *name, double value, opp_string_map *attributes)
 {
     if (!initialized) {
@@ -160,8 +184,13 @@ void SqliteOutputScalarManager::recordScalar(cComponent *component, const char *
 
     std::string componentFullPath = component->getFullPath();
     bool enabled = getEnvir()->getConfig()->getAsBool((componentFullPath+"."+name).c_str(), CFGID_SCALAR_RECORDING);
-    if (enabled)
-        writer.recordScalar(componentFullPath, name, value, convertMap(attributes));
+    if (enabled) {
+        std::string scalarName = name;
+        StringMap attrs = convertMap(attributes);
+        execute([=]() {
+            writer.recordScalar(componentFullPath, scalarName, value, attrs);
+        }, ASYNC_JOB_SIZE);
+    }
 }
 
 void SqliteOutputScalarManager::recordStatistic(cComponent *component, const char *name, cStatistic *statistic, opp_string_map *attributes)
@@ -210,14 +239,23 @@ void SqliteOutputScalarManager::recordStatistic(cComponent *component, const cha
                 for (int i = 0; i < n; i++)
                     bins.addBin(histogram->getBinEdge(i), histogram->getBinValue(i));
                 bins.addBin(histogram->getBinEdge(n), histogram->getOverflowSumWeights());
-                writer.recordHistogram(componentFullPath, name, stats, bins, convertMap(attributes));
+                std::string statisticName = name;
+                StringMap attrs = convertMap(attributes);
+                execute([=]() {
+                    writer.recordHistogram(componentFullPath, statisticName, stats, bins, attrs);
+                }, ASYNC_JOB_SIZE + (n+2) * 2 * sizeof(double));
                 savedAsHistogram = true;
             }
         }
     }
 
-    if (!savedAsHistogram)
-        writer.recordStatistic(componentFullPath, name, stats, convertMap(attributes));
+    if (!savedAsHistogram) {
+        std::string statisticName = name;
+        StringMap attrs = convertMap(attributes);
+        execute([=]() {
+            writer.recordStatistic(componentFullPath, statisticName, stats, attrs);
+        }, ASYNC_JOB_SIZE);
+    }
 }
 
 const char *SqliteOutputScalarManager::getFileName() const
@@ -227,7 +265,15 @@ const char *SqliteOutputScalarManager::getFileName() const
 
 void SqliteOutputScalarManager::flush()
 {
-    writer.flush();
+    if (asyncWriter) {
+        asyncWriter->submit([this]() {
+            if (writer.isOpen())
+                writer.flush();
+        }, 0);
+        asyncWriter->drain();
+    }
+    else
+        writer.flush();
 }
 
 }  // namespace envir
@@ -21,12 +21,14 @@
 #include "omnetpp/envirext.h"
 #include "omnetpp/simutil.h"
 #include "envir/envirdefs.h"
+#include "common/asyncwriter.h"
 #include "common/sqlitescalarfilewriter.h"
 #include "resultfileutils.h"
 
 namespace omnetpp {
 namespace envir {
 
+using omnetpp::common::AsyncWriter;
 using omnetpp::common::SqliteScalarFileWriter;
 
 /**
@@ -40,6 +42,7 @@ class SqliteOutputScalarManager : public cIOutputScalarManager
     bool initialized;    // true after first call to initialize(), even if it failed
     std::string fname;
     SqliteScalarFileWriter writer;
+    AsyncWriter *asyncWriter;  // non-nullptr if the writer runs in a background thread
 
   protected:
     void openDb();
@@ -47,7 +50,8 @@ class SqliteOutputScalarManager : public cIOutputScalarManager
     void writeRunData();
     virtual void initialize();
     virtual void recordNumericIterationVariableAsScalar(const char *name, const char *value); // i.e. write *if* numeric
-    bool isBad() {return initialized && !writer.isOpen();}
+    bool isBad() {return initialized && (asyncWriter ? asyncWriter->checkError() : !writer.isOpen());}
+    void execute(AsyncWriter::Job&& job, size_t size);
 
   public:
     /** @name Constructors, destructor */
@@ -44,6 +44,7 @@ Register_Class(SqliteOutputVectorManager);
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE_APPEND;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE;
 extern omnetpp::cConfigOption *CFGID_OUTPUTVECTOR_MEMORY_LIMIT;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_ASYNC_WRITING;
 
 // per-vector options
 extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING;
@@ -51,6 +52,8 @@ extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING_INTERVALS;
 extern omnetpp::cConfigOption *CFGID_VECTOR_BUFFER;
 
 Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_INDEXING, "output-vector-db-indexing", CFG_CUSTOM, "skip", "Whether and when to add an index to the 'vectordata' table in SQLite output vector files. Possible values: skip, ahead, after");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_COMMIT_FREQ, "output-vector-db-commit-freq", CFG_INT, "0", "Used with SqliteOutputVectorManager: COMMIT after every n inserted samples. With the default 0, every write-out of the buffered samples is a separate transaction. Larger values speed up recording, especially with small vector buffers.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_DB_WAL, "output-vector-db-wal", CFG_BOOL, "false", "Used with SqliteOutputVectorManager: Use write-ahead logging (WAL) while the output vector file is being written. This makes commits cheaper, and allows other processes to read the file during the simulation. The file is switched back to rollback journaling when it is closed.");
 
 //TODO move out table creation code into a common file!
 /*
@@ -68,7 +71,19 @@ SqliteOutputVectorManager::SqliteOutputVectorManager()
     //TODO why not read per-run?
 
     size_t memoryLimit = (size_t) getEnvir()->getConfig()->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
-    writer.setOverallMemoryLimit(memoryLimit);
+    bool asyncWriting = getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_ASYNC_WRITING);
+    if (!asyncWriting) {
+        asyncRecorder = nullptr;
+        writer.setOverallMemoryLimit(memoryLimit);
+    }
+    else {
+        // the memory limit is shared between the writer's buffers and the queue of the writer thread
+        writer.setOverallMemoryLimit(memoryLimit / 2);
+        asyncRecorder = new AsyncVectorRecorder(memoryLimit / 2, [this](void *handle, eventnumber_t eventNumber, int64_t t, int scaleExp, double value) {
+            if (writer.isOpen())
+                writer.recordInVector(handle, eventNumber, t, value);
+        });
+    }
 
     std::string indexModeStr = getEnvir()->getConfig()->getAsCustom(CFGID_OUTPUT_VECTOR_DB_INDEXING);
     if (indexModeStr == "skip")
@@ -80,10 +95,14 @@ SqliteOutputVectorManager::SqliteOutputVectorManager()
     else
         throw cRuntimeError("Invalid value '%s' for '%s', expecting 'skip', 'ahead' or 'after'",
                 indexModeStr.c_str(), CFGID_OUTPUT_VECTOR_DB_INDEXING->getName());
+
+    writer.setCommitFreq(getEnvir()->getConfig()->getAsInt(CFGID_OUTPUT_VECTOR_DB_COMMIT_FREQ));
+    writer.setWriteAheadLogging(getEnvir()->getConfig()->getAsBool(CFGID_OUTPUT_VECTOR_DB_WAL));
 }
 
 SqliteOutputVectorManager::~SqliteOutputVectorManager()
 {
+    delete asyncRecorder;
 }
 
 void SqliteOutputVectorManager::openDb()
@@ -134,6 +153,25 @@ void SqliteOutputVectorManager::startRun()
 }
 
 void SqliteOutputVectorManager::endRun()
+{
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            finishDb();
+            closeDb();
+        });
+        initialized = false;
+        vectors.clear();
+        asyncRecorder->drain();  // so that the file is complete when the run is over
+        return;
+    }
+
+    finishDb();
+    initialized = false;
+    vectors.clear();
+    closeDb();
+}
+
+void SqliteOutputVectorManager::finishDb()
 {
     if (writer.isOpen()) {
         writer.endRecordingForRun();
@@ -144,10 +182,6 @@ void SqliteOutputVectorManager::endRun()
             std::cout << "Indexing SQLite output vector file took about " << elapsedSecs << "s" << endl;
         }
     }
-
-    initialized = false;
-    vectors.clear();
-    closeDb();
 }
 
 void *SqliteOutputVectorManager::registerVector(const char *modulename, const char *vectorname)
@@ -176,8 +210,15 @@ void SqliteOutputVectorManager::deregisterVector(void *vectorhandle)
 {
     ASSERT(vectorhandle != nullptr);
     VectorData *vp = (VectorData *)vectorhandle;
-    if (writer.isOpen() && vp->handleInWriter != nullptr)
-        writer.deregisterVector(vp->handleInWriter);
+    if (vp->handleInWriter != nullptr) {
+        if (asyncRecorder)
+            asyncRecorder->deregisterVector(vp->handleInWriter, [this](void *handle) {
+                if (writer.isOpen() && handle != nullptr)
+                    writer.deregisterVector(handle);
+            });
+        else if (writer.isOpen())
+            writer.deregisterVector(vp->handleInWriter);
+    }
 
     Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
     vectors.erase(newEnd, vectors.end());
@@ -207,14 +248,29 @@ bool SqliteOutputVectorManager::record(void *vectorhandle, simtime_t t, double v
         initialize();
     }
 
+    if (isBad())
+        return false;
+
     if (vp->handleInWriter == nullptr) {
         std::string vectorFullPath = vp->moduleName.str() + "." + vp->vectorName.c_str();
         size_t bufferSize = (size_t) getEnvir()->getConfig()->getAsDouble(vectorFullPath.c_str(), CFGID_VECTOR_BUFFER);
-        vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize);
+        if (asyncRecorder) {
+            std::string moduleName = vp->moduleName.c_str();
+            std::string vectorName = vp->vectorName.c_str();
+            StringMap attributes = convertMap(&vp->attributes);
+            vp->handleInWriter = asyncRecorder->registerVector([=]() {
+                return writer.registerVector(moduleName, vectorName, attributes, bufferSize);
+            });
+        }
+        else
+            vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize);
     }
 
     eventnumber_t eventNumber = getSimulation()->getEventNumber();
-    writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), value);
+    if (asyncRecorder)
+        asyncRecorder->record(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    else
+        writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), value);
     return true;
 }
 
@@ -225,7 +281,15 @@ const char *SqliteOutputVectorManager::getFileName() const
 
 void SqliteOutputVectorManager::flush()
 {
-    writer.flush();
+    if (asyncRecorder) {
+        asyncRecorder->execute([this]() {
+            if (writer.isOpen())
+                writer.flush();
+        });
+        asyncRecorder->drain();
+    }
+    else
+        writer.flush();
 }
 
 }  // namespace envir
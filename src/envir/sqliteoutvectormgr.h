@@ -23,6 +23,7 @@
 #include "omnetpp/simutil.h"
 #include "envir/envirdefs.h"
 #include "envir/intervals.h"
+#include "envir/asyncvectorrecorder.h"
 #include "common/sqlitevectorfilewriter.h"
 #include "resultfileutils.h"
 
@@ -54,16 +55,18 @@ class SqliteOutputVectorManager : public cIOutputVectorManager
     std::string fname;
     SqliteVectorFileWriter writer;
     Vectors vectors;         // registered output vectors
+    AsyncVectorRecorder *asyncRecorder;  // non-nullptr if the writer runs in a background thread
 
     enum IndexingMode { INDEX_AHEAD, INDEX_AFTER, INDEX_NONE } indexingMode;
 
   protected:
     void openDb();
     void closeDb();
+    void finishDb();
     void writeRunData();
 
     virtual void initialize();
-    bool isBad() {return initialized && !writer.isOpen();}
+    bool isBad() {return initialized && (asyncRecorder ? asyncRecorder->checkError() : !writer.isOpen());}
 
   public:
     /** @name Constructors, destructor */
@@ -113,7 +113,7 @@ int setupUserInterface(int argc, char *argv[])
 
         // args
         ArgList args;
-        args.parse(argc, argv, "h?f:u:l:c:r:n:p:x:X:q:agGvwsm");
+        args.parse(argc, argv, "h?f:u:l:c:r:n:p:x:X:q:j:agGvwsm");
 
         useStderr = !args.optionGiven('m');
 
@@ -314,6 +314,10 @@ void MsgAnalyzer::analyzeClassOrStruct(ClassInfo& classInfo, const std::string&
         errors->addError(classInfo.astNode, "class name may only contain '::' when generating descriptor for an existing class");
 
     classInfo.customize = getPropertyAsBool(classInfo.props, PROP_CUSTOMIZE, false);
+    classInfo.pooled = getPropertyAsBool(classInfo.props, PROP_POOLED, false);
+    classInfo.copyOnWrite = getPropertyAsBool(classInfo.props, PROP_COPYONWRITE, false);
+    if (classInfo.copyOnWrite && !classInfo.isClass)
+        errors->addError(classInfo.astNode, "@copyOnWrite is not supported for structs");
 
     if (classInfo.customize) {
         classInfo.className = classInfo.name + "_Base";
@@ -444,6 +448,10 @@ void MsgAnalyzer::analyzeField(ClassInfo& classInfo, FieldInfo *field, const std
     if (hasProperty(field->props, PROP_OWNED) && !field->isPointer)
         errors->addWarning(field->astNode, "ignoring @owned property for non-pointer field '%s'", field->name.c_str());
 
+    // shared field storage cannot express per-object ownership
+    if (classInfo.copyOnWrite && (field->isOwnedPointer || (!field->isPointer && field->iscNamedObject)))
+        errors->addError(field->astNode, "field '%s' in '%s': @copyOnWrite classes cannot have owned pointer or cNamedObject fields", field->name.c_str(), classInfo.name.c_str());
+
     // fromstring/tostring
     field->fromString = fieldClassInfo.fromString;
     field->toString = fieldClassInfo.toString;
@@ -518,6 +526,7 @@ void MsgAnalyzer::analyzeField(ClassInfo& classInfo, FieldInfo *field, const std
     }
 
     field->sizeVar = field->arraySize.empty() ? (field->name + "_arraysize") : field->arraySize;
+    field->storagePrefix = classInfo.copyOnWrite ? "fields->" : "";
     std::string sizetypeprop = getProperty(field->props, PROP_SIZETYPE);
     field->sizeType = !sizetypeprop.empty() ? sizetypeprop : "size_t";
 
@@ -682,6 +691,8 @@ MsgAnalyzer::ClassInfo MsgAnalyzer::extractClassInfoFromEnum(EnumElement *enumEl
     classInfo.generateSettersInDescriptor = false;
 
     classInfo.customize = false;
+    classInfo.pooled = false;
+    classInfo.copyOnWrite = false;
 
     classInfo.className = classInfo.name;
     classInfo.realClass = classInfo.name;
@@ -241,7 +241,7 @@ const char *DESCRIPTOR_BOILERPLATE =
         "}\n"
         "\n";
 
-void MsgCodeGenerator::generateProlog(const std::string& msgFileName, const std::string& firstNamespace, const std::string& exportDef)
+void MsgCodeGenerator::generateProlog(const std::string& msgFileName, const std::string& firstNamespace, const std::string& exportDef, bool usesCopyOnWrite)
 {
     // make header guard using the file name
     std::string hfilenamewithoutdir = hFilename;
@@ -268,6 +268,8 @@ void MsgCodeGenerator::generateProlog(const std::string& msgFileName, const std:
     H << "#endif\n";
     H << "#ifndef " << headerGuard << "\n";
     H << "#define " << headerGuard << "\n\n";
+    if (usesCopyOnWrite)
+        H << "#include <atomic>\n";  // for the share count of the fields block
     H << "#include <omnetpp.h>\n";
     H << "\n";
     H << "// " PROGRAM " version check\n";
@@ -417,20 +419,39 @@ void MsgCodeGenerator::generateClassDecl(const ClassInfo& classInfo, const std::
 
     H << "\n{\n";
     H << "  protected:\n";
+    std::string indent = "    ";
+    if (classInfo.copyOnWrite) {
+        H << "    // data members; shared between copies until one of them is modified\n";
+        H << "    struct Fields {\n";
+        H << "        std::atomic<int> shareCount{0};  // number of objects sharing this instance, minus one; atomic because copies may be deleted on different threads\n";
+        indent = "        ";
+    }
     for (const FieldInfo& field : classInfo.fieldList) {
         if (field.isAbstract)
             continue;
         if (field.isFixedArray) {
-            H << "    " << field.dataType << " " << field.var << "[" << field.arraySize << "]" << (field.value == "0" ? " = {0}" : "") << ";\n"; // note: C++ has no syntax for filling a full array with a (nonzero) value in an expression
+            H << indent << field.dataType << " " << field.var << "[" << field.arraySize << "]" << (field.value == "0" ? " = {0}" : "") << ";\n"; // note: C++ has no syntax for filling a full array with a (nonzero) value in an expression
         }
         else if (field.isDynamicArray) {
-            H << "    " << field.dataType << " *" << field.var << " = nullptr;\n";
-            H << "    " << field.sizeType << " " << field.sizeVar << " = 0;\n";
+            H << indent << field.dataType << " *" << field.var << " = nullptr;\n";
+            H << indent << field.sizeType << " " << field.sizeVar << " = 0;\n";
         }
         else {
-            H << "    " << field.dataType << " " << field.var << (field.value.empty() ? "" : str(" = ") + field.value) << ";\n";
+            H << indent << field.dataType << " " << field.var << (field.value.empty() ? "" : str(" = ") + field.value) << ";\n";
         }
     }
+    if (classInfo.copyOnWrite) {
+        H << "        Fields() {}\n";
+        H << "        Fields(const Fields& other);\n";
+        H << "        ~Fields();\n";
+        H << "        Fields& operator=(const Fields& other) = delete;\n";
+        H << "    };\n";
+        H << "    Fields *fields = nullptr;\n";
+        H << "\n";
+        H << "    // to be called before modifying fields: replaces a shared Fields instance with a private copy\n";
+        H << "    void makeFieldsPrivate() {if (fields->shareCount.load(std::memory_order_acquire) > 0) {Fields *copy = new Fields(*fields); releaseFields(fields); fields = copy;}}\n";
+        H << "    static void releaseFields(Fields *fields) {if (fields->shareCount.fetch_sub(1, std::memory_order_acq_rel) == 0) delete fields;}\n";
+    }
     H << "\n";
     H << "  private:\n";
     H << "    void copy(const " << classInfo.className << "& other);\n\n";
@@ -473,8 +494,14 @@ void MsgCodeGenerator::generateClassDecl(const ClassInfo& classInfo, const std::
         else
             H << "{return new " << classInfo.className << "(*this);}\n";
     }
+    if (classInfo.pooled) {
+        H << "    static void *operator new(size_t size) {return omnetpp::cMemoryPool::allocate(size);}\n";
+        H << "    static void operator delete(void *p, size_t size) {omnetpp::cMemoryPool::deallocate(p, size);}\n";
+    }
     std::string maybe_override = classInfo.iscObject ? " override" : "";
     std::string maybe_handleChange = classInfo.beforeChange.empty() ? "" : (classInfo.beforeChange + ";");
+    if (classInfo.copyOnWrite)
+        maybe_handleChange += "makeFieldsPrivate();";
     if (!classInfo.str.empty())
         H << "    virtual std::string str() const" << maybe_override << ";\n";
     H << "    virtual void parsimPack(omnetpp::cCommBuffer *b) const" << maybe_override << ";\n";
@@ -529,22 +556,29 @@ void MsgCodeGenerator::generateClassDecl(const ClassInfo& classInfo, const std::
 
 inline std::string var(const MsgTypeTable::FieldInfo& field)
 {
-    return str("this->") + field.var;
+    return str("this->") + field.storagePrefix + field.var;
 }
 
 inline std::string varElem(const MsgTypeTable::FieldInfo& field)
 {
-    return str("this->") + field.var + (field.isArray ? "[i]" : "");
+    return str("this->") + field.storagePrefix + field.var + (field.isArray ? "[i]" : "");
+}
+
+inline std::string sizeVar(const MsgTypeTable::FieldInfo& field)
+{
+    return field.isDynamicArray ? field.storagePrefix + field.sizeVar : field.sizeVar;
 }
 
 inline std::string forEachIndex(const MsgTypeTable::FieldInfo& field)
 {
-    return str("    for (") + field.sizeType + " i = 0; i < " + field.sizeVar + "; i++)";
+    return str("    for (") + field.sizeType + " i = 0; i < " + sizeVar(field) + "; i++)";
 }
 
 void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
 {
     std::string maybe_handleChange_line = classInfo.beforeChange.empty() ? "" : (str("    ") + classInfo.beforeChange + ";\n");
+    if (classInfo.copyOnWrite)
+        maybe_handleChange_line += "    makeFieldsPrivate();\n";
 
     if (!classInfo.customize && classInfo.iscObject)
         CC << "Register_Class(" << classInfo.className << ")\n\n";
@@ -558,6 +592,8 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
         CC << " : ::" << classInfo.baseClass << baseArgs;
     CC << "\n";
     CC << "{\n";
+    if (classInfo.copyOnWrite)
+        CC << "    this->fields = new Fields();\n";
     for (const auto& baseclassField : classInfo.baseclassFieldlist)
         CC << "    this->" << baseclassField.setter << "(" << baseclassField.value << ");\n";
     if (!classInfo.baseclassFieldlist.empty() && !classInfo.fieldList.empty())
@@ -567,7 +603,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             continue;
 
         if (field.isFixedArray && !field.value.empty() && field.value != "0")
-            CC << "    std::fill(" << var(field) << ", " << var(field) << " + " << field.sizeVar << ", " << field.value << ");\n";
+            CC << "    std::fill(" << var(field) << ", " << var(field) << " + " << sizeVar(field) << ", " << field.value << ");\n";
 
         std::ostringstream takeElem;
         if (field.iscOwnedObject) {
@@ -593,7 +629,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
         if (field.isAbstract)
             continue;
         if (field.isFixedArray && field.isOwnedPointer)
-            CC << "    std::fill(" << var(field) << ", " << var(field) << " + " << field.sizeVar << ", nullptr);\n";
+            CC << "    std::fill(" << var(field) << ", " << var(field) << " + " << sizeVar(field) << ", nullptr);\n";
         if (!field.isArray && !field.isPointer && field.iscOwnedObject)
             CC << "    take(&" << varElem(field) << ");\n";
         if (field.isFixedArray && !field.isPointer && field.iscOwnedObject) {
@@ -607,8 +643,11 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
     // destructor:
     CC << "" << classInfo.className << "::~" << classInfo.className << "()\n";
     CC << "{\n";
+    if (classInfo.copyOnWrite) {
+        CC << "    releaseFields(this->fields);\n";
+    }
     for (const auto& field : classInfo.fieldList) {
-        if (field.isAbstract)
+        if (field.isAbstract || classInfo.copyOnWrite)
             continue;
         std::ostringstream releaseElem;
         if (field.isOwnedPointer && field.iscOwnedObject)
@@ -642,8 +681,14 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
     // copy function:
     CC << "void " << classInfo.className << "::copy(const " << classInfo.className << "& other)\n";
     CC << "{\n";
+    if (classInfo.copyOnWrite) {
+        CC << "    other.fields->shareCount.fetch_add(1, std::memory_order_relaxed);\n";
+        CC << "    if (this->fields != nullptr)\n";
+        CC << "        releaseFields(this->fields);\n";
+        CC << "    this->fields = other.fields;\n";
+    }
     for (const auto& field : classInfo.fieldList) {
-        if (field.isAbstract)
+        if (field.isAbstract || classInfo.copyOnWrite)
             continue;
         if (!field.isPointer && field.isConst)
             continue;
@@ -666,8 +711,8 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
 
         // allocate new dynamic array
         if (field.isDynamicArray) {
-            CC << "    " << var(field) << " = (other." << field.sizeVar << "==0) ? nullptr : new " << field.dataType << "[other." << field.sizeVar << "];\n";
-            CC << "    " << field.sizeVar << " = other." << field.sizeVar << ";\n";
+            CC << "    " << var(field) << " = (other." << sizeVar(field) << "==0) ? nullptr : new " << field.dataType << "[other." << sizeVar(field) << "];\n";
+            CC << "    " << sizeVar(field) << " = other." << sizeVar(field) << ";\n";
         }
 
         // copy new content
@@ -706,6 +751,9 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
     }
     CC << "}\n\n";
 
+    if (classInfo.copyOnWrite)
+        generateCopyOnWriteFieldsImpl(classInfo);
+
     if (!classInfo.str.empty()) {
         CC << "std::string " << classInfo.className << "::str() const\n";
         CC << "{\n";
@@ -738,8 +786,8 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
         else {
             if (field.isArray) {
                 if (field.isDynamicArray)
-                    CC << "    b->pack(" << field.sizeVar << ");\n";
-                CC << "    doParsimArrayPacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                    CC << "    b->pack(" << sizeVar(field) << ");\n";
+                CC << "    doParsimArrayPacking(b," << var(field) << "," << sizeVar(field) << ");\n";
             }
             else {
                 CC << "    doParsimPacking(b," << var(field) << ");\n";
@@ -759,6 +807,8 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "    doParsimUnpacking(b,(::" << classInfo.baseClass << "&)*this);\n";  // this would do for cOwnedObject too, but the other is nicer
         }
     }
+    if (classInfo.copyOnWrite)
+        CC << "    makeFieldsPrivate();\n";
     for (const auto& field : classInfo.fieldList) {
         if (field.nopack)
             continue; // @nopack specified
@@ -772,12 +822,12 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
                 }
                 else {
                     CC << "    delete [] " << var(field) << ";\n";
-                    CC << "    b->unpack(" << field.sizeVar << ");\n";
-                    CC << "    if (" << field.sizeVar << " == 0) {\n";
+                    CC << "    b->unpack(" << sizeVar(field) << ");\n";
+                    CC << "    if (" << sizeVar(field) << " == 0) {\n";
                     CC << "        " << var(field) << " = nullptr;\n";
                     CC << "    } else {\n";
-                    CC << "        " << var(field) << " = new " << field.dataType << "[" << field.sizeVar << "];\n";
-                    CC << "        doParsimArrayUnpacking(b," << var(field) << "," << field.sizeVar << ");\n";
+                    CC << "        " << var(field) << " = new " << field.dataType << "[" << sizeVar(field) << "];\n";
+                    CC << "        doParsimArrayUnpacking(b," << var(field) << "," << sizeVar(field) << ");\n";
                     CC << "    }\n";
                 }
             }
@@ -795,20 +845,20 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
         std::string idx = (field.isArray) ? "[k]" : "";
         std::string idxarg = (field.isArray) ? (field.sizeType + " k") : std::string("");
         std::string idxarg2 = (field.isArray) ? (idxarg + ", ") : std::string("");
-        std::string indexedVar = str("this->") + field.var + idx;
+        std::string indexedVar = var(field) + idx;
 
         // getters:
         if (field.isArray) {
             CC << "" << field.sizeType << " " << classInfo.className << "::" << field.sizeGetter << "() const\n";
             CC << "{\n";
-            CC << "    return " << field.sizeVar << ";\n";
+            CC << "    return " << sizeVar(field) << ";\n";
             CC << "}\n\n";
         }
 
         CC << field.returnType << " " << classInfo.className << "::" << field.getter << "(" << idxarg << ")" << " const\n";
         CC << "{\n";
         if (field.isArray)
-            CC << "    if (k >= " << field.sizeVar << ") throw omnetpp::cRuntimeError(\"Array of size " << field.sizeVar << " indexed by %lu\", (unsigned long)k);\n";
+            CC << "    if (k >= " << sizeVar(field) << ") throw omnetpp::cRuntimeError(\"Array of size " << field.sizeVar << " indexed by %lu\", (unsigned long)k);\n";
         CC << "    return " << makeFuncall(indexedVar, field.getterConversion) + ";\n";
         CC << "}\n\n";
 
@@ -818,7 +868,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "{\n";
             CC << maybe_handleChange_line;
             CC << "    " << field.dataType << " *" << field.var << "2 = (newSize==0) ? nullptr : new " << field.dataType << "[newSize];\n";
-            CC << "    " << field.sizeType << " minSize = " << field.sizeVar << " < newSize ? " << field.sizeVar << " : newSize;\n";
+            CC << "    " << field.sizeType << " minSize = " << sizeVar(field) << " < newSize ? " << sizeVar(field) << " : newSize;\n";
             CC << "    for (" << field.sizeType << " i = 0; i < minSize; i++)\n";
             CC << "        " << field.var << "2[i] = " << var(field) << "[i];\n";
             if (!field.value.empty()) {
@@ -828,15 +878,15 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             if (!field.isPointer && field.iscOwnedObject)
                 CC << forEachIndex(field) << "\n" << "        drop(&" << varElem(field) << ");\n";
             if (field.isPointer && field.isOwnedPointer) {
-                CC << "    for (" << field.sizeType << " i = newSize; i < " << field.sizeVar << "; i++)\n";
+                CC << "    for (" << field.sizeType << " i = newSize; i < " << sizeVar(field) << "; i++)\n";
                 if (field.iscOwnedObject)
-                    CC << "        dropAndDelete(" << field.var << "[i]);\n";
+                    CC << "        dropAndDelete(" << field.storagePrefix << field.var << "[i]);\n";
                 else
-                    CC << "        delete " << field.var << "[i];\n";
+                    CC << "        delete " << field.storagePrefix << field.var << "[i];\n";
             }
             CC << "    delete [] " << var(field) << ";\n";
             CC << "    " << var(field) << " = " << field.var << "2;\n";
-            CC << "    " << field.sizeVar << " = newSize;\n";
+            CC << "    " << sizeVar(field) << " = newSize;\n";
             if (!field.isPointer && field.iscOwnedObject)
                 CC << forEachIndex(field) << "\n" << "        take(&" << varElem(field) << ");\n";
             CC << "}\n\n";
@@ -847,7 +897,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "void " << classInfo.className << "::" << field.setter << "(" << idxarg2 << field.argType << " " << field.argName << ")\n";
             CC << "{\n";
             if (field.isArray) {
-                CC << "    if (k >= " << field.sizeVar << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
+                CC << "    if (k >= " << sizeVar(field) << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
             }
             CC << maybe_handleChange_line;
             if (field.isOwnedPointer) {
@@ -871,7 +921,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << field.mutableReturnType << " " << classInfo.className << "::" << field.dropper << "(" << idxarg << ")\n";
             CC << "{\n";
             if (field.isArray)
-                CC << "    if (k >= " << field.sizeVar << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
+                CC << "    if (k >= " << sizeVar(field) << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
             CC << maybe_handleChange_line;
             CC << "    " << field.mutableReturnType << " retval = ";
             if (field.isConst)
@@ -892,8 +942,8 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
             CC << "void " << classInfo.className << "::" << field.inserter << "(" << idxarg2 << field.argType << " " << field.argName << ")\n";
             CC << "{\n";
             CC << maybe_handleChange_line;
-            CC << "    if (k > " << field.sizeVar << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
-            CC << "    " << field.sizeType << " newSize = " << field.sizeVar << " + 1;\n";
+            CC << "    if (k > " << sizeVar(field) << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
+            CC << "    " << field.sizeType << " newSize = " << sizeVar(field) << " + 1;\n";
             CC << "    " << field.dataType << " *" << field.var << "2 = new " << field.dataType << "[newSize];\n";
             CC << "    " << field.sizeType << " i;\n";
             CC << "    for (i = 0; i < k; i++)\n";
@@ -909,14 +959,14 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
                 CC << forEachIndex(field) << "\n" << "        drop(&" << varElem(field) << ");\n";
             CC << "    delete [] " << var(field) << ";\n";
             CC << "    " << var(field) << " = " << field.var << "2;\n";
-            CC << "    " << field.sizeVar << " = newSize;\n";
+            CC << "    " << sizeVar(field) << " = newSize;\n";
             if (!field.isPointer && field.iscOwnedObject)
                 CC << forEachIndex(field) << "\n" << "        take(&" << varElem(field) << ");\n";
             CC << "}\n\n";
 
             CC << "void " << classInfo.className << "::" << field.inserter << "(" << field.argType << " " << field.argName << ")\n";
             CC << "{\n";
-            CC << "    " << field.inserter << "(" << field.sizeVar << ", " << field.argName << ");\n";
+            CC << "    " << field.inserter << "(" << sizeVar(field) << ", " << field.argName << ");\n";
             CC << "}\n\n";
         }
 
@@ -924,9 +974,9 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
         if (field.isDynamicArray) {
             CC << "void " << classInfo.className << "::" << field.eraser << "(" << idxarg << ")\n";
             CC << "{\n";
-            CC << "    if (k >= " << field.sizeVar << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
+            CC << "    if (k >= " << sizeVar(field) << ") throw omnetpp::cRuntimeError(\"Array of size " << field.arraySize << " indexed by %lu\", (unsigned long)k);\n";
             CC << maybe_handleChange_line;
-            CC << "    " << field.sizeType << " newSize = " << field.sizeVar << " - 1;\n";
+            CC << "    " << field.sizeType << " newSize = " << sizeVar(field) << " - 1;\n";
             CC << "    " << field.dataType << " *" << field.var << "2 = (newSize == 0) ? nullptr : new " << field.dataType << "[newSize];\n";
             CC << "    " << field.sizeType << " i;\n";
             CC << "    for (i = 0; i < k; i++)\n";
@@ -945,7 +995,7 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
 
             CC << "    delete [] " << var(field) << ";\n";
             CC << "    " << var(field) << " = " << field.var << "2;\n";
-            CC << "    " << field.sizeVar << " = newSize;\n";
+            CC << "    " << sizeVar(field) << " = newSize;\n";
             if (!field.isPointer && field.iscOwnedObject)
                 CC << forEachIndex(field) << "\n" << "        take(&" << varElem(field) << ");\n";
             CC << "}\n\n";
@@ -953,10 +1003,66 @@ void MsgCodeGenerator::generateClassImpl(const ClassInfo& classInfo)
     }
 }
 
+void MsgCodeGenerator::generateCopyOnWriteFieldsImpl(const ClassInfo& classInfo)
+{
+    // note: fields that need per-object ownership handling are rejected by the analyzer
+    CC << classInfo.className << "::Fields::Fields(const Fields& other)\n";
+    CC << "{\n";
+    for (const auto& field : classInfo.fieldList) {
+        if (field.isAbstract)
+            continue;
+        if (!field.isPointer && field.isConst)
+            continue;
+        if (field.isDynamicArray) {
+            CC << "    this->" << field.var << " = (other." << field.sizeVar << "==0) ? nullptr : new " << field.dataType << "[other." << field.sizeVar << "];\n";
+            CC << "    this->" << field.sizeVar << " = other." << field.sizeVar << ";\n";
+        }
+        if (field.isArray) {
+            CC << "    for (" << field.sizeType << " i = 0; i < " << field.sizeVar << "; i++)\n";
+            CC << "        this->" << field.var << "[i] = other." << field.var << "[i];\n";
+        }
+        else {
+            CC << "    this->" << field.var << " = other." << field.var << ";\n";
+        }
+    }
+    CC << "}\n\n";
+
+    CC << classInfo.className << "::Fields::~Fields()\n";
+    CC << "{\n";
+    for (const auto& field : classInfo.fieldList)
+        if (!field.isAbstract && field.isDynamicArray)
+            CC << "    delete [] this->" << field.var << ";\n";
+    CC << "}\n\n";
+}
+
 void MsgCodeGenerator::generateStruct(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode)
 {
     generateStructDecl(classInfo, exportDef, extraCode);
-    generateStructImpl(classInfo);
+    generateStructImpl(classInfo, isPlainDataStruct(classInfo, extraCode));
+}
+
+bool MsgCodeGenerator::isPlainDataStruct(const ClassInfo& classInfo, const std::string& extraCode)
+{
+    // whether the struct only consists of fields of basic types, so that it
+    // can be packed for parallel simulation as a single block of memory
+    static const char *plainTypes[] = {
+        "bool", "char", "short", "int", "long", "unsigned char", "unsigned short", "unsigned int", "unsigned long",
+        "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t",
+        "float", "double", "omnetpp::simtime_t", nullptr
+    };
+    if (!classInfo.baseClass.empty() || !opp_trim(extraCode).empty() || classInfo.fieldList.empty())
+        return false;
+    for (const auto& field : classInfo.fieldList) {
+        if (field.isPointer || (field.isArray && !field.isFixedArray))
+            return false;
+        bool found = false;
+        for (const char **t = plainTypes; *t && !found; t++)
+            if (field.dataType == *t)
+                found = true;
+        if (!found)
+            return false;
+    }
+    return true;
 }
 
 void MsgCodeGenerator::generateStructDecl(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode)
@@ -989,7 +1095,7 @@ void MsgCodeGenerator::generateStructDecl(const ClassInfo& classInfo, const std:
     H << "inline void doParsimUnpacking(omnetpp::cCommBuffer *b, " << classInfo.realClass << "& obj) { " << "__doUnpacking(b, obj); }\n\n";
 }
 
-void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
+void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo, bool isPlainData)
 {
     // Constructor:
     CC << "" << classInfo.className << "::" << classInfo.className << "()\n";
@@ -1018,6 +1124,20 @@ void MsgCodeGenerator::generateStructImpl(const ClassInfo& classInfo)
     CC << "}\n\n";
 
     // doPacking/doUnpacking go to the global namespace
+    if (isPlainData) {
+        // only fields of basic types: pack the whole struct in one go
+        CC << "void __doPacking(omnetpp::cCommBuffer *b, const " << classInfo.className << "& a)\n";
+        CC << "{\n";
+        CC << "    b->packBytes(&a, sizeof(a));\n";
+        CC << "}\n\n";
+
+        CC << "void __doUnpacking(omnetpp::cCommBuffer *b, " << classInfo.className << "& a)\n";
+        CC << "{\n";
+        CC << "    b->unpackBytes(&a, sizeof(a));\n";
+        CC << "}\n\n";
+        return;
+    }
+
     CC << "void __doPacking(omnetpp::cCommBuffer *b, const " << classInfo.className << "& a)\n";
     CC << "{\n";
     if (!classInfo.baseClass.empty())
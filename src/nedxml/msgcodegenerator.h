@@ -60,14 +60,16 @@ class NEDXML_API MsgCodeGenerator
 
     void generateClassDecl(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode);
     void generateClassImpl(const ClassInfo& classInfo);
+    void generateCopyOnWriteFieldsImpl(const ClassInfo& classInfo);
     void generateStructDecl(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode);
-    void generateStructImpl(const ClassInfo& classInfo);
+    void generateStructImpl(const ClassInfo& classInfo, bool isPlainData);
+    bool isPlainDataStruct(const ClassInfo& classInfo, const std::string& extraCode);
 
   public:
     void openFiles(const char *hFile, const char *ccFile);
     void closeFiles();
     void deleteFiles();
-    void generateProlog(const std::string& msgFileName, const std::string& firstNamespace, const std::string& exportDef);
+    void generateProlog(const std::string& msgFileName, const std::string& firstNamespace, const std::string& exportDef, bool usesCopyOnWrite);
     void generateEpilog();
     void generateClass(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode="");
     void generateStruct(const ClassInfo& classInfo, const std::string& exportDef, const std::string& extraCode="");
@@ -36,6 +36,8 @@ static const char *BUILTIN_DEFINITIONS =
         R"ENDMARK(
         @property[property](type=any; usage=file; desc="For declaring properties");
         @property[customize](type=bool; usage=class; desc="Customize the class via inheritance. Generates base class <name>_Base");
+        @property[copyOnWrite](type=bool; usage=class; desc="Store the fields in a reference-counted block that is shared between copies (dup(), copy constructor, assignment) until one of them is modified");
+        @property[pooled](type=bool; usage=class; desc="Allocate instances of the class (and its subclasses) via cMemoryPool, a recycling allocator with per-thread free lists");
         @property[str](type=string; usage=class; desc="Expression to be returned from the generated str() method");
         @property[primitive](type=bool; usage=field,class; desc="Shortcut for @opaque @byValue @editable @subclassable(false) @supportsPtr(false)");
         @property[opaque](type=bool; usage=field,class; desc="Treats the field as atomic (non-compound) type, i.e. having no descriptor class. When specified on a class, it determines the default for fields of that type.");
@@ -320,7 +322,30 @@ void MsgCompiler::generateCode(MsgFileElement *fileElement)
     std::string currentNamespace = "";
     NamespaceElement *firstNSElem = fileElement->getFirstNamespaceChild();
     std::string firstNSName = firstNSElem ? firstNSElem->getName() : "";
-    codegen.generateProlog(fileElement->getFilename(), firstNSName, opts.exportDef);
+
+    // find out whether any generated class uses @copyOnWrite, which needs <atomic> in the header
+    bool usesCopyOnWrite = false;
+    for (ASTNode *child = fileElement->getFirstChild(); child; child = child->getNextSibling()) {
+        switch (child->getTagCode()) {
+            case MSG_NAMESPACE:
+                currentNamespace = check_and_cast<NamespaceElement *>(child)->getName();
+                break;
+            case MSG_STRUCT:
+            case MSG_CLASS:
+            case MSG_MESSAGE:
+            case MSG_PACKET: {
+                std::string qname = prefixWithNamespace(child->getAttribute(ATT_NAME), currentNamespace);
+                ClassInfo& classInfo = typeTable.getClassInfo(qname);
+                analyzer.ensureAnalyzed(classInfo);
+                if (classInfo.generateClass && classInfo.copyOnWrite)
+                    usesCopyOnWrite = true;
+                break;
+            }
+        }
+    }
+    currentNamespace = "";
+
+    codegen.generateProlog(fileElement->getFilename(), firstNSName, opts.exportDef, usesCopyOnWrite);
     std::map<std::string, std::string> classExtraCode;
 
     // generate forward declarations so that cyclic references compile; also collect classExtraCode blocks
@@ -102,6 +102,7 @@ class NEDXML_API MsgTypeTable
         std::string returnType; // getter C++ return type
         std::string mutableReturnType; // mutableGetter C++ return type
         std::string var;        // name of data member variable
+        std::string storagePrefix; // prefix for accessing the data member: "fields->" with @copyOnWrite, empty otherwise
         std::string argName;    // setter argument name
         std::string sizeVar;    // data member to store size of dynamic array
         std::string sizeType;   // type of array sizes and array indices
@@ -154,6 +155,8 @@ class NEDXML_API MsgTypeTable
         std::string extendsQName;      // fully qualified name of base type
         std::string extendsName;       // base type's name from MSG
         bool customize;                // from @customize
+        bool pooled;                   // from @pooled
+        bool copyOnWrite;              // from @copyOnWrite
         bool omitGetVerb;              // from @omitGetVerb
         bool isClass;                  // true=class, false=struct
         bool iscObject;                // whether type is subclassed from cObject
@@ -0,0 +1,79 @@
+//=========================================================================
+//  BINARYRESULTFILELOADER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <memory>
+#include "binaryvectorfile.h"
+#include "binaryresultfileloader.h"
+
+namespace omnetpp {
+namespace scave {
+
+ResultFile *BinaryResultFileLoader::loadFile(const char *fileName, const char *fileSystemFileName, bool reload)
+{
+    ResultFile *fileRef = nullptr;
+
+    try {
+        fileRef = resultFileManager->addFile(fileName, fileSystemFileName, ResultFile::FILETYPE_BINARY);
+
+        std::unique_ptr<VectorFileIndex> index(BinaryVectorFileReader(fileSystemFileName).readIndex());
+        if (index->run.runName.empty())
+            throw opp_runtime_error("Missing run declaration in binary vector file '%s'", fileSystemFileName);
+
+        Run *runRef = resultFileManager->getOrAddRun(index->run.runName);
+        FileRun *fileRunRef = resultFileManager->addFileRun(fileRef, runRef);
+
+        for (auto& pair : index->run.attributes) {
+            const StringMap& attributes = runRef->getAttributes();
+            StringMap::const_iterator oldPairRef = attributes.find(pair.first);
+            if (oldPairRef != attributes.end() && oldPairRef->second != pair.second)
+                throw opp_runtime_error("Value of run attribute '%s' conflicts with previously loaded value", pair.first.c_str());
+            runRef->setAttribute(pair.first, pair.second);
+        }
+        for (auto& pair : index->run.itervars) {
+            const StringMap& itervars = runRef->getIterationVariables();
+            StringMap::const_iterator oldPairRef = itervars.find(pair.first);
+            if (oldPairRef != itervars.end() && oldPairRef->second != pair.second)
+                throw opp_runtime_error("Value of iteration variable '%s' conflicts with previously loaded value", pair.first.c_str());
+            runRef->itervars[pair.first] = pair.second;
+        }
+        if (runRef->getParamAssignments().empty())
+            for (auto& pair : index->run.paramAssignments)
+                runRef->addParamAssignmentEntry(pair.first, pair.second);
+
+        for (int i = 0; i < index->getNumberOfVectors(); i++) {
+            const VectorData *vectorRef = index->getVectorAt(i);
+            int k = resultFileManager->addVector(fileRunRef, vectorRef->vectorId, vectorRef->moduleName.c_str(), vectorRef->name.c_str(), vectorRef->attributes, vectorRef->columns.c_str());
+            VectorResult& vec = fileRef->vectorResults.at(k);
+            vec.startEventNum = vectorRef->startEventNum;
+            vec.endEventNum = vectorRef->endEventNum;
+            vec.startTime = vectorRef->startTime;
+            vec.endTime = vectorRef->endTime;
+            vec.stat = vectorRef->stat;
+        }
+    }
+    catch (std::exception&) {
+        try {
+            if (fileRef)
+                resultFileManager->unloadFile(fileRef);
+        }
+        catch (...) {
+        }
+        throw;
+    }
+    return fileRef;
+}
+
+} // namespace scave
+}  // namespace omnetpp
+
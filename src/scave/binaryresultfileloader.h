@@ -0,0 +1,38 @@
+//=========================================================================
+//  BINARYRESULTFILELOADER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_BINARYRESULTFILELOADER_H
+#define __OMNETPP_SCAVE_BINARYRESULTFILELOADER_H
+
+#include "resultfilemanager.h"
+
+namespace omnetpp {
+namespace scave {
+
+/**
+ * Loads binary output vector files (see BinaryVectorFileReader) into
+ * the ResultFileManager. Only the index of the file is read.
+ */
+class SCAVE_API BinaryResultFileLoader : public IResultFileLoader
+{
+  public:
+    BinaryResultFileLoader(ResultFileManager* resultFileManagerPar) : IResultFileLoader(resultFileManagerPar) {}
+    virtual ResultFile *loadFile(const char *fileName, const char *fileSystemFileName=nullptr, bool reload=false) override;
+};
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
@@ -0,0 +1,244 @@
+//=========================================================================
+//  BINARYVECTORFILE.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <memory>
+#include "common/lzcompress.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "binaryvectorfile.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+typedef BinaryVectorFileFormat Format;
+
+bool BinaryVectorFileReader::isBinaryVectorFile(const char *fileName)
+{
+    bool retval = false;
+    FILE *f = fopen(fileName, "rb");
+    if (f != nullptr) {
+        char buff[sizeof(Format::FILE_MAGIC)];
+        if (fread(buff, sizeof(buff), 1, f) == 1)
+            retval = memcmp(buff, Format::FILE_MAGIC, sizeof(buff)) == 0;
+        fclose(f);
+    }
+    return retval;
+}
+
+BinaryVectorFileReader::BinaryVectorFileReader(const char *filename) : filename(filename)
+{
+    f = fopen(filename, "rb");
+    if (f == nullptr)
+        throw opp_runtime_error("Cannot open '%s' for read", filename);
+    opp_fseek(f, 0, SEEK_END);
+    fileSize = opp_ftell(f);
+}
+
+BinaryVectorFileReader::~BinaryVectorFileReader()
+{
+    fclose(f);
+}
+
+void BinaryVectorFileReader::error(const char *msg, int64_t offset)
+{
+    throw opp_runtime_error("Error reading binary vector file '%s' at offset %" PRId64 ": %s", filename.c_str(), offset, msg);
+}
+
+void BinaryVectorFileReader::readBytes(int64_t offset, size_t len, std::string& dest)
+{
+    dest.resize(len);
+    if (opp_fseek(f, offset, SEEK_SET) != 0 || fread(&dest[0], 1, len, f) != len)
+        error("Unexpected end of file", offset);
+}
+
+VectorFileIndex *BinaryVectorFileReader::readIndex()
+{
+    std::unique_ptr<VectorFileIndex> index(new VectorFileIndex());
+    index->vectorFileName = filename;
+
+    // check header
+    if (fileSize < Format::FILE_HEADER_SIZE)
+        error("File too short", 0);
+    readBytes(0, Format::FILE_HEADER_SIZE, buffer);
+    if (memcmp(buffer.data(), Format::FILE_MAGIC, sizeof(Format::FILE_MAGIC)) != 0)
+        error("Not a binary vector file", 0);
+    uint32_t version = Format::Reader(buffer.data() + sizeof(Format::FILE_MAGIC), 4).readUInt32();
+    if (version > Format::FILE_VERSION)
+        error("Unsupported file format version", sizeof(Format::FILE_MAGIC));
+
+    // look for the index section
+    int64_t indexOffset = -1;
+    if (fileSize >= Format::FILE_HEADER_SIZE + Format::TRAILER_SIZE) {
+        int64_t trailerOffset = fileSize - Format::TRAILER_SIZE;
+        readBytes(trailerOffset, Format::TRAILER_SIZE, buffer);
+        if (memcmp(buffer.data() + 8, Format::TRAILER_MAGIC, sizeof(Format::TRAILER_MAGIC)) == 0) {
+            indexOffset = Format::Reader(buffer.data(), 8).readUInt64();
+            if (indexOffset < Format::FILE_HEADER_SIZE || indexOffset > trailerOffset)
+                error("Invalid index offset in trailer", trailerOffset);
+        }
+    }
+
+    if (indexOffset != -1) {
+        // parse the index section
+        int64_t indexSize = fileSize - Format::TRAILER_SIZE - indexOffset;
+        readBytes(indexOffset, indexSize, buffer);
+        Format::Reader reader(buffer.data(), buffer.size());
+        while (!reader.atEnd()) {
+            int64_t offset = indexOffset + (reader.getPointer() - buffer.data());
+            try {
+                int type = reader.readByte();
+                uint32_t len = reader.readUInt32();
+                const char *payload = reader.readBytes(len);
+                parseRecord(type, payload, len, offset, Format::RECORD_HEADER_SIZE + len, index.get());
+            }
+            catch (std::exception& e) {
+                error(e.what(), offset);
+            }
+        }
+    }
+    else {
+        // no index (file was not closed properly): scan the records
+        std::string header;
+        int64_t offset = Format::FILE_HEADER_SIZE;
+        while (offset + Format::RECORD_HEADER_SIZE <= fileSize) {
+            readBytes(offset, Format::RECORD_HEADER_SIZE, header);
+            Format::Reader reader(header.data(), header.size());
+            int type = reader.readByte();
+            int64_t len = reader.readUInt32();
+            if (offset + Format::RECORD_HEADER_SIZE + len > fileSize)
+                break;  // incomplete record at the end of the file
+            if (type == Format::REC_INDEX)
+                break;  // incomplete index section at the end of the file
+            // for blocks, only the block header is needed
+            size_t lenToRead = type == Format::REC_BLOCK ? std::min(len, (int64_t)Format::MAX_BLOCK_HEADER_SIZE) : len;
+            readBytes(offset + Format::RECORD_HEADER_SIZE, lenToRead, buffer);
+            try {
+                parseRecord(type, buffer.data(), buffer.size(), offset, Format::RECORD_HEADER_SIZE + len, index.get());
+            }
+            catch (std::exception& e) {
+                error(e.what(), offset);
+            }
+            offset += Format::RECORD_HEADER_SIZE + len;
+        }
+    }
+
+    return index.release();
+}
+
+void BinaryVectorFileReader::parseRecord(int type, const char *payload, size_t len, int64_t offset, int64_t recordSize, VectorFileIndex *index)
+{
+    Format::Reader reader(payload, len);
+    RunData& run = index->run;
+    switch (type) {
+        case Format::REC_RUN: {
+            run.runName = reader.readString();
+            break;
+        }
+        case Format::REC_RUNATTR: {
+            std::string name = reader.readString();
+            run.attributes[name] = reader.readString();
+            break;
+        }
+        case Format::REC_ITERVAR: {
+            std::string name = reader.readString();
+            run.itervars[name] = reader.readString();
+            break;
+        }
+        case Format::REC_PARAM: {
+            std::string key = reader.readString();
+            run.paramAssignments.push_back(std::make_pair(key, reader.readString()));
+            break;
+        }
+        case Format::REC_VECTOR: {
+            int vectorId = (int)reader.readVarint();
+            std::string moduleName = reader.readString();
+            std::string name = reader.readString();
+            std::string columns = reader.readString();
+            VectorData vector(vectorId, moduleName, name, columns, 0);
+            uint64_t numAttrs = reader.readVarint();
+            for (uint64_t i = 0; i < numAttrs; i++) {
+                std::string attrName = reader.readString();
+                vector.attributes[attrName] = reader.readString();
+            }
+            if (index->getVectorById(vectorId) != nullptr)
+                throw opp_runtime_error("Vector id %d is not unique", vectorId);
+            index->addVector(vector);
+            break;
+        }
+        case Format::REC_BLOCK:
+        case Format::REC_BLOCKINDEX: {
+            if (type == Format::REC_BLOCKINDEX) {
+                offset = reader.readUInt64();
+                recordSize = reader.readUInt64();
+            }
+            BlockHeader header;
+            reader.readBlockHeader(header);
+            VectorData *vector = index->getVectorById(header.vectorId);
+            if (vector == nullptr)
+                throw opp_runtime_error("Block of undeclared vector %d", header.vectorId);
+            Block block;
+            block.startOffset = offset;
+            block.size = recordSize;
+            block.startSerial = !vector->blocks.empty() ? vector->blocks.back().endSerial() : 0;
+            block.startEventNum = header.startEventNum;
+            block.endEventNum = header.endEventNum;
+            block.startTime = BigDecimal(header.startTime, header.simtimeExp);
+            block.endTime = BigDecimal(header.endTime, header.simtimeExp);
+            block.stat = Statistics::makeUnweighted(header.count, header.min, header.max, header.sum, header.sumSqr);
+            vector->addBlock(block);
+            break;
+        }
+        case Format::REC_INDEX:
+            break;
+        default:
+            break;  // skip unknown records, for forward compatibility
+    }
+}
+
+void BinaryVectorFileReader::readBlock(const Block& block, BlockData& data)
+{
+    readBytes(block.startOffset, block.size, buffer);
+    try {
+        Format::Reader reader(buffer.data(), buffer.size());
+        if (reader.readByte() != Format::REC_BLOCK || reader.readUInt32() != block.size - Format::RECORD_HEADER_SIZE)
+            throw opp_runtime_error("Block record expected");
+        reader.readBlockHeader(data.header);
+        size_t rawSize = reader.readVarint();
+        size_t storedSize = reader.readVarint();
+        const char *storedData = reader.readBytes(storedSize);
+        if (data.header.flags & Format::FLAG_COMPRESSED) {
+            // an LZ4-style sequence expands to at most ~255 bytes per stored byte;
+            // check before allocating memory based on a possibly corrupt size
+            if (rawSize / 255 > storedSize + 1)
+                throw opp_runtime_error("Uncompressed size in block record is too large");
+            columnBuffer.resize(rawSize);
+            opp_lzdecompress(storedData, storedSize, &columnBuffer[0], rawSize);
+            Format::decodeColumns(data.header, columnBuffer.data(), rawSize, data.eventNumbers, data.times, data.values);
+        }
+        else {
+            if (rawSize != storedSize)
+                throw opp_runtime_error("Uncompressed size in block record does not match stored size");
+            Format::decodeColumns(data.header, storedData, storedSize, data.eventNumbers, data.times, data.values);
+        }
+    }
+    catch (std::exception& e) {
+        error(e.what(), block.startOffset);
+    }
+}
+
+} // namespace scave
+}  // namespace omnetpp
+
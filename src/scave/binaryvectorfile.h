@@ -0,0 +1,100 @@
+//=========================================================================
+//  BINARYVECTORFILE.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_BINARYVECTORFILE_H
+#define __OMNETPP_SCAVE_BINARYVECTORFILE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "common/binaryvectorfileformat.h"
+#include "scavedefs.h"
+#include "indexfile.h"
+
+namespace omnetpp {
+namespace scave {
+
+/**
+ * Reader for binary output vector files, as written by
+ * omnetpp::common::BinaryVectorFileWriter. The index of the file is
+ * returned in the same form as the index of text-based vector files
+ * (VectorFileIndex); block offsets refer to the BLOCK records of the file.
+ */
+class SCAVE_API BinaryVectorFileReader
+{
+    public:
+        typedef omnetpp::common::BinaryVectorFileFormat::BlockHeader BlockHeader;
+
+        /**
+         * The decoded content of a block.
+         */
+        struct BlockData {
+            BlockHeader header;
+            std::vector<eventnumber_t> eventNumbers; // empty if the vector has no event number column
+            std::vector<int64_t> times;  // raw simtime values, scale exponent is in header.simtimeExp
+            std::vector<double> values;
+        };
+
+    private:
+        std::string filename;
+        FILE *f;
+        int64_t fileSize;
+        std::string buffer;       // holds the data read from the file
+        std::string columnBuffer; // holds decompressed block data
+
+    private:
+        void error(const char *msg, int64_t offset);
+        void readBytes(int64_t offset, size_t len, std::string& dest);
+        void parseRecord(int type, const char *payload, size_t len, int64_t offset, int64_t recordSize, VectorFileIndex *index);
+
+    public:
+        /**
+         * Returns true if the given file is a binary output vector file.
+         */
+        static bool isBinaryVectorFile(const char *fileName);
+
+        /**
+         * Opens the given file for reading.
+         */
+        explicit BinaryVectorFileReader(const char *filename);
+
+        /**
+         * Closes the file.
+         */
+        ~BinaryVectorFileReader();
+
+        /**
+         * Returns the size of the file.
+         */
+        int64_t getFileSize() const {return fileSize;}
+
+        /**
+         * Reads the index of the file. If the file contains no index (because
+         * it was not closed properly), the records of the whole file are
+         * scanned; an incomplete record at the end of the file is ignored.
+         * The caller is responsible for deleting the returned object.
+         */
+        VectorFileIndex *readIndex();
+
+        /**
+         * Reads and decodes the given block.
+         */
+        void readBlock(const Block& block, BlockData& data);
+};
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
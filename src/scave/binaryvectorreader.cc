@@ -0,0 +1,156 @@
+//=========================================================================
+//  BINARYVECTORREADER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include "channel.h"
+#include "scaveutils.h"
+#include "binaryvectorreader.h"
+
+using namespace std;
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+BinaryVectorReaderNode::BinaryVectorReaderNode(const char *filename) :
+    filename(filename), reader(filename), index(nullptr), currentBlockIndex(0), numReadBytes(0)
+{
+}
+
+BinaryVectorReaderNode::~BinaryVectorReaderNode()
+{
+    delete index;
+}
+
+Port *BinaryVectorReaderNode::addVector(const VectorResult& vector)
+{
+    return addVector(vector.getVectorId());
+}
+
+Port *BinaryVectorReaderNode::addVector(int vectorId)
+{
+    PortData& portdata = ports[vectorId];
+    portdata.ports.push_back(Port(this));
+    Port& port = portdata.ports.back();
+    return &port;
+}
+
+bool BinaryVectorReaderNode::isReady() const
+{
+    return true;
+}
+
+void BinaryVectorReaderNode::process()
+{
+    if (!index)
+        readIndex();
+
+    long bytesRead = 0;
+    while (currentBlockIndex < blocksToRead.size() && bytesRead < 64 * 1024) {
+        BlockAndPortData& blockAndPort = blocksToRead[currentBlockIndex++];
+        readBlock(blockAndPort.blockPtr, blockAndPort.portDataPtr);
+        bytesRead += blockAndPort.blockPtr->size;
+    }
+}
+
+bool BinaryVectorReaderNode::isFinished() const
+{
+    return index && currentBlockIndex >= blocksToRead.size();
+}
+
+void BinaryVectorReaderNode::readIndex()
+{
+    index = reader.readIndex();
+
+    for (VectorIdToPortMap::iterator it = ports.begin(); it != ports.end(); ++it) {
+        int vectorId = it->first;
+        PortData& portData = it->second;
+
+        portData.vector = index->getVectorById(vectorId);
+
+        if (!portData.vector)
+            throw opp_runtime_error("Binary vector file reader: Vector %d not found, file %s",
+                    vectorId, filename.c_str());
+
+        Blocks& blocks = portData.vector->blocks;
+        for (Blocks::iterator it = blocks.begin(); it != blocks.end(); ++it)
+            blocksToRead.push_back(BlockAndPortData(&(*it), &portData));
+    }
+
+    sort(blocksToRead.begin(), blocksToRead.end());
+}
+
+void BinaryVectorReaderNode::readBlock(const Block *blockPtr, const PortData *portDataPtr)
+{
+    assert(blockPtr);
+    assert(portDataPtr->vector);
+
+    reader.readBlock(*blockPtr, blockData);
+    numReadBytes += blockPtr->size;
+
+    bool hasEventNumbers = !blockData.eventNumbers.empty();
+    int simtimeExp = blockData.header.simtimeExp;
+    size_t count = blockData.values.size();
+    for (size_t i = 0; i < count; i++) {
+        Datum a;
+        a.eventNumber = hasEventNumbers ? blockData.eventNumbers[i] : -1;
+        a.xp = BigDecimal(blockData.times[i], simtimeExp);
+        a.x = a.xp.dbl();
+        a.y = blockData.values[i];
+
+        // write to port(s)
+        for (PortVector::const_iterator port = portDataPtr->ports.begin(); port != portDataPtr->ports.end(); ++port)
+            port->getChannel()->write(&a, 1);
+    }
+}
+
+//-----
+
+const char *BinaryVectorReaderNodeType::getDescription() const
+{
+    return "Reads binary output vector files.";
+}
+
+void BinaryVectorReaderNodeType::getAttributes(StringMap& attrs) const
+{
+    attrs["filename"] = "name of the binary output vector file (.vec)";
+}
+
+Node *BinaryVectorReaderNodeType::create(DataflowManager *mgr, StringMap& attrs) const
+{
+    checkAttrNames(attrs);
+
+    const char *fname = attrs["filename"].c_str();
+
+    Node *node = new BinaryVectorReaderNode(fname);
+    node->setNodeType(this);
+    mgr->addNode(node);
+    return node;
+}
+
+Port *BinaryVectorReaderNodeType::getPort(Node *node, const char *portname) const
+{
+    // vector id is used as port name
+    BinaryVectorReaderNode *node1 = dynamic_cast<BinaryVectorReaderNode *>(node);
+    if (node1 == nullptr)
+        throw opp_runtime_error("node type should be 'BinaryVectorReaderNode'");
+    int vectorId;
+    if (!parseInt(portname, vectorId))
+        throw opp_runtime_error("port should be a vector id, received: %s", portname);
+    return node1->addVector(vectorId);
+}
+
+}  // namespace scave
+}  // namespace omnetpp
+
@@ -0,0 +1,105 @@
+//=========================================================================
+//  BINARYVECTORREADER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_BINARYVECTORREADER_H
+#define __OMNETPP_SCAVE_BINARYVECTORREADER_H
+
+#include <map>
+#include <string>
+#include "node.h"
+#include "nodetype.h"
+#include "commonnodes.h"
+#include "binaryvectorfile.h"
+#include "resultfilemanager.h"
+
+namespace omnetpp {
+namespace scave {
+
+/**
+ * Producer node which reads a binary output vector file.
+ */
+class SCAVE_API BinaryVectorReaderNode : public ReaderNode
+{
+    typedef std::vector<Port> PortVector;
+
+    struct PortData
+    {
+        VectorData *vector;
+        PortVector ports;
+
+        PortData() : vector(nullptr) {}
+    };
+
+    struct BlockAndPortData
+    {
+        Block *blockPtr;
+        PortData *portDataPtr;
+
+        BlockAndPortData(Block *blockPtr, PortData *portDataPtr)
+            : blockPtr(blockPtr), portDataPtr(portDataPtr) {}
+
+        bool operator<(const BlockAndPortData& other) const
+        {
+            return this->blockPtr->startOffset < other.blockPtr->startOffset;
+        }
+    };
+
+    typedef std::map<int,PortData> VectorIdToPortMap;
+
+    private:
+        std::string filename;
+        BinaryVectorFileReader reader;
+        VectorIdToPortMap ports;
+        VectorFileIndex *index;
+        std::vector<BlockAndPortData> blocksToRead;
+        unsigned int currentBlockIndex;
+        BinaryVectorFileReader::BlockData blockData;
+        int64_t numReadBytes;
+
+    public:
+        BinaryVectorReaderNode(const char *filename);
+        virtual ~BinaryVectorReaderNode();
+
+        Port *addVector(const VectorResult& vector);
+        Port *addVector(int vectorId);
+
+        virtual bool isReady() const override;
+        virtual void process() override;
+        virtual bool isFinished() const override;
+
+        virtual int64_t getFileSize() override {return reader.getFileSize();}
+        virtual int64_t getNumReadBytes() override {return numReadBytes;}
+
+    private:
+        void readIndex();
+        void readBlock(const Block *blockPtr, const PortData *portDataPtr);
+};
+
+
+class SCAVE_API BinaryVectorReaderNodeType : public ReaderNodeType
+{
+    public:
+        virtual const char *getName() const override {return "binaryvectorreader";}
+        virtual const char *getDescription() const override;
+        virtual void getAttributes(StringMap& attrs) const override;
+        virtual Node *create(DataflowManager *mgr, StringMap& attrs) const override;
+        virtual Port *getPort(Node *node, const char *portname) const override;
+};
+
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
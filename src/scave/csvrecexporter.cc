@@ -116,7 +116,7 @@ string CsvRecordsExporterType::getXswtForm() const
 StringMap CsvRecordsExporterType::getSupportedOptions() const
 {
     StringMap options {
-        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15."},
+        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15; -1 selects the shortest representation that converts back to exactly the same value."},
         {"columnNames", "Whether to print a row containing column names. Values: 'true', 'false'"},
         {"omitBlankColumns", "Whether to omit columns generated by result types not present in the output. Values: 'true', 'false'"},
         {"separator", "Separator character. Values: 'tab', 'comma', 'semicolon', 'colon'"},
@@ -131,7 +131,7 @@ string CsvForSpreadsheetExporterType::getXswtForm() const
 StringMap CsvForSpreadsheetExporterType::getSupportedOptions() const
 {
     StringMap options {
-        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15."},
+        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15; -1 selects the shortest representation that converts back to exactly the same value."},
         {"columnNames", "Whether to print a row containing column names. Values: 'true', 'false'"},
         {"allowMixed", "Whether to allow mixed content (e.g. vectors and scalars in the same file). Values: 'true', 'false'"},
         {"separator", "Separator character. Values: 'tab', 'comma', 'semicolon', 'colon'"},
@@ -93,7 +93,7 @@ string PythonExporterType::getXswtForm() const
 StringMap PythonExporterType::getSupportedOptions() const
 {
     StringMap options {
-        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15."},
+        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15; -1 selects the shortest representation that converts back to exactly the same value."},
         {"pythonFlavoured", "Generate Python-flavoured JSON."},
         {"useNumpy", "Use NumPy arrays in the output."},
         {"indentSize", "Number of spaces to indent with. Set to 0 or 1 to reduce file size."},
@@ -0,0 +1,492 @@
+//=========================================================================
+//  MAPPEDVECTORFILEREADER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <thread>
+#include "common/opp_ctype.h"
+#include "channel.h"
+#include "scaveutils.h"
+#include "scaveexception.h"
+#include "mappedvectorfilereader.h"
+
+using namespace std;
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+// amount of data (bytes in the file) to be parsed per thread in one process() call
+#define BYTES_PER_THREAD    (1024*1024)
+
+// longer tokens are certainly invalid
+#define MAX_TOKEN_LENGTH    63
+
+MappedVectorFileReaderNode::MappedVectorFileReaderNode(const char *filename, int numThreads) :
+    filename(filename), numThreads(numThreads), file(nullptr), index(nullptr), currentBlockIndex(0), numReadBytes(0)
+{
+    if (this->numThreads <= 0)
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+MappedVectorFileReaderNode::~MappedVectorFileReaderNode()
+{
+    delete index;
+    delete file;
+}
+
+Port *MappedVectorFileReaderNode::addVector(const VectorResult& vector)
+{
+    return addVector(vector.getVectorId());
+}
+
+Port *MappedVectorFileReaderNode::addVector(int vectorId)
+{
+    PortData& portdata = ports[vectorId];
+    portdata.ports.push_back(Port(this));
+    Port& port = portdata.ports.back();
+    return &port;
+}
+
+bool MappedVectorFileReaderNode::isReady() const
+{
+    return true;
+}
+
+int64_t MappedVectorFileReaderNode::getFileSize()
+{
+    if (!file)
+        file = new MappedFile(filename.c_str());
+    return file->getSize();
+}
+
+void MappedVectorFileReaderNode::process()
+{
+    if (!index)
+        readIndexFile();
+
+    // select the next batch of blocks
+    unsigned int first = currentBlockIndex, last = currentBlockIndex;
+    int64_t batchBytes = 0;
+    while (last < blocksToRead.size() && (last == first || batchBytes < (int64_t)numThreads * BYTES_PER_THREAD))
+        batchBytes += blocksToRead[last++].blockPtr->size;
+    int numBlocks = last - first;
+    if (numBlocks == 0)
+        return;
+
+    // parse them in parallel
+    if ((int)parsedBlocks.size() < numBlocks)
+        parsedBlocks.resize(numBlocks);
+    std::vector<std::exception_ptr> errors(numBlocks);
+    std::atomic<int> nextBlock(0);
+    auto parseBlocks = [&]() {
+        int i;
+        while ((i = nextBlock++) < numBlocks) {
+            try {
+                parseBlock(blocksToRead[first + i], parsedBlocks[i]);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    int numExtraThreads = std::min(numThreads, numBlocks) - 1;
+    for (int i = 0; i < numExtraThreads; i++)
+        threads.push_back(std::thread(parseBlocks));
+    parseBlocks();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // write the data to the ports in file order
+    for (int i = 0; i < numBlocks; i++) {
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+        Datums& datums = parsedBlocks[i];
+        const PortVector& portVec = blocksToRead[first + i].portDataPtr->ports;
+        for (PortVector::const_iterator port = portVec.begin(); port != portVec.end(); ++port)
+            port->getChannel()->write(datums.data(), datums.size());
+    }
+
+    numReadBytes += batchBytes;
+    currentBlockIndex = last;
+}
+
+bool MappedVectorFileReaderNode::isFinished() const
+{
+    return index && currentBlockIndex >= blocksToRead.size();
+}
+
+void MappedVectorFileReaderNode::readIndexFile()
+{
+    const char *fn = filename.c_str();
+
+    if (!IndexFile::isExistingVectorFile(fn))
+        throw opp_runtime_error("Mapped vector file reader: Not a vector file, file %s", fn);
+    if (!IndexFile::isIndexFileUpToDate(fn))
+        throw opp_runtime_error("Mapped vector file reader: Index file is not up to date, file %s", fn);
+
+    string indexFileName = IndexFile::getIndexFileName(fn);
+    IndexFileReader reader(indexFileName.c_str());
+    index = reader.readAll();
+
+    if (!file)
+        file = new MappedFile(fn);
+
+    for (VectorIdToPortMap::iterator it = ports.begin(); it != ports.end(); ++it) {
+        int vectorId = it->first;
+        PortData& portData = it->second;
+
+        portData.vector = index->getVectorById(vectorId);
+
+        if (!portData.vector)
+            throw opp_runtime_error("Mapped vector file reader: Vector %d not found, file %s",
+                    vectorId, indexFileName.c_str());
+
+        Blocks& blocks = portData.vector->blocks;
+        for (Blocks::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+            if (it->startOffset < 0 || it->startOffset + it->size > file->getSize())
+                throw opp_runtime_error("Mapped vector file reader: Block of vector %d extends beyond the end of file %s",
+                        vectorId, fn);
+            blocksToRead.push_back(BlockAndPortData(&(*it), &portData));
+        }
+    }
+
+    sort(blocksToRead.begin(), blocksToRead.end());
+
+    // the parser threads use strtod() in rare cases; setlocale() is not
+    // thread-safe, so it is called here and not in the threads
+    setlocale(LC_NUMERIC, "C");
+}
+
+//
+// Number parsing. Tokens are not NUL-terminated (the file is mapped
+// read-only), so the parsers take a [begin,end) range. The fast paths cover
+// the numbers written by the simulation; everything else is copied into a
+// buffer and handed over to the standard routines.
+//
+
+static const double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool copyToken(const char *begin, const char *end, char *buf)
+{
+    if (end - begin > MAX_TOKEN_LENGTH)
+        return false;
+    memcpy(buf, begin, end - begin);
+    buf[end - begin] = '\0';
+    return true;
+}
+
+// Like parseDouble(), but does not call setlocale()
+static bool parseDoubleSlow(const char *s, double& dest)
+{
+    char *e;
+    dest = strtod(s, &e);
+    if (!*e)
+        return true;
+
+    // infinity: GCC: "inf" or "-inf"; MSVC: "1.#INF" or "-1.#INF"
+    if (strstr(s, "inf") || strstr(s, "Inf") || strstr(s, "INF")) {
+        dest = *s == '-' ? NEGATIVE_INFINITY : POSITIVE_INFINITY;
+        return true;
+    }
+
+    // not-a-number: GCC: "nan"; MSVC: "1.#IND"
+    if (strstr(s, "nan") || strstr(s, "NaN") || strstr(s, "NAN") || strstr(s, "IND")) {
+        dest = NaN;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Parses a decimal number with at most 19 significant digits whose
+ * mantissa is at most 2^53 and decimal exponent is within [-22,22]. These
+ * conversions are exact with one floating-point multiplication or division
+ * (Clinger's fast path), so the result is the same as with strtod().
+ */
+static bool parseDoubleFast(const char *p, const char *end, double& dest)
+{
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int numDigits = 0;  // significant digits in the mantissa
+    int exponent = 0;
+    bool anyDigits = false;
+    for ( ; p != end && opp_isdigit(*p); p++) {
+        anyDigits = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (++numDigits > 19)
+            return false;
+        mantissa = 10 * mantissa + (*p - '0');
+    }
+    if (p != end && *p == '.') {
+        for (p++; p != end && opp_isdigit(*p); p++) {
+            anyDigits = true;
+            exponent--;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (++numDigits > 19)
+                return false;
+            mantissa = 10 * mantissa + (*p - '0');
+        }
+    }
+    if (!anyDigits)
+        return false;
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExp = false;
+        if (p != end && (*p == '-' || *p == '+'))
+            negativeExp = *p++ == '-';
+        if (p == end)
+            return false;
+        int exp = 0;
+        for ( ; p != end && opp_isdigit(*p); p++) {
+            exp = 10 * exp + (*p - '0');
+            if (exp > 1000)
+                return false;
+        }
+        exponent += negativeExp ? -exp : exp;
+    }
+    if (p != end)
+        return false;
+
+    double d;
+    if (mantissa == 0)
+        d = 0;
+    else {
+        if (mantissa > (1ULL << 53) || exponent < -22 || exponent > 22)
+            return false;
+        d = (double)mantissa;
+        if (exponent < 0)
+            d /= EXACT_POWERS_OF_TEN[-exponent];
+        else
+            d *= EXACT_POWERS_OF_TEN[exponent];
+    }
+    dest = negative ? -d : d;
+    return true;
+}
+
+static inline bool parseDouble(const char *begin, const char *end, double& dest)
+{
+    if (parseDoubleFast(begin, end, dest))
+        return true;
+    char buf[MAX_TOKEN_LENGTH + 1];
+    return copyToken(begin, end, buf) && parseDoubleSlow(buf, dest);
+}
+
+static bool parseSimtime(const char *begin, const char *end, BigDecimal& dest)
+{
+    // fast path: at most 18 digits with an optional sign and decimal point
+    const char *p = begin;
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    int64_t intVal = 0;
+    int numDigits = 0;
+    int scale = 0;
+    for ( ; p != end && opp_isdigit(*p); p++, numDigits++)
+        intVal = 10 * intVal + (*p - '0');
+    if (p != end && *p == '.')
+        for (p++; p != end && opp_isdigit(*p); p++, numDigits++, scale--)
+            intVal = 10 * intVal + (*p - '0');
+    if (p == end && numDigits > 0 && numDigits <= 18) {
+        dest = BigDecimal(negative ? -intVal : intVal, scale);
+        return true;
+    }
+
+    // slow path, like parseSimtime() in scaveutils
+    char buf[MAX_TOKEN_LENGTH + 1];
+    if (!copyToken(begin, end, buf))
+        return false;
+    try {
+        const char *e;
+        BigDecimal t = BigDecimal::parse(buf, e);
+        if (*e == '\0') {
+            dest = t;
+            return true;
+        }
+        double d;
+        if ((*e == 'e' || *e == 'E') && parseDoubleSlow(buf, d)) {
+            dest = BigDecimal(d);
+            return true;
+        }
+    }
+    catch (std::exception& e) {
+        // overflow
+    }
+    return false;
+}
+
+template<typename T>
+static inline bool parseInteger(const char *p, const char *end, T& dest)
+{
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p == end || end - p > std::numeric_limits<T>::digits10)
+        return false;  // empty or possibly out of range
+    T value = 0;
+    for ( ; p != end; p++) {
+        if (!opp_isdigit(*p))
+            return false;
+        value = 10 * value + (*p - '0');
+    }
+    dest = negative ? -value : value;
+    return true;
+}
+
+static inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
+}
+
+static inline const char *findTokenEnd(const char *p, const char *end)
+{
+    while (p != end && *p != ' ' && *p != '\t' && *p != '\r')
+        p++;
+    return p;
+}
+
+void MappedVectorFileReaderNode::parseBlock(const BlockAndPortData& blockAndPort, Datums& result) const
+{
+    const Block *block = blockAndPort.blockPtr;
+    const VectorData *vector = blockAndPort.portDataPtr->vector;
+    const char *fn = filename.c_str();
+    const char *data = file->getData();
+    const char *p = data + block->startOffset;
+    const char *blockEnd = p + block->size;
+    const std::string& columns = vector->columns;
+    int numColumns = columns.size();
+    long count = block->getCount();
+
+    result.clear();
+    result.reserve(count);
+
+    while (p != blockEnd && (long)result.size() < count) {
+        const char *lineEnd = (const char *)memchr(p, '\n', blockEnd - p);
+        if (!lineEnd)
+            lineEnd = blockEnd;
+        file_offset_t offset = p - data;
+
+        // check vector id
+        p = skipSpaces(p, lineEnd);
+        const char *tokenEnd = findTokenEnd(p, lineEnd);
+        int vectorId;
+        if (p == tokenEnd || !opp_isdigit(*p) || !parseInteger(p, tokenEnd, vectorId))
+            throw ResultFileFormatException("Invalid vector file syntax: Invalid vector id column", fn, -1, offset);
+        if (vectorId != vector->vectorId)
+            throw ResultFileFormatException("vector file reader: unexpected vector id", fn, -1, offset);
+
+        // parse columns
+        Datum a;
+        for (int i = 0; i < numColumns; i++) {
+            p = skipSpaces(tokenEnd, lineEnd);
+            tokenEnd = findTokenEnd(p, lineEnd);
+            if (p == tokenEnd)
+                throw ResultFileFormatException("Invalid vector file syntax: Missing columns", fn, -1, offset);
+
+            switch (columns[i]) {
+                case 'E':
+                    if (!parseInteger(p, tokenEnd, a.eventNumber))
+                        throw ResultFileFormatException("Invalid vector file syntax: Invalid event number", fn, -1, offset);
+                    break;
+
+                case 'T':
+                    if (!parseSimtime(p, tokenEnd, a.xp))
+                        throw ResultFileFormatException("Invalid vector file syntax: Invalid time", fn, -1, offset);
+                    a.x = a.xp.dbl();
+                    break;
+
+                case 'V':
+                    if (!parseDouble(p, tokenEnd, a.y))
+                        throw ResultFileFormatException("Invalid vector file syntax: Invalid value", fn, -1, offset);
+                    break;
+
+                default:
+                    throw ResultFileFormatException("Invalid vector file syntax: Unknown column type", fn, -1, offset);
+            }
+        }
+        if (skipSpaces(tokenEnd, lineEnd) != lineEnd)
+            throw ResultFileFormatException("Invalid vector file syntax: Extra columns", fn, -1, offset);
+
+        result.push_back(a);
+        p = lineEnd == blockEnd ? blockEnd : lineEnd + 1;
+    }
+}
+
+//-----
+
+const char *MappedVectorFileReaderNodeType::getDescription() const
+{
+    return "Reads indexed output vector files, using memory mapping and several threads.";
+}
+
+void MappedVectorFileReaderNodeType::getAttributes(StringMap& attrs) const
+{
+    attrs["filename"] = "name of the output vector file (.vec)";
+    attrs["threads"] = "number of parser threads; 0 means the number of hardware threads";
+}
+
+void MappedVectorFileReaderNodeType::getAttrDefaults(StringMap& attrs) const
+{
+    attrs["threads"] = "0";
+}
+
+Node *MappedVectorFileReaderNodeType::create(DataflowManager *mgr, StringMap& attrs) const
+{
+    checkAttrNames(attrs);
+
+    const char *fname = attrs["filename"].c_str();
+    int numThreads = 0;
+    if (attrs.find("threads") != attrs.end() && !parseInt(attrs["threads"].c_str(), numThreads))
+        throw opp_runtime_error("Mapped vector file reader: Invalid number of threads '%s'", attrs["threads"].c_str());
+
+    Node *node = new MappedVectorFileReaderNode(fname, numThreads);
+    node->setNodeType(this);
+    mgr->addNode(node);
+    return node;
+}
+
+Port *MappedVectorFileReaderNodeType::getPort(Node *node, const char *portname) const
+{
+    // vector id is used as port name
+    MappedVectorFileReaderNode *node1 = dynamic_cast<MappedVectorFileReaderNode *>(node);
+    if (node1 == nullptr)
+        throw opp_runtime_error("node type should be 'MappedVectorFileReaderNode'");
+    int vectorId;
+    if (!parseInt(portname, vectorId))
+        throw opp_runtime_error("Mapped vector file reader node: Port should be a vector id, received: %s", portname);
+    return node1->addVector(vectorId);
+}
+
+}  // namespace scave
+}  // namespace omnetpp
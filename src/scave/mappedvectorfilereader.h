@@ -0,0 +1,118 @@
+//=========================================================================
+//  MAPPEDVECTORFILEREADER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_MAPPEDVECTORFILEREADER_H
+#define __OMNETPP_SCAVE_MAPPEDVECTORFILEREADER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "common/mappedfile.h"
+#include "node.h"
+#include "nodetype.h"
+#include "commonnodes.h"
+#include "indexfile.h"
+#include "resultfilemanager.h"
+
+namespace omnetpp {
+namespace scave {
+
+/**
+ * Producer node which reads an indexed output vector file. Like
+ * IndexedVectorFileReaderNode, it only reads the blocks of the requested
+ * vectors (as listed in the index file), but the file is mapped into memory,
+ * and blocks are parsed in parallel on several threads, using number parsing
+ * routines optimized for the vector file syntax. Data are written to the
+ * output ports in the same order as by IndexedVectorFileReaderNode.
+ */
+class SCAVE_API MappedVectorFileReaderNode : public ReaderNode
+{
+    typedef std::vector<Port> PortVector;
+    typedef std::vector<Datum> Datums;
+
+    struct PortData
+    {
+        VectorData *vector;
+        PortVector ports;
+
+        PortData() : vector(nullptr) {}
+    };
+
+    struct BlockAndPortData
+    {
+        Block *blockPtr;
+        PortData *portDataPtr;
+
+        BlockAndPortData(Block *blockPtr, PortData *portDataPtr)
+            : blockPtr(blockPtr), portDataPtr(portDataPtr) {}
+
+        bool operator<(const BlockAndPortData& other) const
+        {
+            return this->blockPtr->startOffset < other.blockPtr->startOffset;
+        }
+    };
+
+    typedef std::map<int,PortData> VectorIdToPortMap;
+
+    private:
+        std::string filename;
+        int numThreads;
+        omnetpp::common::MappedFile *file;
+        VectorIdToPortMap ports;
+        VectorFileIndex *index;
+        std::vector<BlockAndPortData> blocksToRead;
+        unsigned int currentBlockIndex;
+        std::vector<Datums> parsedBlocks;  // reused between process() calls
+        int64_t numReadBytes;
+
+    public:
+        /**
+         * numThreads=0 means the number of hardware threads.
+         */
+        MappedVectorFileReaderNode(const char *filename, int numThreads = 0);
+        virtual ~MappedVectorFileReaderNode();
+
+        Port *addVector(const VectorResult& vector);
+        Port *addVector(int vectorId);
+
+        virtual bool isReady() const override;
+        virtual void process() override;
+        virtual bool isFinished() const override;
+
+        virtual int64_t getFileSize() override;
+        virtual int64_t getNumReadBytes() override {return numReadBytes;}
+
+    private:
+        void readIndexFile();
+        void parseBlock(const BlockAndPortData& blockAndPort, Datums& result) const;
+};
+
+
+class SCAVE_API MappedVectorFileReaderNodeType : public ReaderNodeType
+{
+    public:
+        virtual const char *getName() const override {return "mappedvectorfilereader";}
+        virtual const char *getDescription() const override;
+        virtual void getAttributes(StringMap& attrs) const override;
+        virtual void getAttrDefaults(StringMap& attrs) const override;
+        virtual Node *create(DataflowManager *mgr, StringMap& attrs) const override;
+        virtual Port *getPort(Node *node, const char *portname) const override;
+};
+
+
+} // namespace scave
+}  // namespace omnetpp
+
+
+#endif
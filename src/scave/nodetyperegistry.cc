@@ -23,7 +23,9 @@
 #include "vectorfilewriter.h"
 #include "indexedvectorfile.h"
 #include "indexedvectorfilereader.h"
+#include "mappedvectorfilereader.h"
 #include "sqlitevectorreader.h"
+#include "binaryvectorreader.h"
 #include "vectorreaderbyfiletype.h"
 #include "filewriter.h"
 #include "windowavg.h"
@@ -70,7 +72,9 @@ NodeTypeRegistry::NodeTypeRegistry()
     add(new VectorFileWriterNodeType());
     add(new IndexedVectorFileWriterNodeType());
     add(new IndexedVectorFileReaderNodeType());
+    add(new MappedVectorFileReaderNodeType());
     add(new SqliteVectorReaderNodeType());
+    add(new BinaryVectorReaderNodeType());
     add(new VectorReaderByFileTypeNodeType());
     add(new FileWriterNodeType());
     add(new MergerNodeType());
@@ -79,7 +79,7 @@ string OmnetppScalarFileExporterType::getXswtForm() const
 StringMap OmnetppScalarFileExporterType::getSupportedOptions() const
 {
     StringMap options {
-        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15."},
+        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15; -1 selects the shortest representation that converts back to exactly the same value."},
     };
     return options;
 }
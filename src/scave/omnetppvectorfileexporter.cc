@@ -87,7 +87,7 @@ StringMap OmnetppVectorFileExporterType::getSupportedOptions() const
     StringMap options {
         {"vectorFilters", "A semicolon-separated list of operations to be applied to the vectors to be exported. See the 'operations' help page. Example value: 'winavg(10);mean'"},
         {"skipSpecialValues", "Allow and skip NaN and +/-Inf values as simulation time in vectors."},
-        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15."},
+        {"precision", "The number of significant digits for floating-point values (double). The maximum value is ~15; -1 selects the shortest representation that converts back to exactly the same value."},
         {"overallMemoryLimitMB", "Maximum amount of memory allowed to use, in megabytes. Use zero for no limit."},
         {"perVectorMemoryLimitKB", "Maximum amount of memory allowed to use per vector by the writer for output buffering, in kilobytes. Use zero for no limit."},
     };
@@ -42,6 +42,8 @@
 #include "resultfilemanager.h"
 #include "omnetppresultfileloader.h"
 #include "sqliteresultfileloader.h"
+#include "binaryvectorfile.h"
+#include "binaryresultfileloader.h"
 
 
 #ifdef THREADED
@@ -1096,6 +1098,8 @@ ResultFile *ResultFileManager::loadFile(const char *fileName, const char *fileSy
 
     ResultFile *file = SqliteResultFileUtils::isSqliteFile(fileSystemFileName) ?
         SqliteResultFileLoader(this).loadFile(fileName, fileSystemFileName, reload) :
+        BinaryVectorFileReader::isBinaryVectorFile(fileSystemFileName) ?
+        BinaryResultFileLoader(this).loadFile(fileName, fileSystemFileName, reload) :
         OmnetppResultFileLoader(this).loadFile(fileName, fileSystemFileName, reload);
 
     // add numeric itervars as scalars
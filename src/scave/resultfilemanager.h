@@ -87,6 +87,7 @@ class SCAVE_API ResultItem
 {
     friend class ResultFileManager;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
 
   public:
     enum DataType { TYPE_INT, TYPE_DOUBLE, TYPE_ENUM };
@@ -167,6 +168,7 @@ class SCAVE_API VectorResult : public ResultItem
     friend class ResultFileManager;
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
   private:
     int vectorId;
     std::string columns;
@@ -202,6 +204,7 @@ class SCAVE_API StatisticsResult : public ResultItem
     friend class ResultFileManager;
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
   private:
     Statistics stat; //TODO weighted
   protected:
@@ -220,6 +223,7 @@ class SCAVE_API HistogramResult : public StatisticsResult
     friend class ResultFileManager;
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
   private:
     Histogram bins;
   protected:
@@ -247,11 +251,12 @@ class SCAVE_API ResultFile
 {
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
     friend class ResultFileManager;
     friend class DataSorter; // due to ScalarResults[] etc
 
   public:
-    enum FileType { FILETYPE_OMNETPP, FILETYPE_SQLITE };
+    enum FileType { FILETYPE_OMNETPP, FILETYPE_SQLITE, FILETYPE_BINARY };
 
   private:
     int id;  // position in fileList
@@ -285,6 +290,7 @@ class SCAVE_API Run
     friend class ResultFileManager;
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
 
   private:
     std::string runName; // unique identifier for the run, "runId"
@@ -330,6 +336,7 @@ class SCAVE_API ResultFileManager
     friend class CmpBase; // uncheckedGet...()
     friend class OmnetppResultFileLoader;
     friend class SqliteResultFileLoader;
+    friend class BinaryResultFileLoader;
   private:
     // List of files loaded. This vector can have holes (NULLs) in it due to
     // unloaded files. The "id" field of ResultFile is the index into this vector.
@@ -18,8 +18,9 @@
 #include "omnetpp/platdep/platmisc.h"
 #include "channel.h"
 #include "scaveutils.h"
-#include "indexedvectorfilereader.h"
+#include "mappedvectorfilereader.h"
 #include "sqlitevectorreader.h"
+#include "binaryvectorreader.h"
 #include "sqliteresultfileutils.h"
 #include "vectorreaderbyfiletype.h"
 
@@ -50,8 +51,10 @@ Node *VectorReaderByFileTypeNodeType::create(DataflowManager *mgr, StringMap& at
     Node *node = nullptr;
     if (SqliteResultFileUtils::isSqliteFile(fname))
         node = new SqliteVectorReaderNode(fname, allowIndexing);
+    else if (BinaryVectorFileReader::isBinaryVectorFile(fname))
+        node = new BinaryVectorReaderNode(fname);
     else
-        node = new IndexedVectorFileReaderNode(fname);
+        node = new MappedVectorFileReaderNode(fname);
     node->setNodeType(this);  // note: both classes should be prepared to accept this class as node type
     mgr->addNode(node);
     return node;
@@ -67,14 +70,21 @@ Port *VectorReaderByFileTypeNodeType::getPort(Node *node, const char *portname)
         return node1->addVector(vectorId);
     }
 
-    if (IndexedVectorFileReaderNode *node1 = dynamic_cast<IndexedVectorFileReaderNode *>(node)) {
+    if (BinaryVectorReaderNode *node1 = dynamic_cast<BinaryVectorReaderNode *>(node)) {
         int vectorId;
         if (!parseInt(portname, vectorId))
-            throw opp_runtime_error("indexed file reader node: port should be a vector id, received: %s", portname);
+            throw opp_runtime_error("binary vector file reader node: port should be a vector id, received: %s", portname);
+        return node1->addVector(vectorId);
+    }
+
+    if (MappedVectorFileReaderNode *node1 = dynamic_cast<MappedVectorFileReaderNode *>(node)) {
+        int vectorId;
+        if (!parseInt(portname, vectorId))
+            throw opp_runtime_error("mapped vector file reader node: port should be a vector id, received: %s", portname);
         return node1->addVector(vectorId);
     }
 
-    throw opp_runtime_error("SqliteVectorReaderNode or IndexedVectorFileReaderNode expected");
+    throw opp_runtime_error("SqliteVectorReaderNode, BinaryVectorReaderNode or MappedVectorFileReaderNode expected");
 }
 
 }  // namespace scave
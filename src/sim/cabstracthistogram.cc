@@ -102,8 +102,8 @@ double cAbstractHistogram::getCDF(double x) const
 
 const cAbstractHistogram::Bin& cAbstractHistogram::internalGetBinInfo(int k) const
 {
-    // only for use in sim_std.msg (each call overwrites the static buffer!)
-    static Bin buf;
+    // only for use in sim_std.msg (each call overwrites the per-thread static buffer!)
+    static thread_local Bin buf;
     buf = getBinInfo(k);
     return buf;
 }
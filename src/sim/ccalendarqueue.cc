@@ -0,0 +1,386 @@
+//=========================================================================
+//  CCALENDARQUEUE.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//    cCalendarQueue : future event set, implemented as calendar queue
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <sstream>
+#include "omnetpp/globals.h"
+#include "omnetpp/cevent.h"
+#include "omnetpp/ccalendarqueue.h"
+
+namespace omnetpp {
+
+Register_Class(cCalendarQueue);
+
+#define MIN_BUCKETS       16    // must be power of 2
+#define WIDTH_SAMPLES     25    // number of events used for estimating the bucket width
+#define MAX_HEAD_WASTE    32    // compact bucket if more than this many slots are unused at its front
+
+inline bool precedes(const cEvent *a, const cEvent *b)
+{
+    return cEvent::compareBySchedulingOrder(a, b) < 0;
+}
+
+inline bool earlierTime(const cEvent *a, const cEvent *b)
+{
+    return a->getArrivalTime() < b->getArrivalTime();
+}
+
+//----
+
+cCalendarQueue::cCalendarQueue(const char *name) : cFutureEventSet(name)
+{
+    insertCount = 0;
+    length = 0;
+
+    numBuckets = MIN_BUCKETS;
+    buckets = new Bucket[numBuckets];
+    bucketWidth = SimTime::getScale() > 0 ? SimTime::getScale() : 1; // 1s; properly estimated on first resize
+    shrinkThreshold = 0;
+    growThreshold = 2 * numBuckets;
+
+    currentBucket = 0;
+    currentTop = bucketWidth;
+
+    snapshotValid = false;
+}
+
+cCalendarQueue::cCalendarQueue(const cCalendarQueue& other) : cFutureEventSet(other)
+{
+    buckets = nullptr;
+    length = 0;
+    copy(other);
+}
+
+cCalendarQueue::~cCalendarQueue()
+{
+    clear();
+    delete[] buckets;
+}
+
+std::string cCalendarQueue::str() const
+{
+    if (isEmpty())
+        return std::string("empty");
+    std::stringstream out;
+    out << "length=" << getLength() << " buckets=" << numBuckets << " width=" << getBucketWidth().ustr();
+    return out.str();
+}
+
+void cCalendarQueue::forEachChild(cVisitor *v)
+{
+    sort();
+
+    for (cEvent *event : snapshot)
+        v->visit(event);
+}
+
+void cCalendarQueue::clear()
+{
+    for (int i = 0; i < numBuckets; i++) {
+        Bucket& bucket = buckets[i];
+        for (int j = bucket.head; j < (int)bucket.events.size(); j++)
+            dropAndDelete(bucket.events[j]);
+        bucket.events.clear();
+        bucket.head = 0;
+    }
+    length = 0;
+    invalidateSnapshot();
+}
+
+void cCalendarQueue::copy(const cCalendarQueue& other)
+{
+    numBuckets = other.numBuckets;
+    bucketWidth = other.bucketWidth;
+    length = other.length;
+    insertCount = other.insertCount;
+    currentBucket = other.currentBucket;
+    currentTop = other.currentTop;
+    shrinkThreshold = other.shrinkThreshold;
+    growThreshold = other.growThreshold;
+
+    delete[] buckets;
+    buckets = new Bucket[numBuckets];
+    for (int i = 0; i < numBuckets; i++) {
+        const Bucket& otherBucket = other.buckets[i];
+        for (int j = otherBucket.head; j < (int)otherBucket.events.size(); j++) {
+            cEvent *event = otherBucket.events[j]->dup();
+            event->insertOrder = otherBucket.events[j]->insertOrder;
+            event->heapIndex = i;
+            take(event);
+            buckets[i].events.push_back(event);
+        }
+    }
+    invalidateSnapshot();
+}
+
+cCalendarQueue& cCalendarQueue::operator=(const cCalendarQueue& other)
+{
+    if (this == &other)
+        return *this;
+    cFutureEventSet::operator=(other);
+    clear();
+    copy(other);
+    return *this;
+}
+
+void cCalendarQueue::buildSnapshot()
+{
+    snapshot.clear();
+    snapshot.reserve(length);
+    for (int i = 0; i < numBuckets; i++) {
+        const Bucket& bucket = buckets[i];
+        snapshot.insert(snapshot.end(), bucket.events.begin() + bucket.head, bucket.events.end());
+    }
+    snapshotValid = true;
+}
+
+cEvent *cCalendarQueue::get(int k)
+{
+    if (k < 0 || k >= length)
+        return nullptr;
+    if (!snapshotValid)
+        buildSnapshot();
+    return snapshot[k];
+}
+
+void cCalendarQueue::sort()
+{
+    buildSnapshot();
+    std::sort(snapshot.begin(), snapshot.end(), precedes);
+}
+
+void cCalendarQueue::setPositionTo(int64_t t) const
+{
+    currentBucket = getBucketIndex(t);
+    int64_t year = t / bucketWidth;
+    currentTop = year < INT64_MAX / bucketWidth ? (year + 1) * bucketWidth : INT64_MAX;
+}
+
+void cCalendarQueue::bucketInsert(cEvent *event)
+{
+    int64_t t = event->getArrivalTime().raw();
+
+    // inserting before the current position (e.g. into an empty queue, or
+    // via putBackFirst()) moves the position back
+    if (length == 0 || t < currentTop - bucketWidth)
+        setPositionTo(t);
+
+    int index = getBucketIndex(t);
+    Bucket& bucket = buckets[index];
+    std::vector<cEvent*>& events = bucket.events;
+    event->heapIndex = index;
+
+    // fast paths: new last event (typical), new first event (putBackFirst())
+    if (bucket.isEmpty() || precedes(events.back(), event))
+        events.push_back(event);
+    else if (bucket.head > 0 && precedes(event, bucket.front()))
+        events[--bucket.head] = event;
+    else {
+        auto it = std::upper_bound(events.begin() + bucket.head, events.end(), event, precedes);
+        events.insert(it, event);
+    }
+}
+
+cCalendarQueue::Bucket *cCalendarQueue::findFirst() const
+{
+    if (length == 0)
+        return nullptr;
+
+    // sweep through the buckets for at most one "year"
+    for (int i = 0; i < numBuckets; i++) {
+        Bucket& bucket = buckets[currentBucket];
+        if (!bucket.isEmpty() && bucket.front()->getArrivalTime().raw() < currentTop)
+            return &bucket;
+        currentBucket = (currentBucket + 1) & (numBuckets-1);
+        currentTop = currentTop < INT64_MAX - bucketWidth ? currentTop + bucketWidth : INT64_MAX;
+    }
+
+    // no event in the next year: direct search
+    return findMinimum();
+}
+
+cCalendarQueue::Bucket *cCalendarQueue::findMinimum() const
+{
+    Bucket *first = nullptr;
+    for (int i = 0; i < numBuckets; i++)
+        if (!buckets[i].isEmpty() && (!first || precedes(buckets[i].front(), first->front())))
+            first = &buckets[i];
+    ASSERT(first != nullptr);
+    setPositionTo(first->front()->getArrivalTime().raw());
+    return first;
+}
+
+void cCalendarQueue::insert(cEvent *event)
+{
+    take(event);
+    event->insertOrder = insertCount++;
+    bucketInsert(event);
+    invalidateSnapshot();
+
+    if (++length > growThreshold)
+        resize(2 * numBuckets);
+}
+
+cEvent *cCalendarQueue::peekFirst() const
+{
+    Bucket *bucket = findFirst();
+    return bucket ? bucket->front() : nullptr;
+}
+
+cEvent *cCalendarQueue::removeFirst()
+{
+    Bucket *bucket = findFirst();
+    if (!bucket)
+        return nullptr;
+
+    cEvent *event = bucket->events[bucket->head++];
+    if (bucket->isEmpty()) {
+        bucket->events.clear();
+        bucket->head = 0;
+    }
+    else if (bucket->head > MAX_HEAD_WASTE && 2 * bucket->head > (int)bucket->events.size()) {
+        bucket->events.erase(bucket->events.begin(), bucket->events.begin() + bucket->head);
+        bucket->head = 0;
+    }
+
+    drop(event);
+    event->heapIndex = -1;
+    invalidateSnapshot();
+
+    if (--length < shrinkThreshold)
+        resize(numBuckets / 2);
+    return event;
+}
+
+cEvent *cCalendarQueue::remove(cEvent *event)
+{
+    // make sure it is really in the FES
+    if (event->heapIndex == -1)
+        return nullptr;
+
+    int index = getBucketIndex(event->getArrivalTime().raw());
+    ASSERT(event->heapIndex == index);  // sanity check
+    Bucket& bucket = buckets[index];
+    std::vector<cEvent*>& events = bucket.events;
+    auto it = std::lower_bound(events.begin() + bucket.head, events.end(), event, precedes);
+    ASSERT(it != events.end() && *it == event);  // sanity check
+
+    if (it == events.begin() + bucket.head)
+        bucket.head++;
+    else
+        events.erase(it);
+    if (bucket.isEmpty()) {
+        events.clear();
+        bucket.head = 0;
+    }
+
+    drop(event);
+    event->heapIndex = -1;
+    invalidateSnapshot();
+
+    if (--length < shrinkThreshold)
+        resize(numBuckets / 2);
+    return event;
+}
+
+void cCalendarQueue::putBackFirst(cEvent *event)
+{
+    take(event);
+    bucketInsert(event);  // note: insertOrder is kept, so the event gets back to the front
+    invalidateSnapshot();
+    length++;
+}
+
+int64_t cCalendarQueue::estimateBucketWidth(std::vector<cEvent*>& events) const
+{
+    // Brown's heuristic: the bucket width should be about three times the
+    // average separation of the events near the front of the queue, where
+    // the average is computed without the outliers
+    int n = std::min((int)events.size(), WIDTH_SAMPLES);
+    if (n < 2)
+        return bucketWidth;
+    std::nth_element(events.begin(), events.begin() + n - 1, events.end(), earlierTime);
+    std::sort(events.begin(), events.begin() + n, earlierTime);
+
+    double sum = 0;
+    for (int i = 1; i < n; i++)
+        sum += (double)(events[i]->getArrivalTime().raw() - events[i-1]->getArrivalTime().raw());
+    double average = sum / (n-1);
+
+    double sumBelow = 0;
+    int countBelow = 0;
+    for (int i = 1; i < n; i++) {
+        double separation = (double)(events[i]->getArrivalTime().raw() - events[i-1]->getArrivalTime().raw());
+        if (separation <= 2 * average) {
+            sumBelow += separation;
+            countBelow++;
+        }
+    }
+    if (countBelow == 0 || sumBelow == 0)
+        return bucketWidth;  // all sampled events at the same time: no information, keep the old width
+    double width = 3 * sumBelow / countBelow;
+    return width < 1 ? 1 : width > (double)(INT64_MAX / 4) ? INT64_MAX / 4 : (int64_t)width;
+}
+
+void cCalendarQueue::resize(int newNumBuckets)
+{
+    if (newNumBuckets < MIN_BUCKETS)
+        newNumBuckets = MIN_BUCKETS;
+
+    // collect all events
+    std::vector<cEvent*> events;
+    events.reserve(length);
+    for (int i = 0; i < numBuckets; i++)
+        events.insert(events.end(), buckets[i].events.begin() + buckets[i].head, buckets[i].events.end());
+    ASSERT((int)events.size() == length);
+
+    // set up new calendar
+    bucketWidth = estimateBucketWidth(events);
+    if (newNumBuckets != numBuckets) {
+        delete[] buckets;
+        numBuckets = newNumBuckets;
+        buckets = new Bucket[numBuckets];
+    }
+    else {
+        for (int i = 0; i < numBuckets; i++) {
+            buckets[i].events.clear();
+            buckets[i].head = 0;
+        }
+    }
+    growThreshold = 2 * numBuckets;
+    shrinkThreshold = numBuckets == MIN_BUCKETS ? 0 : numBuckets / 2 - 2;
+
+    // redistribute events; buckets are sorted afterwards, which is cheap
+    // because the typical bucket only contains a few events
+    for (cEvent *event : events) {
+        int index = getBucketIndex(event->getArrivalTime().raw());
+        event->heapIndex = index;
+        buckets[index].events.push_back(event);
+    }
+    for (int i = 0; i < numBuckets; i++)
+        if (buckets[i].events.size() > 1)
+            std::sort(buckets[i].events.begin(), buckets[i].events.end(), precedes);
+
+    if (length > 0)
+        findMinimum();  // sets the position
+    invalidateSnapshot();
+}
+
+}  // namespace omnetpp
+
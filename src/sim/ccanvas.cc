@@ -135,7 +135,7 @@ static const char *PKEY_RESOLUTION = "resolution";
 static const char *PKEY_INTERPOLATION = "interpolation";
 static const char *PKEY_TINT = "tint";
 
-int cFigure::lastId = 0;
+static thread_local int lastId = 0;  // per-thread, for concurrently running simulations
 cStringPool cFigure::stringPool;
 
 std::map<std::string,cObjectFactory*> cCanvas::figureFactories;
@@ -14,6 +14,8 @@
 *--------------------------------------------------------------*/
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include "common/stringutil.h"
 #include "omnetpp/ccomponent.h"
 #include "omnetpp/ccomponenttype.h"
@@ -41,28 +43,60 @@ namespace omnetpp {
 
 Register_PerObjectConfigOption(CFGID_PARAM_RECORD_AS_SCALAR, "param-record-as-scalar", KIND_PARAMETER, CFG_BOOL, "false", "Applicable to module parameters: specifies whether the module parameter should be recorded into the output scalar file. Set it for parameters whose value you will need for result analysis.");
 
-cComponent::SignalNameMapping *cComponent::signalNameMapping = nullptr;
-int cComponent::lastSignalID = -1;
-
+// The signal name registry is process-wide: signal IDs must be the same in all
+// threads. It is dynamically allocated on first access so that registerSignal()
+// can be invoked from static initialization code.
+struct SignalNameMapping {
+    std::map<std::string,simsignal_t> signalNameToID;
+    std::map<simsignal_t,std::string> signalIDToName;
+};
+static SignalNameMapping *signalNameMapping = nullptr;
+static std::atomic<int> lastSignalID(-1);
+static std::mutex signalRegistrationMutex;  // protects signalNameMapping
+
+// incremented on subscribe/unsubscribe and on module hierarchy changes, see getListenerFlags()
+static std::atomic<uint64_t> lastListenerFlagsGeneration(1);
+
+// The rest of the signal-related state belongs to the running simulation. It is
+// per-thread, so that independent simulations may run concurrently in separate threads.
+
+// for hasListeners()/mayHaveListeners(); index: signalID, value: number of listeners anywhere
+static thread_local std::vector<int> signalListenerCounts;
+#ifdef OPP_INLINE_TLS
+OPP_THREAD_LOCAL const int *cComponent::signalListenerCountsData = nullptr;
+OPP_THREAD_LOCAL int cComponent::numSignalListenerCounts = 0;
+#endif
+
+// stack of listener lists being notified, to detect concurrent modification
 static const int NOTIFICATION_STACK_SIZE = 64;
-cIListener **cComponent::notificationStack[NOTIFICATION_STACK_SIZE];
-int cComponent::notificationSP = 0;
-
-bool cComponent::checkSignals;
+static thread_local cIListener **notificationStack[NOTIFICATION_STACK_SIZE];
+static OPP_THREAD_LOCAL int notificationSP = 0;
+
+// whether only signals declared in NED via @signal are allowed to be emitted
+static OPP_THREAD_LOCAL bool checkSignals;
+
+// for caching the result of getResultRecorders(); not stored in cComponent
+// because we don't want to increase its size
+struct ResultRecorderList {
+    const cComponent *component;
+    std::vector<cResultRecorder*> recorders;
+};
+struct ResultRecorderListCache {
+    std::vector<ResultRecorderList*> lists;
+    ~ResultRecorderListCache() {clear();}
+    void clear() {for (ResultRecorderList *list : lists) delete list; lists.clear();}
+};
+static thread_local ResultRecorderListCache cachedResultRecorderLists;
 
 simsignal_t PRE_MODEL_CHANGE = cComponent::registerSignal("PRE_MODEL_CHANGE");
 simsignal_t POST_MODEL_CHANGE = cComponent::registerSignal("POST_MODEL_CHANGE");
 
 EXECUTE_ON_SHUTDOWN(cComponent::clearSignalRegistrations());
 
-std::vector<int> cComponent::signalListenerCounts;
-
 // Calling registerSignal in static initializers of runtime loaded dynamic
 // libraries would cause an assertion failure without this:
 EXECUTE_ON_STARTUP(cComponent::clearSignalState());
 
-std::vector<cComponent::ResultRecorderList*> cComponent::cachedResultRecorderLists;
-
 EXECUTE_ON_SHUTDOWN(cComponent::invalidateCachedResultRecorderLists())
 
 
@@ -80,6 +114,10 @@ cComponent::cComponent(const char *name) : cDefaultList(name)
 
     signalTable = nullptr;
 
+    listenerFlags = nullptr;
+    numListenerFlagWords = 0;
+    listenerFlagsGeneration = 0;
+
     setLogLevel(LOGLEVEL_TRACE);
 }
 
@@ -92,6 +130,7 @@ cComponent::~cComponent()
     delete[] rngMap;
     delete[] parArray;
     delete displayString;
+    delete[] listenerFlags;
 }
 
 void cComponent::forEachChild(cVisitor *v)
@@ -428,19 +467,18 @@ int cComponent::SignalListenerList::findListener(cIListener *l) const
 
 simsignal_t cComponent::registerSignal(const char *name)
 {
+    std::lock_guard<std::mutex> lock(signalRegistrationMutex);
     if (signalNameMapping == nullptr)
         signalNameMapping = new SignalNameMapping;
 
     std::map<std::string,simsignal_t>::iterator it = signalNameMapping->signalNameToID.find(name);
     if (it == signalNameMapping->signalNameToID.end()) {
-        // assign ID, register name
-        simsignal_t signalID = ++lastSignalID;
+        // assign ID, register name; note: listener counts of this thread and other
+        // threads are extended lazily, in clearSignalState() and subscribe()
+        simsignal_t signalID = lastSignalID + 1;
         signalNameMapping->signalNameToID[name] = signalID;
         signalNameMapping->signalIDToName[signalID] = name;
-        if (cStaticFlag::insideMain()) { // otherwise signalListenerCount[] may not have been initialized by C++ yet
-            signalListenerCounts.push_back(0);
-            ASSERT((int)signalListenerCounts.size() == lastSignalID+1);
-        }
+        lastSignalID = signalID;
         return signalID;
     }
     else {
@@ -450,6 +488,7 @@ simsignal_t cComponent::registerSignal(const char *name)
 
 const char *cComponent::getSignalName(simsignal_t signalID)
 {
+    std::lock_guard<std::mutex> lock(signalRegistrationMutex);
     if (!signalNameMapping)
         return nullptr;
     std::map<simsignal_t,std::string>::iterator it = signalNameMapping->signalIDToName.find(signalID);
@@ -461,9 +500,9 @@ void cComponent::clearSignalState()
     // note: registered signals remain intact
 
     // reset listener counts
-    signalListenerCounts.resize(lastSignalID+1);
-    for (int & listenerCount : signalListenerCounts)
-        listenerCount = 0;
+    signalListenerCounts.assign(lastSignalID+1, 0);
+    signalListenerCountsResized();
+    invalidateListenerFlags();
 
     // clear notification stack
     notificationSP = 0;
@@ -471,10 +510,26 @@ void cComponent::clearSignalState()
 
 void cComponent::clearSignalRegistrations()
 {
+    std::lock_guard<std::mutex> lock(signalRegistrationMutex);
     delete signalNameMapping;
     signalNameMapping = nullptr;
 }
 
+void cComponent::invalidateListenerFlags()
+{
+    lastListenerFlagsGeneration++;
+}
+
+void cComponent::setCheckSignals(bool b)
+{
+    checkSignals = b;
+}
+
+bool cComponent::getCheckSignals()
+{
+    return checkSignals;
+}
+
 cComponent::SignalListenerList *cComponent::findListenerList(simsignal_t signalID) const
 {
     // note: we could use std::binary_search() instead of linear search here,
@@ -549,26 +604,74 @@ void cComponent::removeListenerList(simsignal_t signalID)
     }
 }
 
-bool cComponent::hasListeners(simsignal_t signalID) const
+const uint64_t *cComponent::getListenerFlags() const
 {
-    // check local listeners
-    if (signalTable) {
-        int n = signalTable->size();
-        for (int i = 0; i < n; i++)
-            if ((*signalTable)[i].signalID == signalID)
-                return true;
+    uint64_t generation = lastListenerFlagsGeneration.load(std::memory_order_relaxed);
+    if (listenerFlagsGeneration == generation)
+        return listenerFlags;
+
+    int numWords = lastSignalID / 64 + 1;
+    if (numWords != numListenerFlagWords) {
+        delete[] listenerFlags;
+        listenerFlags = new uint64_t[2*numWords];  // inherited and local flags
+        numListenerFlagWords = numWords;
     }
+    uint64_t *localFlags = listenerFlags + numWords;
 
-    // if not found, check ancestors
+    // start from the parent's flags (note: parent may have fewer words if
+    // signals were registered since; new signals cannot have listeners there)
+    int i = 0;
     cModule *parent = getParentModule();
-    return parent ? parent->hasListeners(signalID) : false;
+    if (parent) {
+        const uint64_t *parentFlags = parent->getListenerFlags();
+        for (; i < numWords && i < parent->numListenerFlagWords; i++)
+            listenerFlags[i] = parentFlags[i];
+    }
+    for (; i < numWords; i++)
+        listenerFlags[i] = 0;
+
+    // add local listeners
+    for (i = 0; i < numWords; i++)
+        localFlags[i] = 0;
+    if (signalTable) {
+        for (const SignalListenerList& listenerList : *signalTable) {
+            uint64_t bit = (uint64_t)1 << (listenerList.signalID & 63);
+            listenerFlags[listenerList.signalID >> 6] |= bit;
+            localFlags[listenerList.signalID >> 6] |= bit;
+        }
+    }
+
+    listenerFlagsGeneration = generation;
+    return listenerFlags;
+}
+
+void cComponent::signalListenerCountsResized()
+{
+#ifdef OPP_INLINE_TLS
+    signalListenerCountsData = signalListenerCounts.data();
+    numSignalListenerCounts = (int)signalListenerCounts.size();
+#endif
+}
+
+bool cComponent::computeMayHaveListeners(simsignal_t signalID) const
+{
+    if (signalID < 0 || signalID > lastSignalID)
+        throwInvalidSignalID(signalID);
+    return signalID < (int)signalListenerCounts.size() && signalListenerCounts[signalID] > 0;
+}
+
+bool cComponent::hasListeners(simsignal_t signalID) const
+{
+    if (signalID < 0 || signalID > lastSignalID)
+        return false;
+    return signalID < (int)signalListenerCounts.size() && signalListenerCounts[signalID] > 0 && hasListenerFlag(signalID);
 }
 
 void cComponent::emit(simsignal_t signalID, bool b, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_BOOL);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, b, details);
 }
 
@@ -576,7 +679,7 @@ void cComponent::emit(simsignal_t signalID, long l, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_LONG);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, l, details);
 }
 
@@ -584,7 +687,7 @@ void cComponent::emit(simsignal_t signalID, unsigned long l, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_ULONG);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, l, details);
 }
 
@@ -592,7 +695,7 @@ void cComponent::emit(simsignal_t signalID, double d, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_DOUBLE);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, d, details);
 }
 
@@ -600,7 +703,7 @@ void cComponent::emit(simsignal_t signalID, const SimTime& t, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_SIMTIME);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, t, details);
 }
 
@@ -608,7 +711,7 @@ void cComponent::emit(simsignal_t signalID, const char *s, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_STRING);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, s, details);
 }
 
@@ -616,7 +719,7 @@ void cComponent::emit(simsignal_t signalID, cObject *obj, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_OBJECT, obj);
-    if (mayHaveListeners(signalID))
+    if (mayHaveListeners(signalID) && hasListenerFlag(signalID))
         fire(this, signalID, obj, details);
 }
 
@@ -624,7 +727,7 @@ template<typename T>
 void cComponent::fire(cComponent *source, simsignal_t signalID, T x, cObject *details)
 {
     // notify local listeners if there are any
-    SignalListenerList *listenerList = findListenerList(signalID);
+    SignalListenerList *listenerList = hasLocalListenerFlag(signalID) ? findListenerList(signalID) : nullptr;
     if (listenerList) {
         cIListener **listeners = listenerList->listeners;
         if (notificationSP >= NOTIFICATION_STACK_SIZE)
@@ -643,10 +746,14 @@ void cComponent::fire(cComponent *source, simsignal_t signalID, T x, cObject *de
         }
     }
 
-    // notify ancestors recursively
-    cModule *parent = getParentModule();
-    if (parent)
-        parent->fire(source, signalID, x, details);
+    // notify the nearest ancestor with local listeners (which continues from
+    // there), skipping the ones without; stop if no ancestor has listeners
+    for (cModule *ancestor = getParentModule(); ancestor && ancestor->hasListenerFlag(signalID); ancestor = ancestor->getParentModule()) {
+        if (ancestor->hasLocalListenerFlag(signalID)) {
+            ancestor->fire(source, signalID, x, details);
+            break;
+        }
+    }
 }
 
 void cComponent::fireFinish()
@@ -670,7 +777,12 @@ void cComponent::subscribe(simsignal_t signalID, cIListener *listener)
     checkNotFiring(signalID, listenerList->listeners);
     if (!listenerList->addListener(listener))
         throw cRuntimeError(this, "subscribe(): Listener already subscribed, signalID=%d (%s)", signalID, getSignalName(signalID));
+    if (signalID >= (int)signalListenerCounts.size()) {
+        signalListenerCounts.resize(lastSignalID+1, 0);  // signal was registered after clearSignalState()
+        signalListenerCountsResized();
+    }
     signalListenerCounts[signalID]++;
+    invalidateListenerFlags();
     listener->subscribeCount++;
     listener->subscribedTo(this, signalID);
 }
@@ -693,6 +805,7 @@ void cComponent::unsubscribe(simsignal_t signalID, cIListener *listener)
         removeListenerList(signalID);
 
     signalListenerCounts[signalID]--;
+    invalidateListenerFlags();
     listener->subscribeCount--;
     ASSERT(signalListenerCounts[signalID] >= 0);
     ASSERT(listener->subscribeCount >= 0);
@@ -785,7 +898,7 @@ void cComponent::releaseLocalListeners()
 const std::vector<cResultRecorder*>& cComponent::getResultRecorders() const
 {
     // return cached copy if exists
-    for (auto & cachedResultRecorderList : cachedResultRecorderLists)
+    for (ResultRecorderList *cachedResultRecorderList : cachedResultRecorderLists.lists)
         if (cachedResultRecorderList->component == this)
             return cachedResultRecorderList->recorders;
 
@@ -793,7 +906,7 @@ const std::vector<cResultRecorder*>& cComponent::getResultRecorders() const
     ResultRecorderList *recorderList =  new ResultRecorderList;
     recorderList->component = this;
     collectResultRecorders(recorderList->recorders);
-    cachedResultRecorderLists.push_back(recorderList);
+    cachedResultRecorderLists.lists.push_back(recorderList);
     return recorderList->recorders;
 }
 
@@ -822,9 +935,6 @@ void cComponent::collectResultRecorders(std::vector<cResultRecorder*>& result) c
 
 void cComponent::invalidateCachedResultRecorderLists()
 {
-    int n = cachedResultRecorderLists.size();
-    for (int i = 0; i < n; i++)
-        delete cachedResultRecorderLists[i];
     cachedResultRecorderLists.clear();
 }
 
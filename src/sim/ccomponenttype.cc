@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstring>
 #include "common/patternmatcher.h"
+#include "common/commonutil.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/csimplemodule.h"
@@ -105,15 +106,18 @@ cComponentType *cComponentType::get(const char *qname)
 
 cParImpl *cComponentType::getSharedParImpl(const char *key) const
 {
+    OptionalLockGuard<std::mutex> lock(cacheMutex);
     StringToParMap::const_iterator it = sharedParMap.find(key);
     return it == sharedParMap.end() ? nullptr : it->second;
 }
 
-void cComponentType::putSharedParImpl(const char *key, cParImpl *value)
+cParImpl *cComponentType::putSharedParImpl(const char *key, cParImpl *value)
 {
-    ASSERT(sharedParMap.find(key) == sharedParMap.end());  // not yet in there
-    value->setIsShared(true);
-    sharedParMap[key] = value;
+    OptionalLockGuard<std::mutex> lock(cacheMutex);
+    auto result = sharedParMap.insert(std::make_pair(std::string(key), value));
+    if (result.second)
+        value->setIsShared(true);
+    return result.first->second;
 }
 
 // cannot go inline due to declaration order
@@ -124,15 +128,18 @@ bool cComponentType::Less::operator()(cParImpl *a, cParImpl *b) const
 
 cParImpl *cComponentType::getSharedParImpl(cParImpl *value) const
 {
+    OptionalLockGuard<std::mutex> lock(cacheMutex);
     ParImplSet::const_iterator it = sharedParSet.find(value);
     return it == sharedParSet.end() ? nullptr : *it;
 }
 
-void cComponentType::putSharedParImpl(cParImpl *value)
+cParImpl *cComponentType::putSharedParImpl(cParImpl *value)
 {
-    ASSERT(sharedParSet.find(value) == sharedParSet.end());  // not yet in there
-    value->setIsShared(true);
-    sharedParSet.insert(value);
+    OptionalLockGuard<std::mutex> lock(cacheMutex);
+    auto result = sharedParSet.insert(value);
+    if (result.second)
+        value->setIsShared(true);
+    return *result.first;
 }
 
 bool cComponentType::isAvailable()
@@ -148,8 +155,14 @@ bool cComponentType::isAvailable()
 void cComponentType::checkSignal(simsignal_t signalID, SimsignalType type, cObject *obj)
 {
     // check that this signal is allowed
-    std::map<simsignal_t, SignalDesc>::const_iterator it = signalsSeen.find(signalID);
-    if (it == signalsSeen.end()) {
+    // note: map elements do not move on insertion, so the pointer remains valid after unlocking
+    const SignalDesc *descPtr;
+    {
+        OptionalLockGuard<std::mutex> lock(cacheMutex);
+        std::map<simsignal_t, SignalDesc>::const_iterator it = signalsSeen.find(signalID);
+        descPtr = it == signalsSeen.end() ? nullptr : &it->second;
+    }
+    if (!descPtr) {
         // ignore built-in signals
         if (signalID == PRE_MODEL_CHANGE || signalID == POST_MODEL_CHANGE)
             return;
@@ -162,7 +175,7 @@ void cComponentType::checkSignal(simsignal_t signalID, SimsignalType type, cObje
 
         // found; extract info from it, and add signal to signalsSeen
         const char *declaredType = prop->getValue("type");
-        SignalDesc& desc = signalsSeen[signalID];
+        SignalDesc desc;
         desc.type = !declaredType ? SIMSIGNAL_UNDEF : getSignalType(declaredType, SIMSIGNAL_OBJECT);
         desc.objectType = nullptr;
         desc.isNullable = false;
@@ -182,11 +195,12 @@ void cComponentType::checkSignal(simsignal_t signalID, SimsignalType type, cObje
                                     "registered class name optionally followed by a question mark",
                         declaredType, prop->getIndex(), getFullName());
         }
-        it = signalsSeen.find(signalID);
+        OptionalLockGuard<std::mutex> lock(cacheMutex);
+        descPtr = &signalsSeen.insert(std::make_pair(signalID, desc)).first->second;
     }
 
     // check data type
-    const SignalDesc& desc = it->second;
+    const SignalDesc& desc = *descPtr;
     if (type == SIMSIGNAL_OBJECT) {
         if (desc.type == SIMSIGNAL_OBJECT) {
             if (desc.objectType && !desc.objectType->isInstance(obj)) {
@@ -21,10 +21,21 @@
 
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
+#include <cstdint>
 #include <new>  // bad::alloc
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/cexception.h"
 
+#if defined(USE_POSIX_COROUTINES) || defined(USE_ASM_COROUTINES)
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <csignal>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
 #ifdef USE_PORTABLE_COROUTINES
 #include "task.h"  // Stig Kofoed's "Portable Multitasking" coroutine library
 #endif
@@ -33,7 +44,8 @@ namespace omnetpp {
 
 #ifdef USE_WIN32_FIBERS
 
-LPVOID cCoroutine::lpMainFiber;
+// per-thread, so that simulations may run concurrently in separate threads
+static thread_local LPVOID lpMainFiber;
 
 void cCoroutine::init(unsigned totalStack, unsigned mainStack)
 {
@@ -99,16 +111,221 @@ unsigned cCoroutine::getStackUsage() const
 
 #endif
 
+#if defined(USE_POSIX_COROUTINES) || defined(USE_ASM_COROUTINES)
+
+//
+// Coroutine stacks are mapped with mmap(), with an inaccessible guard area
+// below them (stacks grow downwards), so that a stack overflow causes an
+// immediate fault instead of silently corrupting memory. Pages are only
+// committed by the OS when first touched, so generously sized stacks only
+// cost address space. Stacks of deleted coroutines are kept in a per-thread
+// free-list, and reused for coroutines of the same stack size; their pages are
+// given back to the OS while in the free-list.
+//
+// Note: every guarded stack takes two memory mappings, and the number of
+// mappings per process is limited (65530 by default on Linux, see
+// vm.max_map_count). Beyond MAX_MAPPED_STACKS, stacks are allocated on the
+// heap, without a guard area.
+//
+
+#define GUARD_SIZE       (64*1024)   // more than one page, as large stack frames may skip a single page
+#define ALTSTACK_SIZE    (256*1024)  // for the SIGSEGV handler (and the handler it chains to)
+#define MAX_FREE_STACKS  256
+#define MAX_MAPPED_STACKS  16384
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS  MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE  0
+#endif
+#ifndef MAP_STACK
+#define MAP_STACK  0
+#endif
+
+static size_t pageSize;
+static size_t guardSize;
+static struct sigaction oldSegvAction;
+static std::atomic<int> numMappedStacks(0);  // per process, like the limit on mappings
+
+// lowest address of the stack of the coroutine running in this thread (nullptr for main)
+static thread_local char *curStackLow;
+
+struct StackPool
+{
+    std::vector<std::pair<char *, size_t>> freeStacks;  // stack and its size
+    ~StackPool();
+};
+
+static thread_local StackPool stackPool;
+
+static size_t roundUpToPageSize(size_t size)
+{
+    return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+static void unmapStack(char *stack, size_t size)
+{
+    munmap(stack - guardSize, guardSize + size);
+    numMappedStacks--;
+}
+
+StackPool::~StackPool()
+{
+    for (auto& item : freeStacks)
+        unmapStack(item.first, item.second);
+}
+
+// note: size must be a multiple of the page size
+static char *allocateStack(size_t size, bool& mapped)
+{
+    mapped = true;
+    std::vector<std::pair<char *, size_t>>& freeStacks = stackPool.freeStacks;
+    for (int i = (int)freeStacks.size() - 1; i >= 0; i--) {
+        if (freeStacks[i].second == size) {
+            char *stack = freeStacks[i].first;
+            freeStacks[i] = freeStacks.back();
+            freeStacks.pop_back();
+            return stack;
+        }
+    }
+
+    if (++numMappedStacks <= MAX_MAPPED_STACKS) {
+        void *p = mmap(nullptr, guardSize + size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+        if (p != MAP_FAILED) {
+            mprotect(p, guardSize, PROT_NONE);  // if it fails, the stack just remains unguarded
+            return (char *)p + guardSize;
+        }
+    }
+    numMappedStacks--;
+
+    mapped = false;
+    try {
+        return new char[size];
+    }
+    catch (std::bad_alloc& e) {
+        return nullptr;
+    }
+}
+
+static void releaseStack(char *stack, size_t size, bool mapped)
+{
+    if (!mapped)
+        delete[] stack;
+    else if (stackPool.freeStacks.size() < MAX_FREE_STACKS) {
+        madvise(stack, size, MADV_DONTNEED);  // release the committed pages, but keep the mapping
+        stackPool.freeStacks.push_back(std::make_pair(stack, size));
+    }
+    else
+        unmapStack(stack, size);
+}
+
+static unsigned getResidentStackSize(char *stack, size_t size, bool mapped)
+{
+    if (!mapped)
+        return 0;
+
+    // pages that have never been touched are not resident
+    std::vector<unsigned char> pages(size / pageSize);
+    if (pages.empty() || mincore(stack, size, (decltype(&pages[0]))pages.data()) != 0)
+        return 0;
+    size_t numResident = 0;
+    for (unsigned char page : pages)
+        if (page & 1)
+            numResident++;
+    return numResident * pageSize;
+}
+
+static void segvHandler(int sig, siginfo_t *info, void *context)
+{
+    char *addr = (char *)info->si_addr;
+    if (curStackLow && addr < curStackLow && addr >= curStackLow - guardSize) {
+        static const char msg[] = "\n<!> Coroutine stack overflow: the activity() of a simple module "
+                                  "ran out of stack, increase its stack size\n";
+        if (write(STDERR_FILENO, msg, sizeof(msg) - 1)) {}
+    }
+
+    // continue with the previous handler (e.g. the one that attaches the debugger),
+    // or with the default action by letting the faulting instruction run again
+    if (oldSegvAction.sa_flags & SA_SIGINFO)
+        oldSegvAction.sa_sigaction(sig, info, context);
+    else if (oldSegvAction.sa_handler != SIG_DFL && oldSegvAction.sa_handler != SIG_IGN)
+        oldSegvAction.sa_handler(sig);
+    else
+        signal(SIGSEGV, SIG_DFL);
+}
+
+struct AltSignalStack
+{
+    void *stack = nullptr;
+    AltSignalStack();
+    ~AltSignalStack();
+};
+
+AltSignalStack::AltSignalStack()
+{
+    // the SIGSEGV handler cannot run on the stack that overflowed
+    stack_t oldStack;
+    if (sigaltstack(nullptr, &oldStack) != 0 || !(oldStack.ss_flags & SS_DISABLE))
+        return;  // already set up by someone else
+    void *p = mmap(nullptr, ALTSTACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return;
+    stack_t altStack;
+    altStack.ss_sp = p;
+    altStack.ss_size = ALTSTACK_SIZE;
+    altStack.ss_flags = 0;
+    if (sigaltstack(&altStack, nullptr) == 0)
+        stack = p;
+    else
+        munmap(p, ALTSTACK_SIZE);
+}
+
+AltSignalStack::~AltSignalStack()
+{
+    if (stack) {
+        stack_t altStack;
+        memset(&altStack, 0, sizeof(altStack));
+        altStack.ss_flags = SS_DISABLE;
+        sigaltstack(&altStack, nullptr);
+        munmap(stack, ALTSTACK_SIZE);
+    }
+}
+
+static void initStacks()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        pageSize = sysconf(_SC_PAGESIZE);
+        guardSize = roundUpToPageSize(GUARD_SIZE);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = segvHandler;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, &oldSegvAction);
+    });
+
+    static thread_local AltSignalStack altSignalStack;
+    (void)altSignalStack;
+}
+
+#endif
+
 #ifdef USE_POSIX_COROUTINES
 
-ucontext_t cCoroutine::mainContext;
-ucontext_t *cCoroutine::curContextPtr;
-unsigned cCoroutine::totalStackUsage;
-unsigned cCoroutine::totalStackLimit;
+// per-thread, so that simulations may run concurrently in separate threads
+static thread_local ucontext_t mainContext;
+static thread_local ucontext_t *curContextPtr;
+static thread_local unsigned totalStackUsage;
+static thread_local unsigned totalStackLimit;
 
 void cCoroutine::init(unsigned totalStack, unsigned mainStack)
 {
+    initStacks();
     curContextPtr = &mainContext;
+    curStackLow = nullptr;
     totalStackUsage = 0;
     totalStackLimit = totalStack;
 }
@@ -117,6 +334,7 @@ void cCoroutine::switchTo(cCoroutine *cor)
 {
     ucontext_t *oldContextPtr = curContextPtr;
     curContextPtr = &(cor->context);
+    curStackLow = cor->stackPtr;
     swapcontext(oldContextPtr, curContextPtr);
 }
 
@@ -126,6 +344,7 @@ void cCoroutine::switchToMain()
         return;
     ucontext_t *oldContextPtr = curContextPtr;
     curContextPtr = &mainContext;
+    curStackLow = nullptr;
     swapcontext(oldContextPtr, curContextPtr);
 }
 
@@ -133,26 +352,26 @@ cCoroutine::cCoroutine()
 {
     stackSize = 0;
     stackPtr = nullptr;
+    stackMapped = false;
 }
 
 cCoroutine::~cCoroutine()
 {
     totalStackUsage -= stackSize;
-    delete[] stackPtr;
+    if (stackPtr)
+        releaseStack(stackPtr, stackSize, stackMapped);
 }
 
 bool cCoroutine::setup(CoroutineFnp fnp, void *arg, unsigned stkSize)
 {
+    stkSize = roundUpToPageSize(stkSize);
     if (totalStackLimit != 0 && totalStackUsage + stkSize >= totalStackLimit)
         return false;
 
-    try {
-        stackPtr = new char[stkSize];
-        stackSize = stkSize;
-    }
-    catch (std::bad_alloc& e) {
+    stackPtr = allocateStack(stkSize, stackMapped);
+    if (!stackPtr)
         return false;
-    }
+    stackSize = stkSize;
     context.uc_stack.ss_sp = stackPtr;
     context.uc_stack.ss_size = stackSize;
     context.uc_link = &mainContext;
@@ -175,7 +394,256 @@ unsigned cCoroutine::getStackSize() const
 
 unsigned cCoroutine::getStackUsage() const
 {
-    return 0;
+    return stackPtr ? getResidentStackSize(stackPtr, stackSize, stackMapped) : 0;
+}
+
+#endif
+
+#ifdef USE_ASM_COROUTINES
+
+//
+// Context switching with hand-written assembly. Only the registers that the
+// calling convention requires a function to preserve are saved, on the stack
+// of the coroutine being suspended; the stack pointer is then stored in
+// *fromSp, and the other coroutine's registers are popped from toSp.
+// New coroutines start in oppCoroutineStart, which calls fnp(arg).
+//
+extern "C" {
+void oppCoroutineSwitch(void **fromSp, void *toSp) __attribute__((visibility("hidden")));
+void oppCoroutineStart() __attribute__((visibility("hidden")));
+void oppCoroutineExit() __attribute__((visibility("hidden"), noreturn));
+}
+
+#if defined __x86_64__
+
+// saved: rbp, rbx, r12-r15, plus the SSE control/status and x87 control words
+__asm__(
+    ".text\n"
+    ".globl oppCoroutineSwitch\n"
+    ".hidden oppCoroutineSwitch\n"
+    ".type oppCoroutineSwitch,@function\n"
+    ".p2align 4\n"
+    "oppCoroutineSwitch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size oppCoroutineSwitch,.-oppCoroutineSwitch\n"
+    "\n"
+    ".globl oppCoroutineStart\n"
+    ".hidden oppCoroutineStart\n"
+    ".type oppCoroutineStart,@function\n"
+    ".p2align 4\n"
+    "oppCoroutineStart:\n"
+    "    .cfi_startproc\n"
+    "    .cfi_undefined rip\n"  // end of the call chain for debuggers and unwinders
+    "    movq %r13, %rdi\n"
+    "    callq *%r12\n"
+    "    callq oppCoroutineExit\n"
+    "    .cfi_endproc\n"
+    ".size oppCoroutineStart,.-oppCoroutineStart\n"
+);
+
+// layout of the saved registers on the stack, from the saved stack pointer upwards
+struct SavedRegisters {
+    uint32_t mxcsr;
+    uint16_t fpucw;
+    uint16_t padding;
+    void *r15, *r14, *r13, *r12, *rbx, *rbp;
+    void *returnAddress;
+};
+
+static void initSavedRegisters(SavedRegisters *regs, CoroutineFnp fnp, void *arg)
+{
+    memset(regs, 0, sizeof(SavedRegisters));
+    __asm__ __volatile__ ("stmxcsr %0" : "=m" (regs->mxcsr));
+    __asm__ __volatile__ ("fnstcw %0" : "=m" (regs->fpucw));
+    regs->r12 = (void *)fnp;
+    regs->r13 = arg;
+    regs->returnAddress = (void *)oppCoroutineStart;
+}
+
+#elif defined __aarch64__
+
+// saved: x19-x28, fp (x29), lr (x30), and the lower halves of v8-v15
+__asm__(
+    ".text\n"
+    ".globl oppCoroutineSwitch\n"
+    ".hidden oppCoroutineSwitch\n"
+    ".type oppCoroutineSwitch,%function\n"
+    ".p2align 4\n"
+    "oppCoroutineSwitch:\n"
+    "    sub sp, sp, #160\n"
+    "    stp d8, d9, [sp, #0]\n"
+    "    stp d10, d11, [sp, #16]\n"
+    "    stp d12, d13, [sp, #32]\n"
+    "    stp d14, d15, [sp, #48]\n"
+    "    stp x19, x20, [sp, #64]\n"
+    "    stp x21, x22, [sp, #80]\n"
+    "    stp x23, x24, [sp, #96]\n"
+    "    stp x25, x26, [sp, #112]\n"
+    "    stp x27, x28, [sp, #128]\n"
+    "    stp x29, x30, [sp, #144]\n"
+    "    mov x2, sp\n"
+    "    str x2, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp d8, d9, [sp, #0]\n"
+    "    ldp d10, d11, [sp, #16]\n"
+    "    ldp d12, d13, [sp, #32]\n"
+    "    ldp d14, d15, [sp, #48]\n"
+    "    ldp x19, x20, [sp, #64]\n"
+    "    ldp x21, x22, [sp, #80]\n"
+    "    ldp x23, x24, [sp, #96]\n"
+    "    ldp x25, x26, [sp, #112]\n"
+    "    ldp x27, x28, [sp, #128]\n"
+    "    ldp x29, x30, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".size oppCoroutineSwitch,.-oppCoroutineSwitch\n"
+    "\n"
+    ".globl oppCoroutineStart\n"
+    ".hidden oppCoroutineStart\n"
+    ".type oppCoroutineStart,%function\n"
+    ".p2align 4\n"
+    "oppCoroutineStart:\n"
+    "    .cfi_startproc\n"
+    "    .cfi_undefined x30\n"  // end of the call chain for debuggers and unwinders
+    "    mov x0, x20\n"
+    "    blr x19\n"
+    "    bl oppCoroutineExit\n"
+    "    .cfi_endproc\n"
+    ".size oppCoroutineStart,.-oppCoroutineStart\n"
+);
+
+// layout of the saved registers on the stack, from the saved stack pointer upwards
+struct SavedRegisters {
+    double d8, d9, d10, d11, d12, d13, d14, d15;
+    void *x19, *x20, *x21, *x22, *x23, *x24, *x25, *x26, *x27, *x28;
+    void *x29, *x30;
+};
+
+static void initSavedRegisters(SavedRegisters *regs, CoroutineFnp fnp, void *arg)
+{
+    memset(regs, 0, sizeof(SavedRegisters));
+    regs->x19 = (void *)fnp;
+    regs->x20 = arg;
+    regs->x30 = (void *)oppCoroutineStart;
+}
+
+#else
+#error "USE_ASM_COROUTINES is only supported on x86-64 and aarch64"
+#endif
+
+// per-thread, so that simulations may run concurrently in separate threads
+static thread_local void *mainSp;
+static thread_local void **curSpPtr;
+static thread_local unsigned totalStackUsage;
+static thread_local unsigned totalStackLimit;
+
+void oppCoroutineExit()
+{
+    // like uc_link with POSIX coroutines: coroutine functions that return end up in main
+    cCoroutine::switchToMain();
+    fprintf(stderr, "INTERNAL ERROR: switch to a coroutine that has already returned");
+    abort();
+}
+
+void cCoroutine::init(unsigned totalStack, unsigned mainStack)
+{
+    initStacks();
+    curSpPtr = &mainSp;
+    curStackLow = nullptr;
+    totalStackUsage = 0;
+    totalStackLimit = totalStack;
+}
+
+void cCoroutine::switchTo(cCoroutine *cor)
+{
+    void **oldSpPtr = curSpPtr;
+    if (oldSpPtr == &cor->savedSp)
+        return;
+    curSpPtr = &cor->savedSp;
+    curStackLow = cor->stackPtr;
+    oppCoroutineSwitch(oldSpPtr, cor->savedSp);
+}
+
+void cCoroutine::switchToMain()
+{
+    if (curSpPtr == &mainSp)
+        return;
+    void **oldSpPtr = curSpPtr;
+    curSpPtr = &mainSp;
+    curStackLow = nullptr;
+    oppCoroutineSwitch(oldSpPtr, mainSp);
+}
+
+cCoroutine::cCoroutine()
+{
+    stackSize = 0;
+    stackPtr = nullptr;
+    stackMapped = false;
+    savedSp = nullptr;
+}
+
+cCoroutine::~cCoroutine()
+{
+    totalStackUsage -= stackSize;
+    if (stackPtr)
+        releaseStack(stackPtr, stackSize, stackMapped);
+}
+
+bool cCoroutine::setup(CoroutineFnp fnp, void *arg, unsigned stkSize)
+{
+    stkSize = roundUpToPageSize(stkSize);
+    if (stkSize == 0)
+        return false;
+    if (totalStackLimit != 0 && totalStackUsage + stkSize >= totalStackLimit)
+        return false;
+
+    stackPtr = allocateStack(stkSize, stackMapped);
+    if (!stackPtr)
+        return false;
+    stackSize = stkSize;
+    totalStackUsage += stackSize;
+
+    // the stack grows downwards; the ABIs require 16-byte alignment at calls
+    uintptr_t stackTop = ((uintptr_t)stackPtr + stackSize) & ~(uintptr_t)15;
+    SavedRegisters *regs = (SavedRegisters *)(stackTop - sizeof(SavedRegisters));
+    initSavedRegisters(regs, fnp, arg);
+    savedSp = regs;
+    return true;
+}
+
+bool cCoroutine::hasStackOverflow() const
+{
+    return false;
+}
+
+unsigned cCoroutine::getStackSize() const
+{
+    return stackSize;
+}
+
+unsigned cCoroutine::getStackUsage() const
+{
+    return stackPtr ? getResidentStackSize(stackPtr, stackSize, stackMapped) : 0;
 }
 
 #endif
@@ -199,6 +199,7 @@ void cDefaultList::drop(cOwnedObject *obj)
         throw cRuntimeError(this, "drop(): Not owner of object (%s)%s",
                 obj->getClassName(), obj->getFullPath().c_str());
     // the following 2 lines are actually the same as defaultOwner->take(obj);
+    cDefaultList *defaultOwner = getDefaultOwner();
     yieldOwnership(obj, defaultOwner);
     defaultOwner->doInsert(obj);
 }
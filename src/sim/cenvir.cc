@@ -29,6 +29,7 @@ cEnvir::cEnvir()
 {
     loggingEnabled = true;
     suppressNotifications = false;  //FIXME set to true when not needed!
+    suppressPassThroughHops = false;
 }
 
 cEnvir::~cEnvir()
@@ -47,7 +48,7 @@ cConfigurationEx *cEnvir::getConfigEx()
 
 void cEnvir::printfmsg(const char *fmt, ...)
 {
-    static char staticbuf[BUFLEN];
+    static thread_local char staticbuf[BUFLEN];
     VSNPRINTF(staticbuf, BUFLEN, fmt);
     alert(staticbuf);
 }
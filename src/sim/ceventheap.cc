@@ -22,8 +22,9 @@
 
 #include <cstdio>           // sprintf
 #include <cstring>          // strlen
-#include <cstdlib>          // qsort
+#include <cstdint>          // uintptr_t
 #include <sstream>
+#include <algorithm>
 #include "omnetpp/globals.h"
 #include "omnetpp/cmessage.h"
 #include "omnetpp/ceventheap.h"
@@ -32,26 +33,22 @@ namespace omnetpp {
 
 Register_Class(cEventHeap);
 
-#define CBHEAPINDEX(i)    (-2-(i))
-#define CBINC(i)          ((i) = ((i)+1)&(cbsize-1))
-#define CBDEC(i)          ((i) = ((i)-1)&(cbsize-1))
-
-inline bool operator>(cEvent& a, cEvent& b)
-{
-    return b.shouldPrecede(&a);
-}
-
-inline bool operator<=(cEvent& a, cEvent& b)
-{
-    return !(a > b);
-}
-
-static int qsort_cmp_msgs(const void *p1, const void *p2)
-{
-    cEvent *m1 = *(cEvent **)p1;
-    cEvent *m2 = *(cEvent **)p2;
-    return cEvent::compareBySchedulingOrder(m1, m2);
-}
+// heapIndex of events in the lanes: encodes the lane and the position in it
+#define CBHEAPINDEX(lane,i)  (-2-((i)*NUM_LANES+(lane)))
+#define CBLANE(heapIndex)    ((-2-(heapIndex)) % NUM_LANES)
+#define CBPOS(heapIndex)     ((-2-(heapIndex)) / NUM_LANES)
+#define CBINC(i)          ((i) = ((i)+1)&(l.cbsize-1))
+#define CBDEC(i)          ((i) = ((i)-1)&(l.cbsize-1))
+
+// The heap is d-ary. The root is placed at index HEAP_ROOT=d-1, so that the
+// children of every node start at an index divisible by d, i.e. with suitable
+// alignment of the array, siblings occupy a single aligned memory block
+// (with d=4 and 32-byte entries, two cache lines).
+#define HEAP_ARITY        4
+#define HEAP_ROOT         (HEAP_ARITY-1)
+#define HEAP_ALIGNMENT    128
+#define FIRSTCHILD(i)     (HEAP_ARITY*((i)-HEAP_ROOT)+HEAP_ROOT+1)
+#define PARENT(i)         (((i)-HEAP_ROOT-1)/HEAP_ARITY+HEAP_ROOT)
 
 //----
 
@@ -61,27 +58,45 @@ cEventHeap::cEventHeap(const char *name, int intialCapacity) : cFutureEventSet(n
 
     heapLength = 0;
     heapCapacity = intialCapacity;
-    heap = new cEvent *[heapCapacity+1];  // +1 is necessary because h[0] is not used
+    heap = allocateHeap(heapCapacity, heapMemory);
 
-    cbsize = 4;  // must be power of 2!
-    cb = new cEvent *[cbsize];
-    cbhead = cbtail = 0;
+    initLanes();
     useCb = true;
 }
 
 cEventHeap::cEventHeap(const cEventHeap& other) : cFutureEventSet(other)
 {
-    cb = nullptr;
     heap = nullptr;
+    heapMemory = nullptr;
     heapLength = 0;
+    initLanes();
     copy(other);
 }
 
 cEventHeap::~cEventHeap()
 {
     clear();
-    delete[] heap;
-    delete[] cb;
+    delete[] heapMemory;
+    for (Lane& l : lanes)
+        delete[] l.cb;
+}
+
+void cEventHeap::initLanes()
+{
+    for (Lane& l : lanes) {
+        l.cbsize = 4;  // must be power of 2!
+        l.cb = new cEvent *[l.cbsize];
+        l.cbhead = l.cbtail = 0;
+    }
+    laneCount = 0;
+    firstLane = NUM_LANES;
+}
+
+cEventHeap::HeapEntry *cEventHeap::allocateHeap(int capacity, char *&memory)
+{
+    memory = new char[(HEAP_ROOT+capacity) * sizeof(HeapEntry) + HEAP_ALIGNMENT];
+    uintptr_t misalignment = (uintptr_t)memory % HEAP_ALIGNMENT;
+    return (HeapEntry *)(memory + (misalignment == 0 ? 0 : HEAP_ALIGNMENT - misalignment));
 }
 
 std::string cEventHeap::str() const
@@ -97,22 +112,22 @@ void cEventHeap::forEachChild(cVisitor *v)
 {
     sort();
 
-    for (int i = cbhead; i != cbtail; CBINC(i))
-        v->visit(cb[i]);
-
-    for (int i = 1; i <= heapLength; i++)
-        if (heap[i])
-            v->visit(heap[i]);
+    for (int i = HEAP_ROOT; i < HEAP_ROOT+heapLength; i++)
+        v->visit(heap[i].event);
 }
 
 void cEventHeap::clear()
 {
-    for (int i = cbhead; i != cbtail; CBINC(i))
-        dropAndDelete(cb[i]);
-    cbhead = cbtail = 0;
+    for (Lane& l : lanes) {
+        for (int i = l.cbhead; i != l.cbtail; CBINC(i))
+            dropAndDelete(l.cb[i]);
+        l.cbhead = l.cbtail = 0;
+    }
+    laneCount = 0;
+    firstLane = NUM_LANES;
 
-    for (int i = 1; i <= heapLength; i++)
-        dropAndDelete(heap[i]);
+    for (int i = HEAP_ROOT; i < HEAP_ROOT+heapLength; i++)
+        dropAndDelete(heap[i].event);
     heapLength = 0;
 }
 
@@ -121,20 +136,36 @@ void cEventHeap::copy(const cEventHeap& other)
     // copy heap
     heapLength = other.heapLength;
     heapCapacity = other.heapCapacity;
-    delete[] heap;
-    heap = new cEvent *[heapCapacity+1];
-    for (int i = 1; i <= heapLength; i++)
-        take(heap[i] = other.heap[i]->dup());
-
-    // copy circular buffer
-    cbhead = other.cbhead;
-    cbtail = other.cbtail;
-    cbsize = other.cbsize;
+    delete[] heapMemory;
+    heap = allocateHeap(heapCapacity, heapMemory);
+    for (int i = HEAP_ROOT; i < HEAP_ROOT+heapLength; i++) {
+        heap[i] = other.heap[i];
+        cEvent *event = heap[i].event = other.heap[i].event->dup();
+        event->insertOrder = heap[i].insertOrder;
+        event->heapIndex = i;
+        take(event);
+    }
+
+    // copy lanes
+    for (int lane = 0; lane < NUM_LANES; lane++) {
+        Lane& l = lanes[lane];
+        const Lane& o = other.lanes[lane];
+        delete[] l.cb;
+        l.cbhead = o.cbhead;
+        l.cbtail = o.cbtail;
+        l.cbsize = o.cbsize;
+        l.cb = new cEvent *[l.cbsize];
+        for (int i = l.cbhead; i != l.cbtail; CBINC(i)) {
+            cEvent *event = l.cb[i] = o.cb[i]->dup();
+            event->insertOrder = o.cb[i]->insertOrder;
+            event->heapIndex = CBHEAPINDEX(lane, i);
+            take(event);
+        }
+    }
+    laneCount = other.laneCount;
+    firstLane = other.firstLane;
+    laneTime = other.laneTime;
     useCb = other.useCb;
-    delete[] cb;
-    cb = new cEvent *[cbsize];
-    for (int i = cbhead; i != cbtail; CBINC(i))
-        take(cb[i] = other.cb[i]->dup());
 }
 
 cEventHeap& cEventHeap::operator=(const cEventHeap& other)
@@ -152,23 +183,34 @@ cEvent *cEventHeap::get(int k)
     if (k < 0)
         return nullptr;
 
-    // first few elements map into the circular buffer
-    int cblen = cblength();
-    if (k < cblen)
-        return cbget(k);
-    k -= cblen;
+    // first few elements map into the lanes
+    if (k < laneCount) {
+        for (int lane = firstLane; lane < NUM_LANES; lane++) {
+            int len = lanes[lane].length();
+            if (k < len)
+                return lanes[lane].get(k);
+            k -= len;
+        }
+        ASSERT(false);
+    }
+    k -= laneCount;
 
-    // map the rest to h[1]..h[n] (h[] is 1-based)
+    // map the rest to the heap
     if (k >= heapLength)
         return nullptr;
-    return heap[k+1];
+    return heap[HEAP_ROOT+k].event;
 }
 
 void cEventHeap::sort()
 {
-    qsort(heap+1, heapLength, sizeof(cEvent *), qsort_cmp_msgs);
-    for (int i = 1; i <= heapLength; i++)
-        heap[i]->heapIndex = i;
+    // the heap may contain events that should precede some in the lanes,
+    // so the easiest way to get everything in order is to move them to the heap
+    flushCb();
+
+    // note: a sorted array also satisfies the heap property
+    std::sort(heap+HEAP_ROOT, heap+HEAP_ROOT+heapLength);
+    for (int i = HEAP_ROOT; i < HEAP_ROOT+heapLength; i++)
+        heap[i].event->heapIndex = i;
 }
 
 void cEventHeap::insert(cEvent *event)
@@ -177,127 +219,176 @@ void cEventHeap::insert(cEvent *event)
 
     event->insertOrder = insertCount++;
 
-    if (!useCb) {
-        heapInsert(event);
-        return;
-    }
-
-    // is event eligible for putting it into the cb?
-    bool eligible = false;
-    simtime_t now = simTime();
-    if (event->getArrivalTime() == now) {
-        ASSERT(cbhead == cbtail || cb[cbhead]->getArrivalTime() == now); // causality violation
-        if (event->getSchedulingPriority() == 0) {
-            if (heapLength == 0 || heap[1]->getArrivalTime() > now)
-                eligible = true;
-        }
-        else if (event->getSchedulingPriority() < 0)
-            flushCb();  // move all events into the heap
-    }
-
-    if (eligible)
-        cbInsert(event);
+    // is event eligible for putting it into a lane?
+    int lane = getLaneFor(event);
+    if (lane != -1 && event->getArrivalTime() == simTime())
+        cbInsert(event, lane);
     else
         heapInsert(event);
 }
 
-void cEventHeap::cbInsert(cEvent *event)
+int cEventHeap::getLaneFor(cEvent *event) const
+{
+    // events in lanes must have the same arrival time, and a priority in the lanes' range
+    if (!useCb || (laneCount != 0 && event->getArrivalTime() != laneTime))
+        return -1;
+    int lane = event->getSchedulingPriority() - LANE_MINPRIORITY;
+    return (lane >= 0 && lane < NUM_LANES) ? lane : -1;
+}
+
+void cEventHeap::cbInsert(cEvent *event, int lane)
 {
-    cb[cbtail] = event;
-    event->heapIndex = CBHEAPINDEX(cbtail);
-    CBINC(cbtail);
-    if (cbtail == cbhead)
-        cbgrow();
+    Lane& l = lanes[lane];
+    l.cb[l.cbtail] = event;
+    event->heapIndex = CBHEAPINDEX(lane, l.cbtail);
+    CBINC(l.cbtail);
+    if (l.cbtail == l.cbhead)
+        laneGrow(lane);
+
+    if (laneCount++ == 0)
+        laneTime = event->getArrivalTime();
+    if (lane < firstLane)
+        firstLane = lane;
 }
 
 void cEventHeap::heapInsert(cEvent *event)
 {
-    if (++heapLength > heapCapacity) {
+    if (heapLength == heapCapacity) {
         heapCapacity *= 2;
-        cEvent **newHeap = new cEvent *[heapCapacity+1];
-        for (int i = 1; i <= heapLength-1; i++)
-            newHeap[i] = heap[i];
-        delete[] heap;
+        char *newHeapMemory;
+        HeapEntry *newHeap = allocateHeap(heapCapacity, newHeapMemory);
+        memcpy(newHeap+HEAP_ROOT, heap+HEAP_ROOT, heapLength*sizeof(HeapEntry));
+        delete[] heapMemory;
         heap = newHeap;
+        heapMemory = newHeapMemory;
     }
 
-    int i, j;
-    for (j = heapLength; j > 1; j = i) {
-        i = j>>1;
-        if (*heap[i] <= *event)  // direction
-            break;
-        (heap[j] = heap[i])->heapIndex = j;
-    }
-    (heap[j] = event)->heapIndex = j;
+    HeapEntry entry;
+    entry.arrivalTime = event->getArrivalTime().raw();
+    entry.insertOrder = event->getInsertOrder();
+    entry.priority = event->getSchedulingPriority();
+    entry.event = event;
+    siftUp(HEAP_ROOT + heapLength++, entry);
 }
 
-void cEventHeap::cbgrow()
+void cEventHeap::laneGrow(int lane)
 {
-    int newsize = 2*cbsize;  // cbsize MUST be power of 2
+    Lane& l = lanes[lane];
+    int newsize = 2*l.cbsize;  // cbsize MUST be power of 2
     cEvent **newcb = new cEvent *[newsize];
-    for (int i = 0; i < cbsize; i++)
-        (newcb[i] = cb[(cbhead+i)&(cbsize-1)])->heapIndex = CBHEAPINDEX(i);
-    delete[] cb;
-
-    cb = newcb;
-    cbhead = 0;
-    cbtail = cbsize;
-    cbsize = newsize;
+    for (int i = 0; i < l.cbsize; i++)
+        (newcb[i] = l.cb[(l.cbhead+i)&(l.cbsize-1)])->heapIndex = CBHEAPINDEX(lane, i);
+    delete[] l.cb;
+
+    l.cb = newcb;
+    l.cbhead = 0;
+    l.cbtail = l.cbsize;
+    l.cbsize = newsize;
 }
 
 void cEventHeap::flushCb()
 {
-    for (int i = cbhead; i != cbtail; CBINC(i))
-        heapInsert(cb[i]);
-    cbtail = cbhead;
+    for (Lane& l : lanes) {
+        for (int i = l.cbhead; i != l.cbtail; CBINC(i))
+            heapInsert(l.cb[i]);
+        l.cbhead = l.cbtail = 0;
+    }
+    laneCount = 0;
+    firstLane = NUM_LANES;
 }
 
-void cEventHeap::shiftup(int from)
+void cEventHeap::siftUp(int pos, const HeapEntry& entry)
+{
+    // moves up the hole at pos until entry can be put into it
+    int parent;
+    while (pos > HEAP_ROOT && entry < heap[parent = PARENT(pos)]) {
+        heap[pos] = heap[parent];  // parent is moved down
+        heap[pos].event->heapIndex = pos;
+        pos = parent;
+    }
+    heap[pos] = entry;
+    entry.event->heapIndex = pos;
+}
+
+void cEventHeap::siftDown(int pos)
 {
     // restores heap structure (in a sub-heap)
-    int i, j;
-    cEvent *temp;
-
-    i = from;
-    while ((j = i<<1) <= heapLength) {
-        if (j < heapLength && (*heap[j] > *heap[j+1]))  // direction
-            j++;
-        if (*heap[i] > *heap[j]) {  // is change necessary?
-            temp = heap[j];
-            (heap[j] = heap[i])->heapIndex = j;
-            (heap[i] = temp)->heapIndex = i;
-            i = j;
-        }
-        else
+    HeapEntry entry = heap[pos];
+    int end = HEAP_ROOT + heapLength;
+    int child;
+    while ((child = FIRSTCHILD(pos)) < end) {
+        // find the smallest child
+        int lastChild = std::min(child + HEAP_ARITY, end);
+        int smallest = child;
+        for (int i = child+1; i < lastChild; i++)
+            if (heap[i] < heap[smallest])
+                smallest = i;
+
+        // is change necessary?
+        if (!(heap[smallest] < entry))
             break;
+        heap[pos] = heap[smallest];
+        heap[pos].event->heapIndex = pos;
+        pos = smallest;
     }
+    heap[pos] = entry;
+    entry.event->heapIndex = pos;
+}
+
+bool cEventHeap::heapTopPrecedes(cEvent *event) const
+{
+    if (heapLength == 0)
+        return false;
+    const HeapEntry& top = heap[HEAP_ROOT];
+    int64_t t = event->getArrivalTime().raw();
+    return top.arrivalTime != t ? top.arrivalTime < t :
+           top.priority != event->getSchedulingPriority() ? top.priority < event->getSchedulingPriority() :
+           top.insertOrder < event->getInsertOrder();
 }
 
 cEvent *cEventHeap::peekFirst() const
 {
-    return cbhead != cbtail ? cb[cbhead] : heapLength != 0 ? heap[1] : nullptr;
+    if (laneCount != 0) {
+        cEvent *event = lanes[firstLane].cb[lanes[firstLane].cbhead];
+        return heapTopPrecedes(event) ? heap[HEAP_ROOT].event : event;
+    }
+    return heapLength != 0 ? heap[HEAP_ROOT].event : nullptr;
+}
+
+cEvent *cEventHeap::laneRemoveFirst()
+{
+    Lane& l = lanes[firstLane];
+    cEvent *event = l.cb[l.cbhead];
+    CBINC(l.cbhead);
+    if (--laneCount == 0)
+        firstLane = NUM_LANES;
+    else
+        while (lanes[firstLane].cbhead == lanes[firstLane].cbtail)
+            firstLane++;
+    return event;
 }
 
 cEvent *cEventHeap::removeFirst()
 {
-    if (cbhead != cbtail) {
-        // remove head element from circular buffer
-        cEvent *event = cb[cbhead];
-        CBINC(cbhead);
-        drop(event);
-        event->heapIndex = -1;
-        return event;
+    cEvent *event;
+    if (laneCount != 0 && !heapTopPrecedes(lanes[firstLane].cb[lanes[firstLane].cbhead])) {
+        // remove head element from the first lane
+        event = laneRemoveFirst();
     }
     else if (heapLength > 0) {
         // heap: first is taken out and replaced by the last one
-        cEvent *event = heap[1];
-        (heap[1] = heap[heapLength--])->heapIndex = 1;
-        shiftup();
-        drop(event);
-        event->heapIndex = -1;
-        return event;
+        event = heap[HEAP_ROOT].event;
+        if (--heapLength > 0) {
+            heap[HEAP_ROOT] = heap[HEAP_ROOT+heapLength];
+            siftDown(HEAP_ROOT);
+        }
     }
-    return nullptr;
+    else
+        return nullptr;
+
+    drop(event);
+    event->heapIndex = -1;
+    return event;
 }
 
 cEvent *cEventHeap::remove(cEvent *event)
@@ -307,32 +398,41 @@ cEvent *cEventHeap::remove(cEvent *event)
         return nullptr;
 
     if (event->heapIndex < 0) {
-        // event is in the circular buffer
-        int i = -event->heapIndex-2;
-        ASSERT(cb[i] == event);  // sanity check
+        // event is in one of the lanes
+        int lane = CBLANE(event->heapIndex);
+        int i = CBPOS(event->heapIndex);
+        Lane& l = lanes[lane];
+        ASSERT(l.cb[i] == event);  // sanity check
 
         // remove
         int iminus1 = i;
         CBINC(i);
-        for (  /**/; i != cbtail; iminus1 = i, CBINC(i))
-            (cb[iminus1] = cb[i])->heapIndex = CBHEAPINDEX(iminus1);
-        CBDEC(cbtail);
+        for (  /**/; i != l.cbtail; iminus1 = i, CBINC(i))
+            (l.cb[iminus1] = l.cb[i])->heapIndex = CBHEAPINDEX(lane, iminus1);
+        CBDEC(l.cbtail);
+
+        if (--laneCount == 0)
+            firstLane = NUM_LANES;
+        else
+            while (lanes[firstLane].cbhead == lanes[firstLane].cbtail)
+                firstLane++;
     }
     else {
         // event is on the heap
-
-        // sanity check:
-        // ASSERT(h[event->heapindex]==event);
+        int out = event->heapIndex;
+        ASSERT(heap[out].event == event);  // sanity check
 
         // last element will be used to fill the hole
-        int father, out = event->heapIndex;
-        cEvent *fill = heap[heapLength--];
-        while ((father = out>>1) != 0 && *heap[father] > *fill) {
-            (heap[out] = heap[father])->heapIndex = out;  // father is moved down
-            out = father;
+        int last = HEAP_ROOT + --heapLength;
+        if (out != last) {
+            HeapEntry fill = heap[last];
+            if (out > HEAP_ROOT && fill < heap[PARENT(out)])
+                siftUp(out, fill);
+            else {
+                heap[out] = fill;
+                siftDown(out);
+            }
         }
-        (heap[out] = fill)->heapIndex = out;
-        shiftup(out);
     }
 
     drop(event);
@@ -344,13 +444,24 @@ void cEventHeap::putBackFirst(cEvent *event)
 {
     take(event);
 
-    CBDEC(cbhead);
-    cb[cbhead] = event;
-    event->heapIndex = CBHEAPINDEX(cbhead);
+    // the event was the first one, so it can go to the front of its lane (if any)
+    int lane = getLaneFor(event);
+    if (lane == -1) {
+        heapInsert(event);
+        return;
+    }
 
-    if (cbtail == cbhead)
-        cbgrow();
+    Lane& l = lanes[lane];
+    CBDEC(l.cbhead);
+    l.cb[l.cbhead] = event;
+    event->heapIndex = CBHEAPINDEX(lane, l.cbhead);
+    if (l.cbtail == l.cbhead)
+        laneGrow(lane);
+
+    if (laneCount++ == 0)
+        laneTime = event->getArrivalTime();
+    if (lane < firstLane)
+        firstLane = lane;
 }
 
 }  // namespace omnetpp
-
@@ -37,8 +37,8 @@ using namespace omnetpp::common;
 namespace omnetpp {
 
 #define BUFLEN 1024
-static char buffer[BUFLEN];
-static char buffer2[BUFLEN];
+static thread_local char buffer[BUFLEN];
+static thread_local char buffer2[BUFLEN];
 
 cException::cException() : std::exception()
 {
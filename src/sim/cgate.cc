@@ -22,6 +22,7 @@
 #include <cmath>  // pow
 #include <cstdio>  // sprintf
 #include <cstring>  // strcpy
+#include <typeinfo>
 #include "common/stringutil.h"
 #include "common/stringpool.h"
 #include "omnetpp/cpacket.h"
@@ -66,10 +67,11 @@ using std::ostream;
  * Mostly affected methods are cGate::getId() and cModule::gate(int id).
  */
 
-// non-refcounting pool for gate fullnames
-static StringPool gateFullnamePool;
+// non-refcounting pool for gate fullnames; per-thread like cModule's gate name
+// pool, as both are cleared when the network is deleted
+static thread_local StringPool gateFullnamePool;
 
-int cGate::lastConnectionId = -1;
+static thread_local int lastConnectionId = -1;
 
 cGate::Name::Name(const char *name, Type type)
 {
@@ -97,6 +99,7 @@ cGate::cGate()
     desc = nullptr;
     pos = 0;
     prevGate = nextGate = nullptr;
+    nextHopGate = nullptr;
     channel = nullptr;
     connectionId = -1;
 }
@@ -150,7 +153,7 @@ const char *cGate::getFullName() const
     if (omnetpp::opp_strlen(getName()) > 100)
         throw cRuntimeError(this, "getFullName(): Gate name too long, should be under 100 characters");
 
-    static char tmp[128];
+    static thread_local char tmp[128];
     strcpy(tmp, getName());
     opp_appendindex(tmp, getIndex());
     return gateFullnamePool.get(tmp);  // non-refcounted stringpool
@@ -288,6 +291,7 @@ cChannel *cGate::connectTo(cGate *g, cChannel *chan, bool leaveUninitialized)
     nextGate = g;
     nextGate->prevGate = this;
     connectionId = ++lastConnectionId;
+    invalidatePathCache();
     if (chan)
         installChannel(chan);
 
@@ -334,6 +338,8 @@ void cGate::installChannel(cChannel *chan)
     channel = chan;
     channel->setSourceGate(this);
     take(channel);
+    invalidatePathCache();
+    cComponent::invalidateListenerFlags();  // channel got a parent module
 }
 
 void cGate::disconnect()
@@ -369,9 +375,12 @@ void cGate::disconnect()
     nextGate->prevGate = nullptr;
     nextGate = nullptr;
     connectionId = -1;
+    invalidatePathCache();
 
     cChannel *oldchannelp = channel;
     channel = nullptr;
+    if (oldchannelp)
+        cComponent::invalidateListenerFlags();
 
 #ifdef SIMFRONTEND_SUPPORT
     mod->updateLastChangeSerial();
@@ -451,12 +460,38 @@ void cGate::setDeliverOnReceptionStart(bool d)
         pos &= ~2;
 }
 
+void cGate::invalidatePathCache()
+{
+    // only gates upstream of this one may have cached a hop beyond it
+    for (cGate *g = this; g != nullptr; g = g->prevGate)
+        g->nextHopGate = nullptr;
+}
+
+cGate *cGate::getNextHopGate()
+{
+    if (!nextHopGate) {
+        // skip connections without a channel, and ones with an initialized
+        // cIdealChannel (whose processMessage() does nothing; subclasses
+        // might do something, so they are not skipped)
+        cGate *g = this;
+        while (g->nextGate && (!g->channel || (typeid(*g->channel) == typeid(cIdealChannel) && g->channel->initialized())))
+            g = g->nextGate;
+        nextHopGate = g;
+    }
+    return nextHopGate;
+}
+
 bool cGate::deliver(cMessage *msg, simtime_t t)
 {
     if (!nextGate) {
         getOwnerModule()->arrived(msg, this, t);
         return true;
     }
+    else if (cSimulation::getActiveEnvir()->suppressPassThroughHops && getNextHopGate() != this) {
+        // nobody is interested in the hops that don't affect the message,
+        // jump right to the next channel that does (or to the path end)
+        return nextHopGate->deliver(msg, t);
+    }
     else if (!channel) {
         EVCB.messageSendHop(msg, this);
         return nextGate->deliver(msg, t);
@@ -27,13 +27,21 @@ LogLevel cLog::logLevel = LOGLEVEL_TRACE;
 cLog::NoncomponentLogPredicate cLog::noncomponentLogPredicate = &cLog::defaultNoncomponentLogPredicate;
 cLog::ComponentLogPredicate cLog::componentLogPredicate = &cLog::defaultComponentLogPredicate;
 
-cLogProxy::LogBuffer cLogProxy::buffer;
-std::ostream cLogProxy::stream(&cLogProxy::buffer);
-cLogEntry cLogProxy::currentEntry;
-LogLevel cLogProxy::previousLogLevel = (LogLevel)-1;
-const char *cLogProxy::previousCategory = nullptr;
 cLogProxy::nullstream cLogProxy::dummyStream;
 
+// Logging state is per-thread, so that simulations running concurrently
+// in separate threads don't mix up each other's log lines.
+struct cLogProxy::State
+{
+    LogBuffer buffer;  // underlying buffer that contains the text that has been written so far
+    std::ostream stream;  // this singleton is used to avoid allocating a new stream each time a log statement executes
+    cLogEntry currentEntry = cLogEntry(); // context of the current (last) log statement that has been executed.
+    LogLevel previousLogLevel = (LogLevel)-1; // log level of the previous log statement
+    const char *previousCategory = nullptr; // category of the previous log statement
+
+    State() : stream(&buffer) {}
+};
+
 //----
 
 const char *cLog::getLogLevelName(LogLevel logLevel)
@@ -100,9 +108,10 @@ int cLogProxy::LogBuffer::sync()
         char *end = text + size;
         for (char *s = text; s != end; s++) {
             if (*s == '\n') {
-                cLogProxy::currentEntry.text = text;
-                cLogProxy::currentEntry.textLength = s - text + 1;
-                getEnvir()->log(&cLogProxy::currentEntry);
+                cLogEntry& currentEntry = cLogProxy::getState().currentEntry;
+                currentEntry.text = text;
+                currentEntry.textLength = s - text + 1;
+                getEnvir()->log(&currentEntry);
                 text = s + 1;
             }
         }
@@ -117,9 +126,16 @@ int cLogProxy::LogBuffer::sync()
 
 //----
 
+cLogProxy::State& cLogProxy::getState()
+{
+    static thread_local State state;
+    return state;
+}
+
 cLogProxy::cLogProxy(const void *sourcePointer, LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction)
 {
     fillEntry(logLevel, category, sourceFile, sourceLine, sourceFunction);
+    cLogEntry& currentEntry = state->currentEntry;
     currentEntry.sourcePointer = sourcePointer;
     currentEntry.sourceObject = currentEntry.sourceComponent = nullptr;
 }
@@ -127,6 +143,7 @@ cLogProxy::cLogProxy(const void *sourcePointer, LogLevel logLevel, const char *c
 cLogProxy::cLogProxy(const cObject *sourceObject, LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction)
 {
     fillEntry(logLevel, category, sourceFile, sourceLine, sourceFunction);
+    cLogEntry& currentEntry = state->currentEntry;
     currentEntry.sourcePointer = currentEntry.sourceObject = const_cast<cObject *>(sourceObject);
     currentEntry.sourceComponent = nullptr;
 }
@@ -134,20 +151,29 @@ cLogProxy::cLogProxy(const cObject *sourceObject, LogLevel logLevel, const char
 cLogProxy::cLogProxy(const cComponent *sourceComponent, LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction)
 {
     fillEntry(logLevel, category, sourceFile, sourceLine, sourceFunction);
+    cLogEntry& currentEntry = state->currentEntry;
     currentEntry.sourcePointer = currentEntry.sourceObject = currentEntry.sourceComponent = const_cast<cComponent *>(sourceComponent);
 }
 
 cLogProxy::~cLogProxy()
 {
-    stream.flush();
-    previousLogLevel = currentEntry.logLevel;
-    previousCategory = currentEntry.category;
+    state->stream.flush();
+    state->previousLogLevel = state->currentEntry.logLevel;
+    state->previousCategory = state->currentEntry.category;
+}
+
+std::ostream& cLogProxy::getStream()
+{
+    return state->stream;
 }
 
 void cLogProxy::fillEntry(LogLevel logLevel, const char *category, const char *sourceFile, int sourceLine, const char *sourceFunction)
 {
-    if (previousLogLevel != logLevel || (previousCategory != category && strcmp(previousCategory ? previousCategory : "", category ? category : "")))
+    state = &getState();
+    const char *previousCategory = state->previousCategory;
+    if (state->previousLogLevel != logLevel || (previousCategory != category && strcmp(previousCategory ? previousCategory : "", category ? category : "")))
         flushLastLine();
+    cLogEntry& currentEntry = state->currentEntry;
     currentEntry.category = category;
     currentEntry.logLevel = logLevel;
     currentEntry.sourceFile = sourceFile;
@@ -158,9 +184,10 @@ void cLogProxy::fillEntry(LogLevel logLevel, const char *category, const char *s
 
 void cLogProxy::flushLastLine()
 {
-    if (!buffer.isEmpty()) {
-        stream.put('\n');
-        stream.flush();
+    State& state = getState();
+    if (!state.buffer.isEmpty()) {
+        state.stream.put('\n');
+        state.stream.flush();
     }
 }
 
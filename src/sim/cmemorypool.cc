@@ -0,0 +1,184 @@
+//=========================================================================
+//  CMEMORYPOOL.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//    cMemoryPool : recycling allocator for messages and packets
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <new>
+#include "omnetpp/cmemorypool.h"
+
+namespace omnetpp {
+
+#define GRANULARITY       16     // size classes are multiples of this
+#define NUM_SIZECLASSES   64     // so the largest pooled size is 1024 bytes
+#define MAX_CACHED_BYTES  (1024*1024)  // per size class; above this, half of the free list is released
+
+namespace {
+
+// free blocks are linked through their first word
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+enum PoolState { UNINITIALIZED = 0, ACTIVE, SHUT_DOWN };
+
+// Note: this struct must remain trivially destructible. Objects may be deleted
+// by destructors of other thread_local objects or static objects after the
+// pool was shut down, and a pool with a destructor would be accessed after
+// its lifetime had ended. Purging at thread exit is done by PoolReleaser.
+struct ThreadPool {
+    FreeBlock *freeLists[NUM_SIZECLASSES] = {};
+    int64_t freeCounts[NUM_SIZECLASSES] = {};
+    cMemoryPool::Statistics stats;
+    PoolState state = UNINITIALIZED;  // after SHUT_DOWN, allocations and deallocations bypass the pool
+
+    void purge() {
+        for (int i = 0; i < NUM_SIZECLASSES; i++)
+            release(i, freeCounts[i]);
+    }
+
+    void release(int sizeClass, int64_t count) {
+        for (int64_t k = 0; k < count; k++) {
+            FreeBlock *block = freeLists[sizeClass];
+            freeLists[sizeClass] = block->next;
+            ::operator delete(block);
+        }
+        freeCounts[sizeClass] -= count;
+    }
+};
+
+struct PoolReleaser {
+    ThreadPool *pool = nullptr;
+    ~PoolReleaser() {
+        if (pool) {
+            pool->purge();
+            pool->state = SHUT_DOWN;
+        }
+    }
+};
+
+thread_local ThreadPool threadPool;
+thread_local PoolReleaser poolReleaser;
+
+// Returns the calling thread's pool, or nullptr if the thread is exiting.
+inline ThreadPool *getThreadPool()
+{
+    ThreadPool *pool = &threadPool;
+    if (pool->state != ACTIVE) {
+        if (pool->state == SHUT_DOWN)
+            return nullptr;
+        poolReleaser.pool = pool;  // first use in this thread: registers the releaser's destructor
+        pool->state = ACTIVE;
+    }
+    return pool;
+}
+
+inline int getSizeClass(size_t size)
+{
+    return size == 0 ? 0 : (int)((size - 1) / GRANULARITY);
+}
+
+}  // namespace
+
+void *cMemoryPool::allocate(size_t size)
+{
+    int sizeClass = getSizeClass(size);
+    if (sizeClass >= NUM_SIZECLASSES)
+        return ::operator new(size);
+
+    ThreadPool *pool = getThreadPool();
+    if (pool) {
+        pool->stats.numAllocations++;
+        FreeBlock *block = pool->freeLists[sizeClass];
+        if (block) {
+            pool->freeLists[sizeClass] = block->next;
+            pool->freeCounts[sizeClass]--;
+            pool->stats.numReused++;
+            return block;
+        }
+    }
+
+    // allocate the full size class, so that the block can be reused for
+    // any size that falls into the same class
+    return ::operator new((sizeClass + 1) * GRANULARITY);
+}
+
+void cMemoryPool::deallocate(void *p, size_t size)
+{
+    if (!p)
+        return;
+    int sizeClass = getSizeClass(size);
+    if (sizeClass >= NUM_SIZECLASSES) {
+        ::operator delete(p);
+        return;
+    }
+
+    ThreadPool *pool = getThreadPool();
+    if (!pool) {
+        ::operator delete(p);
+        return;
+    }
+    pool->stats.numDeallocations++;
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = pool->freeLists[sizeClass];
+    pool->freeLists[sizeClass] = block;
+
+    // Cap the free list. Blocks freed by a thread other than the allocating
+    // one accumulate here (e.g. on the consumer side of a producer-consumer
+    // setup), so without a limit the list would grow without bound. Releasing
+    // half of the list at once keeps the cost amortized O(1) per block.
+    int64_t maxCount = MAX_CACHED_BYTES / ((sizeClass + 1) * GRANULARITY);
+    if (++pool->freeCounts[sizeClass] > maxCount) {
+        int64_t count = pool->freeCounts[sizeClass] / 2;
+        pool->release(sizeClass, count);
+        pool->stats.numReleased += count;
+    }
+}
+
+void cMemoryPool::purge()
+{
+    if (ThreadPool *pool = getThreadPool())
+        pool->purge();
+}
+
+cMemoryPool::Statistics cMemoryPool::getStatistics()
+{
+    const ThreadPool& pool = threadPool;
+    Statistics stats = pool.stats;
+    for (int i = 0; i < NUM_SIZECLASSES; i++) {
+        stats.numCachedBlocks += pool.freeCounts[i];
+        stats.cachedBytes += pool.freeCounts[i] * (i + 1) * GRANULARITY;
+    }
+    return stats;
+}
+
+void cMemoryPool::resetStatistics()
+{
+    threadPool.stats = Statistics();
+}
+
+size_t cMemoryPool::getMaxPooledSize()
+{
+    return NUM_SIZECLASSES * GRANULARITY;
+}
+
+size_t cMemoryPool::getMaxCachedBytesPerSizeClass()
+{
+    return MAX_CACHED_BYTES;
+}
+
+}  // namespace omnetpp
+
@@ -34,9 +34,13 @@ using std::ostream;
 Register_Class(cMessage);
 
 // static members of cMessage
-long cMessage::nextMessageId = 0;
-long cMessage::totalMsgCount = 0;
-long cMessage::liveMsgCount = 0;
+// per-thread, so that simulations running concurrently in separate threads
+// assign the same message IDs as when running alone
+static OPP_THREAD_LOCAL long nextMessageId = 0; // the next unique message identifier to be assigned upon message creation
+
+// global variables for statistics
+static OPP_THREAD_LOCAL long totalMsgCount = 0;
+static OPP_THREAD_LOCAL long liveMsgCount = 0;
 
 cMessage::cMessage(const cMessage& msg) : cEvent(msg)
 {
@@ -81,6 +85,21 @@ cMessage::cMessage(const char *name, short k) : cEvent(name)
     previousEventNumber = getSimulation()->getEventNumber();
 }
 
+long cMessage::getTotalMessageCount()
+{
+    return totalMsgCount;
+}
+
+long cMessage::getLiveMessageCount()
+{
+    return liveMsgCount;
+}
+
+void cMessage::resetMessageCounters()
+{
+    totalMsgCount = liveMsgCount = 0;
+}
+
 cMessage::~cMessage()
 {
     EVCB.messageDeleted(this);
@@ -19,7 +19,9 @@
 #include <cstdio>  // sprintf
 #include <cstring>  // strcpy
 #include <algorithm>
+#include <unordered_map>
 #include "common/stringutil.h"
+#include "common/stringpool.h"
 #include "omnetpp/cmodule.h"
 
 #include "omnetpp/csimplemodule.h"
@@ -46,9 +48,59 @@ namespace omnetpp {
 Register_Class(cModule);
 
 
-// static members:
-std::string cModule::lastModuleFullPath;
-const cModule *cModule::lastModuleFullPathModule = nullptr;
+// cached result of last getFullPath() call, and the module it belongs to;
+// per-thread, so that several simulations may run concurrently in separate threads
+static thread_local std::string lastModuleFullPath;
+static thread_local const cModule *lastModuleFullPathModule = nullptr;
+
+// pooled full paths of modules, indexed by module ID (see getFullPathPooled());
+// per-thread like the gate name pool, and cleared along with it
+static thread_local StringPool fullPathPool;
+static thread_local std::vector<const char *> pooledFullPaths;
+
+// submodule and gate lookups by name use a linear search in small modules;
+// in larger ones they are served from a hash index built on the first lookup
+#define SUBMODULE_INDEX_THRESHOLD  16
+#define GATEDESC_INDEX_THRESHOLD   8
+
+// FNV-1a
+static inline size_t hashName(const char *s)
+{
+    size_t h = 2166136261u;
+    for (; *s; s++)
+        h = (h ^ (unsigned char)*s) * 16777619u;
+    return h;
+}
+
+struct cModule::SubmoduleIndex
+{
+    // name points into the submodule's name; index is -1 for non-vector submodules
+    struct Key {
+        const char *name;
+        int index;
+    };
+    struct Hash {
+        size_t operator()(const Key& k) const {return hashName(k.name) + 31 * k.index;}
+    };
+    struct Equal {
+        bool operator()(const Key& a, const Key& b) const {return a.index == b.index && strcmp(a.name, b.name) == 0;}
+    };
+    std::unordered_map<Key, cModule *, Hash, Equal> map;
+
+    static Key keyOf(const cModule *mod) {return Key{mod->getName(), mod->isVector() ? mod->getIndex() : -1};}
+};
+
+struct cModule::GateDescIndex
+{
+    // keys point into the pooled cGate::Name structs
+    struct Hash {
+        size_t operator()(const char *s) const {return hashName(s);}
+    };
+    struct Equal {
+        bool operator()(const char *a, const char *b) const {return strcmp(a, b) == 0;}
+    };
+    std::unordered_map<const char *, int, Hash, Equal> map;
+};
 
 #ifdef NDEBUG
 bool cModule::cacheFullPath = false; // in release mode keep memory usage low
@@ -64,9 +116,11 @@ cModule::cModule()
     fullName = nullptr;
 
     prevSibling = nextSibling = firstSubmodule = lastSubmodule = nullptr;
+    submoduleIndex = nullptr;
 
     gateDescArraySize = 0;
     gateDescArray = nullptr;
+    gateDescIndex = nullptr;
 #ifdef USE_OMNETPP4x_FINGERPRINTS
     version4ModuleId = -1;
 #endif
@@ -118,10 +172,16 @@ cModule::~cModule()
     // delete all gates
     clearGates();
 
+    // forget pooled full path
+    if (getId() >= 0 && getId() < (int)pooledFullPaths.size())
+        pooledFullPaths[getId()] = nullptr;
+
     // deregister ourselves
     if (getParentModule())
         getParentModule()->removeSubmodule(this);
 
+    delete submoduleIndex;
+
     delete canvas;
     delete osgCanvas;
 
@@ -149,9 +209,14 @@ void cModule::forEachChild(cVisitor *v)
 void cModule::setNameAndIndex(const char *s, int i, int n)
 {
     // a two-in-one function, so that we don't end up calling updateFullPath() twice
+    cModule *parent = getParentModule();
+    if (parent)
+        parent->removeFromSubmoduleIndex(this);
     cOwnedObject::setName(s);
     vectorIndex = i;
     vectorSize = n;
+    if (parent)
+        parent->addToSubmoduleIndex(this);
     updateFullName();
 }
 
@@ -175,9 +240,13 @@ void cModule::insertSubmodule(cModule *mod)
     if (!firstSubmodule)
         firstSubmodule = mod;
     lastSubmodule = mod;
+    addToSubmoduleIndex(mod);
 
     // cached module getFullPath() possibly became invalid
     lastModuleFullPathModule = nullptr;
+
+    // listeners of the ancestors changed
+    invalidateListenerFlags();
 }
 
 void cModule::removeSubmodule(cModule *mod)
@@ -187,6 +256,7 @@ void cModule::removeSubmodule(cModule *mod)
     // on its own DefaultList)
 
     // remove from submodule list
+    removeFromSubmoduleIndex(mod);
     if (mod->nextSibling)
         mod->nextSibling->prevSibling = mod->prevSibling;
     if (mod->prevSibling)
@@ -201,6 +271,9 @@ void cModule::removeSubmodule(cModule *mod)
 
     // cached module getFullPath() possibly became invalid
     lastModuleFullPathModule = nullptr;
+
+    // listeners of the ancestors changed
+    invalidateListenerFlags();
 }
 
 cModule *cModule::getParentModule() const
@@ -208,9 +281,48 @@ cModule *cModule::getParentModule() const
     return dynamic_cast<cModule *>(getOwner());
 }
 
+void cModule::buildSubmoduleIndex() const
+{
+    ASSERT(!submoduleIndex);
+    submoduleIndex = new SubmoduleIndex();
+    for (cModule *child = firstSubmodule; child; child = child->nextSibling)
+        submoduleIndex->map.emplace(SubmoduleIndex::keyOf(child), child);  // if names clash, the first one wins, like with linear search
+}
+
+void cModule::addToSubmoduleIndex(cModule *mod)
+{
+    if (submoduleIndex)
+        submoduleIndex->map.emplace(SubmoduleIndex::keyOf(mod), mod);
+}
+
+void cModule::removeFromSubmoduleIndex(cModule *mod)
+{
+    if (!submoduleIndex)
+        return;
+    SubmoduleIndex::Key key = SubmoduleIndex::keyOf(mod);
+    auto it = submoduleIndex->map.find(key);
+    if (it == submoduleIndex->map.end() || it->second != mod)
+        return;
+    submoduleIndex->map.erase(it);
+
+    // another submodule with the same name and index may have been shadowed by this one
+    SubmoduleIndex::Equal equal;
+    for (cModule *child = firstSubmodule; child; child = child->nextSibling) {
+        if (child != mod && equal(SubmoduleIndex::keyOf(child), key)) {
+            submoduleIndex->map.emplace(SubmoduleIndex::keyOf(child), child);
+            break;
+        }
+    }
+}
+
 void cModule::setName(const char *s)
 {
+    cModule *parent = getParentModule();
+    if (parent)
+        parent->removeFromSubmoduleIndex(this);
     cOwnedObject::setName(s);
+    if (parent)
+        parent->addToSubmoduleIndex(this);
     updateFullName();
 }
 
@@ -229,6 +341,7 @@ void cModule::updateFullName()
     if (lastModuleFullPathModule == this)
         lastModuleFullPathModule = nullptr;  // invalidate
 
+    invalidatePooledFullPathRec();
     if (cacheFullPath)
         updateFullPathRec();
 
@@ -257,6 +370,16 @@ void cModule::reassignModuleIdRec()
         child->reassignModuleIdRec();
 }
 
+void cModule::invalidatePooledFullPathRec()
+{
+    if (pooledFullPaths.empty())
+        return;
+    if (getId() >= 0 && getId() < (int)pooledFullPaths.size())
+        pooledFullPaths[getId()] = nullptr;
+    for (cModule *child = firstSubmodule; child; child = child->nextSibling)
+        child->invalidatePooledFullPathRec();
+}
+
 void cModule::updateFullPathRec()
 {
     delete[] fullPath;
@@ -278,6 +401,9 @@ std::string cModule::getFullPath() const
     // use cached value if filled in
     if (fullPath)
         return fullPath;
+    int id = getId();
+    if (id >= 0 && id < (int)pooledFullPaths.size() && pooledFullPaths[id])
+        return pooledFullPaths[id];
 
     if (lastModuleFullPathModule != this) {
         // stop at the toplevel module (don't go up to cSimulation);
@@ -291,6 +417,32 @@ std::string cModule::getFullPath() const
     return lastModuleFullPath;
 }
 
+const char *cModule::getFullPathPooled() const
+{
+    int id = getId();
+    if (id < 0)
+        return fullPathPool.get(getFullPath().c_str());  // not registered, cannot be stored in the table
+    if (id < (int)pooledFullPaths.size() && pooledFullPaths[id])
+        return pooledFullPaths[id];
+
+    // build it from the parent's pooled path
+    const char *path;
+    cModule *parent = getParentModule();
+    if (!parent)
+        path = fullPathPool.get(getFullName());
+    else {
+        static thread_local std::string buffer;
+        buffer = parent->getFullPathPooled();
+        buffer += '.';
+        buffer += getFullName();
+        path = fullPathPool.get(buffer.c_str());
+    }
+    if (id >= (int)pooledFullPaths.size())
+        pooledFullPaths.resize(id + 1);
+    pooledFullPaths[id] = path;
+    return path;
+}
+
 bool cModule::isSimple() const
 {
     return dynamic_cast<const cSimpleModule *>(this) != nullptr;
@@ -313,7 +465,11 @@ cGate *cModule::createGateObject(cGate::Type)
     return new cGate();
 }
 
-cModule::NamePool cModule::namePool;
+cModule::NamePool& cModule::getNamePool()
+{
+    static thread_local NamePool namePool;
+    return namePool;
+}
 
 void cModule::disposeGateObject(cGate *gate, bool checkConnected)
 {
@@ -355,6 +511,7 @@ void cModule::disposeGateDesc(cGate::Desc *desc, bool checkConnected)
     }
     const char *gatename = desc->name->name.c_str();
     cGate::Type gatetype = desc->getType();
+    removeFromGateDescIndex(desc - gateDescArray);
     desc->name = nullptr;  // mark as deleted, but leave shared Name struct in the pool
 #ifdef SIMFRONTEND_SUPPORT
     updateLastChangeSerial();
@@ -379,12 +536,16 @@ void cModule::clearGates()
     delete[] gateDescArray;
     gateDescArray = nullptr;
     gateDescArraySize = 0;
+    delete gateDescIndex;
+    gateDescIndex = nullptr;
 }
 
 void cModule::clearNamePools()
 {
-    namePool.clear();
+    getNamePool().clear();
     cGate::clearFullnamePool();
+    pooledFullPaths.clear();
+    fullPathPool.clear();
 }
 
 void cModule::adjustGateDesc(cGate *gate, cGate::Desc *newvec)
@@ -439,14 +600,52 @@ cGate::Desc *cModule::addGateDesc(const char *gatename, cGate::Type type, bool i
 
     // configure this gatedesc with name and type
     cGate::Name key(gatename, type);
+    NamePool& namePool = getNamePool();
     NamePool::iterator it = namePool.find(key);
     if (it == namePool.end())
         it = namePool.insert(key).first;
     newDesc->name = const_cast<cGate::Name *>(&(*it));
     newDesc->vectorSize = isVector ? 0 : -1;
+    addToGateDescIndex(gateDescArraySize-1);
     return newDesc;
 }
 
+void cModule::buildGateDescIndex() const
+{
+    ASSERT(!gateDescIndex);
+    gateDescIndex = new GateDescIndex();
+    for (int i = 0; i < gateDescArraySize; i++)
+        const_cast<cModule *>(this)->addToGateDescIndex(i);
+}
+
+void cModule::addToGateDescIndex(int descIndex)
+{
+    if (!gateDescIndex)
+        return;
+    const cGate::Name *name = gateDescArray[descIndex].name;
+    if (!name)
+        return;
+    gateDescIndex->map.emplace(name->name.c_str(), descIndex);
+    if (name->type == cGate::INOUT) {
+        gateDescIndex->map.emplace(name->namei.c_str(), descIndex);
+        gateDescIndex->map.emplace(name->nameo.c_str(), descIndex);
+    }
+}
+
+void cModule::removeFromGateDescIndex(int descIndex)
+{
+    if (!gateDescIndex)
+        return;
+    const cGate::Name *name = gateDescArray[descIndex].name;
+    if (!name)
+        return;
+    for (const char *key : {name->name.c_str(), name->namei.c_str(), name->nameo.c_str()}) {
+        auto it = gateDescIndex->map.find(key);
+        if (it != gateDescIndex->map.end() && it->second == descIndex)
+            gateDescIndex->map.erase(it);
+    }
+}
+
 int cModule::findGateDesc(const char *gatename, char& suffix) const
 {
     // determine whether gatename contains "$i"/"$o" suffix
@@ -455,6 +654,20 @@ int cModule::findGateDesc(const char *gatename, char& suffix) const
     if (suffix && suffix != 'i' && suffix != 'o')
         return -1;  // invalid suffix ==> no such gate
 
+    // use the hash index in large modules
+    if (!gateDescIndex && gateDescArraySize > GATEDESC_INDEX_THRESHOLD)
+        buildGateDescIndex();
+    if (gateDescIndex) {
+        auto it = gateDescIndex->map.find(gatename);
+        if (it == gateDescIndex->map.end())
+            return -1;
+        const cGate::Name *name = gateDescArray[it->second].name;
+        const char *key = suffix == 0 ? name->name.c_str() : suffix == 'i' ? name->namei.c_str() : name->nameo.c_str();
+        if (strcmp(key, gatename) == 0)
+            return it->second;
+        // otherwise fall back to linear search to cover odd cases, e.g. a non-inout gate named "foo$i"
+    }
+
     // and search accordingly
     switch (suffix) {
         case '\0':
@@ -1051,23 +1264,35 @@ bool cModule::checkInternalConnections() const
 
 int cModule::findSubmodule(const char *name, int index) const
 {
-    for (SubmoduleIterator it(this); !it.end(); ++it) {
-        cModule *submodule = *it;
-        if (submodule->isName(name) && ((index == -1 && !submodule->isVector()) || submodule->getIndex() == index))
-            return submodule->getId();
-    }
-
-    return -1;
+    cModule *submodule = getSubmodule(name, index);
+    return submodule ? submodule->getId() : -1;
 }
 
 cModule *cModule::getSubmodule(const char *name, int index) const
 {
-    for (SubmoduleIterator it(this); !it.end(); ++it) {
-        cModule *submodule = *it;
-        if (submodule->isName(name) && ((index == -1 && !submodule->isVector()) || submodule->getIndex() == index))
-            return submodule;
+    if (!submoduleIndex) {
+        int count = 0;
+        for (cModule *submodule = firstSubmodule; submodule; submodule = submodule->nextSibling) {
+            if (submodule->isName(name) && ((index == -1 && !submodule->isVector()) || submodule->getIndex() == index))
+                return submodule;
+            if (++count == SUBMODULE_INDEX_THRESHOLD) {
+                buildSubmoduleIndex();
+                break;
+            }
+        }
+        if (!submoduleIndex)
+            return nullptr;
     }
 
+    auto it = submoduleIndex->map.find(SubmoduleIndex::Key{name, index});
+    if (it != submoduleIndex->map.end())
+        return it->second;
+    if (index == 0) {
+        // non-vector submodules have index 0 as well
+        it = submoduleIndex->map.find(SubmoduleIndex::Key{name, -1});
+        if (it != submoduleIndex->map.end())
+            return it->second;
+    }
     return nullptr;
 }
 
@@ -1254,6 +1479,7 @@ void cModule::changeParentTo(cModule *module)
 
     // do it
     cModule *oldparent = getParentModule();
+    invalidatePooledFullPathRec();
     oldparent->removeSubmodule(this);
     module->insertSubmodule(this);
     int oldId = getId();
@@ -0,0 +1,84 @@
+//=========================================================================
+//  CMODULEPATH.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <cstdlib>
+#include "omnetpp/cmodulepath.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+
+namespace omnetpp {
+
+#define ROOTNAME "<root>"
+
+cModulePath::cModulePath(const char *path) : path(path ? path : "")
+{
+    isRelative = (this->path[0] == '.' || this->path[0] == '^');
+    const char *s = (this->path[0] == '.') ? this->path.c_str()+1 : this->path.c_str();
+
+    // split to dot-separated components, and parse them
+    bool isFirst = true;
+    while (*s) {
+        const char *end = strchr(s, '.');
+        std::string token = end ? std::string(s, end-s) : std::string(s);
+        s = end ? end+1 : s+token.size();
+        bool wasFirst = isFirst;
+        isFirst = false;
+
+        if (token.empty())
+            continue;  // skip empty path component
+
+        Element element;
+        element.index = -1;
+        element.isParent = (token == "^");
+        element.mayBeNetworkName = !isRelative && wasFirst;
+        if (!element.isParent) {
+            size_t lbracket = token.find('[');
+            if (lbracket != std::string::npos) {
+                if (token.back() != ']')
+                    throw cRuntimeError("cModulePath: Syntax error (unmatched bracket?) in path '%s'", path);
+                element.index = atoi(token.c_str() + lbracket + 1);
+                token.resize(lbracket);
+            }
+            if (token == ROOTNAME && (!element.mayBeNetworkName || element.index != -1))
+                throw cRuntimeError("cModulePath: Wrong path '%s', '" ROOTNAME "' may only occur as the first component", path);
+            element.name = token;
+        }
+        elements.push_back(element);
+    }
+}
+
+cModule *cModulePath::resolve(const cModule *contextModule) const
+{
+    if (path.empty())
+        return nullptr;
+
+    const cModule *module = isRelative ? contextModule : cSimulation::getActiveSimulation()->getSystemModule();
+    for (const Element& element : elements) {
+        if (!module)
+            break;
+        if (element.mayBeNetworkName && element.index == -1 && (module->isName(element.name.c_str()) || element.name == ROOTNAME))
+            ;  /*ignore network name*/
+        else if (element.isParent)
+            module = module->getParentModule();  // if module is the root, we'll return nullptr
+        else
+            module = module->getSubmodule(element.name.c_str(), element.index);
+    }
+    return const_cast<cModule *>(module);
+}
+
+}  // namespace omnetpp
+
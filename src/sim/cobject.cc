@@ -105,7 +105,7 @@ void cObject::drop(cOwnedObject *obj)
     if (obj->owner != this)
         throw cRuntimeError(this, "drop(): Not owner of object (%s)%s",
                 obj->getClassName(), obj->getFullPath().c_str());
-    cOwnedObject::defaultOwner->doInsert(obj);
+    cOwnedObject::getDefaultOwner()->doInsert(obj);
 }
 
 void cObject::dropAndDelete(cOwnedObject *obj)
@@ -53,10 +53,15 @@ void printAllObjects()
 
 #endif
 
-// static class members
-cDefaultList *cOwnedObject::defaultOwner = &defaultList;
-long cOwnedObject::totalObjectCount = 0;
-long cOwnedObject::liveObjectCount = 0;
+// list in which objects are accumulated if there is no simple module in context
+// (see also setDefaultOwner() and cSimulation::setContextModule()); thread-local,
+// so that several simulations may run concurrently in separate threads
+static OPP_THREAD_LOCAL cDefaultList *defaultOwner = &defaultList;
+static OPP_THREAD_LOCAL cDefaultList *globalDefaultOwner = &defaultList;
+
+// global variables for statistics (per-thread)
+static OPP_THREAD_LOCAL long totalObjectCount = 0;
+static OPP_THREAD_LOCAL long liveObjectCount = 0;
 
 cDefaultList defaultList;
 
@@ -111,6 +116,21 @@ cOwnedObject::~cOwnedObject()
     liveObjectCount--;
 }
 
+long cOwnedObject::getTotalObjectCount()
+{
+    return totalObjectCount;
+}
+
+long cOwnedObject::getLiveObjectCount()
+{
+    return liveObjectCount;
+}
+
+void cOwnedObject::resetObjectCounters()
+{
+    totalObjectCount = liveObjectCount = 0L;
+}
+
 void cOwnedObject::removeFromOwnershipTree()
 {
     // set ownership of this object to null
@@ -118,6 +138,12 @@ void cOwnedObject::removeFromOwnershipTree()
         owner->yieldOwnership(this, nullptr);
 }
 
+void cOwnedObject::addToDefaultOwner()
+{
+    ASSERT(owner == nullptr);
+    defaultOwner->doInsert(this);
+}
+
 void cOwnedObject::setDefaultOwner(cDefaultList *list)
 {
     ASSERT(list != nullptr);
@@ -129,6 +155,17 @@ cDefaultList *cOwnedObject::getDefaultOwner()
     return defaultOwner;
 }
 
+void cOwnedObject::setGlobalDefaultOwner(cDefaultList *list)
+{
+    ASSERT(list != nullptr);
+    globalDefaultOwner = defaultOwner = list;
+}
+
+cDefaultList *cOwnedObject::getGlobalDefaultOwner()
+{
+    return globalDefaultOwner;
+}
+
 void cOwnedObject::copy(const cOwnedObject& obj)
 {
     // Not too much to do:
@@ -363,11 +363,16 @@ void cPar::acceptDefault()
     // for ourselves, without affecting the shared parameter prototype.
 
     // try to look up the value in the value cache (temporarily setting
-    // isSet=true so that we can use this object as key)
-    p->setIsSet(true);
+    // isSet=true so that we can use this object as key). Not done when
+    // simulations run concurrently, because the prototype may be shared
+    // with other threads, and must not be modified even temporarily.
     cComponentType *componentType = ownerComponent->getComponentType();
-    cParImpl *cachedValue = componentType->getSharedParImpl(p);
-    p->setIsSet(false);
+    cParImpl *cachedValue = nullptr;
+    if (!isMultiThreaded()) {
+        p->setIsSet(true);
+        cachedValue = componentType->getSharedParImpl(p);
+        p->setIsSet(false);
+    }
 
     // use the cached value, or create a value and put it into the cache
     if (cachedValue)
@@ -375,7 +380,9 @@ void cPar::acceptDefault()
     else {
         copyIfShared();
         p->setIsSet(true);
-        componentType->putSharedParImpl(p);
+        cachedValue = componentType->putSharedParImpl(p);
+        if (cachedValue != p)
+            setImpl(cachedValue);  // an identical value was already in the cache
     }
     afterChange();
 }
@@ -393,11 +400,9 @@ void cPar::convertToConst()
 
     // maybe replace it with a shared copy
     cComponentType *componentType = ownerComponent->getComponentType();
-    cParImpl *cachedValue = componentType->getSharedParImpl(p);
-    if (cachedValue)
+    cParImpl *cachedValue = componentType->putSharedParImpl(p);
+    if (cachedValue != p)
         setImpl(cachedValue);
-    else
-        componentType->putSharedParImpl(p);
     afterChange();
 }
 
@@ -435,9 +440,11 @@ void cPar::parse(const char *text)
             throw cRuntimeError("Wrong value '%s' for parameter '%s': %s", text, getFullPath().c_str(), e.what());
         }
 
-        // successfully parsed: install it
-        componentType->putSharedParImpl(key.c_str(), tmp);
-        setImpl(tmp);
+        // successfully parsed: install it (or an identical value that another thread cached meanwhile)
+        cParImpl *value = componentType->putSharedParImpl(key.c_str(), tmp);
+        if (value != tmp)
+            delete tmp;
+        setImpl(value);
     }
     afterChange();
 }
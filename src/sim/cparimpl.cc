@@ -34,8 +34,10 @@
 
 namespace omnetpp {
 
-long cParImpl::totalParimplObjs;
-long cParImpl::liveParimplObjs;
+// global variables for statistics (per-thread)
+static OPP_THREAD_LOCAL long totalParimplObjs;
+static OPP_THREAD_LOCAL long liveParimplObjs;
+
 cStringPool cParImpl::unitStringPool("cParImpl::unitStringPool");
 
 cParImpl::cParImpl()
@@ -51,6 +53,21 @@ cParImpl::~cParImpl()
     liveParimplObjs--;
 }
 
+long cParImpl::getTotalParImplObjectCount()
+{
+    return totalParimplObjs;
+}
+
+long cParImpl::getLiveParImplObjectCount()
+{
+    return liveParimplObjs;
+}
+
+void cParImpl::resetParImplObjectCounters()
+{
+    totalParimplObjs = liveParimplObjs = 0L;
+}
+
 void cParImpl::copy(const cParImpl& other)
 {
     setUnit(other.getUnit());
@@ -93,7 +110,7 @@ void cParImpl::setUnit(const char *s)
 
 cNedValue cParImpl::evaluate(cExpression *expr, cComponent *contextComponent) const
 {
-    static int depth;
+    static thread_local int depth;
     try {
         depth++;
         if (depth >= 5)
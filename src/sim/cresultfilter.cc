@@ -117,6 +117,20 @@ void cResultFilter::fire(cResultFilter *prev, simtime_t_cref t, cObject *obj, cO
         delegates[i]->receiveSignal(this, t, obj, details);
 }
 
+void cResultFilter::fireBatch(cResultFilter *prev, const simtime_t *times, const double *values, int count)
+{
+    for (int i = 0; delegates[i]; i++)
+        delegates[i]->receiveBatch(this, times, values, count);
+}
+
+bool cResultFilter::acceptsDelayedDelivery() const
+{
+    for (int i = 0; delegates[i]; i++)
+        if (!delegates[i]->acceptsDelayedDelivery())
+            return false;
+    return true;
+}
+
 void cResultFilter::callFinish(cResultFilter *prev)
 {
     finish(prev);
@@ -41,6 +41,12 @@ void cResultListener::unsubscribedFrom(cResultFilter *prev)
         delete this;
 }
 
+void cResultListener::receiveBatch(cResultFilter *prev, const simtime_t *times, const double *values, int count)
+{
+    for (int i = 0; i < count; i++)
+        receiveSignal(prev, times[i], values[i], nullptr);
+}
+
 const char *cResultListener::getPooled(const char *s)
 {
     static StringPool namesPool;
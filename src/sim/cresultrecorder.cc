@@ -133,6 +133,12 @@ void cResultRecorder::tweakTitle(opp_string& title)
 
 //---
 
+void cNumericResultRecorder::collectBatch(const simtime_t *times, const double *values, int count)
+{
+    for (int i = 0; i < count; i++)
+        collect(times[i], values[i], nullptr);
+}
+
 void cNumericResultRecorder::receiveSignal(cResultFilter *prev, simtime_t_cref t, bool b, cObject *details)
 {
     collect(t, b, details);
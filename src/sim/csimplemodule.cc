@@ -47,8 +47,9 @@ namespace omnetpp {
 #define DEBUG_TRAP_IF_REQUESTED    { if (getSimulation()->trapOnNextEvent) { getSimulation()->trapOnNextEvent = false; if (getEnvir()->ensureDebugger()) DEBUG_TRAP; } }
 #endif
 
-bool cSimpleModule::stackCleanupRequested;
-cSimpleModule *cSimpleModule::afterCleanupTransferTo;
+// per-thread, like the coroutine state itself
+static thread_local bool stackCleanupRequested; // 'true' value asks activity() to throw a cStackCleanupException
+static thread_local cSimpleModule *afterCleanupTransferTo; // transfer back to this module (or to main)
 
 void cSimpleModule::activate(void *p)
 {
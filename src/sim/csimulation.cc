@@ -25,6 +25,7 @@
 #include <cstring>
 #include <cstdio>
 #include <climits>
+#include <algorithm>
 #include "common/stringutil.h"
 #include "omnetpp/cmodule.h"
 #include "omnetpp/csimplemodule.h"
@@ -41,6 +42,7 @@
 #include "omnetpp/cconfiguration.h"
 #include "omnetpp/ccoroutine.h"
 #include "omnetpp/clifecyclelistener.h"
+#include "omnetpp/resultfilters.h"
 #include "omnetpp/platdep/platmisc.h"  // for DEBUG_TRAP
 
 #ifdef WITH_PARSIM
@@ -115,6 +117,7 @@ cSimulation::cSimulation(const char *name, cEnvir *env) : cNamedObject(name, fal
     currentSimtime = SIMTIME_ZERO;
     currentEventNumber = 0;
     trapOnNextEvent = false;
+    simTimeLimit = SIMTIME_MAX;
 
     // install default FES
     setFES(new cEventHeap("fes"));
@@ -125,7 +128,7 @@ cSimulation::cSimulation(const char *name, cEnvir *env) : cNamedObject(name, fal
 
 cSimulation::~cSimulation()
 {
-    if (this == activeSimulation)
+    if (this == getActiveSimulation())
         // NOTE: subclass destructors will not be called, but the simulation will stop anyway
         throw cRuntimeError(this, "Cannot delete the active simulation manager object");
 
@@ -137,19 +140,6 @@ cSimulation::~cSimulation()
     dropAndDelete(fes);
 }
 
-void cSimulation::setActiveSimulation(cSimulation *sim)
-{
-    activeSimulation = sim;
-    activeEnvir = sim == nullptr ? staticEnvir : sim->envir;
-}
-
-void cSimulation::setStaticEnvir(cEnvir *env)
-{
-    if (!env)
-        throw cRuntimeError("cSimulation::setStaticEnvir(): Argument cannot be nullptr");
-    staticEnvir = env;
-}
-
 void cSimulation::forEachChild(cVisitor *v)
 {
     if (systemModule != nullptr)
@@ -253,6 +243,7 @@ void cSimulation::setFES(cFutureEventSet *f)
 
 void cSimulation::setSimulationTimeLimit(simtime_t simTimeLimit)
 {
+    this->simTimeLimit = simTimeLimit;
 #ifndef USE_OMNETPP4x_FINGERPRINTS
     getFES()->insert(new cEndSimulationEvent("endsimulation", simTimeLimit));
 #else
@@ -375,6 +366,7 @@ void cSimulation::setupNetwork(cModuleType *network)
 
     // just to be sure
     fes->clear();
+    simTimeLimit = SIMTIME_MAX;
     cComponent::clearSignalState();
 
     simulationStage = CTX_BUILD;
@@ -420,6 +412,7 @@ void cSimulation::callInitialize()
         systemModule->scheduleStart(SIMTIME_ZERO);
         getEnvir()->notifyLifecycleListeners(LF_PRE_NETWORK_INITIALIZE);
         systemModule->callInitialize();
+        flushDeferredResults();
         getEnvir()->notifyLifecycleListeners(LF_POST_NETWORK_INITIALIZE);
     }
 
@@ -432,6 +425,8 @@ void cSimulation::callFinish()
 
     simulationStage = CTX_FINISH;
 
+    flushDeferredResults();
+
     // call user-defined finish() functions for all modules recursively
     if (systemModule) {
         getEnvir()->notifyLifecycleListeners(LF_PRE_NETWORK_FINISH);
@@ -633,6 +628,10 @@ void cSimulation::executeEvent(cEvent *event)
     }
     setGlobalContext();
 
+    // deliver result values that may not be deferred past the end of the event
+    if (!deferredResultFilters.empty())
+        flushDeferredResults();
+
     // Note: simulation time (as read via simTime() from modules) will be updated
     // in takeNextEvent(), called right before the next executeEvent().
     // Simtime must NOT be updated here, because it would interfere with parallel
@@ -641,6 +640,24 @@ void cSimulation::executeEvent(cEvent *event)
     // the time of the next event, it should call guessNextSimtime().
 }
 
+void cSimulation::removeDeferredResultFilter(DeferredDeliveryFilter *filter)
+{
+    if (!deferredResultFilters.empty() && deferredResultFilters.back() == filter)
+        deferredResultFilters.pop_back();  // common case, see flushDeferredResults()
+    else {
+        auto it = std::find(deferredResultFilters.begin(), deferredResultFilters.end(), filter);
+        if (it != deferredResultFilters.end())
+            deferredResultFilters.erase(it);
+    }
+}
+
+void cSimulation::flushDeferredResults()
+{
+    // note: flush() unregisters the filter
+    while (!deferredResultFilters.empty())
+        deferredResultFilters.back()->flush();
+}
+
 void cSimulation::doMessageEvent(cMessage *msg, cSimpleModule *module)
 {
     // switch to the module's context
@@ -859,11 +876,47 @@ void StaticEnv::undisposedObject(cObject *obj)
 
 static StaticEnv staticEnv;
 
-// cSimulation's global variables
-cEnvir *cSimulation::activeEnvir = &staticEnv;
+// cSimulation's global variables. The active simulation and its environment are
+// per-thread, so that independent simulations may run concurrently; activeEnvir
+// being nullptr means staticEnvir.
+#ifdef OPP_INLINE_TLS
+OPP_THREAD_LOCAL cSimulation *cSimulation::activeSimulation = nullptr;
+OPP_THREAD_LOCAL cEnvir *cSimulation::activeEnvir = nullptr;
 cEnvir *cSimulation::staticEnvir = &staticEnv;
+#else
+static thread_local cSimulation *activeSimulation = nullptr;
+static thread_local cEnvir *activeEnvir = nullptr;
+static cEnvir *staticEnvir = &staticEnv;
+
+cSimulation *cSimulation::getActiveSimulation()
+{
+    return activeSimulation;
+}
+
+cEnvir *cSimulation::getActiveEnvir()
+{
+    cEnvir *env = activeEnvir;
+    return env ? env : staticEnvir;
+}
+#endif
+
+void cSimulation::setActiveSimulation(cSimulation *sim)
+{
+    activeSimulation = sim;
+    activeEnvir = sim == nullptr ? nullptr : sim->envir;
+}
 
-cSimulation *cSimulation::activeSimulation = nullptr;
+void cSimulation::setStaticEnvir(cEnvir *env)
+{
+    if (!env)
+        throw cRuntimeError("cSimulation::setStaticEnvir(): Argument cannot be nullptr");
+    staticEnvir = env;
+}
+
+cEnvir *cSimulation::getStaticEnvir()
+{
+    return staticEnvir;
+}
 
 }  // namespace omnetpp
 
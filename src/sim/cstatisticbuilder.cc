@@ -35,6 +35,8 @@ const char *PROPKEY_STATISTIC_CHECKSIGNALS = "checkSignals";
 Register_PerObjectConfigOption(CFGID_STATISTIC_RECORDING, "statistic-recording", KIND_STATISTIC, CFG_BOOL, "true", "Whether the matching `@statistic` should be recorded. This option lets one completely disable all recording from a @statistic. Disabling a `@statistic` this way is more efficient than specifying `**.scalar-recording=false` and `**.vector-recording=false` together.\nUsage: `<module-full-path>.<statistic-name>.statistic-recording=true/false`.\nExample: `**.ping.roundTripTime.statistic-recording=false`");
 Register_PerObjectConfigOption(CFGID_RESULT_RECORDING_MODES, "result-recording-modes", KIND_STATISTIC, CFG_STRING, "default", "Defines how to calculate results from the matching `@statistic`.\nUsage: `<module-full-path>.<statistic-name>.result-recording-modes=<modes>`. Special values: `default`, `all`: they select the modes listed in the `record` key of `@statistic`; all selects all of them, default selects the non-optional ones (i.e. excludes the ones that end in a question mark). Example values: `vector`, `count`, `last`, `sum`, `mean`, `min`, `max`, `timeavg`, `stats`, `histogram`. More than one values are accepted, separated by commas. Expressions are allowed. Items prefixed with `-` get removed from the list. Example: `**.queueLength.result-recording-modes=default,-vector,+timeavg`");
 
+Register_PerObjectConfigOption(CFGID_STATISTIC_DEFERRED_DELIVERY, "statistic-deferred-delivery", KIND_STATISTIC, CFG_BOOL, "false", "Whether numeric values of the matching `@statistic` should be buffered, and delivered to its result filters and recorders in batches. Batches are delivered when the buffer fills up, at the end of the event if the statistic is recorded into an output vector, and before finish(). This reduces the per-value overhead of high-rate statistics, at the cost of result recorders (e.g. as seen in the Qtenv inspectors) temporarily lagging behind. All numeric values are delivered as double.\nUsage: `<module-full-path>.<statistic-name>.statistic-deferred-delivery=true/false`.\nExample: `**.mac.frameReceived.statistic-deferred-delivery=true`");
+
 typedef cStatisticBuilder::TristateBool TristateBool;
 
 static int search_(std::vector<std::string>& v, const char *s)
@@ -127,6 +129,13 @@ void cStatisticBuilder::doAddResultRecorders(cComponent *component, std::string&
             StatisticSourceParser::checkSignalDeclaration(component, cComponent::getSignalName(signal), checkSignalDecl);
         }
 
+        // optionally buffer the values in front of the result recorders
+        if (!source.isNull() && config->getAsBool(statisticFullPath.c_str(), CFGID_STATISTIC_DEFERRED_DELIVERY)) {
+            DeferredDeliveryFilter *deferredFilter = new DeferredDeliveryFilter();
+            source.subscribe(deferredFilter);
+            source = SignalSource(deferredFilter);
+        }
+
         // add result recorders
         for (auto & mode : modes)
             doResultRecorder(source, mode.c_str(), component, statisticName, statisticProperty);
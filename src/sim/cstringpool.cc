@@ -13,6 +13,7 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include "common/commonutil.h"
 #include "common/stringutil.h"
 #include "omnetpp/cstringpool.h"
 #include "omnetpp/cownedobject.h"
@@ -42,6 +43,7 @@ cStringPool::~cStringPool()
 
 void cStringPool::dump() const
 {
+    OptionalLockGuard<std::mutex> lock(mutex);
     if (!pool.empty()) {
         printf("contents of stringpool \"%s\":\n", name.c_str());
         for (const auto & it : pool)
@@ -58,6 +60,7 @@ const char *cStringPool::get(const char *s)
     if (!s)
         return nullptr;
 
+    OptionalLockGuard<std::mutex> lock(mutex);
     StringIntMap::iterator it = pool.find(const_cast<char *>(s));
     if (it == pool.end()) {
         // allocate new string
@@ -82,6 +85,7 @@ const char *cStringPool::peek(const char *s) const
     if (!s)
         return nullptr;
 
+    OptionalLockGuard<std::mutex> lock(mutex);
     StringIntMap::const_iterator it = pool.find(const_cast<char *>(s));
     return it == pool.end() ? nullptr : it->first;
 }
@@ -97,6 +101,7 @@ void cStringPool::release(const char *s)
         return;
     }
 
+    OptionalLockGuard<std::mutex> lock(mutex);
     StringIntMap::iterator it = pool.find(const_cast<char *>(s));
 
     // sanity checks
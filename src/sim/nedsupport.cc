@@ -177,9 +177,10 @@ std::string SiblingModuleParameterRef::str(std::string args[], int numargs)
 
 //----
 
-const char *LoopVar::varNames[32];
-long LoopVar::vars[32];
-int LoopVar::varCount = 0;
+// the loopvar stack; per-thread, so that networks may be set up concurrently in separate threads
+static thread_local const char *varNames[32];
+static thread_local long vars[32];
+static thread_local int varCount = 0;
 
 long& LoopVar::pushVar(const char *varName)
 {
@@ -199,6 +200,16 @@ void LoopVar::reset()
     varCount = 0;
 }
 
+const char **LoopVar::getVarNames()
+{
+    return varNames;
+}
+
+int LoopVar::getNumVars()
+{
+    return varCount;
+}
+
 cNedValue LoopVar::evaluate(Context *context, cNedValue args[], int numargs)
 {
     ASSERT(numargs == 0 && context != nullptr && context->component != nullptr);
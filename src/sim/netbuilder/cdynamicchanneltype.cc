@@ -20,12 +20,18 @@
 #include <ctime>
 #include <iostream>
 
+#include "common/commonutil.h"
 #include "cdynamicchanneltype.h"
 #include "cnedloader.h"
 #include "cnednetworkbuilder.h"
 
 namespace omnetpp {
 
+using namespace omnetpp::common;
+
+// see cNedDeclaration::cacheMutex
+#define LOCK_NED_CACHES  OptionalLockGuard<std::recursive_mutex> lock(cNedDeclaration::cacheMutex)
+
 cDynamicChannelType::cDynamicChannelType(const char *name) : cChannelType(name)
 {
 }
@@ -57,23 +63,27 @@ cChannel *cDynamicChannelType::createChannelObject()
 
 void cDynamicChannelType::addParametersTo(cChannel *channel)
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     cNedNetworkBuilder().addParametersAndGatesTo(channel, decl);  // adds only parameters, because channels have no gates
 }
 
 void cDynamicChannelType::applyPatternAssignments(cComponent *component)
 {
+    LOCK_NED_CACHES;
     cNedNetworkBuilder().assignParametersFromPatterns(component);
 }
 
 cProperties *cDynamicChannelType::getProperties() const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getProperties();
 }
 
 cProperties *cDynamicChannelType::getParamProperties(const char *paramName) const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getParamProperties(paramName);
 }
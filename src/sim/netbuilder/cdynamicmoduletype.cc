@@ -19,6 +19,7 @@
 #include <ctime>
 #include <iostream>
 
+#include "common/commonutil.h"
 #include "cdynamicmoduletype.h"
 #include "cneddeclaration.h"
 #include "cnedloader.h"
@@ -26,6 +27,11 @@
 
 namespace omnetpp {
 
+using namespace omnetpp::common;
+
+// see cNedDeclaration::cacheMutex
+#define LOCK_NED_CACHES  OptionalLockGuard<std::recursive_mutex> lock(cNedDeclaration::cacheMutex)
+
 cDynamicModuleType::cDynamicModuleType(const char *name) : cModuleType(name)
 {
 }
@@ -68,53 +74,62 @@ cModule *cDynamicModuleType::createModuleObject()
 
 void cDynamicModuleType::addParametersAndGatesTo(cModule *module)
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     cNedNetworkBuilder().addParametersAndGatesTo(module, decl);
 }
 
 void cDynamicModuleType::applyPatternAssignments(cComponent *component)
 {
+    LOCK_NED_CACHES;
     cNedNetworkBuilder().assignParametersFromPatterns(component);
 }
 
 void cDynamicModuleType::setupGateVectors(cModule *module)
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     cNedNetworkBuilder().setupGateVectors(module, decl);
 }
 
 void cDynamicModuleType::buildInside(cModule *module)
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     cNedNetworkBuilder().buildInside(module, decl);
 }
 
 cProperties *cDynamicModuleType::getProperties() const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getProperties();
 }
 
 cProperties *cDynamicModuleType::getParamProperties(const char *paramName) const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getParamProperties(paramName);
 }
 
 cProperties *cDynamicModuleType::getGateProperties(const char *gateName) const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getGateProperties(gateName);
 }
 
 cProperties *cDynamicModuleType::getSubmoduleProperties(const char *submoduleName, const char *submoduleType) const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getSubmoduleProperties(submoduleName, submoduleType);
 }
 
 cProperties *cDynamicModuleType::getConnectionProperties(int connectionId, const char *channelType) const
 {
+    LOCK_NED_CACHES;
     cNedDeclaration *decl = getDecl();
     return decl->getConnectionProperties(connectionId, channelType);
 }
@@ -31,6 +31,8 @@ namespace omnetpp {
 
 using namespace omnetpp::common;
 
+std::recursive_mutex cNedDeclaration::cacheMutex;
+
 cNedDeclaration::cNedDeclaration(NedResourceCache *resolver, const char *qname, bool isInnerType, NedElement *tree) : NedTypeInfo(resolver, qname, isInnerType, tree)
 {
     props = nullptr;
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include "nedxml/nedtypeinfo.h"
 #include "omnetpp/simkerneldefs.h"
 #include "omnetpp/globals.h"
@@ -59,6 +60,14 @@ class SIM_API cNedDeclaration : public NedTypeInfo
   public:
     typedef omnetpp::common::PatternMatcher PatternMatcher;
     struct PatternData {PatternMatcher *matcher; ParamElement *patternNode;};
+
+    // Protects the lazily filled caches of all declarations (properties,
+    // patterns, compiled expressions) when simulations run concurrently
+    // (Cmdenv -j). Held by cDynamicModuleType and cDynamicChannelType while
+    // they use a declaration; recursive because building a compound module
+    // creates its submodules.
+    static std::recursive_mutex cacheMutex;
+
   protected:
     // properties
     typedef std::map<std::string, cProperties *> StringPropsMap;
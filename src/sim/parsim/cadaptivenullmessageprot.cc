@@ -0,0 +1,221 @@
+//=========================================================================
+//  CADAPTIVENULLMESSAGEPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include "omnetpp/cmessage.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cfutureeventset.h"
+#include "cadaptivenullmessageprot.h"
+#include "cnmplookahead.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cAdaptiveNullMessageProtocol);
+
+cAdaptiveNullMessageProtocol::cAdaptiveNullMessageProtocol() : cNullMessageProtocol()
+{
+    linkStats = nullptr;
+}
+
+cAdaptiveNullMessageProtocol::~cAdaptiveNullMessageProtocol()
+{
+    delete[] linkStats;
+}
+
+void cAdaptiveNullMessageProtocol::startRun()
+{
+    cNullMessageProtocol::startRun();
+
+    delete[] linkStats;
+    linkStats = new LinkStatistics[numSeg];
+    for (int i = 0; i < numSeg; i++) {
+        LinkStatistics& stats = linkStats[i];
+        stats.numNullMessagesSent = stats.numNullMessagesSuppressed = 0;
+        stats.numMessagesSent = stats.numPiggybackedEots = 0;
+        stats.minObservedDelay = -1;
+    }
+}
+
+void cAdaptiveNullMessageProtocol::endRun()
+{
+    printStatistics();
+    cNullMessageProtocol::endRun();
+}
+
+void cAdaptiveNullMessageProtocol::printStatistics()
+{
+    if (!linkStats)
+        return;
+    EV << "Adaptive Null Message Protocol statistics:\n";
+    for (int i = 0; i < numSeg; i++) {
+        if (i == comm->getProcId())
+            continue;
+        const LinkStatistics& stats = linkStats[i];
+        EV << "  to procId=" << i << ": "
+           << stats.numNullMessagesSent << " null messages sent, "
+           << stats.numNullMessagesSuppressed << " suppressed; "
+           << stats.numMessagesSent << " messages sent, "
+           << stats.numPiggybackedEots << " with piggybacked EOT";
+        if (stats.minObservedDelay >= SIMTIME_ZERO)
+            EV << "; min delay " << stats.minObservedDelay << " (lookahead " << lookaheadcalc->getCurrentLookahead(i) << ")";
+        EV << "\n";
+    }
+}
+
+long cAdaptiveNullMessageProtocol::getNumNullMessagesSent() const
+{
+    long sum = 0;
+    for (int i = 0; linkStats && i < numSeg; i++)
+        sum += linkStats[i].numNullMessagesSent;
+    return sum;
+}
+
+long cAdaptiveNullMessageProtocol::getNumNullMessagesSuppressed() const
+{
+    long sum = 0;
+    for (int i = 0; linkStats && i < numSeg; i++)
+        sum += linkStats[i].numNullMessagesSuppressed;
+    return sum;
+}
+
+long cAdaptiveNullMessageProtocol::getNumPiggybackedEots() const
+{
+    long sum = 0;
+    for (int i = 0; linkStats && i < numSeg; i++)
+        sum += linkStats[i].numPiggybackedEots;
+    return sum;
+}
+
+void cAdaptiveNullMessageProtocol::processOutgoingMessage(cMessage *msg, int destProcId, int destModuleId, int destGateId, void *data)
+{
+    LinkStatistics& stats = linkStats[destProcId];
+
+    // a message arriving sooner than the lookahead would break causality
+    // at the receiving partition, so better detect it here
+    simtime_t delay = msg->getArrivalTime() - sim->getSimTime();
+    if (delay < lookaheadcalc->getCurrentLookahead(destProcId))
+        throw cRuntimeError("cAdaptiveNullMessageProtocol: Message (%s)%s sent to partition %d with delay %s, "
+                            "which is less than the lookahead %s", msg->getClassName(), msg->getName(), destProcId,
+                            SIMTIME_STR(delay), SIMTIME_STR(lookaheadcalc->getCurrentLookahead(destProcId)));
+    if (stats.minObservedDelay < SIMTIME_ZERO || delay < stats.minObservedDelay)
+        stats.minObservedDelay = delay;
+
+    simtime_t lastEotSent = segInfo[destProcId].lastEotSent;
+    cNullMessageProtocol::processOutgoingMessage(msg, destProcId, destModuleId, destGateId, data);
+    stats.numMessagesSent++;
+    if (segInfo[destProcId].lastEotSent != lastEotSent)
+        stats.numPiggybackedEots++;
+}
+
+cEvent *cAdaptiveNullMessageProtocol::takeNextEvent()
+{
+    // our EIT and resendEOT messages are always scheduled, so the FES can
+    // only be empty if there are no other partitions at all -- "no events" then
+    // means we're finished.
+    cFutureEventSet *fes = sim->getFES();
+    if (fes->isEmpty())
+        return nullptr;
+
+    cEvent *event;
+    while (true) {
+        event = fes->peekFirst();
+        cMessage *msg = event->isMessage() ? static_cast<cMessage *>(event) : nullptr;
+        if (msg && msg->getKind() == MK_PARSIM_RESENDEOT) {
+            // take out all due "resend-EOT" events: the first event after
+            // them (a local event or an EIT event) determines the horizon
+            dueProcIds.clear();
+            do {
+                fes->removeFirst();
+                dueProcIds.push_back((uintptr_t)msg->getContextPointer());  // khmm...
+                event = fes->peekFirst();
+                ASSERT(event != nullptr);  // EIT events are always scheduled
+                msg = event->isMessage() ? static_cast<cMessage *>(event) : nullptr;
+            } while (msg && msg->getKind() == MK_PARSIM_RESENDEOT);
+
+            simtime_t horizon = event->getArrivalTime();
+            for (int procId : dueProcIds)
+                sendNullMessage(procId, horizon);
+        }
+        else if (msg && msg->getKind() == MK_PARSIM_EIT) {
+            // wait until it gets out of the way (i.e. we get a higher EIT)
+            {if (debug) EV << "blocking on EIT event '" << event->getName() << "'\n";}
+            if (!receiveBlocking((uintptr_t)msg->getContextPointer()))
+                return nullptr;
+        }
+        else {
+            // just a normal event -- go ahead with it
+            break;
+        }
+    }
+
+    // remove event from FES and return it
+    cEvent *tmp = fes->removeFirst();
+    ASSERT(tmp == event);
+    return event;
+}
+
+void cAdaptiveNullMessageProtocol::sendNullMessage(int procId, simtime_t horizon)
+{
+    // no event can occur in this partition before the horizon, so the
+    // EOT is the horizon plus the lookahead
+    PartitionInfo& info = segInfo[procId];
+    simtime_t lookahead = lookaheadcalc->getCurrentLookahead(procId);
+    simtime_t eot, eotResendTime;
+    if (lookahead >= SIMTIME_MAX - horizon)
+        eot = eotResendTime = SIMTIME_MAX;  // no connection to that partition
+    else {
+        eot = horizon + lookahead;
+        eotResendTime = horizon + lookahead*laziness;
+
+        // a partition that reaches the simulation time limit terminates the
+        // others, so it must not get there before we have processed our events
+        // up to the limit: don't promise beyond the limit until then
+        simtime_t limit = sim->getSimulationTimeLimit();
+        if (horizon < limit && eot > limit)
+            eot = limit;
+    }
+
+    if (eot <= info.lastEotSent) {
+        // EOT has not advanced (e.g. the horizon is an EIT that did not move),
+        // so there's nothing to tell; retry when the horizon may have advanced.
+        // Note that a retry at the horizon is inserted after the events already
+        // scheduled there, so they get processed (or blocked on) first.
+        linkStats[procId].numNullMessagesSuppressed++;
+        simtime_t retryTime = info.lastEotSent == SIMTIME_MAX ? SIMTIME_MAX : std::max(horizon, info.lastEotSent - lookahead*(1-laziness));
+        rescheduleEvent(info.eotEvent, retryTime);
+        {if (debug) EV << "suppressing null msg to " << procId << ", EOT=" << eot << " did not advance; retry at " << retryTime << "\n";}
+        return;
+    }
+    info.lastEotSent = eot;
+    rescheduleEvent(info.eotEvent, eotResendTime);
+    linkStats[procId].numNullMessagesSent++;
+
+    {if (debug) EV << "sending null msg to " << procId << ", horizon=" << horizon << ", lookahead=" << lookahead << ", EOT=" << eot << "; next resend at " << eotResendTime << "\n";}
+
+    // send out null message
+    cCommBuffer *buffer = comm->createCommBuffer();
+    buffer->pack(eot);
+    sendBuffer(buffer, TAG_NULLMESSAGE, procId);
+    comm->recycleCommBuffer(buffer);
+}
+
+}  // namespace omnetpp
+
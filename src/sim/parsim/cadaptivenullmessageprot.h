@@ -0,0 +1,123 @@
+//=========================================================================
+//  CADAPTIVENULLMESSAGEPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CADAPTIVENULLMESSAGEPROT_H
+#define __OMNETPP_CADAPTIVENULLMESSAGEPROT_H
+
+#include <vector>
+#include "cnullmessageprot.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief A variant of the "null message algorithm" that sends considerably
+ * fewer null messages when partitions are loosely coupled.
+ *
+ * The differences from cNullMessageProtocol are:
+ *
+ * - EOTs are computed from the partition's horizon instead of the current
+ *   simulation time. The horizon is the time of the first event in the FES
+ *   other than our own "resend-EOT" events, i.e. the minimum of the next
+ *   local event and the EITs received from the other partitions. No event
+ *   can be executed by the partition before the horizon, so horizon+lookahead
+ *   is a valid EOT, and it is often much larger than now+lookahead.
+ *   EOTs do not go beyond the simulation time limit until the partition has
+ *   processed its events up to it, because the first partition to reach the
+ *   limit terminates the others.
+ *
+ * - When a "resend-EOT" event fires but the EOT would not advance (e.g.
+ *   because the partition is blocked on an EIT that has not advanced since),
+ *   the null message is suppressed, and the event is retried after the
+ *   events at the horizon have been processed.
+ *
+ * - EOTs are piggybacked on every outgoing model message they improve on.
+ *   The actual delay of outgoing messages is checked against the lookahead
+ *   (a smaller one would break causality), and the smallest one observed per
+ *   partition is reported along with the null message counters at the end
+ *   of the run.
+ *
+ * Lookahead itself comes from the same cNMPLookahead object as with
+ * cNullMessageProtocol, and the same laziness setting applies.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cAdaptiveNullMessageProtocol : public cNullMessageProtocol
+{
+  protected:
+    struct LinkStatistics
+    {
+        long numNullMessagesSent;        // null messages sent
+        long numNullMessagesSuppressed;  // null messages not sent because the EOT did not advance
+        long numMessagesSent;            // model messages sent
+        long numPiggybackedEots;         // model messages that carried a new EOT
+        simtime_t minObservedDelay;      // smallest delay of outgoing model messages, or -1
+    };
+
+    LinkStatistics *linkStats;  // per-partition statistics, size numSeg
+    std::vector<int> dueProcIds; // used in takeNextEvent()
+
+  protected:
+    // send null message to this partition, with the EOT based on the given horizon
+    virtual void sendNullMessage(int procId, simtime_t horizon) override;
+
+    // print null message statistics
+    virtual void printStatistics();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cAdaptiveNullMessageProtocol();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cAdaptiveNullMessageProtocol();
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run. Prints null message statistics.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Scheduler function. Unlike in cNullMessageProtocol, null messages
+     * are sent with EOTs based on the horizon.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Sends out the message with a piggybacked EOT if the EOT advanced,
+     * and updates the statistics.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+
+    /** @name Statistics, summed over all partitions. */
+    //@{
+    long getNumNullMessagesSent() const;
+    long getNumNullMessagesSuppressed() const;
+    long getNumPiggybackedEots() const;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
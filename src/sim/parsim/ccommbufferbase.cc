@@ -18,6 +18,7 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <cstring>
 #include "omnetpp/cexception.h"
 #include "ccommbufferbase.h"
 
@@ -73,28 +74,20 @@ void cCommBufferBase::reset()
     mPosition = 0;
 }
 
-void cCommBufferBase::extendBufferFor(int dataSize)
+void cCommBufferBase::growBuffer(int dataSize)
 {
-    // TBD move reallocate+copy out of loop (more efficient)
-    while (mMsgSize+dataSize >= mBufferSize) {
-        // increase the size of the buffer while
-        // retaining its own existing contents
-        char *tempBuffer;
-        int i, oldBufferSize = 0;
-
-        oldBufferSize = mBufferSize;
-        if (mBufferSize == 0)
-            mBufferSize = 1000;
-        else
-            mBufferSize += mBufferSize;
-
-        tempBuffer = new char[mBufferSize];
-        for (i = 0; i < oldBufferSize; i++)
-            tempBuffer[i] = mBuffer[i];
-
-        delete[] mBuffer;
-        mBuffer = tempBuffer;
-    }
+    // increase the size of the buffer (at least doubling it) while
+    // retaining its own existing contents
+    int newBufferSize = mBufferSize == 0 ? 1000 : mBufferSize;
+    while (mMsgSize+dataSize >= newBufferSize)
+        newBufferSize += newBufferSize;
+
+    char *tempBuffer = new char[newBufferSize];
+    if (mBufferSize > 0)
+        memcpy(tempBuffer, mBuffer, mBufferSize);
+    delete[] mBuffer;
+    mBuffer = tempBuffer;
+    mBufferSize = newBufferSize;
 }
 
 bool cCommBufferBase::isBufferEmpty() const
@@ -38,7 +38,8 @@ class SIM_API cCommBufferBase : public cCommBuffer
     int mPosition;    // current position in buffer for unpacking
 
   protected:
-    void extendBufferFor(int dataSize);
+    void extendBufferFor(int dataSize) {if (mMsgSize+dataSize >= mBufferSize) growBuffer(dataSize);}
+    void growBuffer(int dataSize);
 
   public:
     /**
@@ -80,10 +81,17 @@ class SIM_API cCommBufferBase : public cCommBuffer
      */
     int getMessageSize() const;
 
+    /**
+     * Returns the total length of the packed data, i.e. the number of bytes
+     * the communications layer transfers. This is the message length, unless
+     * the subclass can pack data by reference.
+     */
+    virtual int getTotalLength() const {return mMsgSize;}
+
     /**
      * Reset buffer to an empty state.
      */
-    void reset();
+    virtual void reset();
 
     /**
      * Returns true if all data in buffer was used up during unpacking.
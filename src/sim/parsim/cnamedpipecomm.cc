@@ -30,6 +30,8 @@
 #include <cerrno>
 #include <fcntl.h>
 #include <unistd.h>
+#include <climits>
+#include <csignal>
 #include "omnetpp/cexception.h"
 #include "omnetpp/clog.h"
 #include "omnetpp/globals.h"
@@ -38,9 +40,12 @@
 #include "omnetpp/cenvir.h"
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cconfiguration.h"
-#include "cmemcommbuffer.h"
 #include "parsimutil.h"
 
+#ifndef IOV_MAX
+#define IOV_MAX  1024
+#endif
+
 namespace omnetpp {
 
 Register_Class(cNamedPipeCommunications);
@@ -63,6 +68,30 @@ static int readBytes(int fd, void *buf, int len)
     return tot;
 }
 
+// writes all blocks, with as few system calls as possible
+static int writeBlocks(int fd, struct iovec *iov, int count)
+{
+    while (count > 0) {
+        int n = writev(fd, iov, count < IOV_MAX ? count : IOV_MAX);
+        if (n == -1) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return -1;
+        }
+        // skip what has been written
+        while (count > 0 && n >= (int)iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (n > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
 struct PipeHeader
 {
     int tag;
@@ -132,6 +161,10 @@ void cNamedPipeCommunications::init()
         if (wpipes[i] == -1)
             throw cRuntimeError("cNamedPipeCommunications: Cannot open pipe '%s' for write: %s", fname, strerror(errno));
     }
+
+    // a partition that finishes first closes its pipes; writing to them
+    // must not kill the process with SIGPIPE (see send())
+    signal(SIGPIPE, SIG_IGN);
 }
 
 void cNamedPipeCommunications::shutdown()
@@ -154,7 +187,7 @@ int cNamedPipeCommunications::getProcId() const
 
 cCommBuffer *cNamedPipeCommunications::createCommBuffer()
 {
-    return new cMemCommBuffer();
+    return new cScatterGatherCommBuffer();
 }
 
 void cNamedPipeCommunications::recycleCommBuffer(cCommBuffer *buffer)
@@ -164,16 +197,31 @@ void cNamedPipeCommunications::recycleCommBuffer(cCommBuffer *buffer)
 
 void cNamedPipeCommunications::send(cCommBuffer *buffer, int tag, int destination)
 {
-    cMemCommBuffer *b = (cMemCommBuffer *)buffer;
+    cScatterGatherCommBuffer *b = (cScatterGatherCommBuffer *)buffer;
     int fd = wpipes[destination];
 
+    // write the header and the packed data (including data packed by
+    // reference) in one go, without assembling them in a buffer first
     struct PipeHeader ph;
     ph.tag = tag;
-    ph.contentLength = b->getMessageSize();
-    if (write(fd, &ph, sizeof(ph)) == -1)
-        throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, strerror(errno));
-    if (write(fd, b->getBuffer(), ph.contentLength) == -1)
+    ph.contentLength = b->getTotalLength();
+    blocks.clear();
+    b->getBlocks(blocks);
+    iovecs.resize(blocks.size() + 1);
+    iovecs[0].iov_base = &ph;
+    iovecs[0].iov_len = sizeof(ph);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        iovecs[i+1].iov_base = (void *)blocks[i].data;
+        iovecs[i+1].iov_len = blocks[i].length;
+    }
+    if (writeBlocks(fd, iovecs.data(), iovecs.size()) == -1) {
+        // the destination has already finished (e.g. it reached the simulation
+        // time limit earlier), and its termination notice is waiting in our
+        // read pipe; nobody will receive the data, so it is silently dropped
+        if (errno == EPIPE)
+            return;
         throw cRuntimeError("cNamedPipeCommunications: Cannot write pipe to procId=%d: %s", destination, strerror(errno));
+    }
 }
 
 bool cNamedPipeCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking)
@@ -27,6 +27,7 @@
 
 #include <cstdio>
 #include <deque>
+#include <vector>
 #include "omnetpp/simutil.h"
 #include "omnetpp/opp_string.h"
 #include "omnetpp/cparsimcomm.h"
@@ -37,6 +38,11 @@
 #define USE_WINDOWS_PIPES
 #endif
 
+#ifndef USE_WINDOWS_PIPES
+#include <sys/uio.h>
+#include "cscattergathercommbuffer.h"
+#endif
+
 namespace omnetpp {
 
 #ifdef USE_WINDOWS_PIPES
@@ -69,6 +75,12 @@ class SIM_API cNamedPipeCommunications : public cParsimCommunications
     // reordering buffer needed because of tag filtering support (filtTag)
     std::deque<cCommBuffer*> storedBuffers;
 
+#ifndef USE_WINDOWS_PIPES
+    // used by send(), to pass the packed data to writev()
+    std::vector<cScatterGatherCommBuffer::Block> blocks;
+    std::vector<struct iovec> iovecs;
+#endif
+
   protected:
     // common impl. for receiveBlocking() and receiveNonblocking()
     bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId, bool blocking);
@@ -33,6 +33,7 @@
 #include "cnullmessageprot.h"
 #include "clinkdelaylookahead.h"
 #include "cparsimpartition.h"
+#include "cparsimtelemetry.h"
 #include "messagetags.h"
 #include "cplaceholdermod.h"
 #include "cproxygate.h"
@@ -114,6 +115,7 @@ void cNullMessageProtocol::startRun()
         if (i != myProcId) {
             sprintf(buf, "EIT-%d", i);
             cMessage *eitMsg = new cMessage(buf, MK_PARSIM_EIT);
+            eitMsg->setContextPointer((void *)(uintptr_t)i);
             segInfo[i].eitEvent = eitMsg;
             rescheduleEvent(eitMsg, 0.0);
         }
@@ -156,7 +158,7 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, int destProcId,
         buffer->pack(destModuleId);
         buffer->pack(destGateId);
         buffer->packObject(msg);
-        comm->send(buffer, TAG_CMESSAGE_WITH_NULLMESSAGE, destProcId);
+        sendBuffer(buffer, TAG_CMESSAGE_WITH_NULLMESSAGE, destProcId);
     }
     else
     {
@@ -166,7 +168,7 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, int destProcId,
         buffer->pack(destModuleId);
         buffer->pack(destGateId);
         buffer->packObject(msg);
-        comm->send(buffer, TAG_CMESSAGE, destProcId);
+        sendBuffer(buffer, TAG_CMESSAGE, destProcId);
     }
     comm->recycleCommBuffer(buffer);
 }
@@ -213,6 +215,9 @@ void cNullMessageProtocol::processReceivedEIT(int sourceProcId, simtime_t eit)
 
     {if (debug) EV << "null msg received from " << sourceProcId << ", EIT=" << eit << ", rescheduling EIT event\n";}
 
+    if (cParsimTelemetry *telemetry = partition->getTelemetry())
+        telemetry->eitReceived(sourceProcId, eit);
+
     // sanity check
     ASSERT(eit > eitMsg->getArrivalTime());
 
@@ -247,7 +252,7 @@ cEvent *cNullMessageProtocol::takeNextEvent()
         else if (msg && msg->getKind() == MK_PARSIM_EIT) {
             // wait until it gets out of the way (i.e. we get a higher EIT)
             {if (debug) EV << "blocking on EIT event '" << event->getName() << "'\n";}
-            if (!receiveBlocking())
+            if (!receiveBlocking((uintptr_t)msg->getContextPointer()))
                 return nullptr;
         }
         else {
@@ -291,7 +296,7 @@ void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
     // send out null message
     cCommBuffer *buffer = comm->createCommBuffer();
     buffer->pack(eot);
-    comm->send(buffer, TAG_NULLMESSAGE, procId);
+    sendBuffer(buffer, TAG_NULLMESSAGE, procId);
     comm->recycleCommBuffer(buffer);
 }
 
@@ -20,6 +20,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include "common/stringutil.h"
 #include "omnetpp/cmessage.h"
 #include "omnetpp/errmsg.h"
 #include "omnetpp/ccommbuffer.h"
@@ -33,25 +34,33 @@
 #include "cproxygate.h"
 #include "cparsimpartition.h"
 #include "cparsimsynchr.h"
+#include "cparsimtelemetry.h"
 #include "creceivedexception.h"
 #include "messagetags.h"
 
+using namespace omnetpp::common;
+
 namespace omnetpp {
 
 Register_Class(cParsimPartition);
 
 Register_GlobalConfigOption(CFGID_PARSIM_DEBUG, "parsim-debug", CFG_BOOL, "true", "With `parallel-simulation=true`: turns on printing of log messages from the parallel simulation code.");
+Register_PerRunConfigOption(CFGID_PARSIM_TELEMETRY, "parsim-telemetry", CFG_BOOL, "false", "With `parallel-simulation=true`: turns on collecting performance data in each partition: model and synchronization messages and bytes sent to and received from each other partition, wall-clock time spent blocked waiting for them, and the lead of their EITs over local simulation time (with null message protocols). A per-partition summary is printed at the end of the run, and a timeline is written into the file given with `parsim-telemetry-file`.");
+Register_PerRunConfigOption(CFGID_PARSIM_TELEMETRY_FILE, "parsim-telemetry-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.ptl", "With `parsim-telemetry=true`: name of the telemetry timeline file. The partition id is inserted before the file extension, so that every partition writes its own file. Specify empty string to only print the summary.");
+Register_PerRunConfigOptionU(CFGID_PARSIM_TELEMETRY_INTERVAL, "parsim-telemetry-interval", "s", "1s", "With `parsim-telemetry=true`: the wall-clock interval of writing lines into the telemetry timeline file.");
 
 cParsimPartition::cParsimPartition()
 {
     sim = nullptr;
     comm = nullptr;
     synch = nullptr;
+    telemetry = nullptr;
     debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
 }
 
 cParsimPartition::~cParsimPartition()
 {
+    delete telemetry;
 }
 
 void cParsimPartition::setContext(cSimulation *simul, cParsimCommunications *commlayer, cParsimSynchronizer *sync)
@@ -73,11 +82,32 @@ void cParsimPartition::lifecycleEvent(SimulationLifecycleEventType eventType, cO
 
 void cParsimPartition::startRun()
 {
+    delete telemetry;
+    telemetry = nullptr;
+    cConfiguration *cfg = getEnvir()->getConfig();
+    if (cfg->getAsBool(CFGID_PARSIM_TELEMETRY)) {
+        std::string fname = cfg->getAsFilename(CFGID_PARSIM_TELEMETRY_FILE);
+        if (!fname.empty()) {
+            // insert "-<procId>" before the extension
+            std::string::size_type dotPos = fname.rfind('.');
+            std::string::size_type slashPos = fname.find_last_of("/\\");
+            if (dotPos == std::string::npos || (slashPos != std::string::npos && dotPos < slashPos))
+                dotPos = fname.size();
+            fname.insert(dotPos, opp_stringf("-%d", comm->getProcId()));
+        }
+        double interval = cfg->getAsDouble(CFGID_PARSIM_TELEMETRY_INTERVAL);
+        telemetry = new cParsimTelemetry(sim, comm->getProcId(), comm->getNumPartitions(), fname.empty() ? nullptr : fname.c_str(), interval);
+    }
+
     connectRemoteGates();
 }
 
 void cParsimPartition::endRun()
 {
+    if (telemetry) {
+        telemetry->printSummary(EV);
+        telemetry->finish();
+    }
 }
 
 void cParsimPartition::shutdown()
@@ -199,13 +229,14 @@ void cParsimPartition::connectRemoteGates()
     }
 }
 
-void cParsimPartition::processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data)
+bool cParsimPartition::processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data)
 {
     if (debug)
         EV << "sending message '" << msg->getFullName() << "' (for T="
            << msg->getArrivalTime() << " to procId=" << procId << ")\n";
 
     synch->processOutgoingMessage(msg, procId, moduleId, gateId, data);
+    return comm->hasTakenOwnership(msg);
 }
 
 void cParsimPartition::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
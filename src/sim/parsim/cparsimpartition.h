@@ -34,6 +34,7 @@ class cParsimCommunications;
 class cCommBuffer;
 class cException;
 class cTerminationException;
+class cParsimTelemetry;
 
 
 /**
@@ -65,6 +66,7 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
     cSimulation *sim;
     cParsimCommunications *comm;
     cParsimSynchronizer *synch;
+    cParsimTelemetry *telemetry;  // nullptr if not enabled
     bool debug;
 
   protected:
@@ -95,15 +97,23 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
 
     /**
      * Called at the beginning of a simulation run. Fills in remote gate addresses
-     * of all cProxyGate's in the current partition.
+     * of all cProxyGate's in the current partition, and sets up telemetry
+     * if it is enabled.
      */
     void startRun();
 
     /**
-     * Called at the end of a simulation run.
+     * Called at the end of a simulation run. Prints the telemetry summary.
      */
     void endRun();
 
+    /**
+     * Returns the object that collects performance data of this partition,
+     * or nullptr if telemetry is not enabled (see the `parsim-telemetry`
+     * configuration option).
+     */
+    cParsimTelemetry *getTelemetry() const {return telemetry;}
+
     /**
      * Shut down the parallel simulation system.
      */
@@ -112,9 +122,12 @@ class SIM_API cParsimPartition : public cObject, public cISimulationLifecycleLis
     /**
      * A hook called from cProxyGate::deliver() when an outgoing cMessage
      * arrives at partition boundary. We just pass it up to the synchronization
-     * layer (see similar method in cParsimSynchronizer).
+     * layer (see similar method in cParsimSynchronizer). Returns true if
+     * the message object itself was passed to the other partition (see
+     * cParsimCommunications::hasTakenOwnership()), and false if it may
+     * be deleted.
      */
-    virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data);
+    virtual bool processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data);
 
     /**
      * Process messages coming from other partitions. This method is called from
@@ -25,6 +25,7 @@
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/ccommbuffer.h"
 #include "cparsimpartition.h"
+#include "cparsimtelemetry.h"
 #include "messagetags.h"
 #include "cparsimprotocolbase.h"
 
@@ -45,7 +46,7 @@ void cParsimProtocolBase::processOutgoingMessage(cMessage *msg, int destProcId,
     buffer->pack(destModuleId);
     buffer->pack(destGateId);
     buffer->packObject(msg);
-    comm->send(buffer, TAG_CMESSAGE, destProcId);
+    sendBuffer(buffer, TAG_CMESSAGE, destProcId);
 
     comm->recycleCommBuffer(buffer);
 }
@@ -76,28 +77,51 @@ void cParsimProtocolBase::processReceivedMessage(cMessage *msg, int destModuleId
     partition->processReceivedMessage(msg, destModuleId, destGateId, sourceProcId);
 }
 
+void cParsimProtocolBase::sendBuffer(cCommBuffer *buffer, int tag, int destProcId)
+{
+    comm->send(buffer, tag, destProcId);
+    if (cParsimTelemetry *telemetry = partition->getTelemetry())
+        telemetry->bufferSent(buffer, tag, destProcId);
+}
+
 void cParsimProtocolBase::receiveNonblocking()
 {
     int tag, sourceProcId;
+    cParsimTelemetry *telemetry = partition->getTelemetry();
     cCommBuffer *buffer = comm->createCommBuffer();
-    while (comm->receiveNonblocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId))
+    while (comm->receiveNonblocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId)) {
+        if (telemetry)
+            telemetry->bufferReceived(buffer, tag, sourceProcId);
         processReceivedBuffer(buffer, tag, sourceProcId);
+    }
     comm->recycleCommBuffer(buffer);
 }
 
-bool cParsimProtocolBase::receiveBlocking()
+bool cParsimProtocolBase::receiveBlocking(int waitedProcId)
 {
+    cParsimTelemetry *telemetry = partition->getTelemetry();
     cCommBuffer *buffer = comm->createCommBuffer();
 
     int tag, sourceProcId;
+    if (telemetry)
+        telemetry->blockingStarted(waitedProcId);
     if (!comm->receiveBlocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId)) {
+        if (telemetry)
+            telemetry->blockingEnded(-1);
         comm->recycleCommBuffer(buffer);
         return false;
     }
 
+    if (telemetry) {
+        telemetry->blockingEnded(sourceProcId);
+        telemetry->bufferReceived(buffer, tag, sourceProcId);
+    }
     processReceivedBuffer(buffer, tag, sourceProcId);
-    while (comm->receiveNonblocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId))
+    while (comm->receiveNonblocking(PARSIM_ANY_TAG, buffer, tag, sourceProcId)) {
+        if (telemetry)
+            telemetry->bufferReceived(buffer, tag, sourceProcId);
         processReceivedBuffer(buffer, tag, sourceProcId);
+    }
 
     comm->recycleCommBuffer(buffer);
     return true;
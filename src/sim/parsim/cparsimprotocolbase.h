@@ -41,7 +41,14 @@ class SIM_API cParsimProtocolBase : public cParsimSynchronizer
 
     // process whatever comes from other partitions -- blocking
     // (normally returns true; false is returned if blocking was interrupted by the user)
-    virtual bool receiveBlocking();
+    virtual bool receiveBlocking() {return receiveBlocking(-1);}
+
+    // same as above, when a message from the given partition is being waited
+    // for (this only makes a difference in the telemetry)
+    virtual bool receiveBlocking(int waitedProcId);
+
+    // sends the buffer to the given partition, and records it in the telemetry
+    virtual void sendBuffer(cCommBuffer *buffer, int tag, int destProcId);
 
     // process buffers coming from other partitions
     virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId);
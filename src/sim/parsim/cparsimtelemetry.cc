@@ -0,0 +1,229 @@
+//=========================================================================
+//  CPARSIMTELEMETRY.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cinttypes>
+#include <sstream>
+#include "common/fileutil.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/simutil.h"
+#include "ccommbufferbase.h"
+#include "cparsimtelemetry.h"
+#include "messagetags.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+
+cParsimTelemetry::cParsimTelemetry(cSimulation *sim, int procId, int numPartitions, const char *timelineFileName, double sampleInterval) :
+    sim(sim), procId(procId), peers(numPartitions), sampleMinEitLeads(numPartitions, -1)
+{
+    for (PeerStatistics& peer : peers) {
+        peer.numMessagesSent = peer.numSyncMessagesSent = 0;
+        peer.numMessagesReceived = peer.numSyncMessagesReceived = 0;
+        peer.numBytesSent = peer.numBytesReceived = 0;
+        peer.numBlockings = 0;
+        peer.blockingTime = 0;
+        peer.numEitsReceived = 0;
+        peer.sumEitLead = 0;
+        peer.minEitLead = -1;
+    }
+
+    startTime = opp_get_monotonic_clock_usecs();
+    blockingStartTime = -1;
+    blockingProcId = -1;
+    totalBlockingTime = 0;
+
+    timelineFile = nullptr;
+    this->sampleInterval = (int64_t)(sampleInterval * 1e6);
+    nextSampleTime = startTime + this->sampleInterval;
+    callsSinceClockCheck = 0;
+
+    if (timelineFileName) {
+        mkPath(directoryOf(timelineFileName).c_str());
+        timelineFile = fopen(timelineFileName, "w");
+        if (!timelineFile)
+            throw cRuntimeError("Cannot open parallel simulation telemetry file '%s' for write", timelineFileName);
+        fprintf(timelineFile, "# parallel simulation telemetry of partition %d of %d\n", procId, numPartitions);
+        fprintf(timelineFile, "# columns: wallclock simtime event blocked msgsSent syncSent bytesSent msgsReceived syncReceived bytesReceived");
+        for (int i = 0; i < numPartitions; i++)
+            if (i != procId)
+                fprintf(timelineFile, " minEitLead%d", i);
+        fprintf(timelineFile, "\n");
+        writeSample(startTime);
+    }
+}
+
+cParsimTelemetry::~cParsimTelemetry()
+{
+    if (timelineFile)
+        fclose(timelineFile);
+}
+
+int cParsimTelemetry::getTotalLength(cCommBuffer *buffer)
+{
+    // note: for buffers that pack data by reference (cScatterGatherCommBuffer),
+    // getMessageSize() would leave out the referenced blocks
+    cCommBufferBase *b = dynamic_cast<cCommBufferBase *>(buffer);
+    return b ? b->getTotalLength() : 0;
+}
+
+bool cParsimTelemetry::isModelMessageTag(int tag)
+{
+    return tag == TAG_CMESSAGE || tag == TAG_CMESSAGE_WITH_NULLMESSAGE;
+}
+
+void cParsimTelemetry::bufferSent(cCommBuffer *buffer, int tag, int destProcId)
+{
+    PeerStatistics& peer = peers[destProcId];
+    if (isModelMessageTag(tag))
+        peer.numMessagesSent++;
+    else
+        peer.numSyncMessagesSent++;
+    peer.numBytesSent += getTotalLength(buffer);
+    checkSampleTime();
+}
+
+void cParsimTelemetry::bufferReceived(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    PeerStatistics& peer = peers[sourceProcId];
+    if (isModelMessageTag(tag))
+        peer.numMessagesReceived++;
+    else
+        peer.numSyncMessagesReceived++;
+    peer.numBytesReceived += getTotalLength(buffer);
+    checkSampleTime();
+}
+
+void cParsimTelemetry::blockingStarted(int waitedProcId)
+{
+    blockingStartTime = opp_get_monotonic_clock_usecs();
+    blockingProcId = waitedProcId;
+}
+
+void cParsimTelemetry::blockingEnded(int sourceProcId)
+{
+    if (blockingStartTime == -1)
+        return;
+    int64_t now = opp_get_monotonic_clock_usecs();
+    int64_t duration = now - blockingStartTime;
+    totalBlockingTime += duration;
+    int procId = blockingProcId != -1 ? blockingProcId : sourceProcId;
+    if (procId != -1) {
+        peers[procId].numBlockings++;
+        peers[procId].blockingTime += duration;
+    }
+    blockingStartTime = -1;
+    if (timelineFile)
+        doCheckSampleTime(now);
+}
+
+void cParsimTelemetry::eitReceived(int sourceProcId, simtime_t eit)
+{
+    if (eit == SIMTIME_MAX)
+        return;  // the peer won't send anything any more
+    PeerStatistics& peer = peers[sourceProcId];
+    simtime_t lead = eit - sim->getSimTime();
+    peer.numEitsReceived++;
+    peer.sumEitLead += lead.dbl();
+    if (peer.minEitLead < SIMTIME_ZERO || lead < peer.minEitLead)
+        peer.minEitLead = lead;
+    simtime_t& sampleMinEitLead = sampleMinEitLeads[sourceProcId];
+    if (sampleMinEitLead < SIMTIME_ZERO || lead < sampleMinEitLead)
+        sampleMinEitLead = lead;
+}
+
+void cParsimTelemetry::doCheckSampleTime(int64_t now)
+{
+    callsSinceClockCheck = 0;
+    if (now == -1)
+        now = opp_get_monotonic_clock_usecs();
+    if (now >= nextSampleTime) {
+        writeSample(now);
+        while (nextSampleTime <= now)
+            nextSampleTime += sampleInterval > 0 ? sampleInterval : now - nextSampleTime + 1;
+    }
+}
+
+void cParsimTelemetry::writeSample(int64_t now)
+{
+    PeerStatistics sum = {};
+    for (const PeerStatistics& peer : peers) {
+        sum.numMessagesSent += peer.numMessagesSent;
+        sum.numSyncMessagesSent += peer.numSyncMessagesSent;
+        sum.numBytesSent += peer.numBytesSent;
+        sum.numMessagesReceived += peer.numMessagesReceived;
+        sum.numSyncMessagesReceived += peer.numSyncMessagesReceived;
+        sum.numBytesReceived += peer.numBytesReceived;
+    }
+    fprintf(timelineFile, "%.6f %s %" PRId64 " %.6f %ld %ld %" PRId64 " %ld %ld %" PRId64,
+            (now - startTime) / 1e6, SIMTIME_STR(sim->getSimTime()), sim->getEventNumber(), totalBlockingTime / 1e6,
+            sum.numMessagesSent, sum.numSyncMessagesSent, sum.numBytesSent,
+            sum.numMessagesReceived, sum.numSyncMessagesReceived, sum.numBytesReceived);
+
+    // smallest EIT lead from each peer since the previous line ("nan" if no EIT arrived)
+    for (int i = 0; i < (int)peers.size(); i++) {
+        if (i == procId)
+            continue;
+        simtime_t& sampleMinEitLead = sampleMinEitLeads[i];
+        if (sampleMinEitLead < SIMTIME_ZERO)
+            fprintf(timelineFile, " nan");
+        else
+            fprintf(timelineFile, " %s", SIMTIME_STR(sampleMinEitLead));
+        sampleMinEitLead = -1;
+    }
+    fprintf(timelineFile, "\n");
+}
+
+void cParsimTelemetry::printSummary(std::ostream& os) const
+{
+    double elapsed = (opp_get_monotonic_clock_usecs() - startTime) / 1e6;
+    os << "Parallel simulation telemetry of partition " << procId << ": "
+       << elapsed << "s elapsed, " << totalBlockingTime / 1e6 << "s blocked";
+    if (elapsed > 0)
+        os << " (" << (int)(100 * totalBlockingTime / 1e6 / elapsed + 0.5) << "%)";
+    os << "\n";
+    for (int i = 0; i < (int)peers.size(); i++) {
+        if (i == procId)
+            continue;
+        const PeerStatistics& peer = peers[i];
+        os << "  procId=" << i << ": "
+           << "sent " << peer.numMessagesSent << " messages + " << peer.numSyncMessagesSent << " sync, " << peer.numBytesSent << " bytes; "
+           << "received " << peer.numMessagesReceived << " messages + " << peer.numSyncMessagesReceived << " sync, " << peer.numBytesReceived << " bytes; "
+           << "blocked " << peer.numBlockings << " times, " << peer.blockingTime / 1e6 << "s";
+        if (peer.numEitsReceived > 0)
+            os << "; EIT lead min " << peer.minEitLead << "s, avg " << peer.sumEitLead / peer.numEitsReceived << "s";
+        os << "\n";
+    }
+}
+
+void cParsimTelemetry::finish()
+{
+    if (!timelineFile)
+        return;
+    writeSample(opp_get_monotonic_clock_usecs());
+
+    std::stringstream os;
+    printSummary(os);
+    std::string line;
+    while (std::getline(os, line))
+        fprintf(timelineFile, "# %s\n", line.c_str());
+
+    fclose(timelineFile);
+    timelineFile = nullptr;
+}
+
+}  // namespace omnetpp
+
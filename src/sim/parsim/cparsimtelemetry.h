@@ -0,0 +1,153 @@
+//=========================================================================
+//  CPARSIMTELEMETRY.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CPARSIMTELEMETRY_H
+#define __OMNETPP_CPARSIMTELEMETRY_H
+
+#include <cstdio>
+#include <ostream>
+#include <vector>
+#include "omnetpp/simkerneldefs.h"
+#include "omnetpp/simtime_t.h"
+
+namespace omnetpp {
+
+class cSimulation;
+class cCommBuffer;
+
+
+/**
+ * @brief Collects performance data of a partition in a parallel simulation,
+ * to tell whether it is blocked waiting for other partitions, starved of
+ * lookahead, or simply overloaded.
+ *
+ * Data are collected per peer partition: model messages and synchronization
+ * messages (null messages, barriers, etc.) sent and received, bytes
+ * transferred, and the wall-clock time spent blocked waiting for the peer.
+ * Protocols that receive EITs from their peers also record the EIT lead,
+ * i.e. how far the peer's EIT is ahead of the local simulation time when it
+ * arrives; values close to zero mean that the partition is held back by
+ * that peer.
+ *
+ * Totals are periodically written into a timeline file (one line per
+ * sample), together with the smallest EIT lead from each peer during the
+ * sampling interval, and a per-peer summary is produced at the end of the run.
+ * The object is created by cParsimPartition when the `parsim-telemetry`
+ * configuration option is enabled.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cParsimTelemetry
+{
+  public:
+    struct PeerStatistics
+    {
+        long numMessagesSent;          // buffers carrying a cMessage
+        long numSyncMessagesSent;      // buffers carrying only protocol data (null messages, barriers, etc.)
+        int64_t numBytesSent;
+        long numMessagesReceived;
+        long numSyncMessagesReceived;
+        int64_t numBytesReceived;
+        long numBlockings;             // number of waits for this peer
+        int64_t blockingTime;          // wall-clock time spent waiting for this peer, in microseconds
+        long numEitsReceived;
+        double sumEitLead;             // sum of (EIT - local simulation time) at EIT arrival, in seconds
+        simtime_t minEitLead;          // smallest one of the above, or -1
+    };
+
+  protected:
+    cSimulation *sim;
+    int procId;
+    std::vector<PeerStatistics> peers;
+    std::vector<simtime_t> sampleMinEitLeads;  // per peer: smallest EIT lead since the last timeline sample, or -1
+
+    int64_t startTime;          // wall-clock, in microseconds
+    int64_t blockingStartTime;  // -1 if not blocking
+    int blockingProcId;         // the peer we're waiting for, or -1 if it's not known
+    int64_t totalBlockingTime;
+
+    FILE *timelineFile;
+    int64_t sampleInterval;     // in microseconds
+    int64_t nextSampleTime;
+    int callsSinceClockCheck;   // we only look at the clock every now and then
+
+  protected:
+    // number of bytes transferred, and whether a tag denotes a model message
+    static int getTotalLength(cCommBuffer *buffer);
+    static bool isModelMessageTag(int tag);
+
+    // writes a line into the timeline file if the sampling interval has elapsed
+    void checkSampleTime() {if (timelineFile && ++callsSinceClockCheck >= 64) doCheckSampleTime(-1);}
+    void doCheckSampleTime(int64_t now);
+    void writeSample(int64_t now);
+
+  public:
+    /**
+     * Constructor. If timelineFileName is not nullptr, the timeline is
+     * written into that file with the given sampling interval (in seconds).
+     */
+    cParsimTelemetry(cSimulation *sim, int procId, int numPartitions, const char *timelineFileName, double sampleInterval);
+
+    /**
+     * Destructor. Closes the timeline file.
+     */
+    virtual ~cParsimTelemetry();
+
+    /** @name Data collection. */
+    //@{
+    void bufferSent(cCommBuffer *buffer, int tag, int destProcId);
+    void bufferReceived(cCommBuffer *buffer, int tag, int sourceProcId);
+
+    /**
+     * To be called before a blocking receive. waitedProcId is the partition
+     * whose message is being waited for, or -1 if it may be any partition.
+     */
+    void blockingStarted(int waitedProcId);
+
+    /**
+     * To be called after a blocking receive. If the waited partition was not
+     * known, the blocking time is accounted to the one the received buffer
+     * came from (or not at all, if sourceProcId is -1).
+     */
+    void blockingEnded(int sourceProcId);
+
+    /**
+     * To be called by protocols that receive EITs from other partitions.
+     */
+    void eitReceived(int sourceProcId, simtime_t eit);
+    //@}
+
+    /** @name Results. */
+    //@{
+    const PeerStatistics& getPeerStatistics(int procId) const {return peers[procId];}
+    int64_t getTotalBlockingTime() const {return totalBlockingTime;}
+
+    /**
+     * Prints a per-peer summary of the statistics.
+     */
+    void printSummary(std::ostream& os) const;
+
+    /**
+     * Writes the last sample and the summary into the timeline file, and closes it.
+     */
+    void finish();
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -54,8 +54,9 @@ bool cProxyGate::deliver(cMessage *msg, simtime_t t)
         throw cRuntimeError(this, "Cannot deliver message '%s': Not connected to remote gate", msg->getName());
 
     msg->setArrivalTime(t);  // merge arrival time into message
-    partition->processOutgoingMessage(msg, remoteProcId, remoteModuleId, remoteGateId, data);
-    return false;  // meaning message should be deleted
+    // if the message object was passed to the other partition as it is,
+    // it must not be deleted here
+    return partition->processOutgoingMessage(msg, remoteProcId, remoteModuleId, remoteGateId, data);
 }
 
 void cProxyGate::setRemoteGate(short procId, int moduleId, int gateId)
@@ -79,7 +79,8 @@ class SIM_API cProxyGate : public cGate // noncopyable
      * cParsimPartition.
      *
      * Invokes the cParsimPartition::processOutgoingMessage() method
-     * to transmit the message, then deletes the message object.
+     * to transmit the message. The message object is deleted afterwards,
+     * unless it was passed to the other partition as it is.
      */
     virtual bool deliver(cMessage *msg, simtime_t at) override;
     //@}
@@ -0,0 +1,156 @@
+//=========================================================================
+//  CSCATTERGATHERCOMMBUFFER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "cscattergathercommbuffer.h"
+
+namespace omnetpp {
+
+Register_Class(cScatterGatherCommBuffer);
+
+// below this size, copying is cheaper than managing one more block
+#define DEFAULT_MIN_REFERENCED_LENGTH  256
+
+cScatterGatherCommBuffer::cScatterGatherCommBuffer()
+{
+    inlineStart = 0;
+    referencedLength = 0;
+    minReferencedLength = DEFAULT_MIN_REFERENCED_LENGTH;
+}
+
+cScatterGatherCommBuffer::~cScatterGatherCommBuffer()
+{
+}
+
+void cScatterGatherCommBuffer::reset()
+{
+    cMemCommBuffer::reset();
+    segments.clear();
+    inlineStart = 0;
+    referencedLength = 0;
+}
+
+void cScatterGatherCommBuffer::packReference(const void *d, int length)
+{
+    // close the buffer part packed since the previous reference
+    if (mMsgSize > inlineStart) {
+        Segment segment = { nullptr, inlineStart, mMsgSize - inlineStart };
+        segments.push_back(segment);
+        inlineStart = mMsgSize;
+    }
+    Segment segment = { (const char *)d, 0, length };
+    segments.push_back(segment);
+    referencedLength += length;
+}
+
+template<typename T>
+void cScatterGatherCommBuffer::packArray(const T *d, int size)
+{
+    if (size * (int)sizeof(T) >= minReferencedLength)
+        packReference(d, size * sizeof(T));
+    else
+        cMemCommBuffer::pack(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const char *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const unsigned char *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const bool *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const short *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const unsigned short *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const int *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const unsigned int *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const long *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const unsigned long *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const long long *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const unsigned long long *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const float *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const double *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::pack(const long double *d, int size)
+{
+    packArray(d, size);
+}
+
+void cScatterGatherCommBuffer::packBytes(const void *d, int size)
+{
+    packArray((const char *)d, size);
+}
+
+void cScatterGatherCommBuffer::getBlocks(std::vector<Block>& blocks) const
+{
+    for (const Segment& segment : segments) {
+        Block block = { segment.data ? segment.data : mBuffer + segment.offset, segment.length };
+        blocks.push_back(block);
+    }
+    if (mMsgSize > inlineStart) {
+        Block block = { mBuffer + inlineStart, mMsgSize - inlineStart };
+        blocks.push_back(block);
+    }
+}
+
+}  // namespace omnetpp
+
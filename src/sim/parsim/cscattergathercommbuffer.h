@@ -0,0 +1,146 @@
+//=========================================================================
+//  CSCATTERGATHERCOMMBUFFER.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CSCATTERGATHERCOMMBUFFER_H
+#define __OMNETPP_CSCATTERGATHERCOMMBUFFER_H
+
+#include <vector>
+#include "cmemcommbuffer.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief Communication buffer that avoids copying large blocks of data
+ * while packing.
+ *
+ * Basic types and strings are packed like in cMemCommBuffer, but arrays
+ * and memory blocks (see packBytes()) of at least getMinReferencedLength()
+ * bytes are not copied into the buffer: only a reference to them is
+ * recorded. Strings are always copied, because they are routinely passed
+ * as temporaries (e.g. getFullPath().c_str()). The packed data is then the sequence of blocks returned by
+ * getBlocks(), which the communications layer can pass to the operating
+ * system in one call (e.g. with writev()), without assembling it first.
+ * The concatenation of the blocks is identical to what cMemCommBuffer
+ * would produce, so the receiving side can unpack it with cMemCommBuffer
+ * (or this class, used as a cMemCommBuffer).
+ *
+ * Referenced data must stay alive and unchanged until the buffer has been
+ * sent (see cCommBuffer), which is the case for messages packed in
+ * cParsimPartition, as they are only deleted after the send() call. Data cannot be unpacked from
+ * a buffer that contains references.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cScatterGatherCommBuffer : public cMemCommBuffer
+{
+  public:
+    /**
+     * A block of packed data.
+     */
+    struct Block {
+        const char *data;
+        int length;
+    };
+
+  protected:
+    struct Segment {
+        const char *data;  // referenced data; nullptr for data in the buffer
+        int offset;        // position in the buffer, if data==nullptr
+        int length;
+    };
+    std::vector<Segment> segments;  // referenced blocks, and the buffer parts preceding them
+    int inlineStart;          // start of the buffer part not yet in 'segments'
+    int referencedLength;     // total length of referenced blocks
+    int minReferencedLength;  // blocks shorter than this are copied
+
+  protected:
+    void packReference(const void *d, int length);
+    template<typename T> void packArray(const T *d, int size);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cScatterGatherCommBuffer();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cScatterGatherCommBuffer();
+
+    /** @name Redefined cCommBuffer methods that may pack by reference */
+    //@{
+    virtual void pack(const char *d, int size) override;
+    virtual void pack(const unsigned char *d, int size) override;
+    virtual void pack(const bool *d, int size) override;
+    virtual void pack(const short *d, int size) override;
+    virtual void pack(const unsigned short *d, int size) override;
+    virtual void pack(const int *d, int size) override;
+    virtual void pack(const unsigned int *d, int size) override;
+    virtual void pack(const long *d, int size) override;
+    virtual void pack(const unsigned long *d, int size) override;
+    virtual void pack(const long long *d, int size) override;
+    virtual void pack(const unsigned long long *d, int size) override;
+    virtual void pack(const float *d, int size) override;
+    virtual void pack(const double *d, int size) override;
+    virtual void pack(const long double *d, int size) override;
+    virtual void packBytes(const void *d, int size) override;
+    using cMemCommBuffer::pack;
+    //@}
+
+    /** @name Buffer management */
+    //@{
+    /**
+     * Resets the buffer to an empty state, forgetting all references.
+     */
+    virtual void reset() override;
+
+    /**
+     * Returns the total length of the packed data, including referenced
+     * blocks. (getMessageSize() only counts the data copied into the buffer.)
+     */
+    virtual int getTotalLength() const override {return mMsgSize + referencedLength;}
+
+    /**
+     * Returns true if some data was packed by reference.
+     */
+    bool hasReferences() const {return referencedLength > 0;}
+
+    /**
+     * Appends the packed data to the given vector as a sequence of blocks.
+     * The blocks are valid until the buffer or the referenced data changes.
+     */
+    void getBlocks(std::vector<Block>& blocks) const;
+
+    /**
+     * Returns the length from which arrays and memory blocks are packed
+     * by reference.
+     */
+    int getMinReferencedLength() const {return minReferencedLength;}
+
+    /**
+     * Sets the length from which arrays and memory blocks are packed
+     * by reference.
+     */
+    void setMinReferencedLength(int length) {minReferencedLength = length;}
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
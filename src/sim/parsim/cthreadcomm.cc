@@ -0,0 +1,323 @@
+//=========================================================================
+//  CTHREADCOMM.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <mutex>
+#include <thread>
+#include "common/spscqueue.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/clog.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/csimulation.h"
+#include "cthreadcomm.h"
+#include "cthreadcommbuffer.h"
+#include "parsimutil.h"
+
+namespace omnetpp {
+
+using namespace omnetpp::common;
+
+Register_Class(cThreadCommunications);
+
+// number of polling rounds in receiveBlocking() before starting to yield the CPU
+#define SPIN_COUNT  1000
+
+// max number of buffers kept for createCommBuffer()
+#define MAX_POOLED_BUFFERS  16
+
+struct cThreadCommunications::Hub
+{
+    struct Channel {
+        SpscQueue<Envelope> data;                  // written by the source, read by the destination partition
+        SpscQueue<cThreadCommBuffer*> returned;    // emptied buffers, on their way back to the source partition
+    };
+
+    int numPartitions;
+    std::vector<Channel*> channels;  // indexed by sourceProcId*numPartitions+destProcId
+    std::vector<bool> joined;
+    int refCount = 0;
+
+    Hub(int numPartitions);
+    ~Hub();
+    Channel *getChannel(int sourceProcId, int destProcId) {return channels[sourceProcId*numPartitions+destProcId];}
+};
+
+cThreadCommunications::Hub::Hub(int n) : numPartitions(n), channels(n*n), joined(n, false)
+{
+    for (int i = 0; i < n*n; i++)
+        channels[i] = (i / n == i % n) ? nullptr : new Channel();
+}
+
+cThreadCommunications::Hub::~Hub()
+{
+    // free data nobody has received, together with the objects in it: they
+    // were removed from the sender's ownership tree, so nobody else owns them.
+    // (All partitions have left already, so popping from here is safe.)
+    for (Channel *channel : channels) {
+        if (!channel)
+            continue;
+        Envelope envelope;
+        while (channel->data.pop(envelope)) {
+            for (cObject *obj : envelope.buffer->getObjects())
+                delete obj;
+            delete envelope.buffer;
+        }
+        cThreadCommBuffer *buffer;
+        while (channel->returned.pop(buffer))
+            delete buffer;
+        delete channel;
+    }
+}
+
+// the partitions (threads) of this process
+static std::mutex hubMutex;
+static cThreadCommunications::Hub *theHub = nullptr;
+
+cThreadCommunications::cThreadCommunications()
+{
+    numPartitions = myProcId = -1;
+    hub = nullptr;
+    runIndex = 0;
+    rrBase = 0;
+}
+
+cThreadCommunications::~cThreadCommunications()
+{
+    for (auto& item : outbox) {
+        for (cObject *obj : item.second.buffer->getObjects())
+            delete obj;
+        delete item.second.buffer;
+    }
+    if (hub)
+        for (const Envelope& envelope : storedEnvelopes)
+            releaseEnvelope(envelope, true);
+    for (cThreadCommBuffer *buffer : bufferPool)
+        delete buffer;
+
+    if (hub) {
+        std::lock_guard<std::mutex> lock(hubMutex);
+        hub->joined[myProcId] = false;
+        if (--hub->refCount == 0) {
+            delete hub;
+            theHub = nullptr;
+        }
+    }
+}
+
+void cThreadCommunications::init()
+{
+    // get numPartitions and myProcId from "-p" command-line option
+    getProcIdFromCommandLineArgs(myProcId, numPartitions, "cThreadCommunications");
+
+    // join the other partitions
+    {
+        std::lock_guard<std::mutex> lock(hubMutex);
+        if (!theHub)
+            theHub = new Hub(numPartitions);
+        if (theHub->numPartitions != numPartitions)
+            throw cRuntimeError("cThreadCommunications: Partition %d was started with %d partitions, "
+                                "but other partitions in the process use %d", myProcId, numPartitions, theHub->numPartitions);
+        if (theHub->joined[myProcId])
+            throw cRuntimeError("cThreadCommunications: Partition %d is already running in this process", myProcId);
+        theHub->joined[myProcId] = true;
+        theHub->refCount++;
+        hub = theHub;
+    }
+
+    getEnvir()->addLifecycleListener(this);
+    EV << "cThreadCommunications: started as partition " << myProcId << " out of " << numPartitions << ".\n";
+}
+
+void cThreadCommunications::shutdown()
+{
+    flushOutbox();
+}
+
+int cThreadCommunications::getNumPartitions() const
+{
+    return numPartitions;
+}
+
+int cThreadCommunications::getProcId() const
+{
+    return myProcId;
+}
+
+cCommBuffer *cThreadCommunications::createCommBuffer()
+{
+    if (bufferPool.empty())
+        return new cThreadCommBuffer();
+    cThreadCommBuffer *buffer = bufferPool.back();
+    bufferPool.pop_back();
+    return buffer;
+}
+
+void cThreadCommunications::recycleCommBuffer(cCommBuffer *buffer)
+{
+    cThreadCommBuffer *b = (cThreadCommBuffer *)buffer;
+    if (bufferPool.size() >= MAX_POOLED_BUFFERS)
+        delete b;
+    else {
+        b->clear();
+        bufferPool.push_back(b);
+    }
+}
+
+cThreadCommBuffer *cThreadCommunications::getFreeBuffer(int destination)
+{
+    cThreadCommBuffer *buffer;
+    if (hub->getChannel(myProcId, destination)->returned.pop(buffer))
+        return buffer;
+    return new cThreadCommBuffer();
+}
+
+void cThreadCommunications::releaseEnvelope(const Envelope& envelope, bool deleteObjects)
+{
+    if (deleteObjects)
+        for (cObject *obj : envelope.buffer->getObjects())
+            delete obj;
+    envelope.buffer->clear();
+    hub->getChannel(envelope.sourceProcId, myProcId)->returned.push(envelope.buffer);
+}
+
+void cThreadCommunications::flushOutbox()
+{
+    for (auto& item : outbox)
+        hub->getChannel(myProcId, item.first)->data.push(item.second);
+    outbox.clear();
+}
+
+void cThreadCommunications::send(cCommBuffer *buffer, int tag, int destination)
+{
+    if (destination < 0 || destination >= numPartitions || destination == myProcId)
+        throw cRuntimeError("cThreadCommunications: Invalid destination partition %d", destination);
+
+    Envelope envelope;
+    envelope.tag = tag;
+    envelope.sourceProcId = myProcId;
+    envelope.runIndex = runIndex;
+    envelope.buffer = getFreeBuffer(destination);
+    envelope.buffer->takeContents((cThreadCommBuffer *)buffer);
+
+    // the sending module may still access the message until its send() call
+    // returns (see EVCB.endSend()), so objects are only handed over on the next call
+    flushOutbox();
+    if (envelope.buffer->hasObjects())
+        outbox.push_back(std::make_pair(destination, envelope));
+    else
+        hub->getChannel(myProcId, destination)->data.push(envelope);
+}
+
+void cThreadCommunications::broadcast(cCommBuffer *buffer, int tag)
+{
+    if (((cThreadCommBuffer *)buffer)->hasObjects())
+        throw cRuntimeError("cThreadCommunications: Cannot broadcast objects, they can only be passed to one partition");
+    cParsimCommunications::broadcast(buffer, tag);
+}
+
+bool cThreadCommunications::hasTakenOwnership(cObject *obj)
+{
+    for (auto it = outbox.rbegin(); it != outbox.rend(); ++it)
+        for (cObject *o : it->second.buffer->getObjects())
+            if (o == obj)
+                return true;
+    return false;
+}
+
+void cThreadCommunications::deliver(const Envelope& envelope, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // swap the data into the caller's buffer, and send the envelope's buffer back for reuse
+    ((cThreadCommBuffer *)buffer)->swapContents(envelope.buffer);
+    receivedTag = envelope.tag;
+    sourceProcId = envelope.sourceProcId;
+    releaseEnvelope(envelope, false);
+}
+
+bool cThreadCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // data put aside earlier comes first
+    for (auto it = storedEnvelopes.begin(); it != storedEnvelopes.end(); ++it) {
+        if (it->runIndex == runIndex && (filtTag == PARSIM_ANY_TAG || filtTag == it->tag)) {
+            Envelope envelope = *it;
+            storedEnvelopes.erase(it);
+            deliver(envelope, buffer, receivedTag, sourceProcId);
+            return true;
+        }
+    }
+
+    rrBase = (rrBase+1) % numPartitions;
+    for (int k = 0; k < numPartitions; k++) {
+        int i = (rrBase+k) % numPartitions;  // shift by rrBase for Round-Robin query
+        if (i == myProcId)
+            continue;
+        Hub::Channel *channel = hub->getChannel(i, myProcId);
+        Envelope envelope;
+        while (channel->data.pop(envelope)) {
+            if (envelope.runIndex < runIndex)
+                releaseEnvelope(envelope, true);  // left over from an earlier run
+            else if (envelope.runIndex > runIndex || (filtTag != PARSIM_ANY_TAG && filtTag != envelope.tag))
+                storedEnvelopes.push_back(envelope);
+            else {
+                deliver(envelope, buffer, receivedTag, sourceProcId);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool cThreadCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    flushOutbox();
+
+    // other partitions normally run on other cores, so we poll for a while
+    // before starting to give up the CPU
+    for (int i = 0; !receive(filtTag, buffer, receivedTag, sourceProcId); i++) {
+        if (i >= SPIN_COUNT) {
+            if (getEnvir()->idle())
+                return false;
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+bool cThreadCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    flushOutbox();
+    return receive(filtTag, buffer, receivedTag, sourceProcId);
+}
+
+void cThreadCommunications::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    if (eventType == LF_PRE_NETWORK_SETUP) {
+        // the partitions of a run start the next run independently of each
+        // other, so data still in transit belongs to the earlier run
+        flushOutbox();
+        runIndex++;
+        for (auto it = storedEnvelopes.begin(); it != storedEnvelopes.end(); ) {
+            if (it->runIndex < runIndex) {
+                releaseEnvelope(*it, true);
+                it = storedEnvelopes.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+}  // namespace omnetpp
+
@@ -0,0 +1,172 @@
+//=========================================================================
+//  CTHREADCOMM.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTHREADCOMM_H
+#define __OMNETPP_CTHREADCOMM_H
+
+#include <deque>
+#include <vector>
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/clifecyclelistener.h"
+
+namespace omnetpp {
+
+class cThreadCommBuffer;
+
+/**
+ * @brief Implementation of the communications layer for partitions that
+ * run as threads of the same process (see the -j option of Cmdenv).
+ *
+ * Partitions exchange data through lock-free single-producer single-consumer
+ * queues, one for each ordered pair of partitions. Messages are not
+ * serialized: cThreadCommBuffer passes the message object itself to the
+ * receiving partition, which is much cheaper than packing and unpacking
+ * it. Buffers are recycled through a second queue in the reverse direction,
+ * so that steady-state communication does not allocate memory.
+ *
+ * Sending a buffer that contains message objects is delayed until the next
+ * call into the communications layer (send, receive, etc.), because the
+ * sending partition may still access the message after
+ * cParsimPartition::processOutgoingMessage() has returned (e.g. for
+ * eventlog recording).
+ *
+ * The partition number and the number of partitions are taken from the
+ * -p<procId>,<numPartitions> command-line option, like with the other
+ * communications classes.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cThreadCommunications : public cParsimCommunications, public cISimulationLifecycleListener
+{
+  public:
+    struct Hub;  // internal: state shared by the partitions of the process
+
+  protected:
+    struct Envelope {
+        int tag;
+        int sourceProcId;
+        int runIndex;
+        cThreadCommBuffer *buffer;
+    };
+
+    int numPartitions;
+    int myProcId;
+    Hub *hub;
+    int runIndex;  // sequence number of the current run; data sent in earlier runs is discarded
+    int rrBase;
+
+    // sends delayed until the next call (destination procId + envelope)
+    std::vector<std::pair<int,Envelope>> outbox;
+
+    // reordering buffer needed because of tag filtering support (filtTag)
+    std::deque<Envelope> storedEnvelopes;
+
+    // buffers for createCommBuffer()
+    std::vector<cThreadCommBuffer*> bufferPool;
+
+  protected:
+    cThreadCommBuffer *getFreeBuffer(int destination);
+    void releaseEnvelope(const Envelope& envelope, bool deleteObjects);
+    void flushOutbox();
+    bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    void deliver(const Envelope& envelope, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cThreadCommunications();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cThreadCommunications();
+
+    /** @name Redefined methods from cParsimCommunications */
+    //@{
+    /**
+     * Init the library. Here we join the set of partitions in this process.
+     */
+    virtual void init() override;
+
+    /**
+     * Shutdown the communications library.
+     */
+    virtual void shutdown() override;
+
+    /**
+     * Returns total number of partitions.
+     */
+    virtual int getNumPartitions() const override;
+
+    /**
+     * Returns the id of this partition.
+     */
+    virtual int getProcId() const override;
+
+    /**
+     * Creates an empty buffer of type cThreadCommBuffer.
+     */
+    virtual cCommBuffer *createCommBuffer() override;
+
+    /**
+     * Recycle communication buffer after use.
+     */
+    virtual void recycleCommBuffer(cCommBuffer *buffer) override;
+
+    /**
+     * Sends packed data with given tag to destination.
+     */
+    virtual void send(cCommBuffer *buffer, int tag, int destination) override;
+
+    /**
+     * Redefined to reject buffers that contain objects passed by pointer.
+     */
+    virtual void broadcast(cCommBuffer *buffer, int tag) override;
+
+    /**
+     * Returns true for objects packed into buffers that were sent.
+     */
+    virtual bool hasTakenOwnership(cObject *obj) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Normally returns true; false is returned if blocking was interrupted by the user.
+     */
+    virtual bool receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Call is non-blocking -- it returns true if something has been
+     * received, false otherwise.
+     */
+    virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+    //@}
+
+    /** @name Redefined cISimulationLifecycleListener method */
+    //@{
+    /**
+     * Keeps track of the runs, so that data left over from the previous
+     * run can be discarded.
+     */
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -0,0 +1,88 @@
+//=========================================================================
+//  CTHREADCOMMBUFFER.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include "omnetpp/cownedobject.h"
+#include "omnetpp/cpacket.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "cthreadcommbuffer.h"
+
+namespace omnetpp {
+
+Register_Class(cThreadCommBuffer);
+
+cThreadCommBuffer::cThreadCommBuffer()
+{
+}
+
+cThreadCommBuffer::~cThreadCommBuffer()
+{
+}
+
+void cThreadCommBuffer::packObject(cObject *obj)
+{
+    // encapsulated packets may be shared with packets that stay in this
+    // partition; getEncapsulatedPacket() makes a private copy of them
+    if (cPacket *pkt = dynamic_cast<cPacket *>(obj))
+        while ((pkt = pkt->getEncapsulatedPacket()) != nullptr)
+            ;
+
+    if (cOwnedObject *ownedObj = dynamic_cast<cOwnedObject *>(obj))
+        ownedObj->removeFromOwnershipTree();
+
+    pack((unsigned long long)(uintptr_t)obj);
+    objects.push_back(obj);
+}
+
+cObject *cThreadCommBuffer::unpackObject()
+{
+    unsigned long long ptr;
+    unpack(ptr);
+    cObject *obj = (cObject *)(uintptr_t)ptr;
+
+    if (cOwnedObject *ownedObj = dynamic_cast<cOwnedObject *>(obj))
+        ownedObj->addToDefaultOwner();
+    return obj;
+}
+
+void cThreadCommBuffer::takeContents(cThreadCommBuffer *other)
+{
+    reset();
+    allocateAtLeast(other->mMsgSize);
+    memcpy(mBuffer, other->mBuffer, other->mMsgSize);
+    mMsgSize = other->mMsgSize;
+    objects.swap(other->objects);
+    other->objects.clear();
+}
+
+void cThreadCommBuffer::swapContents(cThreadCommBuffer *other)
+{
+    std::swap(mBuffer, other->mBuffer);
+    std::swap(mBufferSize, other->mBufferSize);
+    std::swap(mMsgSize, other->mMsgSize);
+    std::swap(mPosition, other->mPosition);
+}
+
+void cThreadCommBuffer::clear()
+{
+    reset();
+    objects.clear();
+}
+
+}  // namespace omnetpp
+
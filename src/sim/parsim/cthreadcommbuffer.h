@@ -0,0 +1,103 @@
+//=========================================================================
+//  CTHREADCOMMBUFFER.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTHREADCOMMBUFFER_H
+#define __OMNETPP_CTHREADCOMMBUFFER_H
+
+#include <vector>
+#include "cmemcommbuffer.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief Communication buffer used by cThreadCommunications. Basic types
+ * are packed like in cMemCommBuffer, but objects are not serialized:
+ * packObject() stores the object pointer itself, and the object is passed
+ * to the receiving partition as it is.
+ *
+ * Objects packed into the buffer are removed from the ownership tree of
+ * the sender, and encapsulated packets shared with other packets are
+ * duplicated, so that the receiving thread gets exclusive access to them.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cThreadCommBuffer : public cMemCommBuffer
+{
+  protected:
+    std::vector<cObject *> objects;  // objects packed by pointer, in packing order
+
+  public:
+    /**
+     * Constructor.
+     */
+    cThreadCommBuffer();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cThreadCommBuffer();
+
+    /** @name Redefined cCommBuffer methods */
+    //@{
+    /**
+     * Detaches the object from the data structures of the calling thread,
+     * and packs its pointer.
+     */
+    virtual void packObject(cObject *obj) override;
+
+    /**
+     * Unpacks an object pointer, and inserts the object into the ownership
+     * tree of the calling thread.
+     */
+    virtual cObject *unpackObject() override;
+    //@}
+
+    /** @name Buffer management */
+    //@{
+    /**
+     * Returns the objects packed into this buffer by pointer.
+     */
+    const std::vector<cObject *>& getObjects() const {return objects;}
+
+    /**
+     * Returns true if there are objects packed into this buffer by pointer.
+     */
+    bool hasObjects() const {return !objects.empty();}
+
+    /**
+     * Makes this buffer a copy of the other one, ready for unpacking.
+     * The objects packed into the other buffer are moved over to this one.
+     */
+    void takeContents(cThreadCommBuffer *other);
+
+    /**
+     * Exchanges the packed data of the two buffers. The object lists are
+     * not affected.
+     */
+    void swapContents(cThreadCommBuffer *other);
+
+    /**
+     * Empties the buffer and forgets the packed objects (without deleting them).
+     */
+    void clear();
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
@@ -0,0 +1,262 @@
+//=========================================================================
+//  CTIMEWINDOWPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include "omnetpp/cmessage.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/cfutureeventset.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "ctimewindowprot.h"
+#include "cnmplookahead.h"
+#include "cparsimpartition.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cTimeWindowProtocol);
+
+Register_GlobalConfigOption(CFGID_PARSIM_TIMEWINDOWPROTOCOL_LOOKAHEAD_CLASS, "parsim-timewindowprotocol-lookahead-class", CFG_STRING, "cLinkDelayLookahead", "When `cTimeWindowProtocol` is selected as parsim synchronization class: specifies the C++ class that calculates lookahead. The class should subclass from `cNMPLookahead`.");
+extern cConfigOption *CFGID_PARSIM_DEBUG;  // registered in cparsimpartition.cc
+
+cTimeWindowProtocol::cTimeWindowProtocol() : cParsimProtocolBase()
+{
+    numSeg = 0;
+    segInfo = nullptr;
+    windowIndex = 0;
+    numEvents = 0;
+
+    debug = getEnvir()->getConfig()->getAsBool(CFGID_PARSIM_DEBUG);
+    std::string lookhClass = getEnvir()->getConfig()->getAsString(CFGID_PARSIM_TIMEWINDOWPROTOCOL_LOOKAHEAD_CLASS);
+    lookaheadcalc = dynamic_cast<cNMPLookahead *>(createOne(lookhClass.c_str()));
+    if (!lookaheadcalc)
+        throw cRuntimeError("Class \"%s\" is not subclassed from cNMPLookahead", lookhClass.c_str());
+}
+
+cTimeWindowProtocol::~cTimeWindowProtocol()
+{
+    delete lookaheadcalc;
+    delete[] segInfo;
+}
+
+void cTimeWindowProtocol::setContext(cSimulation *sim, cParsimPartition *seg, cParsimCommunications *co)
+{
+    cParsimProtocolBase::setContext(sim, seg, co);
+    lookaheadcalc->setContext(sim, seg, co);
+}
+
+void cTimeWindowProtocol::startRun()
+{
+    EV << "starting Time Window Protocol...\n";
+
+    delete[] segInfo;
+
+    numSeg = comm->getNumPartitions();
+    segInfo = new PartitionInfo[numSeg];
+    for (int i = 0; i < numSeg; i++)
+        segInfo[i].numMessagesSent = segInfo[i].numMessagesReceived = 0;
+
+    for (Barrier& barrier : barriers) {
+        barrier.numReceived = 0;
+        barrier.minNextEvent = barrier.minLookahead = SIMTIME_MAX;
+    }
+
+    // the first window is empty: it only consists of a barrier exchange
+    windowIndex = 0;
+    windowEnd = SIMTIME_ZERO;
+    minSentArrival = SIMTIME_MAX;
+    numEvents = 0;
+
+    lookaheadcalc->startRun();
+
+    EV << "  setup done.\n";
+}
+
+void cTimeWindowProtocol::endRun()
+{
+    EV << "Time Window Protocol: " << numEvents << " events in " << windowIndex << " windows";
+    if (windowIndex > 0)
+        EV << ", " << (double)numEvents / windowIndex << " events per window";
+    EV << "\n";
+
+    lookaheadcalc->endRun();
+}
+
+simtime_t cTimeWindowProtocol::getLookahead()
+{
+    simtime_t lookahead = SIMTIME_MAX;
+    int myProcId = comm->getProcId();
+    for (int i = 0; i < numSeg; i++)
+        if (i != myProcId)
+            lookahead = std::min(lookahead, lookaheadcalc->getCurrentLookahead(i));
+    return lookahead;
+}
+
+void cTimeWindowProtocol::processOutgoingMessage(cMessage *msg, int destProcId, int destModuleId, int destGateId, void *data)
+{
+    // other partitions may already be executing events of the current window
+    if (msg->getArrivalTime() < windowEnd)
+        throw cRuntimeError("cTimeWindowProtocol: Message (%s)%s sent to partition %d would arrive at t=%s, "
+                            "before the end of the current time window at t=%s (delay is less than the lookahead)",
+                            msg->getClassName(), msg->getName(), destProcId, SIMTIME_STR(msg->getArrivalTime()), SIMTIME_STR(windowEnd));
+
+    minSentArrival = std::min(minSentArrival, msg->getArrivalTime());
+    segInfo[destProcId].numMessagesSent++;
+
+    {if (debug) EV << "sending '" << msg->getName() << "' to " << destProcId << "\n";}
+
+    cParsimProtocolBase::processOutgoingMessage(msg, destProcId, destModuleId, destGateId, data);
+}
+
+void cTimeWindowProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    if (tag == TAG_TIMEWINDOW_BARRIER) {
+        processReceivedBarrier(buffer, sourceProcId);
+        buffer->assertBufferEmpty();
+    }
+    else {
+        cParsimProtocolBase::processReceivedBuffer(buffer, tag, sourceProcId);
+    }
+}
+
+void cTimeWindowProtocol::processReceivedMessage(cMessage *msg, int destModuleId, int destGateId, int sourceProcId)
+{
+    segInfo[sourceProcId].numMessagesReceived++;
+    cParsimProtocolBase::processReceivedMessage(msg, destModuleId, destGateId, sourceProcId);
+}
+
+void cTimeWindowProtocol::processReceivedBarrier(cCommBuffer *buffer, int sourceProcId)
+{
+    long long index;
+    int numMessagesSent;
+    simtime_t minNextEvent, lookahead;
+    buffer->unpack(index);
+    buffer->unpack(numMessagesSent);
+    buffer->unpack(minNextEvent);
+    buffer->unpack(lookahead);
+
+    // the other partition may be one window ahead of us, but not more
+    if (index != windowIndex && index != windowIndex+1)
+        throw cRuntimeError("cTimeWindowProtocol: Barrier message for window %lld received from partition %d "
+                            "while in window %lld", index, sourceProcId, (long long)windowIndex);
+
+    // all model messages of the window must have arrived before the barrier message
+    PartitionInfo& info = segInfo[sourceProcId];
+    if (info.numMessagesReceived != numMessagesSent)
+        throw cRuntimeError("cTimeWindowProtocol: Partition %d sent %d messages in window %lld, but %d arrived "
+                            "before its barrier message -- the communications layer must preserve message order",
+                            sourceProcId, numMessagesSent, index, info.numMessagesReceived);
+    info.numMessagesReceived = 0;
+
+    {if (debug) EV << "barrier message for window " << index << " received from " << sourceProcId << ", next event at " << minNextEvent << ", lookahead=" << lookahead << "\n";}
+
+    Barrier& barrier = barriers[index % 2];
+    barrier.numReceived++;
+    barrier.minNextEvent = std::min(barrier.minNextEvent, minNextEvent);
+    barrier.minLookahead = std::min(barrier.minLookahead, lookahead);
+}
+
+bool cTimeWindowProtocol::exchangeBarriers()
+{
+    // messages sent in this window become events in other partitions, so
+    // they count as next events too
+    cFutureEventSet *fes = sim->getFES();
+    simtime_t nextEvent = fes->isEmpty() ? SIMTIME_MAX : fes->peekFirst()->getArrivalTime();
+    simtime_t minNextEvent = std::min(nextEvent, minSentArrival);
+    simtime_t lookahead = getLookahead();
+
+    Barrier& barrier = barriers[windowIndex % 2];
+    barrier.minNextEvent = std::min(barrier.minNextEvent, minNextEvent);
+    barrier.minLookahead = std::min(barrier.minLookahead, lookahead);
+
+    {if (debug) EV << "end of window " << windowIndex << ", sending barrier messages: next event at " << minNextEvent << ", lookahead=" << lookahead << "\n";}
+
+    int myProcId = comm->getProcId();
+    for (int i = 0; i < numSeg; i++) {
+        if (i == myProcId)
+            continue;
+        cCommBuffer *buffer = comm->createCommBuffer();
+        buffer->pack((long long)windowIndex);
+        buffer->pack(segInfo[i].numMessagesSent);
+        buffer->pack(minNextEvent);
+        buffer->pack(lookahead);
+        sendBuffer(buffer, TAG_TIMEWINDOW_BARRIER, i);
+        comm->recycleCommBuffer(buffer);
+        segInfo[i].numMessagesSent = 0;
+    }
+    minSentArrival = SIMTIME_MAX;
+
+    // wait for the barrier messages of the other partitions
+    while (barrier.numReceived < numSeg-1)
+        if (!receiveBlocking())
+            return false;
+
+    // compute the next window; all partitions arrive at the same result
+    simtime_t t = barrier.minNextEvent;
+    simtime_t minLookahead = barrier.minLookahead;
+    if (minLookahead <= SIMTIME_ZERO)
+        throw cRuntimeError("cTimeWindowProtocol: Zero lookahead, time windows cannot advance");
+    windowEnd = (minLookahead >= SIMTIME_MAX - t) ? SIMTIME_MAX : t + minLookahead;
+
+    // a partition that reaches the simulation time limit terminates the others,
+    // so all events before the limit must be executed in earlier windows
+    simtime_t limit = sim->getSimulationTimeLimit();
+    if (t < limit && windowEnd > limit)
+        windowEnd = limit;
+
+    barrier.numReceived = 0;
+    barrier.minNextEvent = barrier.minLookahead = SIMTIME_MAX;
+    windowIndex++;
+
+    {if (debug) EV << "window " << windowIndex << " is [" << t << ", " << windowEnd << ")\n";}
+    return true;
+}
+
+cEvent *cTimeWindowProtocol::takeNextEvent()
+{
+    cFutureEventSet *fes = sim->getFES();
+    while (true) {
+        cEvent *event = fes->peekFirst();
+        if (event && event->getArrivalTime() < windowEnd) {
+            // inside the current window -- go ahead with it
+            fes->removeFirst();
+            numEvents++;
+            return event;
+        }
+
+        // end of window: all partitions exchange barrier messages
+        if (!exchangeBarriers())
+            return nullptr;  // interrupted
+
+        // no events anywhere, and no messages in transit: we're finished
+        if (windowEnd == SIMTIME_MAX && fes->isEmpty())
+            throw cTerminationException(E_ENDEDOK);
+    }
+}
+
+void cTimeWindowProtocol::putBackEvent(cEvent *event)
+{
+    sim->getFES()->putBackFirst(event);
+    numEvents--;
+}
+
+}  // namespace omnetpp
+
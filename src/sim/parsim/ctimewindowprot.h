@@ -0,0 +1,160 @@
+//=========================================================================
+//  CTIMEWINDOWPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTIMEWINDOWPROT_H
+#define __OMNETPP_CTIMEWINDOWPROT_H
+
+#include "cparsimprotocolbase.h"
+
+namespace omnetpp {
+
+class cCommBuffer;
+class cNMPLookahead;
+
+
+/**
+ * @brief Implements a barrier-based time window protocol (similar to YAWNS).
+ *
+ * The simulation proceeds in time windows. In each window, every partition
+ * executes its events with timestamps below the window end, then sends a
+ * barrier message to every other partition. The barrier message carries the
+ * time of the sender's next local event, the earliest arrival time of the
+ * messages it sent in the window, and its lookahead. Once a partition has
+ * received the barrier messages from all other partitions, it knows the
+ * earliest event time T in the whole simulation. The next window ends at
+ * T plus the smallest lookahead of all partitions, but a window never
+ * extends over the simulation time limit (because the first partition to
+ * reach it terminates the others). Every partition computes the same window
+ * end.
+ *
+ * The barrier messages are sent over the same channels as model messages.
+ * The protocol relies on communications preserving message order between
+ * any two partitions, so all model messages of a window have arrived when
+ * the barrier message from the same partition arrives. This is verified
+ * using the message counts in the barrier messages.
+ *
+ * This protocol works best for tightly coupled partitions with uniform
+ * link delays. Then a window contains many events per partition, and the
+ * barrier traffic is only one message per partition pair per window.
+ *
+ * Lookahead is computed by a cNMPLookahead object, by default
+ * cLinkDelayLookahead (see the `parsim-timewindowprotocol-lookahead-class`
+ * configuration option). The lookahead of a partition is its smallest
+ * lookahead towards any other partition.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cTimeWindowProtocol : public cParsimProtocolBase
+{
+  protected:
+    struct PartitionInfo
+    {
+        int numMessagesSent;      // model messages sent to the partition in the current window
+        int numMessagesReceived;  // model messages received from the partition since its last barrier message
+    };
+
+    struct Barrier
+    {
+        int numReceived;         // number of barrier messages received
+        simtime_t minNextEvent;  // minimum of next local events and arrival times of sent messages
+        simtime_t minLookahead;  // minimum of the partitions' lookaheads
+    };
+
+    int numSeg;              // number of partitions
+    PartitionInfo *segInfo;  // partition info array, size numSeg
+
+    int64_t windowIndex;     // index of the current window
+    simtime_t windowEnd;     // events before this time can be executed
+    simtime_t minSentArrival; // earliest arrival time of the messages sent in the current window
+    Barrier barriers[2];     // indexed by window index parity; barrier messages of the next window may arrive early
+
+    int64_t numEvents;       // statistics: events executed
+
+    bool debug;
+
+    cNMPLookahead *lookaheadcalc;
+
+  protected:
+    // process buffers coming from other partitions
+    virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
+
+    // process cMessages received from other partitions
+    virtual void processReceivedMessage(cMessage *msg, int destModuleId, int destGateId, int sourceProcId) override;
+
+    // processes a received barrier message
+    virtual void processReceivedBarrier(cCommBuffer *buffer, int sourceProcId);
+
+    // sends barrier messages to the other partitions, waits for theirs, and
+    // computes the end of the next window; returns false if interrupted
+    virtual bool exchangeBarriers();
+
+    // the smallest lookahead from this partition to any other partition
+    virtual simtime_t getLookahead();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cTimeWindowProtocol();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cTimeWindowProtocol();
+
+    /**
+     * Redefined because we have to pass the same data to the lookahead
+     * calculator object (cNMPLookahead) too.
+     */
+    virtual void setContext(cSimulation *sim, cParsimPartition *seg, cParsimCommunications *co) override;
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Scheduler function. Returns the events of the current window, and
+     * performs the barrier exchange at the end of each window.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Undo takeNextEvent() -- it comes from the cScheduler interface.
+     */
+    virtual void putBackEvent(cEvent *event) override;
+
+    /**
+     * In addition to sending out the cMessage to the given partition,
+     * it checks that the message arrives after the current window,
+     * and updates the data that goes into the next barrier message.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, int procId, int moduleId, int gateId, void *data) override;
+
+    /**
+     * Returns the number of time windows completed in the current run.
+     */
+    int64_t getNumWindows() const {return windowIndex;}
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -31,7 +31,8 @@ enum {
      TAG_NULLMESSAGE,
      TAG_CMESSAGE_WITH_NULLMESSAGE,
      TAG_TERMINATIONEXCEPTION,
-     TAG_EXCEPTION
+     TAG_EXCEPTION,
+     TAG_TIMEWINDOW_BARRIER
 };
 
 #endif
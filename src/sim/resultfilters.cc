@@ -412,5 +412,121 @@ std::string SumPerDurationFilter::str() const
     return os.str();
 }
 
+//---
+
+DeferredDeliveryFilter::DeferredDeliveryFilter(int capacity) : capacity(capacity)
+{
+    ASSERT(capacity > 0);
+    times = new simtime_t[capacity];
+    values = new double[capacity];
+}
+
+DeferredDeliveryFilter::~DeferredDeliveryFilter()
+{
+    // deliver what is still buffered, e.g. when the component is deleted
+    // mid-run; the delegates are only released by the base class destructor
+    flush();
+    delete[] times;
+    delete[] values;
+}
+
+void DeferredDeliveryFilter::bufferingStarted()
+{
+    if (needsEventEndFlush == -1)
+        needsEventEndFlush = !acceptsDelayedDelivery();
+    if (needsEventEndFlush) {
+        getSimulation()->addDeferredResultFilter(this);
+        registered = true;
+    }
+}
+
+void DeferredDeliveryFilter::flush()
+{
+    if (registered) {
+        getSimulation()->removeDeferredResultFilter(this);
+        registered = false;
+    }
+    if (numBuffered > 0) {
+        int n = numBuffered;
+        numBuffered = 0;
+        fireBatch(this, times, values, n);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, bool b, cObject *details)
+{
+    if (!details)
+        append(t, b);
+    else {
+        flush();
+        fire(this, t, b, details);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, long l, cObject *details)
+{
+    if (!details)
+        append(t, l);
+    else {
+        flush();
+        fire(this, t, l, details);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, unsigned long l, cObject *details)
+{
+    if (!details)
+        append(t, l);
+    else {
+        flush();
+        fire(this, t, l, details);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, double d, cObject *details)
+{
+    if (!details)
+        append(t, d);
+    else {
+        flush();
+        fire(this, t, d, details);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details)
+{
+    if (!details)
+        append(t, v.dbl());
+    else {
+        flush();
+        fire(this, t, v, details);
+    }
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details)
+{
+    flush();
+    fire(this, t, s, details);
+}
+
+void DeferredDeliveryFilter::receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details)
+{
+    flush();
+    fire(this, t, obj, details);
+}
+
+void DeferredDeliveryFilter::callFinish(cResultFilter *prev)
+{
+    flush();
+    cResultFilter::callFinish(prev);
+}
+
+std::string DeferredDeliveryFilter::str() const
+{
+    std::stringstream os;
+    os << "buffered: " << getNumBuffered() << "/" << capacity;
+    return os.str();
+}
+
 }  // namespace omnetpp
 
@@ -89,6 +89,14 @@ std::string VectorRecorder::str() const
 
 //---
 
+void CountRecorder::receiveBatch(cResultFilter *prev, const simtime_t *times, const double *values, int n)
+{
+    long c = 0;
+    for (int i = 0; i < n; i++)
+        c += !std::isnan(values[i]);
+    count += c;
+}
+
 void CountRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
@@ -110,6 +118,16 @@ void LastValueRecorder::collect(simtime_t_cref t, double value, cObject *details
         lastValue = value;
 }
 
+void LastValueRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    for (int i = n - 1; i >= 0; i--) {
+        if (!std::isnan(values[i])) {
+            lastValue = values[i];
+            break;
+        }
+    }
+}
+
 void LastValueRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
@@ -131,6 +149,15 @@ void SumRecorder::collect(simtime_t_cref t, double value, cObject *details)
         sum += value;
 }
 
+void SumRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    double s = sum;
+    for (int i = 0; i < n; i++)
+        if (!std::isnan(values[i]))
+            s += values[i];
+    sum = s;
+}
+
 
 void SumRecorder::finish(cResultFilter *prev)
 {
@@ -174,6 +201,24 @@ void MeanRecorder::collect(simtime_t_cref t, double value, cObject *details)
     }
 }
 
+void MeanRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    if (timeWeighted) {
+        cNumericResultRecorder::collectBatch(times, values, n);
+        return;
+    }
+    long c = 0;
+    double s = weightedSum;
+    for (int i = 0; i < n; i++) {
+        if (!std::isnan(values[i])) {
+            c++;
+            s += values[i];
+        }
+    }
+    count += c;
+    weightedSum = s;
+}
+
 std::string MeanRecorder::str() const
 {
     std::stringstream os;
@@ -216,6 +261,14 @@ void MinRecorder::collect(simtime_t_cref t, double value, cObject *details)
     }
 }
 
+void MinRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    double m = min;
+    for (int i = 0; i < n; i++)
+        m = values[i] < m ? values[i] : m;  // comparison with NaN is false, so NaNs are skipped
+    min = m;
+}
+
 void MinRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
@@ -239,6 +292,14 @@ void MaxRecorder::collect(simtime_t_cref t, double value, cObject *details)
     }
 }
 
+void MaxRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    double m = max;
+    for (int i = 0; i < n; i++)
+        m = values[i] > m ? values[i] : m;  // comparison with NaN is false, so NaNs are skipped
+    max = m;
+}
+
 void MaxRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
@@ -262,6 +323,20 @@ void AverageRecorder::collect(simtime_t_cref t, double value, cObject *details)
     }
 }
 
+void AverageRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    long c = 0;
+    double s = sum;
+    for (int i = 0; i < n; i++) {
+        if (!std::isnan(values[i])) {
+            c++;
+            s += values[i];
+        }
+    }
+    count += c;
+    sum = s;
+}
+
 void AverageRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
@@ -287,6 +362,27 @@ void TimeAverageRecorder::collect(simtime_t_cref t, double value, cObject *detai
     lastValue = value;
 }
 
+void TimeAverageRecorder::collectBatch(const simtime_t *times, const double *values, int n)
+{
+    // same as collect(), but keeps the running state in local variables
+    double value = lastValue;
+    simtime_t t = lastTime;
+    simtime_t total = totalTime;
+    double sum = weightedSum;
+    for (int i = 0; i < n; i++) {
+        if (!std::isnan(value)) {
+            total += times[i] - t;
+            sum += value * SIMTIME_DBL(times[i] - t);
+        }
+        t = times[i];
+        value = values[i];
+    }
+    lastValue = value;
+    lastTime = t;
+    totalTime = total;
+    weightedSum = sum;
+}
+
 double TimeAverageRecorder::getTimeAverage() const
 {
     simtime_t tmpTotalTime = totalTime;
@@ -22,6 +22,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cmath>
+#include <mutex>
 #include "common/commonutil.h"
 #include "common/unitconversion.h"
 #include "common/opp_ctype.h"
@@ -69,6 +70,7 @@ char *opp_strprettytrunc(char *dest, const char *src, unsigned maxlen)
 #ifdef __GNUC__
 typedef std::map<std::string, std::string> StringMap;
 static StringMap demangledNames;
+static std::mutex demangledNamesMutex;  // protects demangledNames
 #endif
 
 const char *opp_demangle_typename(const char *mangledName)
@@ -95,6 +97,7 @@ const char *opp_demangle_typename(const char *mangledName)
     }
 
     // if we've already seen this name, return cached result
+    OptionalLockGuard<std::mutex> lock(demangledNamesMutex);
     StringMap::const_iterator it = demangledNames.find(mangledName);
     if (it == demangledNames.end()) {
         // not found -- demangle it and cache the result
@@ -227,12 +230,12 @@ cContextSwitcher::~cContextSwitcher()
 
 static va_list dummy_va;
 
-int cMethodCallContextSwitcher::depth = 0;
+static OPP_THREAD_LOCAL int methodCallDepth = 0;  // per-thread, see cMethodCallContextSwitcher::getDepth()
 
 cMethodCallContextSwitcher::cMethodCallContextSwitcher(const cComponent *newContext) :
     cContextSwitcher(newContext)
 {
-    depth++;
+    methodCallDepth++;
 }
 
 void cMethodCallContextSwitcher::methodCall(const char *methodFmt, ...)
@@ -266,12 +269,17 @@ void cMethodCallContextSwitcher::methodCallSilent()
 
 cMethodCallContextSwitcher::~cMethodCallContextSwitcher()
 {
-    depth--;
+    methodCallDepth--;
     cComponent *methodContext = getSimulation()->getContext();
     if (methodContext != callerContext)
         EVCB.componentMethodEnd();
 }
 
+int cMethodCallContextSwitcher::getDepth()
+{
+    return methodCallDepth;
+}
+
 //----
 
 cContextTypeSwitcher::cContextTypeSwitcher(int contexttype)
@@ -8,6 +8,7 @@
 //
 
 #include <string.h>
+#include <stdio.h>
 #include <omnetpp.h>
 
 using namespace omnetpp;
@@ -15,16 +16,31 @@ using namespace omnetpp;
 class Tic : public cSimpleModule
 {
   protected:
+    long numReceived = 0;
+    simtime_t lastArrivalTime;
+
+    virtual cPacket *createPacket();
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
+    virtual void finish();
 };
 
 Define_Module(Tic);
 
+cPacket *Tic::createPacket()
+{
+    int nameLength = par("packetNameLength");
+    if (nameLength == 0)
+        return new cPacket(getFullName());
+    std::string name = getFullName();
+    name.resize(nameLength, '.');
+    return new cPacket(name.c_str());
+}
+
 void Tic::initialize()
 {
     if (par("initialSend").boolValue()) {
-        cPacket *pkt = new cPacket(getFullName());
+        cPacket *pkt = createPacket();
         send(pkt, par("outputGate").stringValue());
     }
 }
@@ -32,17 +48,32 @@ void Tic::initialize()
 void Tic::handleMessage(cMessage *msg)
 {
     cPacket *pkt = check_and_cast<cPacket *>(msg);
+    numReceived++;
+    lastArrivalTime = pkt->getArrivalTime();
+
+    simtime_t stopTime = par("stopTime");
+    if (stopTime >= SIMTIME_ZERO && simTime() > stopTime) {
+        delete pkt;
+        return;
+    }
 
     if (par("delete").boolValue()) {
         if (par("allowPointerAliasing").boolValue()) {
             delete pkt;
-            pkt = new cPacket(getFullName());  // may get the same address as deleted pkt
+            pkt = createPacket();  // may get the same address as deleted pkt
         }
         else {
-            pkt = new cPacket(getFullName());
+            pkt = createPacket();
             delete msg;
         }
     }
     send(pkt, par("outputGate").stringValue());
 }
 
+void Tic::finish()
+{
+    // printed in one piece, as partitions running as threads share stdout;
+    // the runparsim-threads script compares these lines across runs
+    printf("RESULT %s: received %ld packets, last one at t=%s\n", getFullPath().c_str(), numReceived, lastArrivalTime.str().c_str());
+    fflush(stdout);
+}
@@ -1,4 +1,10 @@
         #include <omnetpp.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#ifdef HAVE_SWAPCONTEXT
+#include <ucontext.h>
+#endif
 
 using namespace omnetpp;
 
@@ -214,3 +220,171 @@ void ScheduleAndCancel_1::finish()
     EV << evPerSec << " event/sec\n";
 }
 
+
+// ---------------
+
+// coroutine switching: cCoroutine (whichever implementation was compiled in)
+// versus plain swapcontext() as baseline
+class CoroutineSwitch_1 : public cSimpleModule
+{
+  protected:
+    int repCount;
+    Timer tmr;
+    double switchesPerSec;
+#ifdef HAVE_SWAPCONTEXT
+    Timer ucontextTmr;
+    double ucontextSwitchesPerSec;
+#endif
+
+  public:
+    virtual void initialize();
+    virtual void finish();
+};
+
+Define_Module(CoroutineSwitch_1);
+
+static void coroutineSwitchBody(void *)
+{
+    for (;;)
+        cCoroutine::switchToMain();
+}
+
+#ifdef HAVE_SWAPCONTEXT
+static ucontext_t mainContext, benchContext;
+
+static void ucontextSwitchBody()
+{
+    for (;;)
+        swapcontext(&benchContext, &mainContext);
+}
+#endif
+
+void CoroutineSwitch_1::initialize()
+{
+    repCount = par("repCount");
+
+    // note: initialize() runs in the main coroutine
+    cCoroutine coroutine;
+    if (!coroutine.setup(coroutineSwitchBody, nullptr, 32768))
+        throw cRuntimeError("Cannot create coroutine");
+    tmr.start();
+    for (int i = 0; i < repCount; i++)
+        cCoroutine::switchTo(&coroutine);
+    tmr.stop();
+    switchesPerSec = 2 * repCount / tmr.get();
+
+#ifdef HAVE_SWAPCONTEXT
+    std::vector<char> stack(32768);
+    getcontext(&benchContext);
+    benchContext.uc_stack.ss_sp = stack.data();
+    benchContext.uc_stack.ss_size = stack.size();
+    benchContext.uc_link = &mainContext;
+    makecontext(&benchContext, ucontextSwitchBody, 0);
+    ucontextTmr.start();
+    for (int i = 0; i < repCount; i++)
+        swapcontext(&mainContext, &benchContext);
+    ucontextTmr.stop();
+    ucontextSwitchesPerSec = 2 * repCount / ucontextTmr.get();
+#endif
+}
+
+void CoroutineSwitch_1::finish()
+{
+    EV << "cCoroutine: " << switchesPerSec << " switches/sec\n";
+#ifdef HAVE_SWAPCONTEXT
+    EV << "swapcontext(): " << ucontextSwitchesPerSec << " switches/sec\n";
+#endif
+}
+
+// ---------------
+
+// receive/wait path of activity() modules: two context switches per event
+class ActivityWait_1 : public cSimpleModule
+{
+  protected:
+    int repCount;
+    Timer tmr;
+
+  public:
+    ActivityWait_1() : cSimpleModule(32768) {}
+    virtual void activity();
+    virtual void finish();
+};
+
+Define_Module(ActivityWait_1);
+
+void ActivityWait_1::activity()
+{
+    repCount = par("repCount");
+    tmr.start();
+    for (int i = 0; i < repCount; i++)
+        wait(1.0);
+    tmr.stop();
+}
+
+void ActivityWait_1::finish()
+{
+    EV << "t=" << 1000000*tmr.get()/repCount << " us per wait()\n";
+}
+
+// ---------------
+
+// getSubmodule() and gate() lookups by name in a module with many submodules
+// and gates; the cost per lookup should not depend on their number
+class ModuleLookup_1 : public cSimpleModule
+{
+  protected:
+    int repCount;
+    int numSubmodules;
+    Timer submoduleTmr;
+    Timer gateTmr;
+
+  public:
+    virtual void initialize();
+    virtual void finish();
+};
+
+Define_Module(ModuleLookup_1);
+
+void ModuleLookup_1::initialize()
+{
+    repCount = par("repCount");
+    numSubmodules = par("numSubmodules");
+
+    // add submodules to the parent, and gates to this module
+    cModule *parent = getParentModule();
+    cModuleType *type = cModuleType::get("Dummy_1");
+    std::vector<std::string> names, gateNames;
+    for (int i = 0; i < numSubmodules; i++) {
+        names.push_back(std::string("node") + std::to_string(i));
+        type->createScheduleInit(names.back().c_str(), parent);
+    }
+    int numGates = std::min(numSubmodules, 1000);
+    for (int i = 0; i < numGates; i++) {
+        std::string gateName = std::string("g") + std::to_string(i);
+        addGate(gateName.c_str(), cGate::INOUT);
+        gateNames.push_back(gateName + "$o");
+    }
+
+    int count = 0;
+    submoduleTmr.start();
+    for (int i = 0; i < repCount; i++)
+        if (parent->getSubmodule(names[i % numSubmodules].c_str()))
+            count++;
+    submoduleTmr.stop();
+
+    gateTmr.start();
+    for (int i = 0; i < repCount; i++)
+        if (gate(gateNames[i % numGates].c_str()))
+            count++;
+    gateTmr.stop();
+
+    if (count != 2*repCount)
+        throw cRuntimeError("Lookup failed");
+}
+
+void ModuleLookup_1::finish()
+{
+    EV << "getSubmodule(): t=" << 1000000*submoduleTmr.get()/repCount << " us per lookup\n";
+    EV << "gate(): t=" << 1000000*gateTmr.get()/repCount << " us per lookup\n";
+}
@@ -41,7 +41,8 @@ static void usage(char *message)
     cerr << "resultfilemanager <input-file>\n";
     cerr << "indexer <input-file>\n";
     cerr << "reader <input-file> <vector-id-list>\n";
-    cerr << "indexedreader <input-file> <vector-id-list>\n\n";
+    cerr << "indexedreader <input-file> <vector-id-list>\n";
+    cerr << "mappedvectorfilereader <input-file> <vector-id-list>\n\n";
 }
 
 static void parseIntList(const char *str, int *& result, int& len)
@@ -134,6 +135,7 @@ int main(int argc, char **argv)
             }
             else if (strcmp(argv[1], "indexedvectorfilereader") == 0 ||
                      strcmp(argv[1], "indexedvectorfilereader2") == 0 ||
+                     strcmp(argv[1], "mappedvectorfilereader") == 0 ||
                      strcmp(argv[1], "vectorfilereader") == 0)
             {
                 if (argc < 4) {
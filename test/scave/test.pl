@@ -173,5 +173,6 @@ testExport("testfiles/vectors.vec", "csv");
 generateVectorFile("testfiles/big.vec", 1000, 10000000, 10000);
 testIndexer("testfiles/big.vec");
 testReader2("indexedvectorfilereader", "testfiles/big.vec", "100,200,300,400,500,600,700,800,900,1000");
+testReader2("mappedvectorfilereader", "testfiles/big.vec", "100,200,300,400,500,600,700,800,900,1000");
 testReader2("vectorfilereader", "testfiles/big.vec", "100,200,300,400,500,600,700,800,900,1000");
 
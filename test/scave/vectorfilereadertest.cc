@@ -127,7 +127,8 @@ void testReaderBuilder(const char *inputfile, const char *outputfile)
 void testReader(const char *readerNodeType, const char *inputFile, int *vectorIds, int count)
 {
     if ((strcmp(readerNodeType, "indexedvectorfilereader") == 0 ||
-         strcmp(readerNodeType, "indexedvectorfilereader2") == 0) &&
+         strcmp(readerNodeType, "indexedvectorfilereader2") == 0 ||
+         strcmp(readerNodeType, "mappedvectorfilereader") == 0) &&
         !IndexFile::isIndexFileUpToDate(inputFile))
         throw exception("Index file is not up to date");
 
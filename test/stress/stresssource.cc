@@ -8,13 +8,15 @@
 //
 
 #include <omnetpp.h>
+#include <algorithm>
 #include <vector>
 #include "stresssource.h"
 #include "stress_m.h"
 
 Define_Module(StressSource);
 
-std::vector<StressSource *> sources;
+// note: thread_local, because with Cmdenv -j, every thread runs a simulation of its own
+static thread_local std::vector<StressSource *> sources;
 
 StressSource::StressSource()
 {
@@ -26,6 +28,7 @@ StressSource::~StressSource()
 {
     EV << "Cancelling and deleting self message: "  << timer << "\n";
     cancelAndDelete(timer);
+    sources.erase(std::find(sources.begin(), sources.end(), this));
 }
 
 void StressSource::initialize()